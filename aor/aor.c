@@ -33,6 +33,7 @@
 #include "hamlib/rig.h"
 #include "serial.h"
 #include "misc.h"
+#include "numcodec.h"
 #include "register.h"
 #include "idx_builtin.h"
 
@@ -154,7 +155,9 @@ static int format_freq(char *buf, freq_t freq)
 		lowhz = 100;
 	f = f*100 + lowhz;
 
-	return sprintf(buf,"RF%010"PRIll, f);
+	buf[0] = 'R';
+	buf[1] = 'F';
+	return num_to_dec(buf+2, (unsigned long long)f, 10) - buf;
 }
 
 /*
@@ -198,7 +201,8 @@ int aor_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
 		return -RIG_EPROTO;
 	}
 
-	sscanf(rfp+2,"%"SCNfreq, freq);
+	if (num_scan_freq(rfp+2, freq) < 0)
+		return -RIG_EPROTO;
 
 	return RIG_OK;
 }
@@ -911,7 +915,8 @@ static int parse_chan_line(RIG *rig, channel_t *chan, char *basep, const channel
 			return -RIG_EPROTO;
 		}
 
-		sscanf(tagp+2,"%"SCNfreq, &chan->freq);
+		if (num_scan_freq(tagp+2, &chan->freq) < 0)
+			return -RIG_EPROTO;
 	}
 
 	/* channel desc */
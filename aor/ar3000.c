@@ -29,6 +29,7 @@
 #include <hamlib/rig.h>
 #include <serial.h>
 #include <misc.h>
+#include <numcodec.h>
 
 #include "aor.h"
 
@@ -239,7 +240,10 @@ int ar3k_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
 		lowhz = 100;
 	freq = freq*100 + lowhz;
 
-	freq_len = sprintf(freqbuf,"%04.5f" EOM, ((double)freq)/MHz(1));
+	/* MHz, with a '.' whatever the locale */
+	freq_len = num_to_fixed(freqbuf, ((long long)freq + 5)/10, 5);
+	strcpy(freqbuf+freq_len, EOM);
+	freq_len += strlen(EOM);
 
 	retval = ar3k_transaction (rig, freqbuf, freq_len, NULL, NULL);
 	if (retval != RIG_OK)
@@ -31,6 +31,7 @@
 #include "serial.h"
 #include "idx_builtin.h"
 #include "misc.h"
+#include "numcodec.h"
 #include "aor.h"
 
 
@@ -317,7 +318,10 @@ int ar3030_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
 	char freqbuf[BUFSZ];
 	int freq_len, retval;
 
-	freq_len = sprintf(freqbuf,"%03.4f" EOM, ((double)freq)/MHz(1));
+	/* MHz, rounded to 100 Hz, with a '.' whatever the locale */
+	freq_len = num_to_fixed(freqbuf, ((long long)freq + 50)/100, 4);
+	strcpy(freqbuf+freq_len, EOM);
+	freq_len += strlen(EOM);
 
 	retval = ar3030_transaction (rig, freqbuf, freq_len, NULL, NULL);
 	if (retval != RIG_OK)
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# Test of the awaitable wrappers: two dummy rigs are driven at the same
+# time, each keeping its own calls in order, and a failing call raises
+# a RigError.
+
+import sys
+import asyncio
+
+sys.path.append ('.')
+sys.path.append ('.libs')
+sys.path.append ('/usr/local/hamlib/python')
+
+import Hamlib
+
+errors = 0
+
+def check (cond, msg):
+    global errors
+    if not cond:
+        print ("error:", msg)
+        errors += 1
+
+async def drive (rig, base):
+    await rig.open ()
+    for i in range (100):
+        await rig.set_freq (base + i*10)
+        freq = await rig.get_freq ()
+        check (freq == base + i*10, "freq %d instead of %d" % (freq, base + i*10))
+    await rig.set_mode (Hamlib.RIG_MODE_USB)
+    (mode, width) = await rig.get_mode ()
+    check (mode == Hamlib.RIG_MODE_USB, "mode %s" % Hamlib.rig_strrmode (mode))
+    return await rig.get_freq ()
+
+async def main ():
+    rig1 = Hamlib.AsyncRig (Hamlib.Rig (Hamlib.RIG_MODEL_DUMMY))
+    rig2 = Hamlib.AsyncRig (Hamlib.Rig (Hamlib.RIG_MODEL_DUMMY))
+
+    print ("two rigs at the same time")
+    (f1, f2) = await asyncio.gather (drive (rig1, 7000000), drive (rig2, 14000000))
+    print ("  last freqs:", f1, f2)
+    check (f1 == 7000990 and f2 == 14000990, "wrong last freqs")
+
+    print ("failing call")
+    await rig1.close ()
+    try:
+        await rig1.set_freq (7074000)
+        check (False, "no RigError raised")
+    except Hamlib.RigError as e:
+        print ("  RigError:", e)
+        check (e.status == -Hamlib.RIG_EINVAL, "status %d" % e.status)
+
+    await rig2.close ()
+    rig1.shutdown ()
+    rig2.shutdown ()
+
+if __name__ == '__main__':
+    Hamlib.rig_set_debug (Hamlib.RIG_DEBUG_NONE)
+    asyncio.run (main ())
+    print ("%d error(s)" % errors)
+    sys.exit (1 if errors else 0)
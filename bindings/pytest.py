@@ -2,6 +2,7 @@
 # -*- coding: utf-8 -*-
 
 import sys
+import threading
 
 sys.path.append ('.')
 sys.path.append ('.libs')
@@ -90,5 +91,44 @@ def StartUp ():
     print "Bearing: ",az,", ",deg,"° ",min,"' ",sec,", recoded: ",az2
 
 
+def StressRig (my_rig, base, loops, errors):
+    for i in range(loops):
+        my_rig.set_freq (base + i)
+        freq = my_rig.get_freq ()
+        if freq != base + i or my_rig.error_status != Hamlib.RIG_OK:
+            errors.append ("rig %d: got %d, expected %d, status %d" % \
+                    (base, freq, base + i, my_rig.error_status))
+            return
+
+def ThreadStress (nthreads = 4, loops = 2000):
+    """every thread hammers its own rig, while the GIL is released"""
+    print "\nThreaded stress test:",nthreads,"threads,",loops,"loops"
+
+    rigs = []
+    for n in range(nthreads):
+        my_rig = Hamlib.Rig (Hamlib.RIG_MODEL_DUMMY)
+        my_rig.open ()
+        rigs.append (my_rig)
+
+    errors = []
+    threads = [threading.Thread (target = StressRig,
+            args = (rigs[n], 14000000 + n * 1000000, loops, errors))
+            for n in range(nthreads)]
+    for t in threads:
+        t.start ()
+    for t in threads:
+        t.join ()
+
+    for my_rig in rigs:
+        my_rig.close ()
+
+    for e in errors:
+        print e
+    print "stress:", errors and "FAILED" or "OK"
+    return not errors
+
+
 if __name__ == '__main__':
     StartUp ()
+    if not ThreadStress ():
+        sys.exit (1)
@@ -0,0 +1,122 @@
+/*
+ *  Hamlib bindings - Python specific code
+ *  Copyright (c) 2026 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/*
+ * Awaitable wrappers, for asyncio applications driving several rigs.
+ *
+ * Each AsyncRig/AsyncRot owns a single worker thread, so the calls
+ * to one rig are serialized in submission order, while the calls to
+ * different rigs overlap, the GIL being released by the wrappers.
+ * Here is an example:
+ *
+ *	rig = Hamlib.AsyncRig(Hamlib.Rig(Hamlib.RIG_MODEL_DUMMY))
+ *	await rig.open()
+ *	await rig.set_freq(14074000)
+ *	freq = await rig.get_freq()
+ *	(mode, width) = await rig.get_mode()
+ *	await rig.close()
+ *
+ * A call failing with error_status != RIG_OK raises a RigError.
+ * The code is kept Python 2 parsable, the wrappers being only
+ * available where asyncio is.
+ */
+
+%pythoncode %{
+
+try:
+    import asyncio
+    import concurrent.futures
+except ImportError:
+    asyncio = None
+
+
+class RigError(Exception):
+    """Hamlib call failed, status holds the -RIG_E* error code"""
+    def __init__(self, status):
+        Exception.__init__(self, rigerror(status))
+        self.status = status
+
+
+def _async_method(name):
+    def method(self, *args):
+        return self._submit(name, args)
+    method.__name__ = name
+    method.__doc__ = "awaitable %s()" % name
+    return method
+
+
+class _AsyncWrapper(object):
+    _methods = ()
+
+    def __init__(self, obj, loop=None):
+        if asyncio is None:
+            raise ImportError("asyncio is not available")
+        self.obj = obj
+        self._loop = loop
+        self._executor = concurrent.futures.ThreadPoolExecutor(max_workers=1)
+
+    def _call(self, name, args):
+        # runs in the worker thread, error_status is only
+        # ever touched from there
+        result = getattr(self.obj, name)(*args)
+        if self.obj.error_status != RIG_OK:
+            raise RigError(self.obj.error_status)
+        return result
+
+    def _submit(self, name, args):
+        loop = self._loop or asyncio.get_event_loop()
+        return loop.run_in_executor(self._executor, self._call, name, args)
+
+    def shutdown(self, wait=True):
+        """stop the worker thread, once the pending calls are done"""
+        self._executor.shutdown(wait)
+
+
+class AsyncRig(_AsyncWrapper):
+    """Awaitable wrapper of a Rig"""
+    _methods = ("open", "close",
+        "set_freq", "get_freq", "set_mode", "get_mode",
+        "set_vfo", "get_vfo", "set_ptt", "get_ptt",
+        "set_split_freq", "get_split_freq", "set_split_mode", "get_split_mode",
+        "set_split_vfo", "get_split_vfo",
+        "set_rit", "get_rit", "set_xit", "get_xit", "set_ts", "get_ts",
+        "set_level", "get_level_i", "get_level_f", "set_func", "get_func",
+        "set_parm", "get_parm_i", "get_parm_f",
+        "set_mem", "get_mem", "vfo_op", "scan",
+        "set_channel", "get_channel",
+        "set_powerstat", "get_powerstat", "send_morse", "get_info")
+
+for _name in AsyncRig._methods:
+    setattr(AsyncRig, _name, _async_method(_name))
+
+
+class AsyncRot(_AsyncWrapper):
+    """Awaitable wrapper of a Rot"""
+    _methods = ("open", "close",
+        "set_position", "get_position", "stop", "park", "reset", "move",
+        "get_info")
+
+for _name in AsyncRot._methods:
+    setattr(AsyncRot, _name, _async_method(_name))
+
+del _name
+
+%}
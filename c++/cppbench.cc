@@ -0,0 +1,109 @@
+/*
+ * Hamlib C++ API micro benchmark
+ *
+ * Compares the value based RigHandle with the throwing Rig class,
+ * on the success and on the error path, and measures the dispatch
+ * cost of AsyncRig.
+ */
+
+#include <iostream>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/time.h>
+#include <hamlib/rigclass.h>
+#include <hamlib/hamlibpp.h>
+
+#define LOOP_COUNT 1000000
+
+static struct timeval tv1;
+
+static void bench_start(void)
+{
+	gettimeofday(&tv1, NULL);
+}
+
+static void bench_end(const char *name, unsigned loops, double sink)
+{
+	struct timeval tv2;
+	double elapsed;
+
+	gettimeofday(&tv2, NULL);
+	elapsed = tv2.tv_sec - tv1.tv_sec + (tv2.tv_usec - tv1.tv_usec)/1000000.0;
+	printf("%-32s %8.1f ns/op   (%lld)\n", name, elapsed*1e9/loops, (long long)sink % 10);
+}
+
+int main(int argc, char* argv[])
+{
+	const int nrigs = 4;
+	unsigned loops = LOOP_COUNT;
+	double sink = 0;
+	unsigned i;
+	int n;
+
+	if (argc > 1)
+		loops = atoi(argv[1]);
+
+	rig_set_debug(RIG_DEBUG_NONE);
+	printf("Perform %u loops...\n", loops);
+
+	Rig oldRig(RIG_MODEL_DUMMY);
+	hamlib::RigHandle rig(RIG_MODEL_DUMMY);
+	oldRig.open();
+	rig.open();
+
+	bench_start();
+	for (i = 0; i < loops; i++)
+		sink += oldRig.getFreq();
+	bench_end("Rig::getFreq", loops, sink);
+
+	bench_start();
+	for (i = 0; i < loops; i++)
+		sink += rig.getFreq().valueOr(0);
+	bench_end("RigHandle::getFreq", loops, sink);
+
+	/* error path, the Rig class allocates (and leaks) each exception */
+	bench_start();
+	for (i = 0; i < loops; i++) {
+		try {
+			sink += oldRig.getLevelI(RIG_LEVEL_SQLSTAT);
+		}
+		catch (const RigException &Ex) {
+			sink += Ex.errorno;
+		}
+	}
+	bench_end("Rig::getLevelI, unavailable", loops, sink);
+
+	bench_start();
+	for (i = 0; i < loops; i++) {
+		hamlib::Result<value_t> level = rig.getLevel(RIG_LEVEL_SQLSTAT);
+		sink += level ? level->i : level.error();
+	}
+	bench_end("RigHandle::getLevel, unavailable", loops, sink);
+
+	/* one thread polling several rigs */
+	std::vector<hamlib::AsyncRig *> rigs;
+	std::vector<std::future<hamlib::Result<freq_t> > > gets(nrigs);
+
+	for (n = 0; n < nrigs; n++) {
+		rigs.push_back(new hamlib::AsyncRig(RIG_MODEL_DUMMY));
+		rigs[n]->open().get();
+	}
+
+	bench_start();
+	for (i = 0; i < loops/100; i++) {
+		for (n = 0; n < nrigs; n++)
+			gets[n] = rigs[n]->getFreq();
+		for (n = 0; n < nrigs; n++)
+			sink += gets[n].get().valueOr(0);
+	}
+	bench_end("AsyncRig::getFreq, 4 rigs", loops/100*nrigs, sink);
+
+	for (n = 0; n < nrigs; n++)
+		delete rigs[n];
+
+	oldRig.close();
+	rig.close();
+
+	return 0;
+}
@@ -0,0 +1,468 @@
+/**
+ * \file hamlibpp.cc
+ * \brief Ham Radio Control Libraries C++ value based interface
+ * \author the Hamlib Group
+ * \date 2026
+ *
+ * Non-throwing, move-only handles, and their asynchronous variant.
+ */
+
+/*
+ *  Hamlib C++ bindings - value based and asynchronous API
+ *  Copyright (c) 2026 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <hamlib/rig.h>
+#include <hamlib/hamlibpp.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace hamlib {
+
+/* a NULL handle, as left by a failed init or a move, reports EINVAL */
+#define CHECK_HANDLE(h)	{ if (!(h)) return Status(-RIG_EINVAL); }
+#define GET_RESULT(T, h, call) { T _val = T(); \
+		if (!(h)) return Result<T>(_val, -RIG_EINVAL); \
+		int _retval = call; \
+		return Result<T>(_val, _retval); }
+
+
+RigHandle::RigHandle(rig_model_t rig_model)
+	: theRig(rig_init(rig_model))
+{
+}
+
+RigHandle::~RigHandle()
+{
+	if (theRig)
+		rig_cleanup(theRig);
+}
+
+RigHandle &RigHandle::operator=(RigHandle &&other)
+{
+	if (this != &other) {
+		if (theRig)
+			rig_cleanup(theRig);
+		theRig = other.release();
+	}
+	return *this;
+}
+
+Status RigHandle::open()
+{
+	CHECK_HANDLE(theRig);
+	return rig_open(theRig);
+}
+
+Status RigHandle::close()
+{
+	CHECK_HANDLE(theRig);
+	return rig_close(theRig);
+}
+
+Status RigHandle::setConf(token_t token, const char *val)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_conf(theRig, token, val);
+}
+
+Status RigHandle::setConf(const char *name, const char *val)
+{
+	token_t token;
+
+	CHECK_HANDLE(theRig);
+	token = rig_token_lookup(theRig, name);
+	if (token == RIG_CONF_END)
+		return -RIG_EINVAL;
+	return rig_set_conf(theRig, token, val);
+}
+
+Status RigHandle::setFreq(freq_t freq, vfo_t vfo)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_freq(theRig, vfo, freq);
+}
+
+Result<freq_t> RigHandle::getFreq(vfo_t vfo)
+{
+	GET_RESULT(freq_t, theRig, rig_get_freq(theRig, vfo, &_val));
+}
+
+Status RigHandle::setMode(rmode_t mode, pbwidth_t width, vfo_t vfo)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_mode(theRig, vfo, mode, width);
+}
+
+Result<Mode> RigHandle::getMode(vfo_t vfo)
+{
+	GET_RESULT(Mode, theRig, rig_get_mode(theRig, vfo, &_val.mode, &_val.width));
+}
+
+Status RigHandle::setVFO(vfo_t vfo)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_vfo(theRig, vfo);
+}
+
+Result<vfo_t> RigHandle::getVFO()
+{
+	GET_RESULT(vfo_t, theRig, rig_get_vfo(theRig, &_val));
+}
+
+Status RigHandle::setPTT(ptt_t ptt, vfo_t vfo)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_ptt(theRig, vfo, ptt);
+}
+
+Result<ptt_t> RigHandle::getPTT(vfo_t vfo)
+{
+	GET_RESULT(ptt_t, theRig, rig_get_ptt(theRig, vfo, &_val));
+}
+
+Result<dcd_t> RigHandle::getDCD(vfo_t vfo)
+{
+	GET_RESULT(dcd_t, theRig, rig_get_dcd(theRig, vfo, &_val));
+}
+
+Status RigHandle::setLevel(setting_t level, value_t val, vfo_t vfo)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_level(theRig, vfo, level, val);
+}
+
+Result<value_t> RigHandle::getLevel(setting_t level, vfo_t vfo)
+{
+	GET_RESULT(value_t, theRig, rig_get_level(theRig, vfo, level, &_val));
+}
+
+Status RigHandle::setFunc(setting_t func, bool status, vfo_t vfo)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_func(theRig, vfo, func, status ? 1 : 0);
+}
+
+Result<bool> RigHandle::getFunc(setting_t func, vfo_t vfo)
+{
+	int status = 0;
+	int retval;
+
+	if (!theRig)
+		return Result<bool>(false, -RIG_EINVAL);
+	retval = rig_get_func(theRig, vfo, func, &status);
+	return Result<bool>(status != 0, retval);
+}
+
+Status RigHandle::setParm(setting_t parm, value_t val)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_parm(theRig, parm, val);
+}
+
+Result<value_t> RigHandle::getParm(setting_t parm)
+{
+	GET_RESULT(value_t, theRig, rig_get_parm(theRig, parm, &_val));
+}
+
+Status RigHandle::setSplitFreq(freq_t tx_freq, vfo_t vfo)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_split_freq(theRig, vfo, tx_freq);
+}
+
+Result<freq_t> RigHandle::getSplitFreq(vfo_t vfo)
+{
+	GET_RESULT(freq_t, theRig, rig_get_split_freq(theRig, vfo, &_val));
+}
+
+Status RigHandle::setSplitMode(rmode_t mode, pbwidth_t width, vfo_t vfo)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_split_mode(theRig, vfo, mode, width);
+}
+
+Result<Mode> RigHandle::getSplitMode(vfo_t vfo)
+{
+	GET_RESULT(Mode, theRig, rig_get_split_mode(theRig, vfo, &_val.mode, &_val.width));
+}
+
+Status RigHandle::setSplitVFO(split_t split, vfo_t tx_vfo, vfo_t vfo)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_split_vfo(theRig, vfo, split, tx_vfo);
+}
+
+Result<SplitVFO> RigHandle::getSplitVFO(vfo_t vfo)
+{
+	GET_RESULT(SplitVFO, theRig, rig_get_split_vfo(theRig, vfo, &_val.split, &_val.txVfo));
+}
+
+Status RigHandle::setRit(shortfreq_t rit, vfo_t vfo)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_rit(theRig, vfo, rit);
+}
+
+Result<shortfreq_t> RigHandle::getRit(vfo_t vfo)
+{
+	GET_RESULT(shortfreq_t, theRig, rig_get_rit(theRig, vfo, &_val));
+}
+
+Status RigHandle::setXit(shortfreq_t xit, vfo_t vfo)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_xit(theRig, vfo, xit);
+}
+
+Result<shortfreq_t> RigHandle::getXit(vfo_t vfo)
+{
+	GET_RESULT(shortfreq_t, theRig, rig_get_xit(theRig, vfo, &_val));
+}
+
+Status RigHandle::setTs(shortfreq_t ts, vfo_t vfo)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_ts(theRig, vfo, ts);
+}
+
+Result<shortfreq_t> RigHandle::getTs(vfo_t vfo)
+{
+	GET_RESULT(shortfreq_t, theRig, rig_get_ts(theRig, vfo, &_val));
+}
+
+Status RigHandle::setMem(int ch, vfo_t vfo)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_mem(theRig, vfo, ch);
+}
+
+Result<int> RigHandle::getMem(vfo_t vfo)
+{
+	GET_RESULT(int, theRig, rig_get_mem(theRig, vfo, &_val));
+}
+
+Status RigHandle::VFOop(vfo_op_t op, vfo_t vfo)
+{
+	CHECK_HANDLE(theRig);
+	return rig_vfo_op(theRig, vfo, op);
+}
+
+Status RigHandle::setPowerStat(powerstat_t status)
+{
+	CHECK_HANDLE(theRig);
+	return rig_set_powerstat(theRig, status);
+}
+
+Result<powerstat_t> RigHandle::getPowerStat()
+{
+	GET_RESULT(powerstat_t, theRig, rig_get_powerstat(theRig, &_val));
+}
+
+Result<const char *> RigHandle::getInfo()
+{
+	const char *info;
+
+	if (!theRig)
+		return Result<const char *>(NULL, -RIG_EINVAL);
+	info = rig_get_info(theRig);
+	return Result<const char *>(info, info ? RIG_OK : -RIG_ENAVAIL);
+}
+
+
+RotHandle::RotHandle(rot_model_t rot_model)
+	: theRot(rot_init(rot_model))
+{
+}
+
+RotHandle::~RotHandle()
+{
+	if (theRot)
+		rot_cleanup(theRot);
+}
+
+RotHandle &RotHandle::operator=(RotHandle &&other)
+{
+	if (this != &other) {
+		if (theRot)
+			rot_cleanup(theRot);
+		theRot = other.release();
+	}
+	return *this;
+}
+
+Status RotHandle::open()
+{
+	CHECK_HANDLE(theRot);
+	return rot_open(theRot);
+}
+
+Status RotHandle::close()
+{
+	CHECK_HANDLE(theRot);
+	return rot_close(theRot);
+}
+
+Status RotHandle::setConf(token_t token, const char *val)
+{
+	CHECK_HANDLE(theRot);
+	return rot_set_conf(theRot, token, val);
+}
+
+Status RotHandle::setConf(const char *name, const char *val)
+{
+	token_t token;
+
+	CHECK_HANDLE(theRot);
+	token = rot_token_lookup(theRot, name);
+	if (token == RIG_CONF_END)
+		return -RIG_EINVAL;
+	return rot_set_conf(theRot, token, val);
+}
+
+Status RotHandle::setPosition(azimuth_t az, elevation_t el)
+{
+	CHECK_HANDLE(theRot);
+	return rot_set_position(theRot, az, el);
+}
+
+Result<Position> RotHandle::getPosition()
+{
+	GET_RESULT(Position, theRot, rot_get_position(theRot, &_val.az, &_val.el));
+}
+
+Status RotHandle::stop()
+{
+	CHECK_HANDLE(theRot);
+	return rot_stop(theRot);
+}
+
+Status RotHandle::park()
+{
+	CHECK_HANDLE(theRot);
+	return rot_park(theRot);
+}
+
+Status RotHandle::reset(rot_reset_t reset)
+{
+	CHECK_HANDLE(theRot);
+	return rot_reset(theRot, reset);
+}
+
+Status RotHandle::move(int direction, int speed)
+{
+	CHECK_HANDLE(theRot);
+	return rot_move(theRot, direction, speed);
+}
+
+
+struct Executor::Impl {
+	std::mutex lock;
+	std::condition_variable cond;
+	std::deque<std::function<void()> > jobs;
+	bool stopping;
+	std::thread worker;
+
+	Impl() : stopping(false), worker(&Impl::run, this) {}
+
+	void run() {
+		for (;;) {
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				while (jobs.empty() && !stopping)
+					cond.wait(guard);
+				if (jobs.empty())
+					return;
+				job = std::move(jobs.front());
+				jobs.pop_front();
+			}
+			job();
+		}
+	}
+};
+
+Executor::Executor()
+	: impl(new Impl)
+{
+}
+
+Executor::~Executor()
+{
+	{
+		std::lock_guard<std::mutex> guard(impl->lock);
+		impl->stopping = true;
+	}
+	impl->cond.notify_one();
+	impl->worker.join();
+	delete impl;
+}
+
+void Executor::post(std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> guard(impl->lock);
+		impl->jobs.push_back(std::move(job));
+	}
+	impl->cond.notify_one();
+}
+
+
+/* shortcuts, forwarding to the handle on the executor */
+#define ASYNC0(cls, R, f) std::future<R> Async##cls::f() \
+	{ return submit([](cls##Handle &h) { return h.f(); }); }
+#define ASYNC1(cls, R, f, t1) std::future<R> Async##cls::f(t1 a1) \
+	{ return submit([a1](cls##Handle &h) { return h.f(a1); }); }
+#define ASYNC2(cls, R, f, t1, t2) std::future<R> Async##cls::f(t1 a1, t2 a2) \
+	{ return submit([a1, a2](cls##Handle &h) { return h.f(a1, a2); }); }
+#define ASYNC3(cls, R, f, t1, t2, t3) std::future<R> Async##cls::f(t1 a1, t2 a2, t3 a3) \
+	{ return submit([a1, a2, a3](cls##Handle &h) { return h.f(a1, a2, a3); }); }
+
+ASYNC0(Rig, Status, open)
+ASYNC0(Rig, Status, close)
+ASYNC2(Rig, Status, setFreq, freq_t, vfo_t)
+ASYNC1(Rig, Result<freq_t>, getFreq, vfo_t)
+ASYNC3(Rig, Status, setMode, rmode_t, pbwidth_t, vfo_t)
+ASYNC1(Rig, Result<Mode>, getMode, vfo_t)
+ASYNC1(Rig, Status, setVFO, vfo_t)
+ASYNC0(Rig, Result<vfo_t>, getVFO)
+ASYNC2(Rig, Status, setPTT, ptt_t, vfo_t)
+ASYNC1(Rig, Result<ptt_t>, getPTT, vfo_t)
+ASYNC3(Rig, Status, setLevel, setting_t, value_t, vfo_t)
+ASYNC2(Rig, Result<value_t>, getLevel, setting_t, vfo_t)
+ASYNC3(Rig, Status, setFunc, setting_t, bool, vfo_t)
+ASYNC2(Rig, Result<bool>, getFunc, setting_t, vfo_t)
+ASYNC2(Rig, Status, setSplitFreq, freq_t, vfo_t)
+ASYNC1(Rig, Result<freq_t>, getSplitFreq, vfo_t)
+
+ASYNC0(Rot, Status, open)
+ASYNC0(Rot, Status, close)
+ASYNC2(Rot, Status, setPosition, azimuth_t, elevation_t)
+ASYNC0(Rot, Result<Position>, getPosition)
+ASYNC0(Rot, Status, stop)
+ASYNC0(Rot, Status, park)
+
+}	// namespace hamlib
@@ -0,0 +1,82 @@
+/*
+ * Hamlib C++ value based and asynchronous API test program
+ */
+
+#include <iostream>
+#include <vector>
+#include <hamlib/hamlibpp.h>
+
+static int errors;
+
+#define CHECK(cond) do { if (!(cond)) { \
+		std::cerr << __LINE__ << ": failed " #cond << std::endl; \
+		errors++; } } while (0)
+
+int main(int argc, char* argv[])
+{
+	const int nrigs = 4;
+	int i;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	/* synchronous handle */
+	hamlib::RigHandle rig(RIG_MODEL_DUMMY);
+	CHECK(rig);
+	CHECK(rig.open().ok());
+	CHECK(rig.setFreq(MHz(144)).ok());
+	hamlib::Result<freq_t> freq = rig.getFreq();
+	CHECK(freq.ok() && *freq == MHz(144));
+
+	/* error path, no exception */
+	hamlib::Result<value_t> level = rig.getLevel(RIG_LEVEL_SQLSTAT);
+	CHECK(!level && level.error() == -RIG_ENAVAIL);
+	CHECK(rig.setConf("no_such_token", "1").error() == -RIG_EINVAL);
+
+	/* move-only ownership */
+	hamlib::RigHandle other(std::move(rig));
+	CHECK(!rig && other);
+	CHECK(rig.getFreq().error() == -RIG_EINVAL);
+	CHECK(other.getFreq().valueOr(0) == MHz(144));
+	rig = std::move(other);
+	CHECK(rig && !other);
+	CHECK(rig.close().ok());
+
+	/* one thread driving several rigs */
+	std::vector<hamlib::AsyncRig *> rigs;
+	std::vector<std::future<hamlib::Status> > sets;
+	std::vector<std::future<hamlib::Result<freq_t> > > gets;
+
+	for (i = 0; i < nrigs; i++) {
+		rigs.push_back(new hamlib::AsyncRig(RIG_MODEL_DUMMY));
+		CHECK(*rigs[i]);
+		sets.push_back(rigs[i]->open());
+		sets.push_back(rigs[i]->setFreq(MHz(7) + i));
+		gets.push_back(rigs[i]->getFreq());
+		sets.push_back(rigs[i]->setMode(RIG_MODE_USB));
+	}
+	for (i = 0; i < nrigs; i++) {
+		hamlib::Result<freq_t> f = gets[i].get();
+		CHECK(f.ok() && f.value() == MHz(7) + i);
+		hamlib::Result<hamlib::Mode> m = rigs[i]->getMode().get();
+		CHECK(m.ok() && m->mode == RIG_MODE_USB);
+		CHECK(rigs[i]->submit([](hamlib::RigHandle &h) {
+					return h.getPowerStat(); }).get().ok());
+	}
+	for (i = 0; i < (int)sets.size(); i++)
+		CHECK(sets[i].get().ok());
+	for (i = 0; i < nrigs; i++)
+		delete rigs[i];
+
+	/* rotator */
+	hamlib::AsyncRot rot(ROT_MODEL_DUMMY);
+	CHECK(rot.open().get().ok());
+	CHECK(rot.setPosition(120, 30).get().ok());
+	hamlib::Result<hamlib::Position> pos = rot.getPosition().get();
+	CHECK(pos.ok());
+	CHECK(rot.close().get().ok());
+
+	if (errors)
+		std::cerr << errors << " errors" << std::endl;
+
+	return errors ? 1 : 0;
+}
@@ -30,6 +30,10 @@
 #include <unistd.h>  /* UNIX standard function definitions */
 #include <math.h>
 #include <time.h>
+#include <sys/time.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 
 #include "hamlib/rig.h"
 #include "serial.h"
@@ -37,11 +41,24 @@
 #include "tones.h"
 #include "idx_builtin.h"
 #include "register.h"
+#include "lock.h"
 
 #include "dummy.h"
 
 #define NB_CHAN 22		/* see caps->chan_list */
 
+/* jitter distributions of the load generator */
+#define DUMMY_DIST_UNIFORM	0
+#define DUMMY_DIST_NORMAL	1
+#define DUMMY_DIST_EXP		2
+
+/* tuning of the simulated events */
+#define DUMMY_EVENT_STEP	Hz(10)
+
+/* kind of operation, for the load generator */
+#define DUMMY_GET	0
+#define DUMMY_SET	1
+
 struct dummy_priv_data {
 		/* current vfo already in rig_state ? */
 		vfo_t curr_vfo;
@@ -61,6 +78,20 @@ struct dummy_priv_data {
 		struct ext_list *ext_parms;
 
         char *magic_conf;
+
+		/* load generator, see dummy_load() */
+		int latency[2];		/* ms, by DUMMY_GET/DUMMY_SET */
+		int jitter;		/* ms */
+		int jitter_dist;
+		float timeout_rate;	/* 0..1 */
+		float error_rate;	/* 0..1 */
+		float event_rate;	/* Hz */
+		struct timeval event_start;
+		unsigned long events;
+#ifdef HAVE_PTHREAD
+		pthread_t event_thread;	/* RIG_TRN_RIG, see dummy_set_trn() */
+		volatile int event_run;
+#endif
 };
 
 /* levels pertain to each VFO */
@@ -90,6 +121,27 @@ static const struct confparams dummy_cfg_params[] = {
 	{ TOK_CFG_MAGICCONF, "mcfg", "Magic conf", "Magic parameter, as an example",
 		"DX", RIG_CONF_STRING, { }
 	},
+	{ TOK_CFG_GETLATENCY, "get_latency", "Get latency", "Time taken by each get operation, in ms",
+		"0", RIG_CONF_NUMERIC, { .n = { 0, 10000, 1 } }
+	},
+	{ TOK_CFG_SETLATENCY, "set_latency", "Set latency", "Time taken by each set operation, in ms",
+		"0", RIG_CONF_NUMERIC, { .n = { 0, 10000, 1 } }
+	},
+	{ TOK_CFG_JITTER, "jitter", "Jitter", "Spread of the latency, in ms",
+		"0", RIG_CONF_NUMERIC, { .n = { 0, 10000, 1 } }
+	},
+	{ TOK_CFG_JITTERDIST, "jitter_dist", "Jitter distribution", "Distribution of the jitter",
+		"Uniform", RIG_CONF_COMBO, { .c = {{ "Uniform", "Normal", "Exponential", NULL }} }
+	},
+	{ TOK_CFG_TIMEOUTRATE, "timeout_rate", "Timeout rate", "Share of the operations timing out",
+		"0", RIG_CONF_NUMERIC, { .n = { 0, 1, .001 } }
+	},
+	{ TOK_CFG_ERRORRATE, "error_rate", "Error rate", "Share of the operations getting a garbled answer",
+		"0", RIG_CONF_NUMERIC, { .n = { 0, 1, .001 } }
+	},
+	{ TOK_CFG_EVENTRATE, "event_rate", "Event rate", "Tuning steps per second made on the rig itself",
+		"0", RIG_CONF_NUMERIC, { .n = { 0, 1000, .1 } }
+	},
 	{ RIG_CONF_END, NULL, }
 };
 
@@ -222,6 +274,12 @@ static int dummy_init(RIG *rig)
 
   priv->magic_conf = strdup("DX");
 
+  priv->latency[DUMMY_GET] = priv->latency[DUMMY_SET] = 0;
+  priv->jitter = 0;
+  priv->jitter_dist = DUMMY_DIST_UNIFORM;
+  priv->timeout_rate = priv->error_rate = priv->event_rate = 0;
+  priv->events = 0;
+
   return RIG_OK;
 }
 
@@ -275,6 +333,37 @@ static int dummy_set_conf(RIG *rig, token_t token, const char *val)
                 priv->magic_conf = strdup(val);
             }
 			break;
+		case TOK_CFG_GETLATENCY:
+			priv->latency[DUMMY_GET] = atoi(val);
+			break;
+		case TOK_CFG_SETLATENCY:
+			priv->latency[DUMMY_SET] = atoi(val);
+			break;
+		case TOK_CFG_JITTER:
+			priv->jitter = atoi(val);
+			break;
+		case TOK_CFG_JITTERDIST:
+			if (!strcmp(val, "Uniform"))
+				priv->jitter_dist = DUMMY_DIST_UNIFORM;
+			else if (!strcmp(val, "Normal"))
+				priv->jitter_dist = DUMMY_DIST_NORMAL;
+			else if (!strcmp(val, "Exponential"))
+				priv->jitter_dist = DUMMY_DIST_EXP;
+			else
+				return -RIG_EINVAL;
+			break;
+		case TOK_CFG_TIMEOUTRATE:
+			priv->timeout_rate = atof(val);
+			break;
+		case TOK_CFG_ERRORRATE:
+			priv->error_rate = atof(val);
+			break;
+		case TOK_CFG_EVENTRATE:
+			priv->event_rate = atof(val);
+			/* the events start over at the new rate */
+			gettimeofday(&priv->event_start, NULL);
+			priv->events = 0;
+			break;
 		default:
 			return -RIG_EINVAL;
 	}
@@ -291,17 +380,123 @@ static int dummy_get_conf(RIG *rig, token_t token, char *val)
 		case TOK_CFG_MAGICCONF:
 			strcpy(val, priv->magic_conf);
 			break;
+		case TOK_CFG_GETLATENCY:
+			sprintf(val, "%d", priv->latency[DUMMY_GET]);
+			break;
+		case TOK_CFG_SETLATENCY:
+			sprintf(val, "%d", priv->latency[DUMMY_SET]);
+			break;
+		case TOK_CFG_JITTER:
+			sprintf(val, "%d", priv->jitter);
+			break;
+		case TOK_CFG_JITTERDIST:
+			strcpy(val, priv->jitter_dist == DUMMY_DIST_NORMAL ? "Normal" :
+					priv->jitter_dist == DUMMY_DIST_EXP ? "Exponential" :
+					"Uniform");
+			break;
+		case TOK_CFG_TIMEOUTRATE:
+			sprintf(val, "%g", priv->timeout_rate);
+			break;
+		case TOK_CFG_ERRORRATE:
+			sprintf(val, "%g", priv->error_rate);
+			break;
+		case TOK_CFG_EVENTRATE:
+			sprintf(val, "%g", priv->event_rate);
+			break;
 		default:
 			return -RIG_EINVAL;
 	}
 	return RIG_OK;
 }
 
+/* uniform in ]0,1[ */
+static double dummy_random(void)
+{
+	return (rand() + 1.0) / (RAND_MAX + 2.0);
+}
+
+static double dummy_jitter(const struct dummy_priv_data *priv)
+{
+	switch (priv->jitter_dist) {
+		case DUMMY_DIST_NORMAL:
+			/* Box-Muller */
+			return priv->jitter * sqrt(-2 * log(dummy_random())) *
+				cos(2 * M_PI * dummy_random());
+		case DUMMY_DIST_EXP:
+			/* a long tail of slow answers */
+			return -priv->jitter * log(dummy_random());
+		default:
+			return priv->jitter * (2 * dummy_random() - 1);
+	}
+}
+
+/*
+ * Apply the tuning steps made on the rig itself since the last call,
+ * at the event rate. Returns 1 when the frequency changed.
+ * Assumes the handle is held.
+ */
+static int dummy_drift(struct dummy_priv_data *priv)
+{
+  struct timeval now;
+  unsigned long events;
+
+  if (priv->event_rate <= 0)
+    return 0;
+
+  gettimeofday(&now, NULL);
+  events = (unsigned long)(priv->event_rate *
+          ((now.tv_sec - priv->event_start.tv_sec) +
+           (now.tv_usec - priv->event_start.tv_usec) / 1e6));
+  if (events <= priv->events)
+    return 0;
+
+  priv->curr->freq += (events - priv->events) * DUMMY_EVENT_STEP;
+  priv->events = events;
+
+  return 1;
+}
+
+/*
+ * Load generator, run by the operations before they act: the tuning
+ * steps made on the rig itself since the last operation are applied,
+ * then the operation takes its latency, or the port timeout when it
+ * times out. The errors and timeouts are drawn at the configured rates.
+ */
+static int dummy_load(RIG *rig, int op)
+{
+  struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
+  double latency, draw;
+
+  dummy_drift(priv);
+
+  draw = dummy_random();
+  if (draw < priv->timeout_rate) {
+    usleep(rig->state.rigport.timeout * 1000);
+    return -RIG_ETIMEOUT;
+  }
+
+  latency = priv->latency[op];
+  if (priv->jitter)
+    latency += dummy_jitter(priv);
+  if (latency >= 1)
+    usleep((unsigned long)(latency * 1000));
+
+  if (draw < priv->timeout_rate + priv->error_rate)
+    return -RIG_EPROTO;
+
+  return RIG_OK;
+}
+
 static int dummy_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
   char fstr[20];
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   sprintf_freq(fstr, freq);
   rig_debug(RIG_DEBUG_VERBOSE,"%s called: %s %s\n", __FUNCTION__,
@@ -316,6 +511,11 @@ static int dummy_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE,"%s called: %s\n", __FUNCTION__, rig_strvfo(vfo));
 
@@ -330,6 +530,11 @@ static int dummy_set_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
   char buf[16];
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   sprintf_freq(buf, width);
   rig_debug(RIG_DEBUG_VERBOSE,"%s called: %s %s %s\n", __FUNCTION__,
@@ -346,6 +551,11 @@ static int dummy_get_mode(RIG *rig, vfo_t vfo, rmode_t *mode, pbwidth_t *width)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE,"%s called: %s\n", __FUNCTION__, rig_strvfo(vfo));
 
@@ -360,6 +570,11 @@ static int dummy_set_vfo(RIG *rig, vfo_t vfo)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE,"%s called: %s\n", __FUNCTION__, rig_strvfo(vfo));
 
@@ -386,6 +601,11 @@ static int dummy_set_vfo(RIG *rig, vfo_t vfo)
 static int dummy_get_vfo(RIG *rig, vfo_t *vfo)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   *vfo = priv->curr_vfo;
   rig_debug(RIG_DEBUG_VERBOSE,"%s called: %s\n", __FUNCTION__, rig_strvfo(*vfo));
@@ -397,6 +617,11 @@ static int dummy_get_vfo(RIG *rig, vfo_t *vfo)
 static int dummy_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
   priv->ptt = ptt;
@@ -408,6 +633,11 @@ static int dummy_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
 static int dummy_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
   *ptt = priv->ptt;
@@ -419,6 +649,11 @@ static int dummy_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 static int dummy_get_dcd(RIG *rig, vfo_t vfo, dcd_t *dcd)
 {
   static int twiddle = 0;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
   *dcd = twiddle++ & 1 ? RIG_DCD_ON : RIG_DCD_OFF;
@@ -431,6 +666,11 @@ static int dummy_set_rptr_shift(RIG *rig, vfo_t vfo, rptr_shift_t rptr_shift)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
   curr->rptr_shift = rptr_shift;
@@ -443,6 +683,11 @@ static int dummy_get_rptr_shift(RIG *rig, vfo_t vfo, rptr_shift_t *rptr_shift)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   *rptr_shift = curr->rptr_shift;
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
@@ -455,6 +700,11 @@ static int dummy_set_rptr_offs(RIG *rig, vfo_t vfo, shortfreq_t rptr_offs)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
   curr->rptr_offs = rptr_offs;
@@ -467,6 +717,11 @@ static int dummy_get_rptr_offs(RIG *rig, vfo_t vfo, shortfreq_t *rptr_offs)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   *rptr_offs = curr->rptr_offs;
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
@@ -479,6 +734,11 @@ static int dummy_set_ctcss_tone(RIG *rig, vfo_t vfo, tone_t tone)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
   curr->ctcss_tone = tone;
@@ -491,6 +751,11 @@ static int dummy_get_ctcss_tone(RIG *rig, vfo_t vfo, tone_t *tone)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   *tone = curr->ctcss_tone;
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
@@ -503,6 +768,11 @@ static int dummy_set_dcs_code(RIG *rig, vfo_t vfo, tone_t code)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
   curr->dcs_code = code;
@@ -515,6 +785,11 @@ static int dummy_get_dcs_code(RIG *rig, vfo_t vfo, tone_t *code)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   *code = curr->dcs_code;
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
@@ -527,6 +802,11 @@ static int dummy_set_ctcss_sql(RIG *rig, vfo_t vfo, tone_t tone)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
   curr->ctcss_sql = tone;
@@ -539,6 +819,11 @@ static int dummy_get_ctcss_sql(RIG *rig, vfo_t vfo, tone_t *tone)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   *tone = curr->ctcss_sql;
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
@@ -551,6 +836,11 @@ static int dummy_set_dcs_sql(RIG *rig, vfo_t vfo, unsigned int code)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
   curr->dcs_sql = code;
@@ -563,6 +853,11 @@ static int dummy_get_dcs_sql(RIG *rig, vfo_t vfo, unsigned int *code)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   *code = curr->dcs_sql;
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
@@ -576,6 +871,11 @@ static int dummy_set_split_freq(RIG *rig, vfo_t vfo, freq_t tx_freq)
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
   char fstr[20];
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   sprintf_freq(fstr, tx_freq);
   rig_debug(RIG_DEBUG_VERBOSE,"%s called: %s %s\n", __FUNCTION__,
@@ -590,6 +890,11 @@ static int dummy_get_split_freq(RIG *rig, vfo_t vfo, freq_t *tx_freq)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE,"%s called: %s\n", __FUNCTION__,rig_strvfo(vfo));
 
@@ -603,6 +908,11 @@ static int dummy_set_split_mode(RIG *rig, vfo_t vfo, rmode_t tx_mode, pbwidth_t
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
   char buf[16];
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   sprintf_freq(buf, tx_width);
   rig_debug(RIG_DEBUG_VERBOSE,"%s called: %s %s %s\n", __FUNCTION__,
@@ -618,6 +928,11 @@ static int dummy_get_split_mode(RIG *rig, vfo_t vfo, rmode_t *tx_mode, pbwidth_t
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE,"%s called: %s\n", __FUNCTION__, rig_strvfo(vfo));
 
@@ -631,6 +946,11 @@ static int dummy_set_split_vfo(RIG *rig, vfo_t vfo, split_t split, vfo_t tx_vfo)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
   curr->split = split;
@@ -643,6 +963,11 @@ static int dummy_get_split_vfo(RIG *rig, vfo_t vfo, split_t *split, vfo_t *tx_vf
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   *split = curr->split;
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
@@ -654,6 +979,11 @@ static int dummy_set_rit(RIG *rig, vfo_t vfo, shortfreq_t rit)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
   curr->rit = rit;
@@ -666,6 +996,11 @@ static int dummy_get_rit(RIG *rig, vfo_t vfo, shortfreq_t *rit)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   *rit = curr->rit;
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
@@ -678,6 +1013,11 @@ static int dummy_set_xit(RIG *rig, vfo_t vfo, shortfreq_t xit)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
   curr->xit = xit;
@@ -690,6 +1030,11 @@ static int dummy_get_xit(RIG *rig, vfo_t vfo, shortfreq_t *xit)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   *xit = curr->xit;
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
@@ -702,6 +1047,11 @@ static int dummy_set_ts(RIG *rig, vfo_t vfo, shortfreq_t ts)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
   curr->tuning_step = ts;
@@ -714,6 +1064,11 @@ static int dummy_get_ts(RIG *rig, vfo_t vfo, shortfreq_t *ts)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   *ts = curr->tuning_step;
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
@@ -726,6 +1081,11 @@ static int dummy_set_func(RIG *rig, vfo_t vfo, setting_t func, int status)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE,"%s called: %s %d\n",__FUNCTION__,
 				  rig_strfunc(func), status);
@@ -742,6 +1102,11 @@ static int dummy_get_func(RIG *rig, vfo_t vfo, setting_t func, int *status)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   *status = curr->funcs & func ? 1 : 0;
 
@@ -758,6 +1123,11 @@ static int dummy_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val)
   channel_t *curr = priv->curr;
   int idx;
   char lstr[32];
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   idx = rig_setting2idx(level);
   if (idx >= RIG_SETTING_MAX)
@@ -781,6 +1151,11 @@ static int dummy_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
   int idx;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   idx = rig_setting2idx(level);
 
@@ -817,6 +1192,11 @@ static int dummy_set_ext_level(RIG *rig, vfo_t vfo, token_t token, value_t val)
   char lstr[64];
   const struct confparams *cfp;
   struct ext_list *elp;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   cfp = rig_ext_lookup_tok(rig, token);
   if (!cfp)
@@ -870,6 +1250,11 @@ static int dummy_get_ext_level(RIG *rig, vfo_t vfo, token_t token, value_t *val)
   channel_t *curr = priv->curr;
   const struct confparams *cfp;
   struct ext_list *elp;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   cfp = rig_ext_lookup_tok(rig, token);
   if (!cfp)
@@ -901,6 +1286,11 @@ static int dummy_get_ext_level(RIG *rig, vfo_t vfo, token_t token, value_t *val)
 static int dummy_set_powerstat(RIG *rig, powerstat_t status)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
   priv->powerstat = status;
@@ -912,6 +1302,11 @@ static int dummy_set_powerstat(RIG *rig, powerstat_t status)
 static int dummy_get_powerstat(RIG *rig, powerstat_t *status)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   *status = priv->powerstat;
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
@@ -925,6 +1320,11 @@ static int dummy_set_parm(RIG *rig, setting_t parm, value_t val)
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   int idx;
   char pstr[32];
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   idx = rig_setting2idx(parm);
   if (idx >= RIG_SETTING_MAX)
@@ -946,6 +1346,11 @@ static int dummy_get_parm(RIG *rig, setting_t parm, value_t *val)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   int idx;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   idx = rig_setting2idx(parm);
   if (idx >= RIG_SETTING_MAX)
@@ -964,6 +1369,11 @@ static int dummy_set_ext_parm(RIG *rig, token_t token, value_t val)
   char lstr[64];
   const struct confparams *cfp;
   struct ext_list *epp;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   cfp = rig_ext_lookup_tok(rig, token);
   if (!cfp)
@@ -1015,6 +1425,11 @@ static int dummy_get_ext_parm(RIG *rig, token_t token, value_t *val)
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   const struct confparams *cfp;
   struct ext_list *epp;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   /* TODO: load value from priv->ext_parms */
 
@@ -1048,6 +1463,11 @@ static int dummy_set_ant(RIG *rig, vfo_t vfo, ant_t ant)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   curr->ant = ant;
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
@@ -1060,6 +1480,11 @@ static int dummy_get_ant(RIG *rig, vfo_t vfo, ant_t *ant)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
   *ant = curr->ant;
@@ -1082,6 +1507,11 @@ static int dummy_set_bank(RIG *rig, vfo_t vfo, int bank)
 static int dummy_set_mem(RIG *rig, vfo_t vfo, int ch)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
 
@@ -1101,6 +1531,11 @@ static int dummy_get_mem(RIG *rig, vfo_t vfo, int *ch)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   *ch = curr->channel_num;
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
@@ -1126,9 +1561,11 @@ static int dummy_vfo_op(RIG *rig, vfo_t vfo, vfo_op_t op)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
   channel_t *curr = priv->curr;
-  int ret;
-  freq_t freq;
-  shortfreq_t ts;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE,"%s called: %s\n",__FUNCTION__,
 				  rig_strvfop(op));
@@ -1231,19 +1668,12 @@ static int dummy_vfo_op(RIG *rig, vfo_t vfo, vfo_op_t op)
 	  case RIG_OP_BAND_DOWN:
 		return -RIG_ENIMPL;
 
+	/* on the state directly, the load of the op being already taken */
 	case RIG_OP_UP:
-		ret = dummy_get_freq(rig, vfo, &freq);
-		if (!ret) break;
-		ret = dummy_get_ts(rig, vfo, &ts);
-		if (!ret) break;
-		ret = dummy_set_freq(rig, vfo, freq+ts);	/* up */
+		curr->freq += curr->tuning_step;	/* up */
 		break;
 	case RIG_OP_DOWN:
-		ret = dummy_get_freq(rig, vfo, &freq);
-		if (!ret) break;
-		ret = dummy_get_ts(rig, vfo, &ts);
-		if (!ret) break;
-		ret = dummy_set_freq(rig, vfo, freq-ts);	/* down */
+		curr->freq -= curr->tuning_step;	/* down */
 		break;
 
 	default:
@@ -1256,6 +1686,11 @@ static int dummy_vfo_op(RIG *rig, vfo_t vfo, vfo_op_t op)
 static int dummy_set_channel(RIG *rig, const channel_t *chan)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_SET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
 
@@ -1292,6 +1727,11 @@ static int dummy_set_channel(RIG *rig, const channel_t *chan)
 static int dummy_get_channel(RIG *rig, channel_t *chan)
 {
   struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
+  int retval;
+
+  retval = dummy_load(rig, DUMMY_GET);
+  if (retval != RIG_OK)
+    return retval;
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
 
@@ -1328,19 +1768,74 @@ static int dummy_get_channel(RIG *rig, channel_t *chan)
 }
 
 
+#ifdef HAVE_PTHREAD
+/*
+ * In transceive mode, the tuning steps made on the rig itself are
+ * reported by freq_event as they happen, instead of being found by
+ * the next operation. Like the event thread of the frontend, it leaves
+ * a rig busy in another thread alone, the steps being reported on the
+ * next tick.
+ */
+static void *dummy_event_thread(void *arg)
+{
+  RIG *rig = (RIG *)arg;
+  struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
+  float rate;
+
+  while (priv->event_run) {
+    /* each step on its own up to 100 Hz, and a quick stop */
+    rate = priv->event_rate;
+    usleep(rate > 100 ? (unsigned long)(1e6 / rate) : 10000);
+
+    if (!hamlib_trylock(rig->state.lock))
+      continue;
+    if (priv->event_run && dummy_drift(priv)) {
+      rig->state.current_freq = priv->curr->freq;
+      if (rig->callbacks.freq_event)
+        rig->callbacks.freq_event(rig, priv->curr_vfo, priv->curr->freq,
+                rig->callbacks.freq_arg);
+    }
+    hamlib_unlock(rig->state.lock);
+  }
+
+  return NULL;
+}
+#endif
+
 static int dummy_set_trn(RIG *rig, int trn)
 {
+#ifdef HAVE_PTHREAD
+  struct dummy_priv_data *priv = (struct dummy_priv_data *)rig->state.priv;
+#endif
+
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
 
+#ifdef HAVE_PTHREAD
+  if (trn == RIG_TRN_RIG && !priv->event_run) {
+    priv->event_run = 1;
+    if (pthread_create(&priv->event_thread, NULL, dummy_event_thread, rig)) {
+      priv->event_run = 0;
+      return -RIG_EINTERNAL;
+    }
+  } else if (trn != RIG_TRN_RIG && priv->event_run) {
+    /* the thread never waits for the handle, held here */
+    priv->event_run = 0;
+    pthread_join(priv->event_thread, NULL);
+  }
+
   return RIG_OK;
+#else
+  return trn == RIG_TRN_RIG ? -RIG_ENAVAIL : RIG_OK;
+#endif
 }
 
 
 static int dummy_get_trn(RIG *rig, int *trn)
 {
-  *trn = RIG_TRN_OFF;
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
 
+  *trn = rig->state.transceive == RIG_TRN_RIG ? RIG_TRN_RIG : RIG_TRN_OFF;
+
   return RIG_OK;
 }
 
@@ -1480,7 +1975,7 @@ const struct rig_caps dummy_caps = {
 		 },
   .scan_ops = 	 DUMMY_SCAN,
   .vfo_ops = 	 DUMMY_VFO_OP,
-  .transceive =     RIG_TRN_OFF,
+  .transceive =     RIG_TRN_RIG,
   .attenuator =     { 10, 20, 30, RIG_DBLST_END, },
   .preamp = 		 { 10, RIG_DBLST_END, },
   .rx_range_list1 =  { {.start=kHz(150),.end=MHz(1500),.modes=DUMMY_MODES,
@@ -28,6 +28,15 @@
 /* backend conf */
 #define TOK_CFG_MAGICCONF  TOKEN_BACKEND(1)
 
+/* load generator conf */
+#define TOK_CFG_GETLATENCY  TOKEN_BACKEND(2)
+#define TOK_CFG_SETLATENCY  TOKEN_BACKEND(3)
+#define TOK_CFG_JITTER      TOKEN_BACKEND(4)
+#define TOK_CFG_JITTERDIST  TOKEN_BACKEND(5)
+#define TOK_CFG_TIMEOUTRATE TOKEN_BACKEND(6)
+#define TOK_CFG_ERRORRATE   TOKEN_BACKEND(7)
+#define TOK_CFG_EVENTRATE   TOKEN_BACKEND(8)
+
 
 /* ext_level's and ext_parm's tokens */
 #define TOK_EL_MAGICLEVEL  TOKEN_BACKEND(1)
@@ -30,8 +30,17 @@
 #include <math.h>
 #include <time.h>
 #include <errno.h>
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+#ifdef HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#elif HAVE_WS2TCPIP_H
+#include <ws2tcpip.h>
+#endif
 
 #include "hamlib/rig.h"
+#include "hamlib/rigshm.h"
 #include "iofunc.h"
 #include "misc.h"
 #include "num_stdio.h"
@@ -43,13 +52,39 @@
 
 #define CHKSCN1ARG(a) if ((a) != 1) return -RIG_EPROTO; else do {} while(0)
 
+#define TOK_MULTICAST TOKEN_BACKEND(1)
+
+/* a state older than 3 keyframe periods of rigctld is stale */
+#define MCAST_STALE_MS 3000
+
+struct netrigctl_priv_data {
+  int multicast;		/* read-only follower of rigctld multicast state */
+  int has_state;		/* at least one state datagram received */
+  struct rig_shm_snapshot state;	/* last state received */
+  struct timeval state_tv;	/* when it was received */
+};
+
+static const struct confparams netrigctl_cfg_params[] = {
+	{ TOK_MULTICAST, "multicast", "Multicast follower",
+		"Follow the state broadcast by rigctld --mcast-addr, read-only. "
+		"Rig pathname is then the multicast group, e.g. 239.255.45.32:4532",
+		"0", RIG_CONF_CHECKBUTTON, { }
+	},
+	{ RIG_CONF_END, NULL, }
+};
+
 /*
  * Helper function with protocol return code parsing
  */
 static int netrigctl_transaction(RIG *rig, char *cmd, int len, char *buf)
 {
+  struct netrigctl_priv_data *priv = (struct netrigctl_priv_data *)rig->state.priv;
   int ret;
 
+  /* a multicast follower cannot send commands */
+  if (priv->multicast)
+	return -RIG_ENAVAIL;
+
   ret = write_block(&rig->state.rigport, cmd, len);
   if (ret != RIG_OK)
 	return ret;
@@ -65,6 +100,127 @@ static int netrigctl_transaction(RIG *rig, char *cmd, int len, char *buf)
 }
 
 
+/*
+ * Whether the last state received is recent enough to be answered,
+ * rigctld sending a keyframe every second
+ */
+static int netrigctl_mcast_fresh(struct netrigctl_priv_data *priv)
+{
+  struct timeval now;
+
+  if (!priv->has_state)
+	return 0;
+  gettimeofday(&now, NULL);
+  return (now.tv_sec - priv->state_tv.tv_sec) * 1000 +
+	  (now.tv_usec - priv->state_tv.tv_usec) / 1000 < MCAST_STALE_MS;
+}
+
+/*
+ * Drain the state datagrams received so far, keeping the most recent one.
+ * Datagrams not newer than the state known, ie. reordered, are dropped,
+ * unless it is stale, eg. rigctld having been restarted.
+ * Until a fresh state is known, wait up to the port timeout for it.
+ */
+static int netrigctl_mcast_update(RIG *rig)
+{
+  struct netrigctl_priv_data *priv = (struct netrigctl_priv_data *)rig->state.priv;
+  hamlib_port_t *port = &rig->state.rigport;
+  struct rig_shm_snapshot state;
+  char buf[RIG_SHM_DGRAM_MAX];
+  struct timeval tv;
+  fd_set rfds;
+  int ret, fresh;
+
+  for (;;) {
+	fresh = netrigctl_mcast_fresh(priv);
+	tv.tv_sec = fresh ? 0 : port->timeout/1000;
+	tv.tv_usec = fresh ? 0 : (port->timeout%1000)*1000;
+	FD_ZERO(&rfds);
+	FD_SET(port->fd, &rfds);
+
+	ret = select(port->fd+1, &rfds, NULL, NULL, &tv);
+	if (ret < 0 && errno == EINTR)
+		continue;
+	if (ret < 0)
+		return -RIG_EIO;
+	if (ret == 0)
+		break;
+
+	ret = recv(port->fd, buf, sizeof(buf)-1, 0);
+	if (ret < 0)
+		return -RIG_EIO;
+	buf[ret] = '\0';
+
+	if (rig_shm_decode(buf, &state, NULL) != RIG_OK) {
+		rig_debug(RIG_DEBUG_WARN, "%s: ignoring datagram '%s'\n",
+				__FUNCTION__, buf);
+		continue;
+	}
+	if (fresh && state.serial <= priv->state.serial) {
+		rig_debug(RIG_DEBUG_TRACE, "%s: dropping datagram %lu, %lu known\n",
+				__FUNCTION__, state.serial, priv->state.serial);
+		continue;
+	}
+	priv->state = state;
+	priv->has_state = 1;
+	gettimeofday(&priv->state_tv, NULL);
+  }
+
+  return netrigctl_mcast_fresh(priv) ? RIG_OK : -RIG_ETIMEOUT;
+}
+
+static int netrigctl_init(RIG *rig)
+{
+  struct netrigctl_priv_data *priv;
+
+  priv = (struct netrigctl_priv_data *)calloc(1, sizeof(struct netrigctl_priv_data));
+  if (!priv)
+	return -RIG_ENOMEM;
+
+  rig->state.priv = (void *)priv;
+
+  return RIG_OK;
+}
+
+static int netrigctl_cleanup(RIG *rig)
+{
+  if (rig->state.priv)
+	free(rig->state.priv);
+  rig->state.priv = NULL;
+
+  return RIG_OK;
+}
+
+static int netrigctl_set_conf(RIG *rig, token_t token, const char *val)
+{
+  struct netrigctl_priv_data *priv = (struct netrigctl_priv_data *)rig->state.priv;
+
+  switch (token) {
+	case TOK_MULTICAST:
+		priv->multicast = atoi(val) != 0;
+		rig->state.rigport.type.rig = priv->multicast ?
+				RIG_PORT_UDP_NETWORK : RIG_PORT_NETWORK;
+		break;
+	default:
+		return -RIG_EINVAL;
+  }
+  return RIG_OK;
+}
+
+static int netrigctl_get_conf(RIG *rig, token_t token, char *val)
+{
+  struct netrigctl_priv_data *priv = (struct netrigctl_priv_data *)rig->state.priv;
+
+  switch (token) {
+	case TOK_MULTICAST:
+		sprintf(val, "%d", priv->multicast);
+		break;
+	default:
+		return -RIG_EINVAL;
+  }
+  return RIG_OK;
+}
+
 /*
  * mimics rpcrig_open() from rpcrig/rpcrig_backend.c
  */
@@ -72,12 +228,19 @@ static int netrigctl_open(RIG *rig)
 {
   int ret, len, i;
   struct rig_state *rs = &rig->state;
+  struct netrigctl_priv_data *priv = (struct netrigctl_priv_data *)rs->priv;
   int prot_ver;
   char cmd[CMD_MAX];
   char buf[BUF_MAX];
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
 
+  /* no capabilities to learn from the group, state will come by itself */
+  if (priv->multicast) {
+	priv->has_state = 0;
+	return RIG_OK;
+  }
+
 
   len = sprintf(cmd, "\\dump_state\n");
 
@@ -100,6 +263,11 @@ static int netrigctl_open(RIG *rig)
 
   rs->itu_region = atoi(buf);
 
+  /* the tables of the remote rig replace the caps ones */
+  ret = rig_copy_tables(rig);
+  if (ret != RIG_OK)
+	return ret;
+
   for (i=0; i<FRQRANGESIZ; i++) {
 	ret = read_string(&rig->state.rigport, buf, BUF_MAX, "\n", sizeof("\n"));
 	if (ret <= 0)
@@ -274,8 +442,13 @@ gran_t parm_gran[RIG_SETTING_MAX];    /*!< parm granularity */
 
 static int netrigctl_close(RIG *rig)
 {
+  struct netrigctl_priv_data *priv = (struct netrigctl_priv_data *)rig->state.priv;
+
   rig_debug(RIG_DEBUG_VERBOSE,"%s called\n", __FUNCTION__);
 
+  if (priv->multicast)
+	return RIG_OK;
+
   /* clean signoff, no read back */
   write_block(&rig->state.rigport, "q\n", 2);
 
@@ -301,12 +474,20 @@ static int netrigctl_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
 
 static int netrigctl_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
 {
+  struct netrigctl_priv_data *priv = (struct netrigctl_priv_data *)rig->state.priv;
   int ret, len;
   char cmd[CMD_MAX];
   char buf[BUF_MAX];
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
 
+  if (priv->multicast) {
+	ret = netrigctl_mcast_update(rig);
+	if (ret == RIG_OK)
+		*freq = priv->state.freq;
+	return ret;
+  }
+
   len = sprintf(cmd, "f\n");
 
   ret = netrigctl_transaction(rig, cmd, len, buf);
@@ -340,12 +521,22 @@ static int netrigctl_set_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width
 
 static int netrigctl_get_mode(RIG *rig, vfo_t vfo, rmode_t *mode, pbwidth_t *width)
 {
+  struct netrigctl_priv_data *priv = (struct netrigctl_priv_data *)rig->state.priv;
   int ret, len;
   char cmd[CMD_MAX];
   char buf[BUF_MAX];
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
 
+  if (priv->multicast) {
+	ret = netrigctl_mcast_update(rig);
+	if (ret == RIG_OK) {
+		*mode = priv->state.mode;
+		*width = priv->state.width;
+	}
+	return ret;
+  }
+
   len = sprintf(cmd, "m\n");
 
   ret = netrigctl_transaction(rig, cmd, len, buf);
@@ -385,12 +576,20 @@ static int netrigctl_set_vfo(RIG *rig, vfo_t vfo)
 
 static int netrigctl_get_vfo(RIG *rig, vfo_t *vfo)
 {
+  struct netrigctl_priv_data *priv = (struct netrigctl_priv_data *)rig->state.priv;
   int ret, len;
   char cmd[CMD_MAX];
   char buf[BUF_MAX];
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
 
+  if (priv->multicast) {
+	ret = netrigctl_mcast_update(rig);
+	if (ret == RIG_OK)
+		*vfo = priv->state.vfo;
+	return ret;
+  }
+
   len = sprintf(cmd, "v\n");
 
   ret = netrigctl_transaction(rig, cmd, len, buf);
@@ -424,12 +623,20 @@ static int netrigctl_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
 
 static int netrigctl_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 {
+  struct netrigctl_priv_data *priv = (struct netrigctl_priv_data *)rig->state.priv;
   int ret, len;
   char cmd[CMD_MAX];
   char buf[BUF_MAX];
 
   rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __FUNCTION__);
 
+  if (priv->multicast) {
+	ret = netrigctl_mcast_update(rig);
+	if (ret == RIG_OK)
+		*ptt = priv->state.ptt;
+	return ret;
+  }
+
   len = sprintf(cmd, "t\n");
 
   ret = netrigctl_transaction(rig, cmd, len, buf);
@@ -1327,7 +1534,7 @@ const struct rig_caps netrigctl_caps = {
   .rig_model =      RIG_MODEL_NETRIGCTL,
   .model_name =     "NET rigctl",
   .mfg_name =       "Hamlib",
-  .version =        "0.3",
+  .version =        "0.4",
   .copyright =      "LGPL",
   .status =         RIG_STATUS_BETA,
   .rig_type =       RIG_TYPE_OTHER,
@@ -1362,11 +1569,16 @@ const struct rig_caps netrigctl_caps = {
   .max_ifshift = 0,
   .priv =  NULL,
 
-  .rig_init =     NULL,
-  .rig_cleanup =  NULL,
+  .cfgparams =    netrigctl_cfg_params,
+
+  .rig_init =     netrigctl_init,
+  .rig_cleanup =  netrigctl_cleanup,
   .rig_open =     netrigctl_open,
   .rig_close =    netrigctl_close,
 
+  .set_conf =     netrigctl_set_conf,
+  .get_conf =     netrigctl_get_conf,
+
   .set_freq =     netrigctl_set_freq,
   .get_freq =     netrigctl_get_freq,
   .set_mode =     netrigctl_set_mode,
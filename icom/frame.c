@@ -258,6 +258,8 @@ int icom_transaction (RIG *rig, int cmd, int subcmd, const unsigned char *payloa
 		retval = icom_one_transaction (rig, cmd, subcmd, payload, payload_len, data, data_len);
 		if (retval == RIG_OK)
 			break;
+		if (retry > 0)
+			rig->state.rigport.stats.retries++;
 	} while (retry-- > 0);
 
 	return retval;
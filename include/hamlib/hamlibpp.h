@@ -0,0 +1,311 @@
+/*
+ *  Hamlib C++ bindings - value based and asynchronous API header
+ *  Copyright (c) 2026 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef _HAMLIBPP_H
+#define _HAMLIBPP_H 1
+
+/*
+ * Unlike Rig and Rotator of rigclass.h/rotclass.h, this API does not
+ * throw: every call returns a Result, holding either the value or the
+ * -RIG_E* status, so that error paths (polling an unavailable level..)
+ * cost no allocation. It requires C++11.
+ *
+ * RigHandle and RotHandle own the RIG/ROT, and are move-only.
+ * AsyncRig and AsyncRot run the calls on a worker thread of their
+ * own, returning std::future's, so that a single thread can drive
+ * many rigs. The calls to one rig are executed in submission order.
+ */
+
+#include <hamlib/rig.h>
+#include <hamlib/rotator.h>
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <utility>
+
+
+namespace hamlib {
+
+template <typename T>
+class Result {
+private:
+  T val;
+  int status;
+
+public:
+  Result(const T &v) : val(v), status(RIG_OK) {}
+  Result(const T &v, int err) : val(v), status(err) {}
+
+  bool ok() const { return status == RIG_OK; }
+  explicit operator bool() const { return ok(); }
+  int error() const { return status; }
+  const char *message() const { return rigerror(status); }
+
+  // undefined unless ok()
+  const T &value() const { return val; }
+  const T &operator*() const { return val; }
+  const T *operator->() const { return &val; }
+  T valueOr(const T &def) const { return ok() ? val : def; }
+};
+
+template <>
+class Result<void> {
+private:
+  int status;
+
+public:
+  Result(int err = RIG_OK) : status(err) {}
+
+  bool ok() const { return status == RIG_OK; }
+  explicit operator bool() const { return ok(); }
+  int error() const { return status; }
+  const char *message() const { return rigerror(status); }
+};
+
+typedef Result<void> Status;
+
+struct Mode {
+  rmode_t mode;
+  pbwidth_t width;
+};
+
+struct SplitVFO {
+  split_t split;
+  vfo_t txVfo;
+};
+
+struct Position {
+  azimuth_t az;
+  elevation_t el;
+};
+
+
+class BACKEND_IMPEXP RigHandle {
+private:
+  RIG *theRig;
+
+public:
+  explicit RigHandle(rig_model_t rig_model);
+  // take ownership of a RIG from rig_init()
+  explicit RigHandle(RIG *rig = NULL) : theRig(rig) {}
+  ~RigHandle();
+
+  RigHandle(RigHandle &&other) : theRig(other.release()) {}
+  RigHandle &operator=(RigHandle &&other);
+  RigHandle(const RigHandle &) = delete;
+  RigHandle &operator=(const RigHandle &) = delete;
+
+  RIG *get() const { return theRig; }
+  RIG *release() { RIG *r = theRig; theRig = NULL; return r; }
+  explicit operator bool() const { return theRig != NULL; }
+  const struct rig_caps *caps() const { return theRig ? theRig->caps : NULL; }
+
+  Status open();
+  Status close();
+
+  Status setConf(token_t token, const char *val);
+  Status setConf(const char *name, const char *val);
+
+  Status setFreq(freq_t freq, vfo_t vfo = RIG_VFO_CURR);
+  Result<freq_t> getFreq(vfo_t vfo = RIG_VFO_CURR);
+  Status setMode(rmode_t mode, pbwidth_t width = RIG_PASSBAND_NORMAL, vfo_t vfo = RIG_VFO_CURR);
+  Result<Mode> getMode(vfo_t vfo = RIG_VFO_CURR);
+  Status setVFO(vfo_t vfo);
+  Result<vfo_t> getVFO();
+
+  Status setPTT(ptt_t ptt, vfo_t vfo = RIG_VFO_CURR);
+  Result<ptt_t> getPTT(vfo_t vfo = RIG_VFO_CURR);
+  Result<dcd_t> getDCD(vfo_t vfo = RIG_VFO_CURR);
+
+  Status setLevel(setting_t level, value_t val, vfo_t vfo = RIG_VFO_CURR);
+  Result<value_t> getLevel(setting_t level, vfo_t vfo = RIG_VFO_CURR);
+  Status setFunc(setting_t func, bool status, vfo_t vfo = RIG_VFO_CURR);
+  Result<bool> getFunc(setting_t func, vfo_t vfo = RIG_VFO_CURR);
+  Status setParm(setting_t parm, value_t val);
+  Result<value_t> getParm(setting_t parm);
+
+  Status setSplitFreq(freq_t tx_freq, vfo_t vfo = RIG_VFO_CURR);
+  Result<freq_t> getSplitFreq(vfo_t vfo = RIG_VFO_CURR);
+  Status setSplitMode(rmode_t mode, pbwidth_t width = RIG_PASSBAND_NORMAL, vfo_t vfo = RIG_VFO_CURR);
+  Result<Mode> getSplitMode(vfo_t vfo = RIG_VFO_CURR);
+  Status setSplitVFO(split_t split, vfo_t tx_vfo, vfo_t vfo = RIG_VFO_CURR);
+  Result<SplitVFO> getSplitVFO(vfo_t vfo = RIG_VFO_CURR);
+
+  Status setRit(shortfreq_t rit, vfo_t vfo = RIG_VFO_CURR);
+  Result<shortfreq_t> getRit(vfo_t vfo = RIG_VFO_CURR);
+  Status setXit(shortfreq_t xit, vfo_t vfo = RIG_VFO_CURR);
+  Result<shortfreq_t> getXit(vfo_t vfo = RIG_VFO_CURR);
+  Status setTs(shortfreq_t ts, vfo_t vfo = RIG_VFO_CURR);
+  Result<shortfreq_t> getTs(vfo_t vfo = RIG_VFO_CURR);
+
+  Status setMem(int ch, vfo_t vfo = RIG_VFO_CURR);
+  Result<int> getMem(vfo_t vfo = RIG_VFO_CURR);
+  Status VFOop(vfo_op_t op, vfo_t vfo = RIG_VFO_CURR);
+  Status setPowerStat(powerstat_t status);
+  Result<powerstat_t> getPowerStat();
+
+  Result<const char *> getInfo();
+};
+
+
+class BACKEND_IMPEXP RotHandle {
+private:
+  ROT *theRot;
+
+public:
+  explicit RotHandle(rot_model_t rot_model);
+  // take ownership of a ROT from rot_init()
+  explicit RotHandle(ROT *rot = NULL) : theRot(rot) {}
+  ~RotHandle();
+
+  RotHandle(RotHandle &&other) : theRot(other.release()) {}
+  RotHandle &operator=(RotHandle &&other);
+  RotHandle(const RotHandle &) = delete;
+  RotHandle &operator=(const RotHandle &) = delete;
+
+  ROT *get() const { return theRot; }
+  ROT *release() { ROT *r = theRot; theRot = NULL; return r; }
+  explicit operator bool() const { return theRot != NULL; }
+  const struct rot_caps *caps() const { return theRot ? theRot->caps : NULL; }
+
+  Status open();
+  Status close();
+
+  Status setConf(token_t token, const char *val);
+  Status setConf(const char *name, const char *val);
+
+  Status setPosition(azimuth_t az, elevation_t el);
+  Result<Position> getPosition();
+  Status stop();
+  Status park();
+  Status reset(rot_reset_t reset);
+  Status move(int direction, int speed);
+};
+
+
+/*
+ * A single worker thread, executing the submitted jobs in order.
+ * The destructor runs the jobs still queued, then joins the thread.
+ */
+class BACKEND_IMPEXP Executor {
+private:
+  struct Impl;
+  Impl *impl;
+
+  void post(std::function<void()> job);
+
+public:
+  Executor();
+  ~Executor();
+  Executor(const Executor &) = delete;
+  Executor &operator=(const Executor &) = delete;
+
+  template <typename F>
+  auto submit(F f) -> std::future<decltype(f())> {
+    typedef decltype(f()) R;
+    std::shared_ptr<std::packaged_task<R()> > task =
+        std::make_shared<std::packaged_task<R()> >(std::move(f));
+    std::future<R> fut = task->get_future();
+    post([task]() { (*task)(); });
+    return fut;
+  }
+};
+
+
+/*
+ * Handle plus its executor, any handle call can be dispatched with
+ * submit(), the usual ones have a shortcut.
+ *
+ *	hamlib::AsyncRig rig(RIG_MODEL_DUMMY);
+ *	rig.open().get();
+ *	std::future<hamlib::Result<freq_t> > f = rig.getFreq();
+ *	...
+ *	if (f.get()) ...
+ */
+class BACKEND_IMPEXP AsyncRig {
+private:
+  RigHandle handle;
+  Executor executor;
+
+public:
+  explicit AsyncRig(rig_model_t rig_model) : handle(rig_model) {}
+  explicit AsyncRig(RigHandle &&h) : handle(std::move(h)) {}
+
+  explicit operator bool() const { return bool(handle); }
+  // not to be used while calls are pending
+  RigHandle &sync() { return handle; }
+
+  template <typename F>
+  auto submit(F f) -> std::future<decltype(f(handle))> {
+    RigHandle *h = &handle;
+    return executor.submit([h, f]() { return f(*h); });
+  }
+
+  std::future<Status> open();
+  std::future<Status> close();
+  std::future<Status> setFreq(freq_t freq, vfo_t vfo = RIG_VFO_CURR);
+  std::future<Result<freq_t> > getFreq(vfo_t vfo = RIG_VFO_CURR);
+  std::future<Status> setMode(rmode_t mode, pbwidth_t width = RIG_PASSBAND_NORMAL, vfo_t vfo = RIG_VFO_CURR);
+  std::future<Result<Mode> > getMode(vfo_t vfo = RIG_VFO_CURR);
+  std::future<Status> setVFO(vfo_t vfo);
+  std::future<Result<vfo_t> > getVFO();
+  std::future<Status> setPTT(ptt_t ptt, vfo_t vfo = RIG_VFO_CURR);
+  std::future<Result<ptt_t> > getPTT(vfo_t vfo = RIG_VFO_CURR);
+  std::future<Status> setLevel(setting_t level, value_t val, vfo_t vfo = RIG_VFO_CURR);
+  std::future<Result<value_t> > getLevel(setting_t level, vfo_t vfo = RIG_VFO_CURR);
+  std::future<Status> setFunc(setting_t func, bool status, vfo_t vfo = RIG_VFO_CURR);
+  std::future<Result<bool> > getFunc(setting_t func, vfo_t vfo = RIG_VFO_CURR);
+  std::future<Status> setSplitFreq(freq_t tx_freq, vfo_t vfo = RIG_VFO_CURR);
+  std::future<Result<freq_t> > getSplitFreq(vfo_t vfo = RIG_VFO_CURR);
+};
+
+
+class BACKEND_IMPEXP AsyncRot {
+private:
+  RotHandle handle;
+  Executor executor;
+
+public:
+  explicit AsyncRot(rot_model_t rot_model) : handle(rot_model) {}
+  explicit AsyncRot(RotHandle &&h) : handle(std::move(h)) {}
+
+  explicit operator bool() const { return bool(handle); }
+  // not to be used while calls are pending
+  RotHandle &sync() { return handle; }
+
+  template <typename F>
+  auto submit(F f) -> std::future<decltype(f(handle))> {
+    RotHandle *h = &handle;
+    return executor.submit([h, f]() { return f(*h); });
+  }
+
+  std::future<Status> open();
+  std::future<Status> close();
+  std::future<Status> setPosition(azimuth_t az, elevation_t el);
+  std::future<Result<Position> > getPosition();
+  std::future<Status> stop();
+  std::future<Status> park();
+};
+
+}	// namespace hamlib
+
+#endif	// _HAMLIBPP_H
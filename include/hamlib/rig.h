@@ -196,6 +196,21 @@ enum serial_handshake_e {
 };
 
 
+/**
+ * \brief I/O trace mode of a port
+ *
+ * The bytes written and read on the port can be recorded, with their
+ * timing, into a trace file. Replaying that file later serves the
+ * recorded replies back to the backend, without any device.
+ */
+enum rig_trace_mode_e {
+  RIG_TRACE_NONE = 0,		/*!< No trace */
+  RIG_TRACE_RECORD,		/*!< Record the I/O into the trace file */
+  RIG_TRACE_REPLAY,		/*!< Replay the trace file, as fast as possible */
+  RIG_TRACE_REPLAY_REALTIME	/*!< Replay the trace file, at recorded speed */
+};
+
+
 /**
  * \brief Serial control state
  */
@@ -1097,6 +1112,32 @@ typedef struct cal_table cal_table_t;
 typedef int (*chan_cb_t) (RIG *, channel_t**, int, const chan_t*, rig_ptr_t);
 typedef int (*confval_cb_t) (RIG *, const struct confparams *, value_t *, rig_ptr_t);
 
+/** \brief Fields of a rig_snapshot_t */
+#define RIG_SNAPSHOT_VFO	(1<<0)	/*!< \c vfo read */
+#define RIG_SNAPSHOT_FREQ	(1<<1)	/*!< \c freq read */
+#define RIG_SNAPSHOT_MODE	(1<<2)	/*!< \c mode and \c width read */
+#define RIG_SNAPSHOT_PTT	(1<<3)	/*!< \c ptt read */
+#define RIG_SNAPSHOT_SPLIT	(1<<4)	/*!< \c split and \c tx_vfo read */
+#define RIG_SNAPSHOT_ALL	0x1f
+
+/**
+ * \brief State of the rig read at once, see rig_get_snapshot()
+ *
+ * Only the fields flagged in \a fields were read, the rig
+ * being unable to tell the others.
+ */
+typedef struct {
+  int fields;			/*!< RIG_SNAPSHOT_* read, ORed */
+  vfo_t vfo;			/*!< Current VFO */
+  freq_t freq;			/*!< Frequency */
+  rmode_t mode;			/*!< Mode */
+  pbwidth_t width;		/*!< Passband width */
+  ptt_t ptt;			/*!< PTT status */
+  split_t split;		/*!< Split status */
+  vfo_t tx_vfo;			/*!< Transmit VFO, when split */
+  struct { int tv_sec,tv_usec; } date;	/*!< When read */
+} rig_snapshot_t;
+
 /**
  * \brief Rig data structure.
  *
@@ -1318,8 +1359,42 @@ struct rig_caps {
 
   const char *clone_combo_set;	/*!< String describing key combination to enter load cloning mode */
   const char *clone_combo_get;	/*!< String describing key combination to enter save cloning mode */
+
+  int (*get_levels) (RIG * rig, vfo_t vfo, setting_t * levels, value_t * vals);	/*!< Reads several levels at once, clearing the bits of those read, see rig_get_levels() */
+  int (*get_funcs) (RIG * rig, vfo_t vfo, setting_t * funcs, setting_t * status);	/*!< Reads several functions at once, clearing the bits of those read, see rig_get_funcs() */
+  int (*get_snapshot) (RIG * rig, vfo_t vfo, rig_snapshot_t * snap);	/*!< Reads the state of the rig at once, flagging the fields read, see rig_get_snapshot() */
 };
 
+/** \brief Number of buckets of the port latency histograms */
+#define RIG_PORT_STATS_HIST 16
+
+/**
+ * \brief Port I/O statistics
+ *
+ * Collected by the I/O primitives since the port was opened.
+ * The latency histograms have log2 buckets in milli-seconds:
+ * bucket 0 counts latencies under 1 mS, bucket i counts latencies
+ * in [2^(i-1), 2^i) mS, and the last bucket counts everything longer.
+ * Latencies are measured from the end of the preceding write, for
+ * the reads answering a command only: the other reads, like those
+ * draining what the rig sent on its own, are not in the histograms.
+ *
+ * \sa rig_get_port_stats(), rot_get_port_stats()
+ */
+typedef struct {
+  unsigned long writes;		/*!< Number of blocks written */
+  unsigned long reads;		/*!< Number of blocks/strings read */
+  unsigned long transactions;	/*!< Number of reads answering a write */
+  unsigned long bytes_out;	/*!< Bytes written */
+  unsigned long bytes_in;	/*!< Bytes read */
+  unsigned long timeouts;	/*!< Number of reads which timed out */
+  unsigned long errors;		/*!< Number of I/O errors */
+  unsigned long retries;	/*!< Number of retries issued by the backend */
+  unsigned long long write_us;	/*!< Time spent writing, delays included, in uS */
+  unsigned long ttfb[RIG_PORT_STATS_HIST];	/*!< Time to first byte histogram */
+  unsigned long complete[RIG_PORT_STATS_HIST];	/*!< Time to complete histogram */
+} port_stats_t;
+
 /**
  * \brief Port definition
  *
@@ -1367,6 +1442,14 @@ typedef struct {
         char *product;     /*!< Product (opt.) */
 	} usb;			/*!< USB attributes */
   } parm;			/*!< Port parameter union */
+
+  port_stats_t stats;		/*!< I/O statistics */
+  struct { int tv_sec,tv_usec; } stats_write_date;	/*!< hamlib internal use */
+  int timeout_adaptive;		/*!< Shorten timeout to observed response times, timeout being the ceiling */
+  int timeout_backoff;		/*!< hamlib internal use */
+  char trace_file[FILPATHLEN];	/*!< I/O trace file, see trace_mode */
+  enum rig_trace_mode_e trace_mode;	/*!< Record or replay the I/O */
+  rig_ptr_t trace;		/*!< hamlib internal use */
 } hamlib_port_t;
 
 #if !defined(__APPLE__) || !defined(__cplusplus)
@@ -1374,12 +1457,20 @@ typedef hamlib_port_t port_t;
 #endif
 
 
+struct rig_tables;
+struct rig_index;
+
 /**
  * \brief Rig state containing live data and customized fields.
  *
  * This struct contains live data, as well as a copy of capability fields
  * that may be updated (ie. customized)
  *
+ * The range, tuning step, filter, preamp and attenuator tables point to
+ * the caps ones, shared by all the handles of a model, until
+ * rig_copy_tables() gives the handle its own copy, to be customized.
+ * rig_open() indexes them for the lookups, see rig_index_tables().
+ *
  * It is fine to move fields around, as this kind of struct should
  * not be initialized like caps are.
  */
@@ -1392,14 +1483,15 @@ struct rig_state {
   hamlib_port_t dcdport;	/*!< DCD port (internal use). */
 
   double vfo_comp;	/*!< VFO compensation in PPM, 0.0 to disable */
+  int range_check;	/*!< Reject the frequencies and modes out of the tables without asking the rig */
 
   int itu_region;	/*!< ITU region to select among freq_range_t */
-  freq_range_t rx_range_list[FRQRANGESIZ];	/*!< Receive frequency range list */
-  freq_range_t tx_range_list[FRQRANGESIZ];	/*!< Transmit frequency range list */
+  freq_range_t *rx_range_list;	/*!< Receive frequency range list, FRQRANGESIZ long */
+  freq_range_t *tx_range_list;	/*!< Transmit frequency range list, FRQRANGESIZ long */
 
-  struct tuning_step_list tuning_steps[TSLSTSIZ];	/*!< Tuning step list */
+  struct tuning_step_list *tuning_steps;	/*!< Tuning step list, TSLSTSIZ long */
 
-  struct filter_list filters[FLTLSTSIZ];	/*!< Mode/filter table, at -6dB */
+  struct filter_list *filters;	/*!< Mode/filter table, at -6dB, FLTLSTSIZ long */
 
   cal_table_t str_cal;				/*!< S-meter calibration table */
 
@@ -1411,8 +1503,11 @@ struct rig_state {
 
   ann_t announces;		/*!< Announces bit field list */
 
-  int preamp[MAXDBLSTSIZ];	/*!< Preamp list in dB, 0 terminated */
-  int attenuator[MAXDBLSTSIZ];	/*!< Preamp list in dB, 0 terminated */
+  int *preamp;			/*!< Preamp list in dB, 0 terminated, MAXDBLSTSIZ long */
+  int *attenuator;		/*!< Preamp list in dB, 0 terminated, MAXDBLSTSIZ long */
+
+  struct rig_tables *tables;	/*!< Own copy of the tables above, NULL while shared with caps */
+  struct rig_index *index;	/*!< Lookup index of the tables above, NULL while closed */
 
   setting_t has_get_func;	/*!< List of get functions */
   setting_t has_set_func;	/*!< List of set functions */
@@ -1443,6 +1538,8 @@ struct rig_state {
   pbwidth_t current_width;	/*!< Passband width currently set */
   vfo_t tx_vfo;		/*!< Tx VFO currently set */
   int mode_list;		/*!< Complete list of modes for this rig */
+  ptt_t current_ptt;	/*!< PTT status last set or read */
+  rig_ptr_t lock;	/*!< Internal use by the frontend, serializes the calls on this handle */
 
 };
 
@@ -1455,6 +1552,82 @@ typedef int (*vfo_cb_t) (RIG *, vfo_t, rig_ptr_t);
 typedef int (*ptt_cb_t) (RIG *, vfo_t, ptt_t, rig_ptr_t);
 typedef int (*dcd_cb_t) (RIG *, vfo_t, dcd_t, rig_ptr_t);
 typedef int (*pltune_cb_t) (RIG *, vfo_t, freq_t *, rmode_t *, pbwidth_t *, rig_ptr_t);
+typedef int (*scan_hit_cb_t) (RIG *, vfo_t, int, freq_t, value_t, rig_ptr_t);
+typedef int (*scan_stats_cb_t) (RIG *, int, int, double, rig_ptr_t);
+
+/**
+ * \brief Stop condition of the software scan
+ */
+enum rig_sw_scan_stop_e {
+  RIG_SW_SCAN_STOP_NONE = 0,	/*!< No stop, every channel is a hit, with level sampled if any */
+  RIG_SW_SCAN_STOP_DCD,		/*!< Squelch open, see rig_get_dcd() */
+  RIG_SW_SCAN_STOP_LEVEL	/*!< Level at or above threshold, eg. RIG_LEVEL_STRENGTH */
+};
+
+/**
+ * \brief Software scan, see rig_sw_scan()
+ *
+ * The callbacks get the index of the channel in the list, its frequency
+ * and the value sampled (level, or dcd_t in .i). The scan goes on as long
+ * as they return RIG_OK. hit_cb is called on each hit, stats_cb after
+ * each pass, with the pass number, the hits and the channels per second
+ * of that pass.
+ */
+struct rig_sw_scan {
+  vfo_t vfo;			/*!< VFO to scan with, RIG_VFO_MEM usually for memory channels */
+  const freq_t *freqs;		/*!< Frequencies to scan, or NULL */
+  const int *channels;		/*!< Memory channels to scan, when freqs is NULL */
+  int count;			/*!< Number of frequencies or channels */
+  int passes;			/*!< Number of passes over the list, 0 for no limit, until a callback stops it */
+  enum rig_sw_scan_stop_e stop;	/*!< Stop condition */
+  setting_t level;		/*!< Level sampled, RIG_LEVEL_NONE for none */
+  value_t threshold;		/*!< Level threshold, for RIG_SW_SCAN_STOP_LEVEL */
+  int dwell;			/*!< Settling delay in mS, between tuning and sampling */
+  int hold;			/*!< Max time in mS to stay on a hit, while the condition holds */
+  scan_hit_cb_t hit_cb;		/*!< Called on each hit, may be NULL */
+  scan_stats_cb_t stats_cb;	/*!< Called after each pass, may be NULL */
+  rig_ptr_t arg;		/*!< Passed to the callbacks */
+};
+
+/**
+ * \brief Measurement of a sweep, see rig_sweep()
+ */
+struct rig_sweep_point {
+  int idx;			/*!< Index of the point in the sweep */
+  freq_t freq;			/*!< Frequency measured at, 0 when not tuned */
+  float azimuth;		/*!< Azimuth of the rotator, rig_sweep_rot() only */
+  float elevation;		/*!< Elevation of the rotator, rig_sweep_rot() only */
+  value_t val;			/*!< Level, averaged over the samples once settled */
+  int settle;			/*!< Time in mS between tuning and the first sample */
+  int settled;			/*!< Level settled within settle_max, 0 if it did not */
+};
+
+typedef int (*sweep_point_cb_t) (RIG *, const struct rig_sweep_point *, rig_ptr_t);
+
+/**
+ * \brief Frequency sweep, see rig_sweep()
+ *
+ * After tuning, the level is read every few mS from \a settle_min on,
+ * until two successive readings are within \a settle_tol, or
+ * \a settle_max has elapsed. With \a ptt, the readings must also differ
+ * by more than \a settle_tol from the level read before keying.
+ * With \a settle_max at 0, it is read once, \a settle_min after tuning.
+ */
+struct rig_sweep {
+  vfo_t vfo;			/*!< VFO to sweep with */
+  freq_t start;			/*!< First frequency, 0 to measure at the current frequency */
+  freq_t stop;			/*!< Last frequency */
+  freq_t step;			/*!< Frequency step, 0 for a single point */
+  rmode_t mode;			/*!< Mode to sweep in, RIG_MODE_NONE to keep the current one */
+  setting_t level;		/*!< Level measured, eg. RIG_LEVEL_SWR or RIG_LEVEL_STRENGTH */
+  int ptt;			/*!< Transmit during each measurement, eg. for RIG_LEVEL_SWR */
+  int settle_min;		/*!< Min time in mS between tuning and the first reading */
+  int settle_max;		/*!< Max time in mS for the level to settle, 0 to read once */
+  float settle_tol;		/*!< Max difference between two readings of a settled level */
+  int samples;			/*!< Readings averaged once settled, 1 if 0 */
+  sweep_point_cb_t point_cb;	/*!< Called on each point, may be NULL */
+  rig_ptr_t arg;		/*!< Passed to the callback */
+};
 
 /**
  * \brief Callback functions and args for rig event.
@@ -1569,6 +1742,7 @@ extern HAMLIB_EXPORT(shortfreq_t) rig_get_resolution HAMLIB_PARAMS((RIG *rig, rm
 
 extern HAMLIB_EXPORT(int) rig_set_level HAMLIB_PARAMS((RIG *rig, vfo_t vfo, setting_t level, value_t val));
 extern HAMLIB_EXPORT(int) rig_get_level HAMLIB_PARAMS((RIG *rig, vfo_t vfo, setting_t level, value_t *val));
+extern HAMLIB_EXPORT(int) rig_get_levels HAMLIB_PARAMS((RIG *rig, vfo_t vfo, setting_t levels, value_t *vals));
 
 #define rig_get_strength(r,v,s) rig_get_level((r),(v),RIG_LEVEL_STRENGTH, (value_t*)(s))
 
@@ -1604,6 +1778,8 @@ extern HAMLIB_EXPORT(token_t) rig_token_lookup HAMLIB_PARAMS((RIG *rig, const ch
 
 extern HAMLIB_EXPORT(int) rig_close HAMLIB_PARAMS((RIG *rig));
 extern HAMLIB_EXPORT(int) rig_cleanup HAMLIB_PARAMS((RIG *rig));
+extern HAMLIB_EXPORT(int) rig_copy_tables HAMLIB_PARAMS((RIG *rig));
+extern HAMLIB_EXPORT(int) rig_index_tables HAMLIB_PARAMS((RIG *rig));
 
 extern HAMLIB_EXPORT(int) rig_set_ant HAMLIB_PARAMS((RIG *rig, vfo_t vfo, ant_t ant));	/* antenna */
 extern HAMLIB_EXPORT(int) rig_get_ant HAMLIB_PARAMS((RIG *rig, vfo_t vfo, ant_t *ant));
@@ -1619,6 +1795,7 @@ extern HAMLIB_EXPORT(setting_t) rig_has_set_func HAMLIB_PARAMS((RIG *rig, settin
 
 extern HAMLIB_EXPORT(int) rig_set_func HAMLIB_PARAMS((RIG *rig, vfo_t vfo, setting_t func, int status));
 extern HAMLIB_EXPORT(int) rig_get_func HAMLIB_PARAMS((RIG *rig, vfo_t vfo, setting_t func, int *status));
+extern HAMLIB_EXPORT(int) rig_get_funcs HAMLIB_PARAMS((RIG *rig, vfo_t vfo, setting_t funcs, setting_t *status));
 
 extern HAMLIB_EXPORT(int) rig_send_dtmf HAMLIB_PARAMS((RIG *rig, vfo_t vfo, const char *digits));
 extern HAMLIB_EXPORT(int) rig_recv_dtmf HAMLIB_PARAMS((RIG *rig, vfo_t vfo, char *digits, int *length));
@@ -1630,6 +1807,8 @@ extern HAMLIB_EXPORT(int) rig_get_mem HAMLIB_PARAMS((RIG *rig, vfo_t vfo, int *c
 extern HAMLIB_EXPORT(int) rig_vfo_op HAMLIB_PARAMS((RIG *rig, vfo_t vfo, vfo_op_t op));
 extern HAMLIB_EXPORT(vfo_op_t) rig_has_vfo_op HAMLIB_PARAMS((RIG *rig, vfo_op_t op));
 extern HAMLIB_EXPORT(int) rig_scan HAMLIB_PARAMS((RIG *rig, vfo_t vfo, scan_t scan, int ch));
+extern HAMLIB_EXPORT(int) rig_sw_scan HAMLIB_PARAMS((RIG *rig, const struct rig_sw_scan *scan));
+extern HAMLIB_EXPORT(int) rig_sweep HAMLIB_PARAMS((RIG *rig, const struct rig_sweep *sweep));
 extern HAMLIB_EXPORT(scan_t) rig_has_scan HAMLIB_PARAMS((RIG *rig, scan_t scan));
 
 extern HAMLIB_EXPORT(int) rig_set_channel HAMLIB_PARAMS((RIG *rig, const channel_t *chan));	/* mem */
@@ -1658,6 +1837,9 @@ extern HAMLIB_EXPORT(int) rig_set_dcd_callback HAMLIB_PARAMS((RIG *, dcd_cb_t, r
 extern HAMLIB_EXPORT(int) rig_set_pltune_callback HAMLIB_PARAMS((RIG *, pltune_cb_t, rig_ptr_t));
 
 extern HAMLIB_EXPORT(const char *) rig_get_info HAMLIB_PARAMS((RIG *rig));
+extern HAMLIB_EXPORT(int) rig_get_port_stats HAMLIB_PARAMS((RIG *rig, port_stats_t *stats));
+extern HAMLIB_EXPORT(int) rig_write_wait HAMLIB_PARAMS((RIG *rig));
+extern HAMLIB_EXPORT(int) rig_get_snapshot HAMLIB_PARAMS((RIG *rig, vfo_t vfo, rig_snapshot_t *snap));
 
 extern HAMLIB_EXPORT(const struct rig_caps *) rig_get_caps HAMLIB_PARAMS((rig_model_t rig_model));
 extern HAMLIB_EXPORT(const freq_range_t *) rig_get_range HAMLIB_PARAMS((const freq_range_t range_list[], freq_t freq, rmode_t mode));
@@ -1692,6 +1874,7 @@ extern HAMLIB_EXPORT(int) rig_load_all_backends HAMLIB_PARAMS((void));
 typedef int (*rig_probe_func_t)(const hamlib_port_t *, rig_model_t, rig_ptr_t);
 extern HAMLIB_EXPORT(int) rig_probe_all HAMLIB_PARAMS((hamlib_port_t *p, rig_probe_func_t, rig_ptr_t));
 extern HAMLIB_EXPORT(rig_model_t) rig_probe HAMLIB_PARAMS((hamlib_port_t *p));
+extern HAMLIB_EXPORT(int) rig_probe_ports HAMLIB_PARAMS((hamlib_port_t ports[], int n, rig_probe_func_t, rig_ptr_t));
 
 
 /* Misc calls */
@@ -0,0 +1,89 @@
+/*
+ *  Hamlib Interface - shared memory rig state publication
+ *  Copyright (c) 2026 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef _RIGSHM_H
+#define _RIGSHM_H 1
+
+#include <hamlib/rig.h>
+
+/**
+ * \addtogroup rig
+ * @{
+ */
+
+/*! \file rigshm.h
+ *  \brief Hamlib shared memory rig state.
+ *
+ *  A publisher (typically rigctld) maps a file and keeps the current
+ *  rig state in it, protected by a sequence lock. Local readers map
+ *  the same file read-only and get a consistent snapshot without any
+ *  socket, system call or lock.
+ *
+ *  The same snapshot can be encoded as a text datagram, e.g. for
+ *  multicast broadcast by rigctld.
+ */
+
+__BEGIN_DECLS
+
+/** \brief Default segment file used by rigctld */
+#define RIG_SHM_DEFAULT_PATH "/dev/shm/hamlib-rigctld"
+
+/** \brief Leading token of state datagrams */
+#define RIG_SHM_DGRAM_MAGIC "HSTATE1"
+/** \brief Maximum length of an encoded state datagram */
+#define RIG_SHM_DGRAM_MAX 160
+
+/**
+ * \brief Rig state as published in the shared memory segment
+ */
+struct rig_shm_snapshot {
+  rig_model_t rig_model;	/*!< Rig model of the publisher */
+  vfo_t vfo;			/*!< Current VFO */
+  freq_t freq;			/*!< Frequency of current VFO */
+  rmode_t mode;			/*!< Mode of current VFO */
+  pbwidth_t width;		/*!< Passband width of current VFO */
+  ptt_t ptt;			/*!< PTT status */
+  vfo_t tx_vfo;			/*!< Split transmit VFO */
+  unsigned long serial;		/*!< Publication counter, 0 when never published */
+  long tv_sec;			/*!< Date of publication, seconds */
+  long tv_usec;			/*!< Date of publication, micro-seconds */
+};
+
+/** \brief Shared memory segment handle, opaque */
+typedef struct rig_shm rig_shm_t;
+
+extern HAMLIB_EXPORT(rig_shm_t *) rig_shm_create HAMLIB_PARAMS((const char *path, rig_model_t rig_model));
+extern HAMLIB_EXPORT(rig_shm_t *) rig_shm_attach HAMLIB_PARAMS((const char *path));
+extern HAMLIB_EXPORT(int) rig_shm_close HAMLIB_PARAMS((rig_shm_t *shm));
+
+extern HAMLIB_EXPORT(int) rig_shm_publish HAMLIB_PARAMS((rig_shm_t *shm, const struct rig_shm_snapshot *snap));
+extern HAMLIB_EXPORT(int) rig_shm_publish_rig HAMLIB_PARAMS((rig_shm_t *shm, RIG *rig));
+extern HAMLIB_EXPORT(int) rig_shm_read HAMLIB_PARAMS((const rig_shm_t *shm, struct rig_shm_snapshot *snap));
+extern HAMLIB_EXPORT(int) rig_shm_snapshot_rig HAMLIB_PARAMS((RIG *rig, struct rig_shm_snapshot *snap));
+
+extern HAMLIB_EXPORT(int) rig_shm_encode HAMLIB_PARAMS((char *buf, int len, const struct rig_shm_snapshot *snap, int keyframe));
+extern HAMLIB_EXPORT(int) rig_shm_decode HAMLIB_PARAMS((const char *buf, struct rig_shm_snapshot *snap, int *keyframe));
+
+__END_DECLS
+
+#endif /* _RIGSHM_H */
+
+/*! @} */
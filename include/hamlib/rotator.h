@@ -270,6 +270,8 @@ struct rot_state {
   azimuth_t max_az;            /*!< Upper limit for azimuth (overridable). */
   elevation_t min_el;          /*!< Lower limit for elevation (overridable). */
   elevation_t max_el;          /*!< Upper limit for elevation (overridable). */
+  int pos_interval;            /*!< Min delay in mS between two positions sent, 0 to send each one (overridable). */
+  float pos_deadband;          /*!< Positions closer than that to the previous one are dropped, in degrees (overridable). */
 
 	/*
 	 * non overridable fields, internal use
@@ -279,10 +281,27 @@ struct rot_state {
   int comm_state;	      /*!< Comm port state, opened/closed. */
   rig_ptr_t priv;             /*!< Pointer to private rotator state data. */
   rig_ptr_t obj;              /*!< Internal use by hamlib++ for event handling. */
+  rig_ptr_t lock;             /*!< Internal use by the frontend, serializes the calls on this handle. */
+  rig_ptr_t pace;             /*!< Internal use by the frontend, coalescing of the positions set. */
 
   /* etc... */
 };
 
+/**
+ * \brief Statistics of the positions set, see rot_get_pos_stats()
+ *
+ * With pos_interval or pos_deadband set, rot_set_position() returns
+ * without waiting for the rotator. The position is sent by the frontend,
+ * unless replaced by a later one first, or too close to the previous one.
+ */
+typedef struct {
+  unsigned long requests;	/*!< Calls to rot_set_position() */
+  unsigned long sent;		/*!< Positions sent to the rotator */
+  unsigned long coalesced;	/*!< Positions replaced by a later one before being sent */
+  unsigned long dropped;	/*!< Positions within pos_deadband of the previous one */
+  unsigned long errors;		/*!< Positions the rotator failed to take */
+} rot_pos_stats_t;
+
 /**
  * Rotator structure
  * \struct rot
@@ -300,6 +319,21 @@ struct rot {
 	struct rot_state state;     /*!< Rotator state. */
 };
 
+/**
+ * \brief Rotator synchronized sweep, see rig_sweep_rot()
+ *
+ * With \a az_step at 0, the rotator turns from \a az_start to \a az_stop
+ * in one go, measured on the fly. Otherwise it stops at each step.
+ */
+struct rot_sweep {
+  azimuth_t az_start;		/*!< First azimuth */
+  azimuth_t az_stop;		/*!< Last azimuth */
+  azimuth_t az_step;		/*!< Azimuth step, 0 for a continuous rotation */
+  elevation_t elevation;	/*!< Elevation kept during the sweep */
+  float tolerance;		/*!< Position reached within, in degrees, 1 if 0 */
+  int timeout;			/*!< Max time in mS without the rotator moving, 60000 if 0 */
+};
+
 /* --------------- API function prototypes -----------------*/
 
 extern HAMLIB_EXPORT(ROT *) rot_init HAMLIB_PARAMS((rot_model_t rot_model));
@@ -320,6 +354,10 @@ extern HAMLIB_EXPORT(int) rot_park HAMLIB_PARAMS((ROT *rot));
 extern HAMLIB_EXPORT(int) rot_reset HAMLIB_PARAMS((ROT *rot, rot_reset_t reset));
 extern HAMLIB_EXPORT(int) rot_move HAMLIB_PARAMS((ROT *rot, int direction, int speed));
 extern HAMLIB_EXPORT(const char*) rot_get_info HAMLIB_PARAMS((ROT *rot));
+extern HAMLIB_EXPORT(int) rot_get_port_stats HAMLIB_PARAMS((ROT *rot, port_stats_t *stats));
+extern HAMLIB_EXPORT(int) rot_get_pos_stats HAMLIB_PARAMS((ROT *rot, rot_pos_stats_t *stats));
+
+extern HAMLIB_EXPORT(int) rig_sweep_rot HAMLIB_PARAMS((RIG *rig, ROT *rot, const struct rig_sweep *sweep, const struct rot_sweep *rsweep));
 
 extern HAMLIB_EXPORT(int) rot_register HAMLIB_PARAMS((const struct rot_caps *caps));
 extern HAMLIB_EXPORT(int) rot_unregister HAMLIB_PARAMS((rot_model_t rot_model));
@@ -218,6 +218,7 @@ const struct rig_caps k3_caps = {
 	.get_ext_level =	k3_get_ext_level,
 	.vfo_op =		kenwood_vfo_op,
 	.set_trn =		kenwood_set_trn,
+	.decode_event =		kenwood_decode_event,
 	.get_trn =		kenwood_get_trn,
 	.set_powerstat =	kenwood_set_powerstat,
 	.get_powerstat =	kenwood_get_powerstat,
@@ -34,6 +34,7 @@
 #include "hamlib/rig.h"
 #include "serial.h"
 #include "misc.h"
+#include "numcodec.h"
 #include "register.h"
 #include "cal.h"
 
@@ -164,6 +165,190 @@ const struct confparams kenwood_cfg_params[] = {
 };
 
 
+/*
+ * kenwood_ai_frame
+ *  Decodes an Auto-Information frame, without its terminator: the
+ *  state kept by the frontend is updated, then the callbacks fired.
+ *  Unknown frames are ignored.
+ */
+static void kenwood_ai_frame(RIG *rig, const char *frame)
+{
+	struct rig_state *rs = &rig->state;
+	struct kenwood_priv_data *priv = rs->priv;
+	struct kenwood_priv_caps *caps = kenwood_caps(rig);
+	size_t len = strlen(frame);
+	unsigned long long f;
+	vfo_t vfo;
+	rmode_t mode;
+	pbwidth_t width;
+	ptt_t ptt;
+
+	rig_debug(RIG_DEBUG_TRACE, "%s: %s\n", __func__, frame);
+
+	if (len == 13 && frame[0] == 'F' && (frame[1] == 'A' || frame[1] == 'B')) {
+		if (num_from_dec(frame + 2, 11, &f) != RIG_OK)
+			return;
+		vfo = frame[1] == 'A' ? RIG_VFO_A : RIG_VFO_B;
+		if (vfo == rs->current_vfo)
+			rs->current_freq = f;
+		if (rig->callbacks.freq_event)
+			rig->callbacks.freq_event(rig, vfo, f,
+						rig->callbacks.freq_arg);
+
+	} else if (len == 3 && frame[0] == 'M' && frame[1] == 'D') {
+		mode = kenwood2rmode(frame[2] - '0', caps->mode_table);
+		width = rig_passband_normal(rig, mode);
+		rs->current_mode = mode;
+		rs->current_width = width;
+		if (rig->callbacks.mode_event)
+			rig->callbacks.mode_event(rig, RIG_VFO_CURR, mode, width,
+						rig->callbacks.mode_arg);
+
+	} else if (len == 3 && frame[0] == 'F' && frame[1] == 'R') {
+		switch (frame[2]) {
+		case '0': vfo = RIG_VFO_A; break;
+		case '1': vfo = RIG_VFO_B; break;
+		case '2': vfo = RIG_VFO_MEM; break;
+		default: return;
+		}
+		rs->current_vfo = vfo;
+		if (rig->callbacks.vfo_event)
+			rig->callbacks.vfo_event(rig, vfo, rig->callbacks.vfo_arg);
+
+	} else if (len >= 2 && (!strncmp(frame, "TX", 2) || !strncmp(frame, "RX", 2))) {
+		ptt = frame[0] == 'T' ? RIG_PTT_ON : RIG_PTT_OFF;
+		rs->current_ptt = ptt;
+		if (rig->callbacks.ptt_event)
+			rig->callbacks.ptt_event(rig, RIG_VFO_CURR, ptt,
+						rig->callbacks.ptt_arg);
+
+	} else if (len + 1 == caps->if_len && frame[0] == 'I' && frame[1] == 'F') {
+		/* the whole status, only the changes are reported */
+		switch (frame[30]) {
+		case '0': vfo = RIG_VFO_A; break;
+		case '1': vfo = RIG_VFO_B; break;
+		case '2': vfo = RIG_VFO_MEM; break;
+		default: vfo = rs->current_vfo; break;
+		}
+		if (vfo != rs->current_vfo) {
+			rs->current_vfo = vfo;
+			if (rig->callbacks.vfo_event)
+				rig->callbacks.vfo_event(rig, vfo,
+						rig->callbacks.vfo_arg);
+		}
+
+		if (num_from_dec(frame + 2, 11, &f) == RIG_OK &&
+				(freq_t)f != rs->current_freq) {
+			rs->current_freq = f;
+			if (rig->callbacks.freq_event)
+				rig->callbacks.freq_event(rig, vfo, f,
+						rig->callbacks.freq_arg);
+		}
+
+		mode = kenwood2rmode(frame[29] - '0', caps->mode_table);
+		if (mode != rs->current_mode) {
+			width = rig_passband_normal(rig, mode);
+			rs->current_mode = mode;
+			rs->current_width = width;
+			if (rig->callbacks.mode_event)
+				rig->callbacks.mode_event(rig, vfo, mode, width,
+						rig->callbacks.mode_arg);
+		}
+
+		ptt = frame[28] == '0' ? RIG_PTT_OFF : RIG_PTT_ON;
+		if (ptt != rs->current_ptt) {
+			rs->current_ptt = ptt;
+			if (rig->callbacks.ptt_event)
+				rig->callbacks.ptt_event(rig, vfo, ptt,
+						rig->callbacks.ptt_arg);
+		}
+
+		if (frame[32] == '0' || frame[32] == '1')
+			priv->split = frame[32] == '1' ? RIG_SPLIT_ON : RIG_SPLIT_OFF;
+
+	} else {
+		rig_debug(RIG_DEBUG_VERBOSE, "%s: unsupported frame '%s'\n",
+				__func__, frame);
+	}
+}
+
+/*
+ * An AI frame read while waiting for a reply, decoded once the
+ * transaction is over, so that the callbacks may talk to the rig.
+ * The oldest frame goes when the queue is full.
+ */
+static void kenwood_ai_queue(RIG *rig, const char *frame)
+{
+	struct kenwood_priv_data *priv = rig->state.priv;
+
+	if (priv->ai_count == KENWOOD_AI_QUEUE) {
+		rig_debug(RIG_DEBUG_WARN, "%s: AI frame '%s' lost\n", __func__,
+				priv->ai_frames[0]);
+		memmove(priv->ai_frames[0], priv->ai_frames[1],
+				(KENWOOD_AI_QUEUE - 1) * KENWOOD_MAX_BUF_LEN);
+		priv->ai_count--;
+	}
+
+	strncpy(priv->ai_frames[priv->ai_count], frame, KENWOOD_MAX_BUF_LEN - 1);
+	priv->ai_frames[priv->ai_count][KENWOOD_MAX_BUF_LEN - 1] = '\0';
+	priv->ai_count++;
+}
+
+static void kenwood_ai_flush(RIG *rig)
+{
+	struct kenwood_priv_data *priv = rig->state.priv;
+	char frames[KENWOOD_AI_QUEUE][KENWOOD_MAX_BUF_LEN];
+	int i, count = priv->ai_count;
+
+	if (count == 0)
+		return;
+
+	/* the callbacks may queue more */
+	memcpy(frames, priv->ai_frames, sizeof(frames));
+	priv->ai_count = 0;
+
+	for (i = 0; i < count; i++)
+		kenwood_ai_frame(rig, frames[i]);
+}
+
+/*
+ * kenwood_decode_event is called by sa_sigio, when some asynchronous
+ * data has been received from the rig in AI mode. The frames which
+ * came along are decoded at once.
+ */
+int kenwood_decode_event(RIG *rig)
+{
+	rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+	if (!rig)
+		return -RIG_EINVAL;
+
+	struct kenwood_priv_caps *caps = kenwood_caps(rig);
+	struct rig_state *rs = &rig->state;
+	char buf[KENWOOD_MAX_BUF_LEN];
+	char cmdtrm[2];
+	int timeout = rs->rigport.timeout;
+	int i, retval = RIG_OK;
+
+	cmdtrm[0] = caps->cmdtrm;
+	cmdtrm[1] = '\0';
+
+	for (i = 0; i < KENWOOD_AI_SKIP; i++) {
+		retval = read_string(&rs->rigport, buf, sizeof(buf), cmdtrm, 1);
+		if (retval <= 0 || buf[retval - 1] != caps->cmdtrm)
+			break;
+
+		buf[retval - 1] = '\0';
+		kenwood_ai_frame(rig, buf);
+		rs->rigport.timeout = KENWOOD_AI_TIMEOUT;
+	}
+	rs->rigport.timeout = timeout;
+
+	/* a timeout after the first frame is the normal end */
+	return i > 0 || retval >= 0 ? RIG_OK : retval;
+}
+
+
 /**
  * kenwood_transaction
  * Assumes rig!=NULL rig->state!=NULL rig->caps!=NULL
@@ -198,6 +383,8 @@ int kenwood_transaction(RIG *rig, const char *cmdstr, int cmd_len,
 	int retval;
 	char cmdtrm[2];  /* Default Command/Reply termination char */
 	int retry_read = 0;
+	int ai_skip = 0;
+	size_t size = *datasize;
 
 	rs = &rig->state;
 	rs->hold_decode = 1;
@@ -209,7 +396,12 @@ int kenwood_transaction(RIG *rig, const char *cmdstr, int cmd_len,
 
 transaction_write:
 
-	serial_flush(&rs->rigport);
+	if (retry_read > 0)
+		rs->rigport.stats.retries++;
+
+	/* in AI mode, what is pending are AI frames, read below */
+	if (rs->transceive != RIG_TRN_RIG)
+		serial_flush(&rs->rigport);
 
 	if (cmdstr) {
 
@@ -243,6 +435,10 @@ transaction_write:
 		return RIG_OK;  /* don't want a reply */
 	}
 
+transaction_read:
+
+	/* the whole buffer again, after a retry or an AI frame */
+	*datasize = size;
 	memset(data,0,*datasize);
 	retval = read_string(&rs->rigport, data, *datasize, cmdtrm, strlen(cmdtrm));
 	if (retval < 0) {
@@ -307,10 +503,14 @@ transaction_write:
 	 */
 	if (cmdstr && (data[0] != cmdstr[0] || data[1] != cmdstr[1])) {
 		/*
-		 * TODO: When RIG_TRN is enabled, we can pass the string
-		 * to the decoder for callback. That way we don't ignore
-		 * any commands.
+		 * In AI mode, a frame sent by the rig on its own,
+		 * kept for the decoder while the reply is read again.
 		 */
+		if (rs->transceive == RIG_TRN_RIG && ai_skip++ < KENWOOD_AI_SKIP) {
+			kenwood_ai_queue(rig, data);
+			goto transaction_read;
+		}
+
 		rig_debug(RIG_DEBUG_ERR, "%s: wrong reply %c%c for command %c%c\n",
 			__func__, data[0], data[1], cmdstr[0], cmdstr[1]);
 
@@ -326,6 +526,7 @@ transaction_write:
 transaction_quit:
 
 	rs->hold_decode = 0;
+	kenwood_ai_flush(rig);
 	return retval;
 }
 
@@ -764,7 +965,15 @@ int kenwood_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
 		rig_debug(RIG_DEBUG_ERR, "%s: unsupported VFO %d\n", __func__, vfo);
 		return -RIG_EINVAL;
 	}
-	sprintf(freqbuf, "F%c%011ld", vfo_letter, (long)freq);
+	/* the field has no sign */
+	if (freq < 0) {
+		rig_debug(RIG_DEBUG_ERR, "%s: negative freq %"PRIfreq"\n",
+				__func__, freq);
+		return -RIG_EINVAL;
+	}
+	freqbuf[0] = 'F';
+	freqbuf[1] = vfo_letter;
+	num_to_dec(freqbuf+2, (unsigned long long)freq, 11);
 
 	return kenwood_simple_cmd(rig, freqbuf);
 }
@@ -777,16 +986,17 @@ int kenwood_get_freq_if(RIG *rig, vfo_t vfo, freq_t *freq)
 		return -RIG_EINVAL;
 
 	struct kenwood_priv_data *priv = rig->state.priv;
-	char freqbuf[50];
+	unsigned long long f;
 	int retval;
 
 	retval = kenwood_get_if(rig);
 	if (retval != RIG_OK)
 		return retval;
 
-	memcpy(freqbuf, priv->info, 15);
-	freqbuf[14] = '\0';
-	sscanf(freqbuf + 2, "%"SCNfreq, freq);
+	retval = num_from_dec(priv->info + 2, 11, &f);
+	if (retval != RIG_OK)
+		return retval;
+	*freq = f;
 
 	return RIG_OK;
 }
@@ -805,6 +1015,7 @@ int kenwood_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
 	char cmdbuf[4];
 	int retval;
 	unsigned char vfo_letter;
+	unsigned long long f;
 	vfo_t tvfo;
 
 	tvfo = (vfo == RIG_VFO_CURR || vfo==RIG_VFO_VFO) ? rig->state.current_vfo : vfo;
@@ -831,7 +1042,10 @@ int kenwood_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
 	if (retval != RIG_OK)
 		return retval;
 
-	sscanf(freqbuf+2, "%"SCNfreq, freq);
+	retval = num_from_dec(freqbuf+2, 11, &f);
+	if (retval != RIG_OK)
+		return retval;
+	*freq = f;
 
 	return RIG_OK;
 }
@@ -1548,6 +1762,230 @@ int kenwood_get_func(RIG *rig, vfo_t vfo, setting_t func, int *status)
 	return -RIG_EINVAL;
 }
 
+/*
+ * Levels and functions read in one exchange by kenwood_get_levels()
+ * and kenwood_get_funcs(), the way kenwood_get_level() and
+ * kenwood_get_func() read them one at a time.
+ */
+struct kenwood_batch_cmd {
+	setting_t setting;
+	const char *cmd;
+	int len;	/* answer length, terminator included */
+};
+
+#define KENWOOD_BATCH_MAX	16
+#define KENWOOD_BATCH_LEN	16
+#define KENWOOD_BATCH_SKIP	8	/* unsolicited answers tolerated */
+
+static const struct kenwood_batch_cmd kenwood_batch_levels[] = {
+	{ RIG_LEVEL_RAWSTR, "SM", 7 },
+	{ RIG_LEVEL_STRENGTH, "SM", 7 },
+	{ RIG_LEVEL_RFPOWER, "PC", 6 },
+	{ RIG_LEVEL_AF, "AG", 6 },
+	{ RIG_LEVEL_RF, "RG", 6 },
+	{ RIG_LEVEL_SQL, "SQ", 6 },
+	{ RIG_LEVEL_MICGAIN, "MG", 6 },
+	{ RIG_LEVEL_KEYSPD, "KS", 6 },
+	{ RIG_LEVEL_NONE, NULL }
+};
+
+static const struct kenwood_batch_cmd kenwood_batch_funcs[] = {
+	{ RIG_FUNC_NB, "NB", 4 },
+	{ RIG_FUNC_ABM, "AM", 4 },
+	{ RIG_FUNC_COMP, "PR", 4 },
+	{ RIG_FUNC_TONE, "TO", 4 },
+	{ RIG_FUNC_TSQL, "CT", 4 },
+	{ RIG_FUNC_VOX, "VX", 4 },
+	{ RIG_FUNC_NR, "NR", 4 },
+	{ RIG_FUNC_BC, "BC", 4 },
+	{ RIG_FUNC_ANF, "NT", 4 },
+	{ RIG_FUNC_LOCK, "LK", 4 },
+	{ RIG_FUNC_AIP, "MX", 4 },
+	{ RIG_FUNC_NONE, NULL }
+};
+
+/*
+ * Sends the commands of the table for the settings asked at once,
+ * then reads their answers, without the terminator, into answers[i],
+ * matched to the commands by their prefix.
+ * answers[i] is left empty when not asked, or not answered as expected,
+ * for kenwood_get_level()/kenwood_get_func() to retry. A command the rig
+ * does not answer ends the reading at the timeout, keeping the answers
+ * already read.
+ */
+static int kenwood_batch(RIG *rig, const struct kenwood_batch_cmd *table,
+		setting_t settings, char answers[][KENWOOD_BATCH_LEN])
+{
+	struct kenwood_priv_caps *caps = kenwood_caps(rig);
+	struct rig_state *rs = &rig->state;
+	char cmdbuf[KENWOOD_BATCH_MAX * 4];
+	char buf[KENWOOD_BATCH_LEN];
+	char cmdtrm[2];
+	int pending[KENWOOD_BATCH_MAX];
+	int i, len = 0, npending = 0, skips = 0, retval = RIG_OK;
+
+	for (i = 0; table[i].cmd; i++) {
+		answers[i][0] = '\0';
+		pending[i] = 0;
+		if (!(table[i].setting & settings))
+			continue;
+		pending[i] = 1;
+		npending++;
+		cmdbuf[len++] = table[i].cmd[0];
+		cmdbuf[len++] = table[i].cmd[1];
+		cmdbuf[len++] = caps->cmdtrm;
+	}
+	if (len == 0)
+		return RIG_OK;
+
+	cmdtrm[0] = caps->cmdtrm;
+	cmdtrm[1] = '\0';
+
+	rs->hold_decode = 1;
+
+	if (rs->transceive != RIG_TRN_RIG)
+		serial_flush(&rs->rigport);
+
+	retval = write_block(&rs->rigport, cmdbuf, len);
+	if (retval != RIG_OK)
+		goto batch_quit;
+
+	while (npending > 0) {
+		retval = read_string(&rs->rigport, buf, sizeof(buf), cmdtrm, 1);
+		if (retval == -RIG_ETIMEOUT) {
+			rig_debug(RIG_DEBUG_VERBOSE, "%s: %d command(s) not answered, "
+					"left to the single reads\n", __func__, npending);
+			break;
+		}
+		if (retval < 0)
+			goto batch_quit;
+
+		/* NegAck or unknown command, left to the single read */
+		if (retval <= 2) {
+			npending--;
+			continue;
+		}
+
+		for (i = 0; table[i].cmd; i++) {
+			if (pending[i] && buf[0] == table[i].cmd[0] &&
+					buf[1] == table[i].cmd[1])
+				break;
+		}
+		if (!table[i].cmd) {
+			rig_debug(RIG_DEBUG_VERBOSE, "%s: unsolicited answer %c%c\n",
+					__func__, buf[0], buf[1]);
+			if (skips++ >= KENWOOD_BATCH_SKIP) {
+				retval = -RIG_EPROTO;
+				goto batch_quit;
+			}
+			if (rs->transceive == RIG_TRN_RIG) {
+				buf[retval - 1] = '\0';
+				kenwood_ai_queue(rig, buf);
+			}
+			continue;
+		}
+		pending[i] = 0;
+		npending--;
+
+		if (retval != table[i].len) {
+			rig_debug(RIG_DEBUG_ERR, "%s: wrong answer len for cmd %s: "
+					"expected = %d, got %d\n", __func__,
+					table[i].cmd, table[i].len, retval);
+			continue;
+		}
+
+		memcpy(answers[i], buf, retval - 1);
+		answers[i][retval - 1] = '\0';
+	}
+	retval = RIG_OK;
+
+batch_quit:
+	rs->hold_decode = 0;
+	kenwood_ai_flush(rig);
+	return retval;
+}
+
+/*
+ * kenwood_get_levels
+ * Meters and gains read by kenwood_get_level() from a single answer
+ */
+int kenwood_get_levels(RIG *rig, vfo_t vfo, setting_t *levels, value_t *vals)
+{
+	rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+	if (!rig || !levels || !vals)
+		return -RIG_EINVAL;
+
+	char answers[KENWOOD_BATCH_MAX][KENWOOD_BATCH_LEN];
+	setting_t level;
+	int i, idx, lvl, retval;
+
+	retval = kenwood_batch(rig, kenwood_batch_levels, *levels, answers);
+	if (retval != RIG_OK)
+		return retval;
+
+	for (i = 0; kenwood_batch_levels[i].cmd; i++) {
+		if (!answers[i][0])
+			continue;
+
+		level = kenwood_batch_levels[i].setting;
+		idx = rig_setting2idx(level);
+		sscanf(answers[i]+2, "%d", &lvl);
+
+		switch (level) {
+		case RIG_LEVEL_STRENGTH:
+			if (rig->caps->str_cal.size)
+				vals[idx].i = (int) rig_raw2val(lvl, &rig->caps->str_cal);
+			else
+				vals[idx].i = (lvl * 4) - 54;
+			break;
+		case RIG_LEVEL_RAWSTR:
+		case RIG_LEVEL_KEYSPD:
+			vals[idx].i = lvl;
+			break;
+		default:
+			/* 000..255 */
+			vals[idx].f = (float)lvl/255.0;
+			break;
+		}
+		*levels &= ~level;
+	}
+
+	return RIG_OK;
+}
+
+/*
+ * kenwood_get_funcs
+ * 'format 1' functions read by kenwood_get_func()
+ */
+int kenwood_get_funcs(RIG *rig, vfo_t vfo, setting_t *funcs, setting_t *status)
+{
+	rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+	if (!rig || !funcs || !status)
+		return -RIG_EINVAL;
+
+	char answers[KENWOOD_BATCH_MAX][KENWOOD_BATCH_LEN];
+	setting_t func;
+	int i, retval;
+
+	retval = kenwood_batch(rig, kenwood_batch_funcs, *funcs, answers);
+	if (retval != RIG_OK)
+		return retval;
+
+	for (i = 0; kenwood_batch_funcs[i].cmd; i++) {
+		if (!answers[i][0])
+			continue;
+
+		func = kenwood_batch_funcs[i].setting;
+		if (answers[i][2] != '0')
+			*status |= func;
+		*funcs &= ~func;
+	}
+
+	return RIG_OK;
+}
+
 /*
  * kenwood_set_ctcss_tone
  * Assumes rig->caps->ctcss_list != NULL
@@ -1828,6 +2266,78 @@ int kenwood_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 	return RIG_OK;
 }
 
+/*
+ * kenwood_get_snapshot
+ *  The whole state from one IF answer, for the fields the rig
+ *  reads from IF anyway, the others being left to the frontend.
+ */
+int kenwood_get_snapshot(RIG *rig, vfo_t vfo, rig_snapshot_t *snap)
+{
+	rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+	if (!rig || !snap)
+		return -RIG_EINVAL;
+
+	const struct rig_caps *rcaps = rig->caps;
+	struct kenwood_priv_caps *caps = kenwood_caps(rig);
+	struct kenwood_priv_data *priv = rig->state.priv;
+	unsigned long long f;
+	int retval;
+
+	/* IF tells about the current VFO only */
+	if (vfo != RIG_VFO_CURR && vfo != RIG_VFO_VFO &&
+			vfo != rig->state.current_vfo)
+		return -RIG_ENTARGET;
+
+	retval = kenwood_get_if(rig);
+	if (retval != RIG_OK)
+		return retval;
+
+	if (rcaps->get_vfo == kenwood_get_vfo_if) {
+		switch (priv->info[30]) {
+		case '0': snap->vfo = RIG_VFO_A; break;
+		case '1': snap->vfo = RIG_VFO_B; break;
+		case '2': snap->vfo = RIG_VFO_MEM; break;
+		default: snap->vfo = RIG_VFO_NONE; break;
+		}
+		if (snap->vfo != RIG_VFO_NONE)
+			snap->fields |= RIG_SNAPSHOT_VFO;
+	}
+
+	if (num_from_dec(priv->info + 2, 11, &f) == RIG_OK) {
+		snap->freq = f;
+		snap->fields |= RIG_SNAPSHOT_FREQ;
+	}
+
+	/* MD answers the same mode as IF, the filter is read apart */
+	if (rcaps->get_mode == kenwood_get_mode ||
+			(rcaps->get_mode == kenwood_get_mode_if &&
+			 rcaps->rig_model != RIG_MODEL_TS450S &&
+			 rcaps->rig_model != RIG_MODEL_TS690S &&
+			 rcaps->rig_model != RIG_MODEL_TS850 &&
+			 rcaps->rig_model != RIG_MODEL_TS950SDX)) {
+		snap->mode = kenwood2rmode(priv->info[29] - '0', caps->mode_table);
+		snap->width = RIG_PASSBAND_NORMAL;
+		snap->fields |= RIG_SNAPSHOT_MODE;
+	}
+
+	if (rcaps->get_ptt == kenwood_get_ptt) {
+		snap->ptt = priv->info[28] == '0' ? RIG_PTT_OFF : RIG_PTT_ON;
+		snap->fields |= RIG_SNAPSHOT_PTT;
+	}
+
+	if (rcaps->get_split_vfo == kenwood_get_split_vfo_if &&
+			(priv->info[32] == '0' || priv->info[32] == '1')) {
+		snap->split = priv->info[32] == '1' ? RIG_SPLIT_ON : RIG_SPLIT_OFF;
+		snap->tx_vfo = rig->state.tx_vfo;
+		/* Remember whether split is on, for kenwood_set_vfo */
+		priv->split = snap->split;
+		snap->fields |= RIG_SNAPSHOT_SPLIT;
+	}
+
+	return RIG_OK;
+}
+
 int kenwood_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
 {
 	const char *ptt_cmd;
@@ -2394,7 +2904,7 @@ DECLARE_PROBERIG_BACKEND(kenwood)
 	char idbuf[IDBUFSZ];
 	int id_len=-1, i, k_id;
 	int retval=-1;
-	int rates[] = { 115200, 57600, 38400, 19200, 9600, 4800, 1200, 0 };	/* possible baud rates */
+	int rates[] = { 9600, 115200, 57600, 38400, 19200, 4800, 1200, 0 };	/* possible baud rates, most likely first */
 	int rates_idx;
 
 	if (!port)
@@ -2424,6 +2934,7 @@ DECLARE_PROBERIG_BACKEND(kenwood)
 
 		if (retval != RIG_OK || id_len < 0)
 			continue;
+		break;
 	}
 
 	if (retval != RIG_OK || id_len < 0 || !strcmp(idbuf, "ID;"))
@@ -2432,7 +2943,7 @@ DECLARE_PROBERIG_BACKEND(kenwood)
 	/*
 	 * reply should be something like 'IDxxx;'
 	 */
-	if (id_len != 5 || id_len != 6) {
+	if (id_len != 5 && id_len != 6) {
 		idbuf[7] = '\0';
 		rig_debug(RIG_DEBUG_VERBOSE, "probe_kenwood: protocol error, "
 					" expected %d, received %d: %s\n",
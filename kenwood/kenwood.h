@@ -32,6 +32,9 @@
 
 #define KENWOOD_MODE_TABLE_MAX	10
 #define KENWOOD_MAX_BUF_LEN		50 /* max answer len, arbitrary */
+#define KENWOOD_AI_QUEUE	8	/* AI frames kept during a transaction */
+#define KENWOOD_AI_SKIP		16	/* AI frames skipped waiting for a reply */
+#define KENWOOD_AI_TIMEOUT	20	/* mS between AI frames read at once */
 
 
 /* Tokens for Parameters common to multiple rigs.
@@ -73,6 +76,8 @@ struct kenwood_priv_data {
     int k3_ext_lvl;		/* Initial K3 extension level */
     int k2_md_rtty;		/* K2 RTTY mode available flag, 1 = RTTY, 0 = N/A */
     char k3_fw_rev[KENWOOD_MAX_BUF_LEN]; /* K3 firmware revision level */
+    char ai_frames[KENWOOD_AI_QUEUE][KENWOOD_MAX_BUF_LEN]; /* AI frames read by a transaction */
+    int ai_count;		/* AI frames to decode once the transaction is over */
 };
 
 #define kenwood_caps(rig) ((struct kenwood_priv_caps *)(rig)->caps->priv)
@@ -114,6 +119,10 @@ int kenwood_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val);
 int kenwood_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val);
 int kenwood_set_func(RIG *rig, vfo_t vfo, setting_t func, int status);
 int kenwood_get_func(RIG *rig, vfo_t vfo, setting_t func, int *status);
+int kenwood_get_levels(RIG *rig, vfo_t vfo, setting_t *levels, value_t *vals);
+int kenwood_get_funcs(RIG *rig, vfo_t vfo, setting_t *funcs, setting_t *status);
+int kenwood_get_snapshot(RIG *rig, vfo_t vfo, rig_snapshot_t *snap);
+int kenwood_decode_event(RIG *rig);
 int kenwood_set_ext_parm(RIG *rig, token_t token, value_t val);
 int kenwood_get_ext_parm(RIG *rig, token_t token, value_t *val);
 int kenwood_set_ctcss_tone(RIG *rig, vfo_t vfo, tone_t tone);
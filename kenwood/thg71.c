@@ -430,6 +430,10 @@ int thg71_open(RIG *rig)
         return retval;
 
 	/* fill state.rx/tx range_list */
+    retval = rig_copy_tables(rig);
+    if (retval != RIG_OK)
+        return retval;
+
     ack_len=ACKBUF_LEN;
     retval = kenwood_transaction(rig, "FL", 3, ackbuf, &ack_len);
         if (retval != RIG_OK)
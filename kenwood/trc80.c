@@ -164,8 +164,11 @@ const struct rig_caps trc80_caps = {
 .get_dcd =  kenwood_get_dcd,
 .set_func =  kenwood_set_func,
 .get_func =  kenwood_get_func,
+.get_funcs =  kenwood_get_funcs,
+.get_snapshot =  kenwood_get_snapshot,
 .set_level =  kenwood_set_level,
 .get_level =  kenwood_get_level,
+.get_levels =  kenwood_get_levels,
 .set_mem =  kenwood_set_mem,
 .get_mem =  kenwood_get_mem,
 .get_channel =  kenwood_get_channel,
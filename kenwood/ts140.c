@@ -176,6 +176,8 @@ const struct rig_caps ts140_caps = {
 .set_ptt =  kenwood_set_ptt,
 .set_func = kenwood_set_func,
 .get_func =  kenwood_get_func,
+.get_funcs =  kenwood_get_funcs,
+.get_snapshot =  kenwood_get_snapshot,
 .vfo_op =  kenwood_vfo_op,
 .set_mem =  kenwood_set_mem,
 .get_mem = kenwood_get_mem_if,
@@ -297,6 +297,8 @@ const struct rig_caps ts2000_caps = {
 .get_dcd =  kenwood_get_dcd,
 .set_func =  kenwood_set_func,
 .get_func =  kenwood_get_func,
+.get_funcs =  kenwood_get_funcs,
+.get_snapshot =  kenwood_get_snapshot,
 .set_level =  kenwood_set_level,
 .get_level =  ts2000_get_level,
 .set_ant =  kenwood_set_ant,
@@ -309,6 +311,7 @@ const struct rig_caps ts2000_caps = {
 .get_channel = ts2000_get_channel,
 .set_channel = ts2000_set_channel,
 .set_trn =  kenwood_set_trn,
+.decode_event =  kenwood_decode_event,
 .get_trn =  kenwood_get_trn,
 .set_powerstat =  kenwood_set_powerstat,
 .get_powerstat =  kenwood_get_powerstat,
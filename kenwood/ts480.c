@@ -397,6 +397,8 @@ const struct rig_caps ts480_caps = {
   .has_set_func = TS480_FUNC_ALL,
   .set_func = kenwood_set_func,
   .get_func = kenwood_get_func,
+  .get_funcs = kenwood_get_funcs,
+  .get_snapshot = kenwood_get_snapshot,
 };
 
 
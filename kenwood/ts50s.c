@@ -192,12 +192,16 @@ const struct rig_caps ts50s_caps = {
 .get_dcd =  kenwood_get_dcd,
 .set_func =  kenwood_set_func,
 .get_func =  kenwood_get_func,
+.get_funcs =  kenwood_get_funcs,
+.get_snapshot =  kenwood_get_snapshot,
 .set_level =  kenwood_set_level,
 .get_level =  kenwood_get_level,
+.get_levels =  kenwood_get_levels,
 .vfo_op =  kenwood_vfo_op,
 .set_mem =  kenwood_set_mem,
 .get_mem =  kenwood_get_mem,
 .set_trn =  kenwood_set_trn,
+.decode_event =  kenwood_decode_event,
 .get_trn =  kenwood_get_trn,
 .set_powerstat =  kenwood_set_powerstat,
 .get_powerstat =  kenwood_get_powerstat,
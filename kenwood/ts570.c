@@ -839,6 +839,7 @@ const struct rig_caps ts570s_caps = {
 .set_ctcss_tone =  kenwood_set_ctcss_tone,
 .get_ctcss_tone =  kenwood_get_ctcss_tone,
 .get_ptt =  kenwood_get_ptt,
+.get_snapshot =  kenwood_get_snapshot,
 .set_ptt =  kenwood_set_ptt,
 .get_dcd =  kenwood_get_dcd,
 .set_func =  ts570_set_func,
@@ -854,6 +855,7 @@ const struct rig_caps ts570s_caps = {
 .get_channel = kenwood_get_channel,
 .set_channel = ts570_set_channel,
 .set_trn =  kenwood_set_trn,
+.decode_event =  kenwood_decode_event,
 .get_trn =  kenwood_get_trn,
 .set_powerstat =  kenwood_set_powerstat,
 .get_powerstat =  kenwood_get_powerstat,
@@ -1023,6 +1025,7 @@ const struct rig_caps ts570d_caps = {
 .set_ctcss_tone =  kenwood_set_ctcss_tone,
 .get_ctcss_tone =  kenwood_get_ctcss_tone,
 .get_ptt =  kenwood_get_ptt,
+.get_snapshot =  kenwood_get_snapshot,
 .set_ptt =  kenwood_set_ptt,
 .get_dcd =  kenwood_get_dcd,
 .set_func =  ts570_set_func,
@@ -1038,6 +1041,7 @@ const struct rig_caps ts570d_caps = {
 .get_channel = kenwood_get_channel,
 .set_channel = ts570_set_channel,
 .set_trn =  kenwood_set_trn,
+.decode_event =  kenwood_decode_event,
 .get_trn =  kenwood_get_trn,
 .set_powerstat =  kenwood_set_powerstat,
 .get_powerstat =  kenwood_get_powerstat,
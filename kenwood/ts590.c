@@ -213,14 +213,18 @@ const struct rig_caps ts590_caps = {
   .has_get_level = TS590_LEVEL_ALL,
   .set_level = kenwood_set_level,
   .get_level = kenwood_get_level,
+  .get_levels = kenwood_get_levels,
   .has_get_func = TS590_FUNC_ALL,
   .has_set_func = TS590_FUNC_ALL,
   .set_func = kenwood_set_func,
   .get_func = kenwood_get_func,
+  .get_funcs = kenwood_get_funcs,
+  .get_snapshot = kenwood_get_snapshot,
   .set_ctcss_tone =  kenwood_set_ctcss_tone,
   .get_ctcss_tone =  kenwood_get_ctcss_tone,
   .ctcss_list =  kenwood38_ctcss_list,
   .set_trn =  kenwood_set_trn,
+  .decode_event =  kenwood_decode_event,
   .get_trn =  kenwood_get_trn,
   .send_morse =  kenwood_send_morse,
   .set_mem =  kenwood_set_mem,
@@ -182,14 +182,18 @@ const struct rig_caps ts690s_caps = {
 .get_dcd =  kenwood_get_dcd,
 .set_func =  kenwood_set_func,
 .get_func =  kenwood_get_func,
+.get_funcs =  kenwood_get_funcs,
+.get_snapshot =  kenwood_get_snapshot,
 .set_level =  kenwood_set_level,
 .get_level =  kenwood_get_level,
+.get_levels =  kenwood_get_levels,
 .set_ext_parm = kenwood_set_ext_parm,
 .get_ext_parm = kenwood_get_ext_parm,
 .vfo_op =  kenwood_vfo_op,
 .set_mem =  kenwood_set_mem,
 .get_mem =  kenwood_get_mem_if,
 .set_trn =  kenwood_set_trn,
+.decode_event =  kenwood_decode_event,
 .get_trn =  kenwood_get_trn,
 .set_powerstat = kenwood_set_powerstat,
 .get_powerstat = kenwood_get_powerstat,
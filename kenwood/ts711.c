@@ -162,6 +162,7 @@ const struct rig_caps ts711_caps = {
 .get_ptt =  ic10_get_ptt,
 .set_func =  kenwood_set_func,
 .get_func =  kenwood_get_func,
+.get_funcs =  kenwood_get_funcs,
 .vfo_op =  kenwood_vfo_op,
 .set_mem =  kenwood_set_mem,
 .get_mem =  ic10_get_mem,
@@ -171,6 +172,7 @@ const struct rig_caps ts711_caps = {
 .get_ctcss_tone =  kenwood_get_ctcss_tone,
 .set_level =  kenwood_set_level,
 .get_level =  kenwood_get_level,
+.get_levels =  kenwood_get_levels,
 .set_channel = ic10_set_channel,
 .get_channel = ic10_get_channel,
 .decode_event = ic10_decode_event,
@@ -198,8 +198,11 @@ const struct rig_caps ts790_caps = {
 .get_dcd =  kenwood_get_dcd,
 .set_func =  kenwood_set_func,
 .get_func =  kenwood_get_func,
+.get_funcs =  kenwood_get_funcs,
+.get_snapshot =  kenwood_get_snapshot,
 .set_level =  kenwood_set_level,
 .get_level =  kenwood_get_level,
+.get_levels =  kenwood_get_levels,
 .vfo_op =  kenwood_vfo_op,
 .scan =  kenwood_scan,
 .set_mem =  kenwood_set_mem,
@@ -207,6 +210,7 @@ const struct rig_caps ts790_caps = {
 .set_channel = kenwood_set_channel,
 .get_channel = kenwood_get_channel,
 .set_trn =  kenwood_set_trn,
+.decode_event =  kenwood_decode_event,
 .get_trn =  kenwood_get_trn,
 .get_info =  kenwood_get_info,
 
@@ -226,6 +226,8 @@ const struct rig_caps ts850_caps = {
 	.set_ptt =  kenwood_set_ptt_safe,
 	.set_func = kenwood_set_func,
 	.get_func = kenwood_get_func,
+	.get_funcs = kenwood_get_funcs,
+	.get_snapshot = kenwood_get_snapshot,
 	.set_level = kenwood_set_level,
 	.get_level =  ts850_get_level,
 	.vfo_op =  kenwood_vfo_op,
@@ -233,7 +235,8 @@ const struct rig_caps ts850_caps = {
 	.get_mem =  kenwood_get_mem_if,
 	.get_channel = kenwood_get_channel,
 	.set_channel = ts850_set_channel,
-	.set_trn =  kenwood_set_trn
+	.set_trn =  kenwood_set_trn,
+	.decode_event =  kenwood_decode_event,
 };
 
 /*
@@ -507,6 +507,8 @@ const struct rig_caps ts870s_caps = {
 .get_dcd =  kenwood_get_dcd,
 .set_func =  kenwood_set_func,
 .get_func =  kenwood_get_func,
+.get_funcs =  kenwood_get_funcs,
+.get_snapshot =  kenwood_get_snapshot,
 .set_level =  ts870s_set_level,
 .get_level =  ts870s_get_level,
 .set_ant =  kenwood_set_ant,
@@ -516,6 +518,7 @@ const struct rig_caps ts870s_caps = {
 .set_mem =  kenwood_set_mem,
 .get_mem =  kenwood_get_mem,
 .set_trn =  kenwood_set_trn,
+.decode_event =  kenwood_decode_event,
 .get_trn =  kenwood_get_trn,
 .set_powerstat =  kenwood_set_powerstat,
 .get_powerstat =  kenwood_get_powerstat,
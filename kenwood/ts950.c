@@ -174,6 +174,7 @@ const struct rig_caps ts950sdx_caps = {
 .set_ctcss_tone =  kenwood_set_ctcss_tone,
 .get_ctcss_tone =  kenwood_get_ctcss_tone,
 .get_ptt =  kenwood_get_ptt,
+.get_snapshot =  kenwood_get_snapshot,
 .set_ptt =  kenwood_set_ptt,
 .get_dcd =  kenwood_get_dcd,
 /* Things that the '950 doesn't do ...
@@ -182,6 +183,7 @@ const struct rig_caps ts950sdx_caps = {
  * .set_level =  kenwood_set_level,
  */
 .get_level =  kenwood_get_level,
+.get_levels =  kenwood_get_levels,
 /*
  * .send_morse =  kenwood_send_morse,
  */
@@ -189,6 +191,7 @@ const struct rig_caps ts950sdx_caps = {
 .set_mem =  kenwood_set_mem,
 .get_mem =  kenwood_get_mem,
 .set_trn =  kenwood_set_trn,
+.decode_event =  kenwood_decode_event,
 .get_trn =  kenwood_get_trn,
 .set_powerstat =  kenwood_set_powerstat,
 .get_powerstat =  kenwood_get_powerstat,
@@ -0,0 +1,182 @@
+/*
+ *  Hamlib KIT backend - Si570 register math
+ *  Copyright (c) 2009-2012 by Stephane Fillod
+ *
+ *  Derived from usbsoftrock-0.5:
+ *  Copyright (C) 2009 Andrew Nilsson (andrew.nilsson@gmail.com)
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef HAVE_STDINT_H
+#include <stdint.h>
+#endif
+
+#include <math.h>
+#include "hamlib/rig.h"
+
+#include "si570avrusb.h"
+
+/*
+ * Kept apart from si570avrusb.c, which needs libusb,
+ * so that it can be unit tested.
+ */
+
+const int si570_hs_div_map[8] = {4,5,6,7,-1,9,-1,11};
+
+#define RFREQ_FRAC_ONE 268435456.0	/* 2^28 */
+
+/*
+ * Full search of the HS_DIV/N1 dividers putting the DCO at the lowest
+ * frequency within its range, for an output frequency of f.
+ * Returns 1 when found, 0 otherwise.
+ */
+int si570_calc_dividers(double osc_freq, double f, struct solution *solution)
+{
+	struct solution sols[8];
+	int i;
+	int imin;
+	double fmin;
+	double y;
+
+	// Count down through the dividers
+	for (i=7;i >= 0;i--) {
+
+		if (si570_hs_div_map[i] > 0) {
+			sols[i].HS_DIV = i;
+			y = (SI570_DCO_HIGH + SI570_DCO_LOW) / (2 * f);
+			y = y / si570_hs_div_map[i];
+			if (y < 1.5) {
+				y = 1.0;
+			} else {
+				y = 2 * round ( y / 2.0);
+			}
+			if (y > 128) {
+				y = 128;
+			}
+			sols[i].N1 = trunc(y) - 1;
+			sols[i].f0 = f * y * si570_hs_div_map[i];
+		} else {
+			sols[i].f0 = 10000000000000000.0;
+		}
+	}
+	imin = -1;
+	fmin = 10000000000000000.0;
+
+	for (i=0; i < 8; i++) {
+		if ((sols[i].f0 >= SI570_DCO_LOW) && (sols[i].f0 <= SI570_DCO_HIGH)) {
+			if (sols[i].f0 < fmin) {
+				fmin = sols[i].f0;
+				imin = i;
+			}
+		}
+	}
+
+	if (imin >= 0) {
+		solution->HS_DIV = sols[imin].HS_DIV;
+		solution->N1 = sols[imin].N1;
+		solution->f0 = sols[imin].f0;
+		solution->RFREQ = sols[imin].f0 / osc_freq;
+
+	    rig_debug(RIG_DEBUG_TRACE, "%s: solution: HS_DIV = %d, N1 = %d, f0 = %f, RFREQ = %f\n",
+			__func__, solution->HS_DIV, solution->N1, solution->f0, solution->RFREQ);
+
+		return 1;
+	} else {
+		solution->HS_DIV = 0;
+		solution->N1 = 0;
+		solution->f0 = 0;
+		solution->RFREQ = 0;
+	    rig_debug(RIG_DEBUG_TRACE, "%s: No solution\n", __func__);
+		return 0;
+	}
+}
+
+/*
+ * Smooth tune: keep the dividers of the cached solution, computed for
+ * the output frequency center, and recompute RFREQ only.
+ * This is possible as long as f stays within SI570_SMOOTH_TUNE_PPM
+ * of center, and the DCO within its range.
+ * Returns 1 when possible, 0 when a full search is needed.
+ */
+int si570_smooth_tune(double osc_freq, double f, double center,
+		const struct solution *cached, struct solution *solution)
+{
+	double f0;
+
+	if (center <= 0 || cached->f0 <= 0)
+		return 0;
+
+	if (fabs(f - center) > center * SI570_SMOOTH_TUNE_PPM / 1e6)
+		return 0;
+
+	f0 = f * (cached->N1 + 1) * si570_hs_div_map[cached->HS_DIV];
+	if (f0 < SI570_DCO_LOW || f0 > SI570_DCO_HIGH)
+		return 0;
+
+	solution->HS_DIV = cached->HS_DIV;
+	solution->N1 = cached->N1;
+	solution->f0 = f0;
+	solution->RFREQ = f0 / osc_freq;
+
+	return 1;
+}
+
+/*
+ * Registers 7..12 of the Si570, as sent by REQUEST_SET_FREQ
+ */
+void si570_set_registers(const struct solution *solution, unsigned char *buffer)
+{
+	uint32_t RFREQ_int;
+	uint32_t RFREQ_frac;
+
+	RFREQ_int = trunc(solution->RFREQ);
+	RFREQ_frac = round((solution->RFREQ - RFREQ_int) * RFREQ_FRAC_ONE);
+	if (RFREQ_frac >= (1UL<<28)) {
+		/* rounded up to the next integer */
+		RFREQ_int++;
+		RFREQ_frac = 0;
+	}
+
+	buffer[5] = RFREQ_frac & 0xff;
+	buffer[4] = (RFREQ_frac >> 8) & 0xff;
+	buffer[3] = (RFREQ_frac >> 16) & 0xff;
+	buffer[2] = ((RFREQ_frac >> 24) & 0xf) | ((RFREQ_int & 0xf) << 4);
+	buffer[1] = ((RFREQ_int >> 4) & 0x3f) | ((solution->N1 & 3) << 6);
+	buffer[0] = ((solution->N1 >> 2) & 0x1f) | (solution->HS_DIV << 5);
+}
+
+/*
+ * Output frequency programmed by registers 7..12
+ */
+double si570_calc_frequency(double osc_freq, const unsigned char *buffer)
+{
+	int RFREQ_int = ((buffer[2] & 0xf0) >> 4) + ((buffer[1] & 0x3f) * 16);
+	int RFREQ_frac = (256 * 256 * 256 * (buffer[2] & 0xf)) + (256 * 256 * buffer[3]) + (256 * buffer[4]) + (buffer[5]);
+	double RFREQ = RFREQ_int + (RFREQ_frac / RFREQ_FRAC_ONE);
+	int N1 = ((buffer[1] & 0xc0 ) >> 6) + ((buffer[0] & 0x1f) * 4);
+	int HS_DIV = (buffer[0] & 0xE0) >> 5;
+
+	if (si570_hs_div_map[HS_DIV] < 0)
+		return 0;
+
+	return osc_freq * RFREQ / ((N1 + 1) * si570_hs_div_map[HS_DIV]);
+}
@@ -78,6 +78,7 @@ static const char *si570xxxusb_get_info(RIG *rig);
 #define TOK_MULTIPLIER	TOKEN_BACKEND(3)
 #define TOK_I2C_ADDR	TOKEN_BACKEND(4)
 #define TOK_BPF     	TOKEN_BACKEND(5)
+#define TOK_SMOOTH_TUNE	TOKEN_BACKEND(6)
 
 static const struct confparams si570xxxusb_cfg_params[] = {
 	{ TOK_OSCFREQ, "osc_freq", "Oscillator freq", "Oscillator frequency in Hz",
@@ -92,6 +93,10 @@ static const struct confparams si570xxxusb_cfg_params[] = {
 	{ TOK_BPF, "bpf", "BPF", "Enable Band Pass Filter",
 		"0", RIG_CONF_CHECKBUTTON, { }
 	},
+	{ TOK_SMOOTH_TUNE, "smooth_tune", "Smooth tune",
+		"Change RFREQ only, within 3500 ppm of the last divider change",
+		"0", RIG_CONF_CHECKBUTTON, { }
+	},
 	{ RIG_CONF_END, NULL, }
 };
 
@@ -108,6 +113,10 @@ struct si570xxxusb_priv_data {
 
 	int i2c_addr;
 	int bpf;    /* enable BPF? */
+
+	int smooth_tune;		/* reuse the dividers when possible */
+	double center;			/* MHz, output freq of the last divider change, 0 if none */
+	struct solution solution;	/* dividers computed then */
 };
 
 #define SI570AVRUSB_MODES (RIG_MODE_USB)	/* USB is for SDR */
@@ -389,6 +398,7 @@ int si570xxxusb_set_conf(RIG *rig, token_t token, const char *val)
 			if (sscanf(val, "%"SCNfreq, &freq) != 1)
 				return -RIG_EINVAL;
 			priv->osc_freq = (double)freq/1e6;
+			priv->center = 0;
 			break;
 		case TOK_MULTIPLIER:
 			if (sscanf(val, "%lf", &multiplier) != 1)
@@ -396,6 +406,7 @@ int si570xxxusb_set_conf(RIG *rig, token_t token, const char *val)
 			if (multiplier == 0.)
 				return -RIG_EINVAL;
 			priv->multiplier = multiplier;
+			priv->center = 0;
 			break;
 		case TOK_I2C_ADDR:
 			if (sscanf(val, "%x", &i2c_addr) != 1)
@@ -408,6 +419,11 @@ int si570xxxusb_set_conf(RIG *rig, token_t token, const char *val)
 			if (sscanf(val, "%d", &priv->bpf) != 1)
 				return -RIG_EINVAL;
 			break;
+		case TOK_SMOOTH_TUNE:
+			if (sscanf(val, "%d", &priv->smooth_tune) != 1)
+				return -RIG_EINVAL;
+			priv->center = 0;
+			break;
 		default:
 			return -RIG_EINVAL;
 	}
@@ -433,6 +449,9 @@ int si570xxxusb_get_conf(RIG *rig, token_t token, char *val)
 		case TOK_BPF:
 			sprintf(val, "%d", priv->bpf);
 			break;
+		case TOK_SMOOTH_TUNE:
+			sprintf(val, "%d", priv->smooth_tune);
+			break;
 		default:
 			return -RIG_EINVAL;
 	}
@@ -557,70 +576,6 @@ const char * si570xxxusb_get_info(RIG *rig)
 }
 
 
-static const int HS_DIV_MAP[] = {4,5,6,7,-1,9,-1,11};
-
-static int calcDividers(RIG *rig, double f, struct solution* solution)
-{
-	struct si570xxxusb_priv_data *priv = (struct si570xxxusb_priv_data *)rig->state.priv;
-	struct solution sols[8];
-	int i;
-	int imin;
-	double fmin;
-	double y;
-
-	// Count down through the dividers
-	for (i=7;i >= 0;i--) {
-
-		if (HS_DIV_MAP[i] > 0) {
-			sols[i].HS_DIV = i;
-			y = (SI570_DCO_HIGH + SI570_DCO_LOW) / (2 * f);
-			y = y / HS_DIV_MAP[i];
-			if (y < 1.5) {
-				y = 1.0;
-			} else {
-				y = 2 * round ( y / 2.0);
-			}
-			if (y > 128) {
-				y = 128;
-			}
-			sols[i].N1 = trunc(y) - 1;
-			sols[i].f0 = f * y * HS_DIV_MAP[i];
-		} else {
-			sols[i].f0 = 10000000000000000.0;
-		}
-	}
-	imin = -1;
-	fmin = 10000000000000000.0;
-
-	for (i=0; i < 8; i++) {
-		if ((sols[i].f0 >= SI570_DCO_LOW) && (sols[i].f0 <= SI570_DCO_HIGH)) {
-			if (sols[i].f0 < fmin) {
-				fmin = sols[i].f0;
-				imin = i;
-			}
-		}
-	}
-
-	if (imin >= 0) {
-		solution->HS_DIV = sols[imin].HS_DIV;
-		solution->N1 = sols[imin].N1;
-		solution->f0 = sols[imin].f0;
-		solution->RFREQ = sols[imin].f0 / priv->osc_freq;
-
-	    rig_debug(RIG_DEBUG_TRACE, "%s: solution: HS_DIV = %d, N1 = %d, f0 = %f, RFREQ = %f\n",
-			__func__, solution->HS_DIV, solution->N1, solution->f0, solution->RFREQ);
-
-		return 1;
-	} else {
-		solution->HS_DIV = 0;
-		solution->N1 = 0;
-		solution->f0 = 0;
-		solution->RFREQ = 0;
-	    rig_debug(RIG_DEBUG_TRACE, "%s: No solution\n", __func__);
-		return 0;
-	}
-}
-
 static void setLongWord(uint32_t value, unsigned char * bytes)
 {
 	bytes[0] = value & 0xff;
@@ -641,32 +596,29 @@ int si570xxxusb_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
 	int index = 0;
 	double f;
 	struct solution theSolution;
-	int RFREQ_int;
-	int RFREQ_frac;
-	unsigned char fracBuffer[4];
-	unsigned char intBuffer[4];
 
 	if (priv->version >= 0x0f00 || rig->caps->rig_model == RIG_MODEL_SI570PICUSB)
 		return si570xxxusb_set_freq_by_value(rig, vfo, freq);
 
 	f = (freq * priv->multiplier)/1e6;
 
-	calcDividers(rig, f, &theSolution);
-
-	RFREQ_int = trunc(theSolution.RFREQ);
-	RFREQ_frac = round((theSolution.RFREQ - RFREQ_int)*268435456);
-	setLongWord(RFREQ_int, intBuffer);
-	setLongWord(RFREQ_frac, fracBuffer);
+	/*
+	 * Small steps, eg. SDR sweeping, keep the dividers and change
+	 * RFREQ only: no divider search, and the output does not glitch
+	 * as it does when the dividers change.
+	 */
+	if (priv->smooth_tune && si570_smooth_tune(priv->osc_freq, f,
+				priv->center, &priv->solution, &theSolution)) {
+		rig_debug(RIG_DEBUG_TRACE, "%s: smooth tune, RFREQ = %f\n",
+				__func__, theSolution.RFREQ);
+	} else {
+		if (!si570_calc_dividers(priv->osc_freq, f, &theSolution))
+			return -RIG_EINVAL;
+		priv->solution = theSolution;
+		priv->center = f;
+	}
 
-	buffer[5] = fracBuffer[0];
-	buffer[4] = fracBuffer[1];
-	buffer[3] = fracBuffer[2];
-	buffer[2] = fracBuffer[3];
-	buffer[2] = buffer[2] | ((intBuffer[0] & 0xf) << 4);
-	buffer[1] = RFREQ_int / 16;
-	buffer[1] = buffer[1] + ((theSolution.N1 & 3) << 6);
-	buffer[0] = theSolution.N1 / 4;
-	buffer[0] = buffer[0] + (theSolution.HS_DIV << 5);
+	si570_set_registers(&theSolution, buffer);
 
 	ret = usb_control_msg(udh, USB_TYPE_VENDOR | USB_RECIP_DEVICE | USB_ENDPOINT_OUT,
 			request, value, index, (char*)buffer, sizeof(buffer), rig->state.rigport.timeout);
@@ -680,6 +632,8 @@ int si570xxxusb_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
 		rig_debug (RIG_DEBUG_ERR, "%s: usb_control_msg failed: %s\n",
 					__func__,
 					usb_strerror ());
+		/* the dividers of the rig are unknown */
+		priv->center = 0;
 		return -RIG_EIO;
 	}
 
@@ -729,12 +683,7 @@ static double calculateFrequency(RIG *rig, const unsigned char * buffer)
 {
 	struct si570xxxusb_priv_data *priv = (struct si570xxxusb_priv_data *)rig->state.priv;
 
-	int RFREQ_int = ((buffer[2] & 0xf0) >> 4) + ((buffer[1] & 0x3f) * 16);
-	int RFREQ_frac = (256 * 256 * 256 * (buffer[2] & 0xf)) + (256 * 256 * buffer[3]) + (256 * buffer[4]) + (buffer[5]);
-	double RFREQ = RFREQ_int + (RFREQ_frac / 268435456.0);
-	int N1 = ((buffer[1] & 0xc0 ) >> 6) + ((buffer[0] & 0x1f) * 4);
-	int HS_DIV = (buffer[0] & 0xE0) >> 5;
-	double fout = priv->osc_freq * RFREQ / ((N1 + 1) * HS_DIV_MAP[HS_DIV]);
+	double fout = si570_calc_frequency(priv->osc_freq, buffer);
 
 	rig_debug (RIG_DEBUG_VERBOSE,
 			"%s: Registers 7..13: %02x%02x%02x%02x%02x%02x\n",
@@ -746,10 +695,7 @@ static double calculateFrequency(RIG *rig, const unsigned char * buffer)
 			buffer[4],
 			buffer[5]);
 
-	rig_debug (RIG_DEBUG_VERBOSE,
-			"%s: RFREQ = %f, N1 = %d, HS_DIV = %d, nHS_DIV = %d, fout = %f\n",
-			__func__,
-			RFREQ, N1, HS_DIV, HS_DIV_MAP[HS_DIV], fout);
+	rig_debug (RIG_DEBUG_VERBOSE, "%s: fout = %f\n", __func__, fout);
 
 	return fout;
 }
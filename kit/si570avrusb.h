@@ -53,6 +53,9 @@
 #define REQUEST_SET_PTT				0x50
 #define REQUEST_READ_KEYS			0x51
 
+/* RFREQ only changes, without a new divider, stay glitch-free within this window */
+#define SI570_SMOOTH_TUNE_PPM 3500
+
 struct solution {
 	int HS_DIV;
 	int N1;
@@ -60,4 +63,13 @@ struct solution {
 	double RFREQ;
 };
 
+/* Register math, in si570.c. Frequencies are in MHz. */
+extern const int si570_hs_div_map[8];
+
+extern int si570_calc_dividers(double osc_freq, double f, struct solution *solution);
+extern int si570_smooth_tune(double osc_freq, double f, double center,
+		const struct solution *cached, struct solution *solution);
+extern void si570_set_registers(const struct solution *solution, unsigned char *buffer);
+extern double si570_calc_frequency(double osc_freq, const unsigned char *buffer);
+
 #endif	/* _SI570AVRUSB_H */
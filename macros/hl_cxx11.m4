@@ -0,0 +1,67 @@
+# Check for a C++11 compiler.                      -*- Autoconf -*-
+
+# Copyright (c) 2026 by the Hamlib Group
+# 
+# This file is part of Hamlib
+# 
+# This library is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Library General Public License as
+# published by the Free Software Foundation; either version 2 of
+# the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Library General Public License for more details.
+#
+# You should have received a copy of the GNU Library General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+
+# HL_CXX_STD11([ACTION-IF-FOUND], [ACTION-IF-NOT-FOUND])
+#
+# Checks whether $CXX compiles C++11 as is, or else with one of the
+# usual switches, which is then appended to CXX so that it is not lost
+# when CXXFLAGS gets set again.
+AC_DEFUN([HL_CXX_STD11],
+[
+AC_CACHE_CHECK([for the switch of $CXX to enable C++11],
+               [hl_cv_cxx_std11],
+               [hl_cv_cxx_std11=no
+                AC_LANG_PUSH([C++])
+                hl_save_CXX="$CXX"
+                for hl_switch in none -std=gnu++11 -std=c++11 -std=c++0x; do
+                    AS_IF([test x"$hl_switch" != "xnone"],
+                          [CXX="$hl_save_CXX $hl_switch"])
+                    AC_COMPILE_IFELSE([AC_LANG_PROGRAM([[
+                        #include <memory>
+                        #include <utility>
+                        #if __cplusplus < 201103L
+                        #error not C++11
+                        #endif
+                        struct movable {
+                            movable() = default;
+                            movable(movable &&) noexcept = default;
+                            movable(const movable &) = delete;
+                        };
+                        ]],
+                        [[std::unique_ptr<int> p(new int(0));
+                          auto q = std::move(p);
+                          movable m;
+                          movable n(std::move(m));
+                          (void)n;
+                          return q == nullptr;]])],
+                        [hl_cv_cxx_std11=$hl_switch])
+                    CXX="$hl_save_CXX"
+                    AS_IF([test x"$hl_cv_cxx_std11" != "xno"], [break])
+                done
+                AC_LANG_POP([C++])
+               ])
+
+AS_IF([test x"$hl_cv_cxx_std11" = "xno"],
+      [$2],
+      [AS_IF([test x"$hl_cv_cxx_std11" != "xnone"],
+             [CXX="$CXX $hl_cv_cxx_std11"])
+       $1])
+])
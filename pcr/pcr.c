@@ -159,6 +159,27 @@ static int is_sub_rcvr(RIG * rig, vfo_t vfo);
 #define is_valid_answer(x) \
 	((x) == 'I' || (x) == 'G' || (x) == 'N' || (x) == 'H')
 
+/* frames of the auto update stream decoded at once, and the time (ms)
+ * the following ones may take to come along */
+#define PCR_EVENT_FRAMES	16
+#define PCR_EVENT_TIMEOUT	20
+
+/* Bit 1 of the squelch status: AF open (CTCSS open) */
+#define pcr_rcvr_dcd(rcvr) \
+	((rcvr)->squelch_status & 0x02 ? RIG_DCD_ON : RIG_DCD_OFF)
+
+static void
+pcr_push_dtmf(struct pcr_rcvr *rcvr, char digit)
+{
+	/* the oldest tone is dropped when nobody reads them */
+	if (rcvr->dtmf_len == PCR_DTMF_LEN) {
+		memmove(rcvr->dtmf, rcvr->dtmf + 1, PCR_DTMF_LEN - 1);
+		rcvr->dtmf_len--;
+	}
+
+	rcvr->dtmf[rcvr->dtmf_len++] = digit;
+}
+
 static int
 pcr_read_block(RIG *rig, char *rxbuffer, size_t count)
 {
@@ -261,8 +282,9 @@ pcr_parse_answer(RIG *rig, char *buf, int len)
 			return RIG_OK;
 
 		case '3':
-			rig_debug(RIG_DEBUG_WARN, "%s: DTMF %c\n",
+			rig_debug(RIG_DEBUG_VERBOSE, "%s: DTMF %c\n",
 				__func__, buf[3]);
+			pcr_push_dtmf(&priv->main_rcvr, buf[3]);
 			return RIG_OK;
 
             /* Sub receiver (on PCR-2500..) - TBC */
@@ -280,8 +302,9 @@ pcr_parse_answer(RIG *rig, char *buf, int len)
 			return RIG_OK;
 
 		case '7':
-			rig_debug(RIG_DEBUG_WARN, "%s: DTMF %c (Sub)\n",
+			rig_debug(RIG_DEBUG_VERBOSE, "%s: DTMF %c (Sub)\n",
 				__func__, buf[3]);
+			pcr_push_dtmf(&priv->sub_rcvr, buf[3]);
 			return RIG_OK;
 		}
 	} else if (buf[0] == 'G') {
@@ -343,7 +366,7 @@ pcr_send(RIG * rig, const char *cmd)
 static int
 pcr_transaction(RIG * rig, const char *cmd)
 {
-	int err;
+	int err, frames = 0;
 	struct rig_state *rs = &rig->state;
 	struct pcr_priv_caps *caps = pcr_caps(rig);
 	struct pcr_priv_data *priv = (struct pcr_priv_data *) rs->priv;
@@ -360,6 +383,7 @@ pcr_transaction(RIG * rig, const char *cmd)
 	if (priv->auto_update)
 		return RIG_OK;
 
+read_reply:
 	err = pcr_read_block(rig, priv->reply_buf, caps->reply_size);
 	if (err < 0) {
 		rig_debug(RIG_DEBUG_ERR,
@@ -372,6 +396,14 @@ pcr_transaction(RIG * rig, const char *cmd)
 		return -RIG_EPROTO;
 	}
 
+	/* status frames of the auto update stream, still on their way
+	 * when it was turned off, are decoded before the reply */
+	if (priv->reply_buf[caps->reply_offset] == 'I' && cmd[0] != 'I' &&
+			++frames < PCR_EVENT_FRAMES) {
+		pcr_parse_answer(rig, &priv->reply_buf[caps->reply_offset], err);
+		goto read_reply;
+	}
+
 	return pcr_parse_answer(rig, &priv->reply_buf[caps->reply_offset], err);
 }
 
@@ -1628,17 +1660,55 @@ int pcr_set_trn(RIG * rig, int trn)
 		return -RIG_EINVAL;
 }
 
+/*
+ * Decodes the frames of the auto update stream which came along, keeping
+ * the signal strength, squelch and DTMF status of the receivers current
+ * for the getters, and firing the DCD callback on the squelch changes.
+ */
 int pcr_decode_event(RIG *rig)
 {
-	int err;
-	char buf[4];
+	struct rig_state *rs = &rig->state;
+	struct pcr_priv_caps *caps = pcr_caps(rig);
+	struct pcr_priv_data *priv = (struct pcr_priv_data *) rs->priv;
+	char buf[PCR_MAX_CMD_LEN];
+	int timeout = rs->rigport.timeout;
+	dcd_t main_dcd, sub_dcd;
+	int err = RIG_OK, frames;
+
+	for (frames = 0; frames < PCR_EVENT_FRAMES; frames++) {
+		main_dcd = pcr_rcvr_dcd(&priv->main_rcvr);
+		sub_dcd = pcr_rcvr_dcd(&priv->sub_rcvr);
+
+		err = pcr_read_block(rig, buf, caps->reply_size);
+		if (err != caps->reply_size) {
+			if (err >= 0) {
+				priv->sync = 0;
+				err = -RIG_EPROTO;
+			}
+			break;
+		}
 
-	/* XXX check this */
-	err = pcr_read_block(rig, buf, 4);
-	if (err == 4)
-		return pcr_parse_answer(rig, buf, 4);
+		err = pcr_parse_answer(rig, &buf[caps->reply_offset], err);
+
+		if (rig->callbacks.dcd_event) {
+			if (pcr_rcvr_dcd(&priv->main_rcvr) != main_dcd)
+				rig->callbacks.dcd_event(rig, RIG_VFO_MAIN,
+					pcr_rcvr_dcd(&priv->main_rcvr),
+					rig->callbacks.dcd_arg);
+			if (pcr_rcvr_dcd(&priv->sub_rcvr) != sub_dcd)
+				rig->callbacks.dcd_event(rig, RIG_VFO_SUB,
+					pcr_rcvr_dcd(&priv->sub_rcvr),
+					rig->callbacks.dcd_arg);
+		}
 
-	return RIG_OK;
+		/* the following frames, if any, are already on their way */
+		rs->rigport.timeout = PCR_EVENT_TIMEOUT;
+	}
+
+	rs->rigport.timeout = timeout;
+
+	/* running out of frames is the normal end of the stream */
+	return frames ? RIG_OK : err;
 }
 
 int pcr_set_powerstat(RIG * rig, powerstat_t status)
@@ -1692,7 +1762,33 @@ int pcr_get_dcd(RIG * rig, vfo_t vfo, dcd_t *dcd)
 	 * Bit 2: VSC open
 	 * Bit 3: RX error (not ready to receive)
 	 */
-	*dcd = rcvr->squelch_status & 0x02 ? RIG_DCD_ON : RIG_DCD_OFF;
+	*dcd = pcr_rcvr_dcd(rcvr);
+
+	return RIG_OK;
+}
+
+/*
+ * The PCR reports the DTMF tones it hears in auto update mode only,
+ * the ones decoded since the last call are returned.
+ */
+int pcr_recv_dtmf(RIG * rig, vfo_t vfo, char *digits, int *length)
+{
+	struct pcr_priv_data *priv = (struct pcr_priv_data *) rig->state.priv;
+	struct pcr_rcvr *rcvr = is_sub_rcvr(rig, vfo) ? &priv->sub_rcvr : &priv->main_rcvr;
+	int len = rcvr->dtmf_len;
+
+	/* NUL terminated, like the other backends */
+	if (*length < 1)
+		return -RIG_EINVAL;
+	if (len > *length - 1)
+		len = *length - 1;
+
+	memcpy(digits, rcvr->dtmf, len);
+	digits[len] = '\0';
+	memmove(rcvr->dtmf, rcvr->dtmf + len, rcvr->dtmf_len - len);
+	rcvr->dtmf_len -= len;
+
+	*length = len;
 
 	return RIG_OK;
 }
@@ -31,6 +31,7 @@
 
 #define BACKEND_VER		"0.8"
 #define PCR_MAX_CMD_LEN		32
+#define PCR_DTMF_LEN		16
 
 struct pcr_priv_data
 {
@@ -52,6 +53,10 @@ struct pcr_priv_data
 	    int raw_level;
 	    int squelch_status;
 
+	    /* DTMF tones heard in auto update mode, not yet read */
+	    char dtmf[PCR_DTMF_LEN];
+	    int dtmf_len;
+
 	} main_rcvr, sub_rcvr;
 
 	vfo_t current_vfo;
@@ -115,6 +120,7 @@ int pcr_decode_event(RIG *rig);
 int pcr_set_powerstat(RIG * rig, powerstat_t status);
 int pcr_get_powerstat(RIG * rig, powerstat_t *status);
 int pcr_get_dcd(RIG * rig, vfo_t vfo, dcd_t *dcd);
+int pcr_recv_dtmf(RIG * rig, vfo_t vfo, char *digits, int *length);
 
 /* ------------------------------------------------------------------ */
 
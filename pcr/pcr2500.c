@@ -187,6 +187,7 @@ const struct rig_caps pcr2500_caps = {
 	.set_trn	= pcr_set_trn,
 	.decode_event	= pcr_decode_event,
 	.get_dcd	= pcr_get_dcd,
+	.recv_dtmf	= pcr_recv_dtmf,
 
 	.set_powerstat  = pcr_set_powerstat,
 	.get_powerstat  = pcr_get_powerstat,
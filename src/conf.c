@@ -42,6 +42,7 @@
 
 #include <hamlib/rig.h>
 #include "token.h"
+#include "lock.h"
 
 /*
  * Configuration options available in the rig->state struct.
@@ -65,6 +66,18 @@ static const struct confparams frontend_cfg_params[] = {
 	{ TOK_RETRY, "retry", "Retry", "Max number of retry",
 			"0", RIG_CONF_NUMERIC, { .n = { 0, 10, 1 } }
 	},
+	{ TOK_TIMEOUT_ADAPTIVE, "timeout_adaptive", "Adaptive timeout",
+			"Shorten the timeout to the observed response times, timeout being the ceiling",
+			"0", RIG_CONF_CHECKBUTTON, { }
+	},
+	{ TOK_TRACE_FILE, "trace_file", "I/O trace file",
+			"File the I/O of the rig port is recorded into, or replayed from",
+			"", RIG_CONF_STRING,
+	},
+	{ TOK_TRACE_MODE, "trace_mode", "I/O trace mode",
+			"Record the I/O into trace_file, or replay it instead of opening the port",
+			"None", RIG_CONF_COMBO, { .c = {{ "None", "Record", "Replay", "Realtime", NULL }} }
+	},
 	{ TOK_ITU_REGION, "itu_region", "ITU region",
 			"ITU region this rig has been manufactured for (freq. band plan)",
 			"0", RIG_CONF_NUMERIC, { .n = { 1, 3, 1 } }
@@ -78,6 +91,10 @@ static const struct confparams frontend_cfg_params[] = {
 			"Polling interval in millisecond for transceive emulation",
 			"500", RIG_CONF_NUMERIC, { .n = { 0, 1000000, 1 } }
 	},
+	{ TOK_RANGE_CHECK, "range_check", "Range check",
+			"Reject the frequencies out of the ranges and the unsupported modes without asking the rig",
+			"0", RIG_CONF_CHECKBUTTON, { }
+	},
 	{ TOK_PTT_TYPE, "ptt_type", "PTT type",
 			"Push-To-Talk interface type override",
 			"RIG", RIG_CONF_COMBO, { .c = {{ "RIG", "DTR", "RTS", "Parallel", "CM108", "None", NULL }} }
@@ -145,6 +162,7 @@ static int frontend_set_conf(RIG *rig, token_t token, const char *val)
 {
         const struct rig_caps *caps;
         struct rig_state *rs;
+        const freq_range_t *tx_range_list, *rx_range_list;
         int val_i;
 
         caps = rig->caps;
@@ -178,6 +196,27 @@ static int frontend_set_conf(RIG *rig, token_t token, const char *val)
                 }
                 rs->rigport.retry = val_i;
                 break;
+        case TOK_TIMEOUT_ADAPTIVE:
+                if (1 != sscanf(val, "%d", &val_i)){
+                        return -RIG_EINVAL;//value format error
+                }
+                rs->rigport.timeout_adaptive = val_i ? 1 : 0;
+                break;
+        case TOK_TRACE_FILE:
+                strncpy(rs->rigport.trace_file, val, FILPATHLEN-1);
+                break;
+        case TOK_TRACE_MODE:
+                if (!strcmp(val, "None"))
+                        rs->rigport.trace_mode = RIG_TRACE_NONE;
+                else if (!strcmp(val, "Record"))
+                        rs->rigport.trace_mode = RIG_TRACE_RECORD;
+                else if (!strcmp(val, "Replay"))
+                        rs->rigport.trace_mode = RIG_TRACE_REPLAY;
+                else if (!strcmp(val, "Realtime"))
+                        rs->rigport.trace_mode = RIG_TRACE_REPLAY_REALTIME;
+                else
+                        return -RIG_EINVAL;
+                break;
 
         case TOK_SERIAL_SPEED:
                 if (rs->rigport.type.rig != RIG_PORT_SERIAL)
@@ -264,23 +303,30 @@ static int frontend_set_conf(RIG *rig, token_t token, const char *val)
                 }
                 switch(val_i) {
                 case RIG_ITU_REGION1:
-                        rs->itu_region = val_i;
-                        memcpy(rs->tx_range_list, caps->tx_range_list1,
-                                        sizeof(struct freq_range_list)*FRQRANGESIZ);
-                        memcpy(rs->rx_range_list, caps->rx_range_list1,
-                                        sizeof(struct freq_range_list)*FRQRANGESIZ);
+                        tx_range_list = caps->tx_range_list1;
+                        rx_range_list = caps->rx_range_list1;
                         break;
                 case RIG_ITU_REGION2:
                 case RIG_ITU_REGION3:
-                        rs->itu_region = val_i;
-                        memcpy(rs->tx_range_list, caps->tx_range_list2,
-                                        sizeof(struct freq_range_list)*FRQRANGESIZ);
-                        memcpy(rs->rx_range_list, caps->rx_range_list2,
-                                        sizeof(struct freq_range_list)*FRQRANGESIZ);
+                        tx_range_list = caps->tx_range_list2;
+                        rx_range_list = caps->rx_range_list2;
                         break;
                 default:
                         return -RIG_EINVAL;
                 }
+                rs->itu_region = val_i;
+                if (rs->tables) {
+                        /* own copy, see rig_copy_tables() */
+                        memcpy(rs->tx_range_list, tx_range_list,
+                                        sizeof(struct freq_range_list)*FRQRANGESIZ);
+                        memcpy(rs->rx_range_list, rx_range_list,
+                                        sizeof(struct freq_range_list)*FRQRANGESIZ);
+                } else {
+                        rs->tx_range_list = (freq_range_t *) tx_range_list;
+                        rs->rx_range_list = (freq_range_t *) rx_range_list;
+                }
+                if (rs->index)
+                        return rig_index_tables(rig);
                 break;
 
         case TOK_PTT_TYPE:
@@ -343,6 +389,12 @@ static int frontend_set_conf(RIG *rig, token_t token, const char *val)
         case TOK_POLL_INTERVAL:
                 rs->poll_interval = atof(val);
                 break;
+        case TOK_RANGE_CHECK:
+                if (1 != sscanf(val, "%d", &val_i)){
+                        return -RIG_EINVAL;//value format error
+                }
+                rs->range_check = val_i ? 1 : 0;
+                break;
 
 
         default:
@@ -378,6 +430,21 @@ static int frontend_get_conf(RIG *rig, token_t token, char *val)
 	case TOK_RETRY:
 		sprintf(val, "%d", rs->rigport.retry);
 		break;
+	case TOK_TIMEOUT_ADAPTIVE:
+		sprintf(val, "%d", rs->rigport.timeout_adaptive);
+		break;
+	case TOK_TRACE_FILE:
+		strcpy(val, rs->rigport.trace_file);
+		break;
+	case TOK_TRACE_MODE:
+		switch (rs->rigport.trace_mode) {
+		case RIG_TRACE_RECORD: s = "Record"; break;
+		case RIG_TRACE_REPLAY: s = "Replay"; break;
+		case RIG_TRACE_REPLAY_REALTIME: s = "Realtime"; break;
+		default: s = "None";
+		}
+		strcpy(val, s);
+		break;
 	case TOK_ITU_REGION:
 		sprintf(val, "%d",
 			rs->itu_region == 1 ? RIG_ITU_REGION1 : RIG_ITU_REGION2);
@@ -452,6 +519,9 @@ static int frontend_get_conf(RIG *rig, token_t token, char *val)
 	case TOK_POLL_INTERVAL:
 		sprintf(val, "%d", rs->poll_interval);
 		break;
+	case TOK_RANGE_CHECK:
+		sprintf(val, "%d", rs->range_check);
+		break;
 
 	default:
 		return -RIG_EINVAL;
@@ -575,6 +645,8 @@ int HAMLIB_API rig_set_conf(RIG *rig, token_t token, const char *val)
 	if (!rig || !rig->caps)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
     if (rig_need_debug(RIG_DEBUG_VERBOSE)) {
 	    const struct confparams *cfp;
         char tokenstr[12];
@@ -614,6 +686,8 @@ int HAMLIB_API rig_get_conf(RIG *rig, token_t token, char *val)
 	if (!rig || !rig->caps || !val)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	if (IS_TOKEN_FRONTEND(token))
 		return frontend_get_conf(rig, token, val);
 
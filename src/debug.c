@@ -46,11 +46,14 @@
 #include <hamlib/rig.h>
 
 #include "misc.h"
+#include "lock.h"
 
 static int rig_debug_level = RIG_DEBUG_TRACE;
 static FILE *rig_debug_stream;
 static vprintf_cb_t rig_vprintf_cb;
 static rig_ptr_t rig_vprintf_arg;
+/* keeps the messages of concurrent threads from interleaving */
+HAMLIB_MUTEX(debug_lock)
 
 
 #define DUMP_HEX_WIDTH 16
@@ -129,6 +132,7 @@ void HAMLIB_API rig_debug(enum rig_debug_level_e debug_level, const char *fmt, .
 
 
 	va_start(ap, fmt);
+	HAMLIB_MUTEX_LOCK(debug_lock);
 
 	if (rig_vprintf_cb) {
 
@@ -141,6 +145,7 @@ void HAMLIB_API rig_debug(enum rig_debug_level_e debug_level, const char *fmt, .
 		vfprintf (rig_debug_stream, fmt, ap);
 	}
 
+	HAMLIB_MUTEX_UNLOCK(debug_lock);
 	va_end(ap);
 }
 
@@ -181,10 +186,13 @@ rig_message_cb	(enum rig_debug_level_e debug_level,
  */
 vprintf_cb_t HAMLIB_API rig_set_debug_callback(vprintf_cb_t cb, rig_ptr_t arg)
 {
-	vprintf_cb_t prev_cb = rig_vprintf_cb;
+	vprintf_cb_t prev_cb;
 
+	HAMLIB_MUTEX_LOCK(debug_lock);
+	prev_cb = rig_vprintf_cb;
 	rig_vprintf_cb = cb;
 	rig_vprintf_arg = arg;
+	HAMLIB_MUTEX_UNLOCK(debug_lock);
 
 	return prev_cb;
 }
@@ -195,9 +203,12 @@ vprintf_cb_t HAMLIB_API rig_set_debug_callback(vprintf_cb_t cb, rig_ptr_t arg)
  */
 FILE* HAMLIB_API rig_set_debug_file(FILE *stream)
 {
-	FILE *prev_stream = rig_debug_stream;
+	FILE *prev_stream;
 
+	HAMLIB_MUTEX_LOCK(debug_lock);
+	prev_stream = rig_debug_stream;
 	rig_debug_stream = stream;
+	HAMLIB_MUTEX_UNLOCK(debug_lock);
 
 	return prev_stream;
 }
@@ -55,6 +55,8 @@
 #include <hamlib/rig.h>
 
 #include "event.h"
+#include "iofunc.h"
+#include "lock.h"
 
 #if defined(WIN32) && !defined(HAVE_TERMIOS_H)
 #include "win32termios.h"
@@ -81,6 +83,60 @@ static void sa_sigalrmhandler(int signum);
 /* This one should be in an include file */
 extern int foreach_opened_rig(int (*cfunc)(RIG *, rig_ptr_t),rig_ptr_t data);
 
+#if defined(HAVE_SIGACTION) && defined(HAVE_PTHREAD)
+/*
+ * Nothing is locked from signal context: the SIGIO/SIGALRM handlers only
+ * write the event to a pipe, and an event thread decodes or polls the
+ * rigs in normal context, under their handle lock.
+ */
+#define EVENT_DECODE	'D'
+#define EVENT_POLL	'P'
+#define EVENT_RETRY_MS	10	/* before decoding again a rig busy elsewhere */
+
+static int event_pipe[2] = { -1, -1 };
+static pthread_once_t event_once = PTHREAD_ONCE_INIT;
+
+static void *event_thread(void *arg);
+
+static void event_start(void)
+{
+	pthread_attr_t attr;
+	pthread_t thread;
+
+	if (pipe(event_pipe) < 0) {
+		rig_debug(RIG_DEBUG_ERR,"%s: pipe failed: %s\n",
+						__func__, strerror(errno));
+		event_pipe[0] = event_pipe[1] = -1;
+		return;
+	}
+	/* the events coalesce when the pipe is full */
+	fcntl(event_pipe[1], F_SETFL, O_NONBLOCK);
+
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	if (pthread_create(&thread, &attr, event_thread, NULL) != 0) {
+		rig_debug(RIG_DEBUG_ERR,"%s: cannot start the event thread\n",
+						__func__);
+		close(event_pipe[0]);
+		close(event_pipe[1]);
+		event_pipe[0] = event_pipe[1] = -1;
+	}
+	pthread_attr_destroy(&attr);
+}
+
+/* async-signal-safe */
+static void event_post(char ev)
+{
+	int saved_errno = errno;
+	ssize_t ret;
+
+	if (event_pipe[1] >= 0)
+		ret = write(event_pipe[1], &ev, 1);
+	(void)ret;
+	errno = saved_errno;
+}
+#endif
+
 /*
  * add_trn_rig
  * not exported in Hamlib API.
@@ -91,6 +147,19 @@ int add_trn_rig(RIG *rig)
 #ifdef HAVE_SIGACTION
 	struct sigaction act;
 	int status;
+#endif
+
+	/* no port to watch, the backend reports its events itself */
+	if (rig->state.rigport.fd < 0)
+		return RIG_OK;
+
+#ifdef HAVE_SIGACTION
+
+#ifdef HAVE_PTHREAD
+	pthread_once(&event_once, event_start);
+	if (event_pipe[1] < 0)
+		return -RIG_EINTERNAL;
+#endif
 
 		/*
 		 * FIXME: multiple open will register several time SIGIO hndlr
@@ -153,6 +222,12 @@ int remove_trn_rig(RIG *rig)
 {
 #ifdef HAVE_SIGACTION
 	int status;
+#endif
+
+	if (rig->state.rigport.fd < 0)
+		return RIG_OK;
+
+#ifdef HAVE_SIGACTION
 
     /* assert(rig->caps->transceive == RIG_TRN_RIG); */
 
@@ -187,6 +262,12 @@ static int add_trn_poll_rig(RIG *rig)
 	struct sigaction act;
 	int status;
 
+#ifdef HAVE_PTHREAD
+	pthread_once(&event_once, event_start);
+	if (event_pipe[1] < 0)
+		return -RIG_EINTERNAL;
+#endif
+
 		/*
 		 * FIXME: multiple open will register several time SIGALRM hndlr
 		 */
@@ -238,9 +319,10 @@ static int remove_trn_poll_rig(RIG *rig)
 
 
 /*
- * This is used by sa_sigio, the SIGIO handler
+ * This is used by the event thread, on SIGIO,
  * to find out which rig generated this event,
  * and decode/process it.
+ * data, when not NULL, points to a flag set when a rig is busy.
  *
  * assumes rig!=NULL
  */
@@ -257,13 +339,23 @@ static int search_rig_and_decode(RIG *rig, rig_ptr_t data)
 			rig->state.rigport.fd == -1)
 		return -1;
 
-	/* FIXME: siginfo is not portable, however use it where available */
-#if 0&&defined(HAVE_SIGINFO_T)
-	siginfo_t *si = (siginfo_t*)data;
+	/*
+	 * Do not disturb when another thread is talking to the rig,
+	 * nor when the backend is currently receiving data,
+	 * it will be retried
+	 */
+	if (!hamlib_trylock(rig->state.lock)) {
+		if (data)
+			*(int *)data = 1;
+		return -1;
+	}
+	if (rig->state.hold_decode) {
+		hamlib_unlock(rig->state.lock);
+		if (data)
+			*(int *)data = 1;
+		return -1;
+	}
 
-	if (rig->state.rigport.fd != si->si_fd)
-			return -1;
-#else
 	FD_ZERO(&rfds);
 	FD_SET(rig->state.rigport.fd, &rfds);
 	/* Read status immediately. */
@@ -273,30 +365,25 @@ static int search_rig_and_decode(RIG *rig, rig_ptr_t data)
 	/* don't use FIONREAD to detect activity
 	 * since it is less portable than select
 	 * REM: EINTR possible with 0sec timeout? retval==0?
+	 * The data may have been read along with a reply meanwhile.
 	 */
 	retval = select(rig->state.rigport.fd+1, &rfds, NULL, NULL, &tv);
-	if (retval < 0) {
+	if (retval < 0)
 		rig_debug(RIG_DEBUG_ERR, "search_rig_and_decode: select: %s\n",
 								strerror(errno));
-		return -1;
-	}
-#endif
-
-	/*
-	 * Do not disturb, the backend is currently receiving data
-	 */
-	if (rig->state.hold_decode)
-			return -1;
 
-	if (rig->caps->decode_event)
+	if (retval > 0 && rig->caps->decode_event)
 		rig->caps->decode_event(rig);
 
+	hamlib_unlock(rig->state.lock);
+
 	return 1;	/* process each opened rig */
 }
 
 /*
- * This is used by sa_sigio, the SIGALRM handler
+ * This is used by the event thread, on SIGALRM,
  * to poll each RIG in RIG_TRN_POLL mode.
+ * A rig busy in another thread is polled next time.
  *
  * assumes rig!=NULL
  */
@@ -308,10 +395,16 @@ static int search_rig_and_poll(RIG *rig, rig_ptr_t data)
 	if (rig->state.transceive != RIG_TRN_POLL)
 		return -1;
 	/*
-	 * Do not disturb, the backend is currently receiving data
+	 * Do not disturb when another thread is talking to the rig,
+	 * nor when the backend is currently receiving data,
+	 * nor before its write delays are over, it will be next time
 	 */
-	if (rig->state.hold_decode)
+	if (!hamlib_trylock(rig->state.lock))
+		return -1;
+	if (rig->state.hold_decode || port_write_wait(&rs->rigport) > 0) {
+		hamlib_unlock(rig->state.lock);
 		return -1;
+	}
 
 	rig->state.hold_decode = 2;
 
@@ -355,32 +448,93 @@ static int search_rig_and_poll(RIG *rig, rig_ptr_t data)
 
 	rig->state.hold_decode = 0;
 
+	hamlib_unlock(rig->state.lock);
+
 	return 1;	/* process each opened rig */
 }
 
 
+#ifdef HAVE_PTHREAD
 /*
- * This is the SIGIO handler
+ * The event thread, waiting for the signal handlers
  *
  * lookup in the list of open rigs,
+ * call rig->caps->decode_event() on SIGIO, retrying the busy rigs,
+ * and get_freq and co. on SIGALRM (this is done by search_rig)
+ */
+static void *event_thread(void *arg)
+{
+	char buf[64];
+	fd_set rfds;
+	struct timeval tv;
+	int decode = 0, poll = 0, busy;
+	ssize_t i, n;
+
+	for (;;) {
+		FD_ZERO(&rfds);
+		FD_SET(event_pipe[0], &rfds);
+		tv.tv_sec = 0;
+		tv.tv_usec = EVENT_RETRY_MS*1000;
+
+		if (select(event_pipe[0]+1, &rfds, NULL, NULL,
+					decode ? &tv : NULL) > 0) {
+			n = read(event_pipe[0], buf, sizeof(buf));
+			for (i=0; i<n; i++) {
+				if (buf[i] == EVENT_DECODE)
+					decode = 1;
+				else if (buf[i] == EVENT_POLL)
+					poll = 1;
+			}
+		}
+
+		if (decode) {
+			rig_debug(RIG_DEBUG_VERBOSE, "event_thread: activity detected\n");
+			busy = 0;
+			foreach_opened_rig(search_rig_and_decode, &busy);
+			decode = busy;
+		}
+		if (poll) {
+			rig_debug(RIG_DEBUG_TRACE, "event_thread: polling\n");
+			foreach_opened_rig(search_rig_and_poll, NULL);
+			poll = 0;
+		}
+	}
+
+	return NULL;
+}
+#endif
+
+/*
+ * This is the SIGIO handler
+ *
+ * with pthread, wake up the event thread,
+ * otherwise lookup in the list of open rigs,
  * check the rig is not holding SIGIO,
  * then call rig->caps->decode_event()  (this is done by search_rig)
  */
 #ifdef HAVE_SIGINFO_T
 static void sa_sigioaction(int signum, siginfo_t *si, rig_ptr_t data)
 {
+#ifdef HAVE_PTHREAD
+	event_post(EVENT_DECODE);
+#else
 	rig_debug(RIG_DEBUG_VERBOSE, "sa_sigioaction: activity detected\n");
 
-	foreach_opened_rig(search_rig_and_decode, si);
+	foreach_opened_rig(search_rig_and_decode, NULL);
+#endif
 }
 
 #else
 
 static void sa_sigiohandler(int signum)
 {
+#ifdef HAVE_PTHREAD
+	event_post(EVENT_DECODE);
+#else
 	rig_debug(RIG_DEBUG_VERBOSE, "sa_sigiohandler: activity detected\n");
 
 	foreach_opened_rig(search_rig_and_decode, NULL);
+#endif
 }
 
 #endif
@@ -389,25 +543,34 @@ static void sa_sigiohandler(int signum)
 /*
  * This is the SIGALRM handler
  *
- * lookup in the list of open rigs,
+ * with pthread, wake up the event thread,
+ * otherwise lookup in the list of open rigs,
  * check the rig is not holding SIGALRM,
  * then call get_freq and check for changes  (this is done by search_rig)
  */
 #ifdef HAVE_SIGINFO_T
 static void sa_sigalrmaction(int signum, siginfo_t *si, rig_ptr_t data)
 {
+#ifdef HAVE_PTHREAD
+	event_post(EVENT_POLL);
+#else
 	rig_debug(RIG_DEBUG_TRACE, "sa_sigalrmaction entered\n");
 
-	foreach_opened_rig(search_rig_and_poll, si);
+	foreach_opened_rig(search_rig_and_poll, NULL);
+#endif
 }
 
 #else
 
 static void sa_sigalrmhandler(int signum)
 {
+#ifdef HAVE_PTHREAD
+	event_post(EVENT_POLL);
+#else
 	rig_debug(RIG_DEBUG_TRACE, "sa_sigalrmhandler entered\n");
 
 	foreach_opened_rig(search_rig_and_poll, NULL);
+#endif
 }
 
 #endif /* !HAVE_SIGINFO_T */
@@ -436,6 +599,8 @@ int HAMLIB_API rig_set_freq_callback(RIG *rig, freq_cb_t cb, rig_ptr_t arg)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	rig->callbacks.freq_event = cb;
 	rig->callbacks.freq_arg = arg;
 
@@ -462,6 +627,8 @@ int HAMLIB_API rig_set_mode_callback(RIG *rig, mode_cb_t cb, rig_ptr_t arg)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	rig->callbacks.mode_event = cb;
 	rig->callbacks.mode_arg = arg;
 
@@ -488,6 +655,8 @@ int HAMLIB_API rig_set_vfo_callback(RIG *rig, vfo_cb_t cb, rig_ptr_t arg)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	rig->callbacks.vfo_event = cb;
 	rig->callbacks.vfo_arg = arg;
 
@@ -514,6 +683,8 @@ int HAMLIB_API rig_set_ptt_callback(RIG *rig, ptt_cb_t cb, rig_ptr_t arg)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	rig->callbacks.ptt_event = cb;
 	rig->callbacks.ptt_arg = arg;
 
@@ -540,6 +711,8 @@ int HAMLIB_API rig_set_dcd_callback(RIG *rig, dcd_cb_t cb, rig_ptr_t arg)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	rig->callbacks.dcd_event = cb;
 	rig->callbacks.dcd_arg = arg;
 
@@ -568,6 +741,8 @@ int HAMLIB_API rig_set_pltune_callback(RIG *rig, pltune_cb_t cb, rig_ptr_t arg)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	rig->callbacks.pltune = cb;
 	rig->callbacks.pltune_arg = arg;
 
@@ -599,6 +774,8 @@ int HAMLIB_API rig_set_trn(RIG *rig, int trn)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	/* detect whether tranceive is active already */
@@ -707,6 +884,8 @@ int HAMLIB_API rig_get_trn(RIG *rig, int *trn)
 	if (CHECK_RIG_ARG(rig) || !trn)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	if (rig->caps->get_trn != NULL)
 		return rig->caps->get_trn(rig, trn);
 
@@ -53,6 +53,7 @@
 #include "usb_port.h"
 #include "network.h"
 #include "cm108.h"
+#include "trace.h"
 
 /**
  * \brief Open a hamlib_port based on its rig port type
@@ -65,6 +66,16 @@ int HAMLIB_API port_open(hamlib_port_t *p)
 	int want_state_delay = 0;
 
 	p->fd = -1;
+	memset(&p->stats, 0, sizeof(p->stats));
+	p->stats_write_date.tv_sec = 0;
+	p->post_write_date.tv_sec = 0;
+	p->timeout_backoff = 0;
+	p->trace = NULL;
+
+	/* the trace stands for the device */
+	if (p->trace_mode == RIG_TRACE_REPLAY ||
+			p->trace_mode == RIG_TRACE_REPLAY_REALTIME)
+		return trace_open(p);
 
 	switch(p->type.rig) {
 	case RIG_PORT_SERIAL:
@@ -136,6 +147,14 @@ int HAMLIB_API port_open(hamlib_port_t *p)
 		return -RIG_EINVAL;
 	}
 
+	if (p->trace_mode == RIG_TRACE_RECORD) {
+		status = trace_open(p);
+		if (status < 0) {
+			port_close(p, p->type.rig);
+			return status;
+		}
+	}
+
 	return RIG_OK;
 }
 
@@ -151,6 +170,9 @@ int HAMLIB_API port_close(hamlib_port_t *p, rig_port_t port_type)
 {
     int ret = RIG_OK;
 
+	if (trace_close(p))
+		return RIG_OK;	/* replayed, no device */
+
 	if (p->fd != -1) {
 		switch (port_type) {
 		case RIG_PORT_SERIAL:
@@ -269,6 +291,214 @@ static ssize_t port_read(hamlib_port_t *p, void *buf, size_t count)
 
 #endif
 
+/*
+ * Record/replay hooks, see trace.c
+ */
+static ssize_t io_read(hamlib_port_t *p, void *buf, size_t count)
+{
+  ssize_t ret;
+
+  if (TRACE_REPLAYING(p))
+	return read(p->fd, buf, count);
+
+  ret = port_read(p, buf, count);
+  if (p->trace && ret > 0)
+	trace_record(p, TRACE_RX, buf, ret);
+  return ret;
+}
+
+static ssize_t io_write(hamlib_port_t *p, const void *buf, size_t count)
+{
+  ssize_t ret;
+
+  if (TRACE_REPLAYING(p))
+	return trace_replay_write(p, buf, count);
+
+  ret = port_write(p, buf, count);
+  if (p->trace && ret > 0)
+	trace_record(p, TRACE_TX, buf, ret);
+  return ret;
+}
+
+static int io_select(hamlib_port_t *p, int n, fd_set *readfds, fd_set *writefds,
+			fd_set *exceptfds, struct timeval *timeout)
+{
+  if (TRACE_REPLAYING(p)) {
+	trace_replay_feed(p, timeout);
+	return select(n, readfds, writefds, exceptfds, timeout);
+  }
+  return port_select(p, n, readfds, writefds, exceptfds, timeout);
+}
+
+/*
+ * Account a latency in a log2 mS histogram bucket
+ */
+static void stats_hist(unsigned long *hist, const struct timeval *from,
+				const struct timeval *to)
+{
+	long ms;
+	int i = 0;
+
+	ms = (to->tv_sec - from->tv_sec)*1000 +
+			(to->tv_usec - from->tv_usec)/1000;
+	while (ms > 0 && i < RIG_PORT_STATS_HIST-1) {
+		ms >>= 1;
+		i++;
+	}
+	hist[i]++;
+}
+
+/*
+ * Latencies of a read answering a command are measured
+ * from the end of that command.
+ * Returns 1 when the read answers a command, 0 otherwise.
+ */
+static int stats_read_start(hamlib_port_t *p, const struct timeval *start,
+				struct timeval *origin)
+{
+	if (p->stats_write_date.tv_sec != 0) {
+		origin->tv_sec = p->stats_write_date.tv_sec;
+		origin->tv_usec = p->stats_write_date.tv_usec;
+		p->stats_write_date.tv_sec = 0;
+		p->stats.transactions++;
+		return 1;
+	}
+	*origin = *start;
+	return 0;
+}
+
+#define ADAPTIVE_MIN_SAMPLES	16	/* before trusting the histogram */
+#define ADAPTIVE_PERCENTILE	99
+#define ADAPTIVE_MARGIN		2
+#define ADAPTIVE_FLOOR		10	/* mS */
+#define ADAPTIVE_MAX_BACKOFF	6
+
+/*
+ * Timeout, in mS, to wait for the answer to a command.
+ *
+ * In adaptive mode, this is twice the upper bound of the histogram
+ * bucket holding the 99th percentile of completion times, doubled
+ * after each consecutive timeout, and never more than p->timeout.
+ */
+static int reply_timeout(hamlib_port_t *p, int is_reply)
+{
+	unsigned long total = 0, n = 0;
+	int i, timeout;
+
+	if (!is_reply || !p->timeout_adaptive || p->timeout <= 0)
+		return p->timeout;
+
+	for (i = 0; i < RIG_PORT_STATS_HIST; i++)
+		total += p->stats.complete[i];
+	if (total < ADAPTIVE_MIN_SAMPLES)
+		return p->timeout;
+
+	for (i = 0; i < RIG_PORT_STATS_HIST-1; i++) {
+		n += p->stats.complete[i];
+		if (n*100 >= total*ADAPTIVE_PERCENTILE)
+			break;
+	}
+	if (i == RIG_PORT_STATS_HIST-1)
+		return p->timeout;
+
+	/* bucket i holds latencies below 2^i mS */
+	timeout = (1 << i) * ADAPTIVE_MARGIN;
+	if (timeout < ADAPTIVE_FLOOR)
+		timeout = ADAPTIVE_FLOOR;
+	timeout <<= p->timeout_backoff;
+
+	return timeout < p->timeout ? timeout : p->timeout;
+}
+
+/*
+ * Back off after a lost answer, until one comes back in time.
+ */
+static void reply_backoff(hamlib_port_t *p, int is_reply, int timed_out)
+{
+	if (!is_reply || !p->timeout_adaptive)
+		return;
+
+	if (!timed_out)
+		p->timeout_backoff = 0;
+	else if (p->timeout_backoff < ADAPTIVE_MAX_BACKOFF)
+		p->timeout_backoff++;
+}
+
+/*
+ * Only the reads answering a command go into the histograms,
+ * not the ones draining what the rig sent on its own.
+ */
+static void stats_read_done(hamlib_port_t *p, int is_reply,
+		const struct timeval *origin, const struct timeval *first,
+		int total_count)
+{
+	struct timeval now;
+
+	p->stats.reads++;
+	p->stats.bytes_in += total_count;
+	if (!is_reply || total_count == 0)
+		return;
+
+	gettimeofday(&now, NULL);
+	stats_hist(p->stats.ttfb, origin, first);
+	stats_hist(p->stats.complete, origin, &now);
+}
+
+
+/*
+ * Time in uS before post_write_date, 0 when passed
+ */
+static long write_date_us(const hamlib_port_t *p)
+{
+  struct timeval tv;
+  long us;
+
+  if (p->post_write_date.tv_sec == 0)
+	return 0;
+
+  /* FIXME in Y2038 ... */
+  gettimeofday(&tv, NULL);
+  us = (p->post_write_date.tv_sec - tv.tv_sec)*1000000L +
+		  (p->post_write_date.tv_usec - tv.tv_usec);
+
+  return us > 0 ? us : 0;
+}
+
+static void wait_write_date(hamlib_port_t *p)
+{
+  long us = write_date_us(p);
+
+  if (us > 0)
+	usleep(us);
+  p->post_write_date.tv_sec = 0;
+}
+
+/* next write no earlier than delay mS from now */
+static void set_write_date(hamlib_port_t *p, int delay)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  tv.tv_usec += delay*1000;
+  tv.tv_sec += tv.tv_usec / 1000000;
+  tv.tv_usec %= 1000000;
+  p->post_write_date.tv_sec = tv.tv_sec;
+  p->post_write_date.tv_usec = tv.tv_usec;
+}
+
+/**
+ * \brief Time left before the port accepts the next write
+ * \param p rig port descriptor
+ * \return the time in mS, rounded up, before write_block() can send
+ * without waiting for the write_delay/post_write_delay, 0 if it can now.
+ *
+ * Lets an event loop arm a timer rather than block in write_block().
+ */
+int HAMLIB_API port_write_wait(const hamlib_port_t *p)
+{
+  return (write_date_us(p) + 999) / 1000;
+}
+
 /**
  * \brief Write a block of characters to an fd.
  * \param p rig port descriptor
@@ -292,7 +522,13 @@ static ssize_t port_read(hamlib_port_t *p, void *buf, size_t count)
  * count - count of byte to send from the txbuffer
  * write_delay - write delay in ms between 2 chars
  * post_write_delay - minimum delay between two writes
- * post_write_date - timeval of last write
+ * post_write_date - earliest date of the next write
+ *
+ * The delays are deadlines rather than sleeps: nothing waits after the
+ * last byte, the next write_block only waits for what is left of the
+ * delay, time usually spent reading the answer. See port_write_wait().
+ * Within the block though, each byte after the first still sleeps
+ * for the write_delay.
  *
  * Actually, this function has nothing specific to serial comm,
  * it could work very well also with any file handle, like a socket.
@@ -300,63 +536,52 @@ static ssize_t port_read(hamlib_port_t *p, void *buf, size_t count)
 
 int HAMLIB_API write_block(hamlib_port_t *p, const char *txbuffer, size_t count)
 {
-  int i, ret;
-
-#ifdef WANT_NON_ACTIVE_POST_WRITE_DELAY
-  if (p->post_write_date.tv_sec != 0) {
-		  signed int date_delay;	/* in us */
-		  struct timeval tv;
-
-		  /* FIXME in Y2038 ... */
-		  gettimeofday(&tv, NULL);
-		  date_delay = p->post_write_delay*1000 -
-				  		((tv.tv_sec - p->post_write_date.tv_sec)*1000000 +
-				  		 (tv.tv_usec - p->post_write_date.tv_usec));
-		  if (date_delay > 0) {
-				/*
-				 * optional delay after last write
-				 */
-				usleep(date_delay);
-		  }
-		  p->post_write_date.tv_sec = 0;
-  }
-#endif
+  int i, ret, delay;
+  struct timeval start_time, end_time;
+
+  gettimeofday(&start_time, NULL);
 
   if (p->write_delay > 0) {
   	for (i=0; i < count; i++) {
-		ret = port_write(p, txbuffer+i, 1);
+		wait_write_date(p);
+		ret = io_write(p, txbuffer+i, 1);
 		if (ret != 1) {
 			rig_debug(RIG_DEBUG_ERR,"%s():%d failed %d - %s\n",
 				__func__, __LINE__, ret, strerror(errno));
+			p->stats.errors++;
 			return -RIG_EIO;
     	}
-    	usleep(p->write_delay*1000);
+		set_write_date(p, p->write_delay);
   	}
   } else {
-	ret = port_write(p, txbuffer, count);
+	wait_write_date(p);
+	ret = io_write(p, txbuffer, count);
 	if (ret != count) {
 		rig_debug(RIG_DEBUG_ERR,"%s():%d failed %d - %s\n",
 			__func__, __LINE__, ret, strerror(errno));
+		p->stats.errors++;
 		return -RIG_EIO;
     	}
   }
 
-  if (p->post_write_delay > 0) {
-#ifdef WANT_NON_ACTIVE_POST_WRITE_DELAY
-#define POST_WRITE_DELAY_TRSHLD 10
+  /* answers are timed from the end of the transmission */
+  gettimeofday(&end_time, NULL);
+  p->stats_write_date.tv_sec = end_time.tv_sec;
+  p->stats_write_date.tv_usec = end_time.tv_usec;
+
+  /*
+   * optional delay after last write, otherwise some yaesu rigs
+   * get confused with sequential fast writes
+   */
+  delay = p->write_delay + p->post_write_delay;
+  if (delay > 0)
+	set_write_date(p, delay);
+
+  p->stats.writes++;
+  p->stats.bytes_out += count;
+  p->stats.write_us += (end_time.tv_sec - start_time.tv_sec)*1000000 +
+			(end_time.tv_usec - start_time.tv_usec);
 
-	if (p->post_write_delay > POST_WRITE_DELAY_TRSHLD) {
-		struct timeval tv;
-		gettimeofday(&tv, NULL);
-		p->post_write_date.tv_sec = tv.tv_sec;
-		p->post_write_date.tv_usec = tv.tv_usec;
-	}
-	else
-#endif
-    usleep(p->post_write_delay*1000); /* optional delay after last write */
-				   /* otherwise some yaesu rigs get confused */
-				   /* with sequential fast writes*/
-  }
   rig_debug(RIG_DEBUG_TRACE,"%s(): TX %d bytes\n", __func__, count);
   dump_hex((unsigned char *) txbuffer,count);
 
@@ -386,18 +611,22 @@ int HAMLIB_API read_block(hamlib_port_t *p, char *rxbuffer, size_t count)
 {
   fd_set rfds, efds;
   struct timeval tv, tv_timeout, start_time, end_time, elapsed_time;
+  struct timeval origin, first_time;
   int rd_count, total_count = 0;
-  int retval;
+  int retval, is_reply, timeout;
+
 
+  /* Store the time of the read loop start */
+  gettimeofday(&start_time, NULL);
+  is_reply = stats_read_start(p, &start_time, &origin);
+  first_time = start_time;
 
   /*
    * Wait up to timeout ms.
    */
-  tv_timeout.tv_sec = p->timeout/1000;
-  tv_timeout.tv_usec = (p->timeout%1000)*1000;
-
-  /* Store the time of the read loop start */
-  gettimeofday(&start_time, NULL);
+  timeout = reply_timeout(p, is_reply);
+  tv_timeout.tv_sec = timeout/1000;
+  tv_timeout.tv_usec = (timeout%1000)*1000;
 
   while (count > 0) {
 	tv = tv_timeout;	/* select may have updated it */
@@ -406,7 +635,7 @@ int HAMLIB_API read_block(hamlib_port_t *p, char *rxbuffer, size_t count)
 	FD_SET(p->fd, &rfds);
 	efds = rfds;
 
-	retval = port_select(p, p->fd+1, &rfds, NULL, &efds, &tv);
+	retval = io_select(p, p->fd+1, &rfds, NULL, &efds, &tv);
 	if (retval == 0) {
 		/* Record timeout time and caculate elapsed time */
 		gettimeofday(&end_time, NULL);
@@ -416,6 +645,9 @@ int HAMLIB_API read_block(hamlib_port_t *p, char *rxbuffer, size_t count)
 		rig_debug(RIG_DEBUG_WARN, "%s(): Timed out %d.%d seconds after %d chars\n",
 			  __func__, elapsed_time.tv_sec, elapsed_time.tv_usec, total_count);
 
+		p->stats.reads++;
+		p->stats.timeouts++;
+		reply_backoff(p, is_reply, 1);
 		return -RIG_ETIMEOUT;
 	}
 	if (retval < 0) {
@@ -423,12 +655,14 @@ int HAMLIB_API read_block(hamlib_port_t *p, char *rxbuffer, size_t count)
 		rig_debug(RIG_DEBUG_ERR,"%s(): select() error after %d chars: %s\n",
 			  __func__, total_count, strerror(errno));
 
+		p->stats.errors++;
 		return -RIG_EIO;
 	}
 	if (FD_ISSET(p->fd, &efds)) {
 		rig_debug(RIG_DEBUG_ERR, "%s(): fd error after %d chars\n",
 			  __func__, total_count);
 
+		p->stats.errors++;
 		return -RIG_EIO;
 	}
 
@@ -436,17 +670,23 @@ int HAMLIB_API read_block(hamlib_port_t *p, char *rxbuffer, size_t count)
 	 * grab bytes from the rig
 	 * The file descriptor must have been set up non blocking.
 	 */
-	rd_count = port_read(p, rxbuffer+total_count, count);
+	rd_count = io_read(p, rxbuffer+total_count, count);
 	if (rd_count < 0) {
 		rig_debug(RIG_DEBUG_ERR, "%s(): read() failed - %s\n",
 			  __func__, strerror(errno));
 
+		p->stats.errors++;
 		return -RIG_EIO;
 	}
+	if (total_count == 0 && rd_count > 0)
+		gettimeofday(&first_time, NULL);
 	total_count += rd_count;
 	count -= rd_count;
   }
 
+  stats_read_done(p, is_reply, &origin, &first_time, total_count);
+  reply_backoff(p, is_reply, 0);
+
   rig_debug(RIG_DEBUG_TRACE,"%s(): RX %d bytes\n", __func__, total_count);
   dump_hex((unsigned char *) rxbuffer, total_count);
 
@@ -484,17 +724,21 @@ int HAMLIB_API read_string(hamlib_port_t *p, char *rxbuffer, size_t rxmax, const
 {
   fd_set rfds, efds;
   struct timeval tv, tv_timeout, start_time, end_time, elapsed_time;
+  struct timeval origin, first_time;
   int rd_count, total_count = 0;
-  int retval;
+  int retval, is_reply, timeout;
+
+  /* Store the time of the read loop start */
+  gettimeofday(&start_time, NULL);
+  is_reply = stats_read_start(p, &start_time, &origin);
+  first_time = start_time;
 
   /*
    * Wait up to timeout ms.
    */
-  tv_timeout.tv_sec = p->timeout/1000;
-  tv_timeout.tv_usec = (p->timeout%1000)*1000;
-
-  /* Store the time of the read loop start */
-  gettimeofday(&start_time, NULL);
+  timeout = reply_timeout(p, is_reply);
+  tv_timeout.tv_sec = timeout/1000;
+  tv_timeout.tv_usec = (timeout%1000)*1000;
 
   while (total_count < rxmax-1) {
 	tv = tv_timeout;	/* select may have updated it */
@@ -503,21 +747,25 @@ int HAMLIB_API read_string(hamlib_port_t *p, char *rxbuffer, size_t rxmax, const
 	FD_SET(p->fd, &rfds);
 	efds = rfds;
 
-	retval = port_select(p, p->fd+1, &rfds, NULL, &efds, &tv);
-        if (retval == 0)    /* Timed out */
+	retval = io_select(p, p->fd+1, &rfds, NULL, &efds, &tv);
+        if (retval == 0) {   /* Timed out */
+            p->stats.timeouts++;
             break;
+        }
 
 	if (retval < 0) {
 		dump_hex((unsigned char *) rxbuffer, total_count);
 		rig_debug(RIG_DEBUG_ERR, "%s(): select() error after %d chars: %s\n",
 			  __func__, total_count, strerror(errno));
 
+		p->stats.errors++;
 		return -RIG_EIO;
 	}
 	if (FD_ISSET(p->fd, &efds)) {
 		rig_debug(RIG_DEBUG_ERR, "%s(): fd error after %d chars\n",
 			  __func__, total_count);
 
+		p->stats.errors++;
 		return -RIG_EIO;
 	}
 
@@ -525,14 +773,17 @@ int HAMLIB_API read_string(hamlib_port_t *p, char *rxbuffer, size_t rxmax, const
        	 * read 1 character from the rig, (check if in stop set)
 	 * The file descriptor must have been set up non blocking.
 	 */
-        rd_count = port_read(p, &rxbuffer[total_count], 1);
+        rd_count = io_read(p, &rxbuffer[total_count], 1);
 	if (rd_count < 0) {
 		dump_hex((unsigned char *) rxbuffer, total_count);
 		rig_debug(RIG_DEBUG_ERR, "%s(): read() failed - %s\n",
 			  __func__, strerror(errno));
 
+		p->stats.errors++;
 		return -RIG_EIO;
 	}
+	if (total_count == 0)
+		gettimeofday(&first_time, NULL);
         ++total_count;
 	if (stopset && memchr(stopset, rxbuffer[total_count-1], stopset_len))
 		break;
@@ -543,6 +794,9 @@ int HAMLIB_API read_string(hamlib_port_t *p, char *rxbuffer, size_t rxmax, const
    */
   rxbuffer[total_count] = '\000';
 
+  stats_read_done(p, is_reply, &origin, &first_time, total_count);
+  reply_backoff(p, is_reply, total_count == 0);
+
   if (total_count == 0) {
     /* Record timeout time and caculate elapsed time */
     gettimeofday(&end_time, NULL);
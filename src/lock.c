@@ -0,0 +1,133 @@
+/*
+ *  Hamlib Interface - locking
+ *  Copyright (c) 2026 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+
+#include <hamlib/rig.h>
+
+#include "lock.h"
+
+
+#ifdef HAVE_PTHREAD
+
+int hamlib_mutex_init(pthread_mutex_t *m)
+{
+	pthread_mutexattr_t attr;
+	int ret;
+
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	ret = pthread_mutex_init(m, &attr);
+	pthread_mutexattr_destroy(&attr);
+
+	return ret;
+}
+
+rig_ptr_t hamlib_lock_new(void)
+{
+	pthread_mutex_t *m;
+
+	m = malloc(sizeof(pthread_mutex_t));
+	if (!m)
+		return NULL;
+	if (hamlib_mutex_init(m) != 0) {
+		free(m);
+		return NULL;
+	}
+	return (rig_ptr_t)m;
+}
+
+void hamlib_lock_free(rig_ptr_t lock)
+{
+	if (!lock)
+		return;
+	pthread_mutex_destroy((pthread_mutex_t *)lock);
+	free(lock);
+}
+
+rig_ptr_t hamlib_lock(rig_ptr_t lock)
+{
+	if (lock)
+		pthread_mutex_lock((pthread_mutex_t *)lock);
+	return lock;
+}
+
+int hamlib_trylock(rig_ptr_t lock)
+{
+	if (!lock)
+		return 1;
+	return pthread_mutex_trylock((pthread_mutex_t *)lock) == 0;
+}
+
+void hamlib_unlock(rig_ptr_t lock)
+{
+	if (lock)
+		pthread_mutex_unlock((pthread_mutex_t *)lock);
+}
+
+#else	/* !HAVE_PTHREAD */
+
+rig_ptr_t hamlib_lock_new(void)
+{
+	return NULL;
+}
+
+void hamlib_lock_free(rig_ptr_t lock)
+{
+}
+
+rig_ptr_t hamlib_lock(rig_ptr_t lock)
+{
+	return lock;
+}
+
+int hamlib_trylock(rig_ptr_t lock)
+{
+	return 1;
+}
+
+void hamlib_unlock(rig_ptr_t lock)
+{
+}
+
+#endif	/* !HAVE_PTHREAD */
+
+HAMLIB_MUTEX(registry_lock)
+
+void hamlib_registry_lock(void)
+{
+	HAMLIB_MUTEX_LOCK(registry_lock);
+}
+
+void hamlib_registry_unlock(void)
+{
+	HAMLIB_MUTEX_UNLOCK(registry_lock);
+}
+
+/* cleanup handler of HANDLE_LOCK */
+void hamlib_unlock_scope(rig_ptr_t *lock)
+{
+	hamlib_unlock(*lock);
+}
@@ -0,0 +1,108 @@
+/*
+ *  Hamlib Interface - locking header
+ *  Copyright (c) 2026 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef _LOCK_H
+#define _LOCK_H 1
+
+#include <hamlib/rig.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+__BEGIN_DECLS
+
+/*
+ * All the locks are recursive: frontend functions call each other,
+ * and backends call back into the frontend, with the lock held.
+ *
+ * Global registries use a static mutex:
+ *
+ *	HAMLIB_MUTEX(list_lock)
+ *	...
+ *	HAMLIB_MUTEX_LOCK(list_lock);
+ *	...
+ *	HAMLIB_MUTEX_UNLOCK(list_lock);
+ *
+ * Without pthread, the locks compile to nothing.
+ */
+#ifdef HAVE_PTHREAD
+
+extern int hamlib_mutex_init(pthread_mutex_t *m);
+
+#define HAMLIB_MUTEX(m) \
+	static pthread_mutex_t m; \
+	static pthread_once_t m##_once = PTHREAD_ONCE_INIT; \
+	static void m##_init(void) { hamlib_mutex_init(&m); }
+#define HAMLIB_MUTEX_LOCK(m) \
+	(pthread_once(&m##_once, m##_init), pthread_mutex_lock(&m))
+#define HAMLIB_MUTEX_UNLOCK(m) pthread_mutex_unlock(&m)
+
+#else
+
+#define HAMLIB_MUTEX(m)
+#define HAMLIB_MUTEX_LOCK(m) ((void)0)
+#define HAMLIB_MUTEX_UNLOCK(m) ((void)0)
+
+#endif
+
+/*
+ * Rig and rotator registries, and backend loading (ltdl)
+ */
+extern void hamlib_registry_lock(void);
+extern void hamlib_registry_unlock(void);
+
+/*
+ * Per RIG/ROT handle lock, allocated by rig_init/rot_init.
+ * hamlib_trylock returns 1 when the lock has been acquired.
+ * None of them may be called from a signal handler.
+ */
+extern rig_ptr_t hamlib_lock_new(void);
+extern void hamlib_lock_free(rig_ptr_t lock);
+extern HAMLIB_EXPORT(rig_ptr_t) hamlib_lock(rig_ptr_t lock);
+extern HAMLIB_EXPORT(int) hamlib_trylock(rig_ptr_t lock);
+extern HAMLIB_EXPORT(void) hamlib_unlock(rig_ptr_t lock);
+extern void hamlib_unlock_scope(rig_ptr_t *lock);
+
+/*
+ * RIG_LOCK/ROT_LOCK lock the handle until the end of the enclosing
+ * block, whatever the return path. To be used in frontend entry
+ * points, once the handle has been checked.
+ *
+ * The thread safety of the handles needs the GCC cleanup attribute:
+ * without it, the applications have to serialize the calls themselves.
+ */
+#if defined(HAVE_PTHREAD) && defined(__GNUC__)
+#define HANDLE_LOCK(l) \
+	rig_ptr_t _handle_lock __attribute__((cleanup(hamlib_unlock_scope))) = hamlib_lock(l)
+#else
+#ifdef HAVE_PTHREAD
+#warning "no scoped cleanup without the GCC cleanup attribute, handles are not locked"
+#endif
+#define HANDLE_LOCK(l) do { } while (0)
+#endif
+
+#define RIG_LOCK(r) HANDLE_LOCK((r)->state.lock)
+#define ROT_LOCK(r) HANDLE_LOCK((r)->state.lock)
+
+__END_DECLS
+
+#endif /* _LOCK_H */
@@ -45,6 +45,7 @@
 #include <fcntl.h>
 
 #include <hamlib/rig.h>
+#include "lock.h"
 
 #ifndef DOC_HIDDEN
 
@@ -79,6 +80,8 @@ int HAMLIB_API rig_set_mem(RIG *rig, vfo_t vfo, int ch)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_mem == NULL)
@@ -125,6 +128,8 @@ int HAMLIB_API rig_get_mem(RIG *rig, vfo_t vfo, int *ch)
 	if (CHECK_RIG_ARG(rig) || !ch)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_mem == NULL)
@@ -173,6 +178,8 @@ int HAMLIB_API rig_set_bank(RIG *rig, vfo_t vfo, int bank)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_bank == NULL)
@@ -515,6 +522,8 @@ int HAMLIB_API rig_set_channel(RIG *rig, const channel_t *chan)
 	if (CHECK_RIG_ARG(rig) || !chan)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	/*
 	 * TODO: check validity of chan->channel_num
 	 */
@@ -638,6 +647,8 @@ int HAMLIB_API rig_get_channel(RIG *rig, channel_t *chan)
 	if (CHECK_RIG_ARG(rig) || !chan)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	/*
 	 * TODO: check validity of chan->channel_num
 	 */
@@ -830,6 +841,8 @@ int HAMLIB_API rig_set_chan_all_cb (RIG *rig, chan_cb_t chan_cb, rig_ptr_t arg)
 	if (CHECK_RIG_ARG(rig) || !chan_cb)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	rc = rig->caps;
 
 	if (rc->set_chan_all_cb)
@@ -870,6 +883,8 @@ int HAMLIB_API rig_get_chan_all_cb (RIG *rig, chan_cb_t chan_cb, rig_ptr_t arg)
 	if (CHECK_RIG_ARG(rig) || !chan_cb)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	rc = rig->caps;
 
 	if (rc->get_chan_all_cb)
@@ -905,6 +920,8 @@ int HAMLIB_API rig_set_chan_all (RIG *rig, const channel_t chans[])
 	if (CHECK_RIG_ARG(rig) || !chans)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	rc = rig->caps;
 	map_arg.chans = (channel_t *) chans;
 
@@ -941,6 +958,8 @@ int HAMLIB_API rig_get_chan_all (RIG *rig, channel_t chans[])
 	if (CHECK_RIG_ARG(rig) || !chans)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	rc = rig->caps;
 	map_arg.chans = chans;
 
@@ -1022,6 +1041,8 @@ int HAMLIB_API rig_set_mem_all_cb (RIG *rig, chan_cb_t chan_cb, confval_cb_t par
 	if (CHECK_RIG_ARG(rig) || !chan_cb)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	rc = rig->caps;
 
 	if (rc->set_mem_all_cb)
@@ -1072,6 +1093,8 @@ int HAMLIB_API rig_get_mem_all_cb (RIG *rig, chan_cb_t chan_cb, confval_cb_t par
 	if (CHECK_RIG_ARG(rig) || !chan_cb)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	rc = rig->caps;
 
 	if (rc->get_mem_all_cb)
@@ -1122,6 +1145,8 @@ int HAMLIB_API rig_set_mem_all (RIG *rig, const channel_t chans[], const struct
 	if (CHECK_RIG_ARG(rig) || !chans || !cfgps || !vals)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	rc = rig->caps;
 	mem_all_arg.chans = (channel_t *) chans;
 	mem_all_arg.cfgps = cfgps;
@@ -1174,6 +1199,8 @@ int HAMLIB_API rig_get_mem_all (RIG *rig, channel_t chans[], const struct confpa
 	if (CHECK_RIG_ARG(rig) || !chans || !cfgps || !vals)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	rc = rig->caps;
 	mem_all_arg.chans = chans;
 	mem_all_arg.cfgps = cfgps;
@@ -50,6 +50,8 @@
 #include <hamlib/rig.h>
 
 #include "misc.h"
+#include "numcodec.h"
+#include "misc_hash.h"
 
 /**
  * \brief Convert from binary to 4-bit BCD digits, little-endian
@@ -65,7 +67,7 @@
  * bcd_len is the number of BCD digits, usually 10 or 8 in 1-Hz units,
  * and 6 digits in 100-Hz units for Tx offset data.
  *
- * Hope the compiler will do a good job optimizing it (esp. w/the 64bit freq)
+ * Digits are converted two at a time through a lookup table.
  *
  * Returns a pointer to (unsigned char *)bcd_data.
  *
@@ -74,17 +76,13 @@
 unsigned char * HAMLIB_API to_bcd(unsigned char bcd_data[], unsigned long long freq, unsigned bcd_len)
 {
 	int i;
-	unsigned char a;
 
 	/* '450'/4-> 5,0;0,4 */
 	/* '450'/3-> 5,0;x,4 */
 
 	for (i=0; i < bcd_len/2; i++) {
-		a = freq%10;
-		freq /= 10;
-		a |= (freq%10)<<4;
-		freq /= 10;
-		bcd_data[i] = a;
+		bcd_data[i] = num_bin2bcd[freq%100];
+		freq /= 100;
 	}
 	if (bcd_len&1) {
 		bcd_data[i] &= 0xf0;
@@ -105,7 +103,7 @@ unsigned char * HAMLIB_API to_bcd(unsigned char bcd_data[], unsigned long long f
  *
  * bcd_len is the number of BCD digits.
  *
- * Hope the compiler will do a good job optimizing it (esp. w/ the 64bit freq)
+ * Digits are converted two at a time through a lookup table.
  *
  * Returns frequency in Hz an unsigned long long integer.
  *
@@ -114,17 +112,13 @@ unsigned char * HAMLIB_API to_bcd(unsigned char bcd_data[], unsigned long long f
 unsigned long long HAMLIB_API from_bcd(const unsigned char bcd_data[], unsigned bcd_len)
 {
 	int i;
-	freq_t f = 0;
+	unsigned long long f = 0;
 
 	if (bcd_len&1)
 		f = bcd_data[bcd_len/2] & 0x0f;
 
-	for (i=(bcd_len/2)-1; i >= 0; i--) {
-		f *= 10;
-		f += bcd_data[i]>>4;
-		f *= 10;
-		f += bcd_data[i] & 0x0f;
-	}
+	for (i=(bcd_len/2)-1; i >= 0; i--)
+		f = f*100 + num_bcd2bin[bcd_data[i]];
 
 	return f;
 }
@@ -144,7 +138,6 @@ unsigned long long HAMLIB_API from_bcd(const unsigned char bcd_data[], unsigned
 unsigned char * HAMLIB_API to_bcd_be(unsigned char bcd_data[], unsigned long long freq, unsigned bcd_len)
 {
 	int i;
-	unsigned char a;
 
 	/* '450'/4 -> 0,4;5,0 */
 	/* '450'/3 -> 4,5;0,x */
@@ -155,11 +148,8 @@ unsigned char * HAMLIB_API to_bcd_be(unsigned char bcd_data[], unsigned long lon
 		freq /= 10;
 	}
 	for (i=(bcd_len/2)-1; i >= 0; i--) {
-		a = freq%10;
-		freq /= 10;
-		a |= (freq%10)<<4;
-		freq /= 10;
-		bcd_data[i] = a;
+		bcd_data[i] = num_bin2bcd[freq%100];
+		freq /= 100;
 	}
 
 	return bcd_data;
@@ -179,14 +169,10 @@ unsigned char * HAMLIB_API to_bcd_be(unsigned char bcd_data[], unsigned long lon
 unsigned long long HAMLIB_API from_bcd_be(const unsigned char bcd_data[], unsigned bcd_len)
 {
 	int i;
-	freq_t f = 0;
+	unsigned long long f = 0;
 
-	for (i=0; i < bcd_len/2; i++) {
-		f *= 10;
-		f += bcd_data[i]>>4;
-		f *= 10;
-		f += bcd_data[i] & 0x0f;
-	}
+	for (i=0; i < bcd_len/2; i++)
+		f = f*100 + num_bcd2bin[bcd_data[i]];
 	if (bcd_len&1) {
 		f *= 10;
 		f += bcd_data[bcd_len/2]>>4;
@@ -254,6 +240,46 @@ const char * HAMLIB_API rig_strstatus(enum rig_status_e status)
 }
 
 
+/*
+ * The string tables below are looked up through the perfect hashes
+ * and bit position maps generated from this file by mkhash.awk.
+ */
+
+/* candidate table index of string s, -1 if none */
+static int strhash_slot(const char *s, const unsigned char *hash,
+				unsigned mult, unsigned size)
+{
+	unsigned h = 0;
+
+	for (; *s; s++)
+		h = (h * mult + (unsigned char)*s) & (size - 1);
+
+	return hash[h] - 1;
+}
+
+/* candidate table index of single bit value v, -1 if none */
+static int strhash_bit(unsigned long long v, const unsigned char *bit)
+{
+	int pos = 0;
+
+	if (v == 0 || (v & (v - 1)) != 0)
+		return -1;
+#ifdef __GNUC__
+	pos = __builtin_ctzll(v);
+#else
+	while (!(v & 1)) {
+		v >>= 1;
+		pos++;
+	}
+#endif
+	return bit[pos] - 1;
+}
+
+#define STRHASH_FIND(t, s) \
+	strhash_slot((s), t##_hash, t##_HASH_MULT, t##_HASH_SIZE)
+#define STRHASH_BIT(t, v) \
+	strhash_bit((unsigned long long)(v), t##_bit)
+
 static struct {
 		rmode_t mode;
 		const char *str;
@@ -290,11 +316,11 @@ static struct {
  */
 rmode_t HAMLIB_API rig_parse_mode(const char *s)
 {
-	int i;
+	int i = STRHASH_FIND(mode_str, s);
+
+	if (i >= 0 && !strcmp(s, mode_str[i].str))
+		return mode_str[i].mode;
 
-	for (i=0 ; mode_str[i].str[0] != '\0'; i++)
-			if (!strcmp(s, mode_str[i].str))
-					return mode_str[i].mode;
 	return RIG_MODE_NONE;
 }
 
@@ -312,9 +338,9 @@ const char * HAMLIB_API rig_strrmode(rmode_t mode)
 	if (mode == RIG_MODE_NONE)
 		return "";
 
-	for (i=0 ; mode_str[i].str[0] != '\0'; i++)
-		if (mode == mode_str[i].mode)
-			return mode_str[i].str;
+	i = STRHASH_BIT(mode_str, mode);
+	if (i >= 0 && mode == mode_str[i].mode)
+		return mode_str[i].str;
 
 	return "";
 }
@@ -345,11 +371,11 @@ static struct {
  */
 vfo_t HAMLIB_API rig_parse_vfo(const char *s)
 {
-	int i;
+	int i = STRHASH_FIND(vfo_str, s);
+
+	if (i >= 0 && !strcmp(s, vfo_str[i].str))
+		return vfo_str[i].vfo;
 
-	for (i=0 ; vfo_str[i].str[0] != '\0'; i++)
-		if (!strcmp(s, vfo_str[i].str))
-			return vfo_str[i].vfo;
 	return RIG_VFO_NONE;
 }
 
@@ -367,6 +393,11 @@ const char * HAMLIB_API rig_strvfo(vfo_t vfo)
 	if (vfo == RIG_VFO_NONE)
 		return "";
 
+	i = STRHASH_BIT(vfo_str, (unsigned)vfo);
+	if (i >= 0 && vfo == vfo_str[i].vfo)
+		return vfo_str[i].str;
+
+	/* composite values, e.g. RIG_VFO_TX */
 	for (i=0 ; vfo_str[i].str[0] != '\0'; i++)
 		if (vfo == vfo_str[i].vfo)
 			return vfo_str[i].str;
@@ -420,11 +451,10 @@ static struct {
  */
 setting_t HAMLIB_API rig_parse_func(const char *s)
 {
-	int i;
+	int i = STRHASH_FIND(func_str, s);
 
-	for (i=0 ; func_str[i].str[0] != '\0'; i++)
-		if (!strcmp(s, func_str[i].str))
-			return func_str[i].func;
+	if (i >= 0 && !strcmp(s, func_str[i].str))
+		return func_str[i].func;
 
 	return RIG_FUNC_NONE;
 }
@@ -443,9 +473,9 @@ const char * HAMLIB_API rig_strfunc(setting_t func)
 	if (func == RIG_FUNC_NONE)
 		return "";
 
-	for (i=0; func_str[i].str[0] != '\0'; i++)
-		if (func == func_str[i].func)
-			return func_str[i].str;
+	i = STRHASH_BIT(func_str, func);
+	if (i >= 0 && func == func_str[i].func)
+		return func_str[i].str;
 
 	return "";
 }
@@ -497,11 +527,10 @@ static struct {
  */
 setting_t HAMLIB_API rig_parse_level(const char *s)
 {
-	int i;
+	int i = STRHASH_FIND(level_str, s);
 
-	for (i=0 ; level_str[i].str[0] != '\0'; i++)
-		if (!strcmp(s, level_str[i].str))
-			return level_str[i].level;
+	if (i >= 0 && !strcmp(s, level_str[i].str))
+		return level_str[i].level;
 
 	return RIG_LEVEL_NONE;
 }
@@ -520,9 +549,9 @@ const char * HAMLIB_API rig_strlevel(setting_t level)
 	if (level == RIG_LEVEL_NONE)
 		return "";
 
-	for (i=0; level_str[i].str[0] != '\0'; i++)
-		if (level == level_str[i].level)
-			return level_str[i].str;
+	i = STRHASH_BIT(level_str, level);
+	if (i >= 0 && level == level_str[i].level)
+		return level_str[i].str;
 
 	return "";
 }
@@ -550,11 +579,10 @@ static struct {
  */
 setting_t HAMLIB_API rig_parse_parm(const char *s)
 {
-	int i;
+	int i = STRHASH_FIND(parm_str, s);
 
-	for (i=0 ; parm_str[i].str[0] != '\0'; i++)
-		if (!strcmp(s, parm_str[i].str))
-			return parm_str[i].parm;
+	if (i >= 0 && !strcmp(s, parm_str[i].str))
+		return parm_str[i].parm;
 
 	return RIG_PARM_NONE;
 }
@@ -573,9 +601,9 @@ const char * HAMLIB_API rig_strparm(setting_t parm)
 	if (parm == RIG_PARM_NONE)
 		return "";
 
-	for (i=0; parm_str[i].str[0] != '\0'; i++)
-		if (parm == parm_str[i].parm)
-			return parm_str[i].str;
+	i = STRHASH_BIT(parm_str, parm);
+	if (i >= 0 && parm == parm_str[i].parm)
+		return parm_str[i].str;
 
 	return "";
 }
@@ -609,11 +637,10 @@ static struct {
  */
 vfo_op_t HAMLIB_API rig_parse_vfo_op(const char *s)
 {
-	int i;
+	int i = STRHASH_FIND(vfo_op_str, s);
 
-	for (i=0 ; vfo_op_str[i].str[0] != '\0'; i++)
-		if (!strcmp(s, vfo_op_str[i].str))
-			return vfo_op_str[i].vfo_op;
+	if (i >= 0 && !strcmp(s, vfo_op_str[i].str))
+		return vfo_op_str[i].vfo_op;
 
 	return RIG_OP_NONE;
 }
@@ -632,9 +659,9 @@ const char * HAMLIB_API rig_strvfop(vfo_op_t op)
 	if (op == RIG_OP_NONE)
 		return "";
 
-	for (i=0; vfo_op_str[i].str[0] != '\0'; i++)
-		if (op == vfo_op_str[i].vfo_op)
-			return vfo_op_str[i].str;
+	i = STRHASH_BIT(vfo_op_str, op);
+	if (i >= 0 && op == vfo_op_str[i].vfo_op)
+		return vfo_op_str[i].str;
 
 	return "";
 }
@@ -663,13 +690,11 @@ static struct {
  */
 scan_t HAMLIB_API rig_parse_scan(const char *s)
 {
-	int i;
+	int i = STRHASH_FIND(scan_str, s);
+
+	if (i >= 0 && !strcmp(s, scan_str[i].str))
+		return scan_str[i].rscan;
 
-	for (i=0 ; scan_str[i].str[0] != '\0'; i++) {
-		if (strcmp(s, scan_str[i].str) == 0) {
-			return scan_str[i].rscan;
-		}
-	}
 	return RIG_SCAN_NONE;
 }
 
@@ -687,9 +712,10 @@ const char * HAMLIB_API rig_strscan(scan_t rscan)
 	if (rscan == RIG_SCAN_NONE)
 		return "";
 
-	for (i=0; scan_str[i].str[0] != '\0'; i++)
-		if (rscan == scan_str[i].rscan)
-			return scan_str[i].str;
+	i = STRHASH_BIT(scan_str, rscan);
+	if (i >= 0 && rscan == scan_str[i].rscan)
+		return scan_str[i].str;
+
 	return "";
 }
 
@@ -746,13 +772,11 @@ static struct {
  */
 chan_type_t HAMLIB_API rig_parse_mtype(const char *s)
 {
-	int i;
+	int i = STRHASH_FIND(mtype_str, s);
+
+	if (i >= 0 && !strcmp(s, mtype_str[i].str))
+		return mtype_str[i].mtype;
 
-	for (i=0 ; mtype_str[i].str[0] != '\0'; i++) {
-		if (strcmp(s, mtype_str[i].str) == 0) {
-			return mtype_str[i].mtype;
-		}
-	}
 	return RIG_MTYPE_NONE;
 }
 
@@ -770,9 +794,13 @@ const char * HAMLIB_API rig_strmtype(chan_type_t mtype)
 	if (mtype == RIG_MTYPE_NONE)
 		return "";
 
-	for (i=0; mtype_str[i].str[0] != '\0'; i++)
-		if (mtype == mtype_str[i].mtype)
-			return mtype_str[i].str;
+	if ((unsigned)mtype >= sizeof(mtype_str_idx))
+		return "";
+
+	i = mtype_str_idx[mtype] - 1;
+	if (i >= 0 && mtype == mtype_str[i].mtype)
+		return mtype_str[i].str;
+
 	return "";
 }
 
@@ -0,0 +1,158 @@
+#
+# mkhash.awk - generate lookup tables for the string tables of misc.c
+#
+# Reads misc.c, and for every table of the form
+#
+#	} xxx_str[] = {
+#		{ RIG_XXX_YYY, "YYY" },
+#		...
+#		{ RIG_XXX_NONE, "" },
+#	};
+#
+# emits:
+#  - xxx_str_hash[], a perfect hash of the strings to (table index + 1),
+#    of size xxx_str_HASH_SIZE (a power of 2) and multiplier
+#    xxx_str_HASH_MULT, see strhash_slot() in misc.c,
+#  - xxx_str_bit[], the (table index + 1) of each bit position value,
+#    or, for the tables listed in the "direct" variable, xxx_str_idx[],
+#    the (table index + 1) of each enum value.
+#
+# When several entries share a value, the first one wins, as it does
+# with a linear scan of the table.
+#
+# Usage: awk -v direct="mtype_str" -f mkhash.awk misc.c > misc_hash.h
+#
+
+function fail(msg) {
+	print "mkhash.awk: " msg > "/dev/stderr"
+	failed = 1
+	exit 1
+}
+
+function hash(s, mult, size,	h, i) {
+	h = 0
+	for (i = 1; i <= length(s); i++)
+		h = (h * mult + ord[substr(s, i, 1)]) % size
+	return h
+}
+
+# find a collision free (mult, size) for table t
+function perfect(t,	n, size, mult, i, h, used, ok) {
+	n = count[t]
+	for (size = 1; size < 2 * n; size *= 2)
+		;
+	for (; size <= 1024; size *= 2) {
+		for (mult = 1; mult < 4096; mult++) {
+			split("", used)
+			ok = 1
+			for (i = 0; i < n; i++) {
+				h = hash(name[t, i], mult, size)
+				if (h in used) {
+					ok = 0
+					break
+				}
+				used[h] = i
+			}
+			if (ok) {
+				hsize[t] = size
+				hmult[t] = mult
+				for (h = 0; h < size; h++)
+					slot[t, h] = (h in used) ? used[h] + 1 : 0
+				return
+			}
+		}
+	}
+	fail("no perfect hash found for " t)
+}
+
+function emit(t,	i, h, line, sep) {
+	perfect(t)
+
+	printf "\n/* %s */\n", t
+	printf "#define %s_HASH_MULT %d\n", t, hmult[t]
+	printf "#define %s_HASH_SIZE %d\n", t, hsize[t]
+	printf "static const unsigned char %s_hash[%s_HASH_SIZE] = {", t, t
+	for (h = 0; h < hsize[t]; h++) {
+		if (h % 16 == 0)
+			printf "\n\t"
+		else
+			printf " "
+		printf "%d,", slot[t, h]
+	}
+	printf "\n};\n"
+
+	# reverse order, so that the first entry of a value wins
+	if (t in is_direct) {
+		printf "static const unsigned char %s_idx[] = {\n", t
+		for (i = count[t] - 1; i >= 0; i--)
+			printf "\t[%s] = %d,\n", sym[t, i], i + 1
+	} else {
+		printf "static const unsigned char %s_bit[64] = {\n", t
+		for (i = count[t] - 1; i >= 0; i--)
+			printf "\t[STRHASH_BITPOS(%s)] = %d,\n", sym[t, i], i + 1
+	}
+	printf "};\n"
+}
+
+BEGIN {
+	for (i = 32; i < 127; i++)
+		ord[sprintf("%c", i)] = i
+	n = split(direct, d, /[ ,]+/)
+	for (i = 1; i <= n; i++)
+		is_direct[d[i]] = 1
+	ntables = 0
+	table = ""
+}
+
+/^} [a-z_]+_str\[\] = \{/ {
+	table = $2
+	sub(/\[\]$/, "", table)
+	tables[ntables++] = table
+	count[table] = 0
+	next
+}
+
+table != "" && /^};/ {
+	table = ""
+	next
+}
+
+table != "" && /^[ \t]*\{[ \t]*[A-Z_0-9]+[ \t]*,[ \t]*"/ {
+	line = $0
+	sub(/^[ \t]*\{[ \t]*/, "", line)
+	s = line
+	sub(/[ \t]*,.*$/, "", s)
+	str = line
+	sub(/^[^"]*"/, "", str)
+	sub(/".*$/, "", str)
+	if (str == "")
+		next
+	sym[table, count[table]] = s
+	name[table, count[table]] = str
+	count[table]++
+	if (count[table] > 255)
+		fail("table " table " too large")
+	next
+}
+
+END {
+	if (failed)
+		exit 1
+	if (ntables == 0)
+		fail("no table found")
+
+	print "/* Generated by mkhash.awk from misc.c, do not edit */"
+	print ""
+	print "/* bit position of a single bit constant, 63 for 0 */"
+	print "#define STRHASH_BP1(x)  (((x) & 0x1ULL) ? 0 : 1)"
+	print "#define STRHASH_BP2(x)  (((x) & 0x3ULL) ? STRHASH_BP1(x) : 2 + STRHASH_BP1((x) >> 2))"
+	print "#define STRHASH_BP4(x)  (((x) & 0xfULL) ? STRHASH_BP2(x) : 4 + STRHASH_BP2((x) >> 4))"
+	print "#define STRHASH_BP8(x)  (((x) & 0xffULL) ? STRHASH_BP4(x) : 8 + STRHASH_BP4((x) >> 8))"
+	print "#define STRHASH_BP16(x) (((x) & 0xffffULL) ? STRHASH_BP8(x) : 16 + STRHASH_BP8((x) >> 16))"
+	print "#define STRHASH_BITPOS(x) ((((unsigned long long)(x)) & 0xffffffffULL) ? \\"
+	print "\tSTRHASH_BP16((unsigned long long)(x)) : \\"
+	print "\t32 + STRHASH_BP16(((unsigned long long)(x)) >> 32))"
+
+	for (i = 0; i < ntables; i++)
+		emit(tables[i])
+}
@@ -70,12 +70,72 @@
 static int wsstarted;
 #endif
 
+static int is_multicast(const struct sockaddr *sa)
+{
+	if (sa->sa_family == AF_INET)
+		return IN_MULTICAST(ntohl(((const struct sockaddr_in *)sa)->sin_addr.s_addr));
+#ifdef IN6_IS_ADDR_MULTICAST
+	if (sa->sa_family == AF_INET6)
+		return IN6_IS_ADDR_MULTICAST(&((const struct sockaddr_in6 *)sa)->sin6_addr);
+#endif
+	return 0;
+}
+
+/*
+ * Bind the UDP socket to the group port and join the group
+ * on the default interface.
+ */
+static int network_join_group(int fd, const struct sockaddr *sa, socklen_t salen)
+{
+	int reuseaddr = 1;
+
+	if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR,
+				(char *)&reuseaddr, sizeof(reuseaddr)) < 0)
+		return -1;
+
+	if (sa->sa_family == AF_INET) {
+		struct sockaddr_in any;
+		struct ip_mreq mreq;
+
+		memcpy(&any, sa, sizeof(any));
+		any.sin_addr.s_addr = htonl(INADDR_ANY);
+		if (bind(fd, (struct sockaddr *)&any, sizeof(any)) < 0)
+			return -1;
+
+		mreq.imr_multiaddr = ((const struct sockaddr_in *)sa)->sin_addr;
+		mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+		return setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP,
+				(char *)&mreq, sizeof(mreq));
+	}
+#ifdef IPV6_JOIN_GROUP
+	if (sa->sa_family == AF_INET6) {
+		struct sockaddr_in6 any;
+		struct ipv6_mreq mreq;
+
+		memcpy(&any, sa, sizeof(any));
+		any.sin6_addr = in6addr_any;
+		if (bind(fd, (struct sockaddr *)&any, sizeof(any)) < 0)
+			return -1;
+
+		mreq.ipv6mr_multiaddr = ((const struct sockaddr_in6 *)sa)->sin6_addr;
+		mreq.ipv6mr_interface = 0;
+		return setsockopt(fd, IPPROTO_IPV6, IPV6_JOIN_GROUP,
+				(char *)&mreq, sizeof(mreq));
+	}
+#endif
+	errno = EAFNOSUPPORT;
+	return -1;
+}
+
 /**
  * \brief Open network port using rig.state data
  *
  * Open Open network port using rig.state data.
  * NB: The signal PIPE will be ignored for the whole application.
  *
+ * A UDP port whose address is a multicast group is not connected,
+ * but bound to the group port, receiving the datagrams sent to the group.
+ *
  * \param rp Port data structure (must spec port id eg hostname:port)
  * \param default_port Default network socket port
  * \return RIG_OK or < 0 if error
@@ -138,6 +198,20 @@ int network_open(hamlib_port_t *rp, int default_port)
 	if (fd < 0)
 		return -RIG_EIO;
 
+	if (rp->type.rig == RIG_PORT_UDP_NETWORK && is_multicast(res->ai_addr)) {
+		/* listen to the group rather than connecting to it */
+		status = network_join_group(fd, res->ai_addr, res->ai_addrlen);
+		freeaddrinfo(res);
+		if (status < 0) {
+			rig_debug(RIG_DEBUG_ERR, "Cannot join multicast group \"%s\": %s\n",
+					rp->pathname, strerror(errno));
+			close(fd);
+			return -RIG_EIO;
+		}
+		rp->fd = fd;
+		return RIG_OK;
+	}
+
 	status = connect(fd, res->ai_addr, res->ai_addrlen);
 	freeaddrinfo(res);
 	if (status < 0) {
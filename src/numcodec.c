@@ -0,0 +1,233 @@
+/*
+ *  Hamlib Interface - numeric field codec
+ *  Copyright (c) 2026 by the Hamlib Group
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/**
+ * \addtogroup rig_internal
+ * @{
+ */
+
+/**
+ * \file numcodec.c
+ * \brief Locale independent numeric field codec
+ *
+ * The CAT protocols carry frequencies and levels as fixed width
+ * decimal or BCD fields. These routines encode and decode them
+ * without going through the locale aware, format parsing,
+ * sprintf/sscanf family.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <hamlib/rig.h>
+
+#include "numcodec.h"
+
+/* ASCII digit pairs, "00" to "99" */
+#define DEC_ROW(t) #t"0" #t"1" #t"2" #t"3" #t"4" #t"5" #t"6" #t"7" #t"8" #t"9"
+static const char dec_pairs[201] =
+	DEC_ROW(0) DEC_ROW(1) DEC_ROW(2) DEC_ROW(3) DEC_ROW(4)
+	DEC_ROW(5) DEC_ROW(6) DEC_ROW(7) DEC_ROW(8) DEC_ROW(9);
+
+/* binary 0..99 to packed BCD */
+#define BIN_ROW(t) \
+	(t<<4)|0, (t<<4)|1, (t<<4)|2, (t<<4)|3, (t<<4)|4, \
+	(t<<4)|5, (t<<4)|6, (t<<4)|7, (t<<4)|8, (t<<4)|9
+const unsigned char num_bin2bcd[100] = {
+	BIN_ROW(0), BIN_ROW(1), BIN_ROW(2), BIN_ROW(3), BIN_ROW(4),
+	BIN_ROW(5), BIN_ROW(6), BIN_ROW(7), BIN_ROW(8), BIN_ROW(9)
+};
+
+/*
+ * packed BCD to binary, high*10+low, which is also what the
+ * former byte loops computed for out of range nibbles
+ */
+#define BCD_ROW(h) \
+	h*10+0, h*10+1, h*10+2, h*10+3, h*10+4, h*10+5, h*10+6, h*10+7, \
+	h*10+8, h*10+9, h*10+10, h*10+11, h*10+12, h*10+13, h*10+14, h*10+15
+const unsigned char num_bcd2bin[256] = {
+	BCD_ROW(0), BCD_ROW(1), BCD_ROW(2), BCD_ROW(3),
+	BCD_ROW(4), BCD_ROW(5), BCD_ROW(6), BCD_ROW(7),
+	BCD_ROW(8), BCD_ROW(9), BCD_ROW(10), BCD_ROW(11),
+	BCD_ROW(12), BCD_ROW(13), BCD_ROW(14), BCD_ROW(15)
+};
+
+static const unsigned long long pow10_tab[20] = {
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+	10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+	100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+	100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+	100000000000000000ULL, 1000000000000000000ULL,
+	10000000000000000000ULL
+};
+
+#define isblank_c(c) ((c) == ' ' || (c) == '\t')
+
+/**
+ * \brief Encode a decimal field
+ * \param buf	The destination, at least max(width,20)+1 long
+ * \param val	The value to encode
+ * \param width	The minimum number of digits
+ * \return a pointer to the terminating NUL
+ *
+ * Writes \a val in ASCII digits, zero padded on the left to
+ * \a width digits, like sprintf "%0*llu" would.
+ */
+char * HAMLIB_API num_to_dec(char *buf, unsigned long long val, unsigned width)
+{
+	unsigned n = 1, d;
+	char *p, *end;
+
+	while (n < 20 && val >= pow10_tab[n])
+		n++;
+	if (n < width)
+		n = width;
+
+	p = end = buf + n;
+	*p = '\0';
+	while (p - buf >= 2) {
+		d = (unsigned)(val % 100) * 2;
+		val /= 100;
+		p -= 2;
+		p[0] = dec_pairs[d];
+		p[1] = dec_pairs[d+1];
+	}
+	if (p > buf)
+		*--p = '0' + (char)(val % 10);
+
+	return end;
+}
+
+/**
+ * \brief Decode a fixed width decimal field
+ * \param buf	The field
+ * \param width	The number of characters of the field
+ * \param val	The location where to store the value
+ * \return RIG_OK, or -RIG_EPROTO if the field is not made of digits
+ *
+ * Leading blanks are accepted.
+ */
+int HAMLIB_API num_from_dec(const char *buf, unsigned width, unsigned long long *val)
+{
+	unsigned long long v = 0;
+	unsigned i = 0, d;
+
+	while (i < width && isblank_c(buf[i]))
+		i++;
+	if (i == width)
+		return -RIG_EPROTO;
+
+	for (; i < width; i++) {
+		d = (unsigned char)buf[i] - '0';
+		if (d > 9)
+			return -RIG_EPROTO;
+		v = v*10 + d;
+	}
+	*val = v;
+
+	return RIG_OK;
+}
+
+/**
+ * \brief Decode a variable length frequency field
+ * \param buf	The NUL terminated field
+ * \param freq	The location where to store the frequency
+ * \return the number of characters consumed, or -RIG_EPROTO if no digit
+ *
+ * Accepts what sscanf "%"SCNfreq does for plain decimal numbers,
+ * the decimal point always being '.' whatever the locale.
+ */
+int HAMLIB_API num_scan_freq(const char *buf, freq_t *freq)
+{
+	const char *p = buf, *digits;
+	unsigned long long v = 0;
+	double frac = 0, scale = 1;
+	unsigned d;
+	int neg = 0;
+
+	while (isblank_c(*p))
+		p++;
+	if (*p == '-' || *p == '+')
+		neg = *p++ == '-';
+
+	for (digits = p; (d = (unsigned char)*p - '0') <= 9; p++)
+		v = v*10 + d;
+	if (*p == '.') {
+		for (p++; (d = (unsigned char)*p - '0') <= 9; p++) {
+			scale /= 10;
+			frac += d * scale;
+		}
+	}
+	if (p == digits || (p == digits+1 && *digits == '.'))
+		return -RIG_EPROTO;
+
+	*freq = (freq_t)v + frac;
+	if (neg)
+		*freq = -*freq;
+
+	return p - buf;
+}
+
+/**
+ * \brief Print a fixed-point decimal number
+ * \param buf	The destination, at least 23 characters long
+ * \param val	The value, in units of 10^-decimals
+ * \param decimals	The number of decimals
+ * \return the length of the string, or -RIG_EINVAL
+ *
+ * E.g. 14074000 Hz with 6 decimals prints as "14.074000" MHz,
+ * with a '.' decimal point whatever the locale.
+ */
+int HAMLIB_API num_to_fixed(char *buf, long long val, unsigned decimals)
+{
+	char digits[24], *p = buf;
+	unsigned long long v;
+	unsigned n;
+
+	if (decimals > 19)
+		return -RIG_EINVAL;
+
+	if (val < 0) {
+		*p++ = '-';
+		v = -(unsigned long long)val;
+	} else {
+		v = val;
+	}
+
+	/* at least one digit before the decimal point */
+	n = num_to_dec(digits, v, decimals + 1) - digits;
+
+	memcpy(p, digits, n - decimals);
+	p += n - decimals;
+	if (decimals > 0) {
+		*p++ = '.';
+		memcpy(p, digits + n - decimals, decimals);
+		p += decimals;
+	}
+	*p = '\0';
+
+	return p - buf;
+}
+
+/** @} */
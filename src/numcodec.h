@@ -0,0 +1,54 @@
+/*
+ *  Hamlib Interface - numeric field codec header
+ *  Copyright (c) 2026 by the Hamlib Group
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef _NUMCODEC_H
+#define _NUMCODEC_H 1
+
+#include <hamlib/rig.h>
+
+__BEGIN_DECLS
+
+/*
+ * Locale independent encoding and decoding of the numeric fields
+ * found in CAT protocols, for use by the backends instead of
+ * sprintf/sscanf in the polling paths.
+ *
+ * num_to_dec writes ASCII digits zero padded to width, like
+ *	sprintf "%0*llu", and returns a pointer to the ending NUL.
+ * num_from_dec reads exactly width digits (leading blanks allowed).
+ * num_scan_freq reads a variable length field, like sscanf
+ *	"%"SCNfreq would, and returns the number of characters consumed.
+ * num_to_fixed prints val/10^decimals with a '.' decimal point,
+ *	and returns the length of the string.
+ *
+ * Decoders return -RIG_EPROTO on malformed input.
+ */
+extern HAMLIB_EXPORT(char *) num_to_dec(char *buf, unsigned long long val, unsigned width);
+extern HAMLIB_EXPORT(int) num_from_dec(const char *buf, unsigned width, unsigned long long *val);
+extern HAMLIB_EXPORT(int) num_scan_freq(const char *buf, freq_t *freq);
+extern HAMLIB_EXPORT(int) num_to_fixed(char *buf, long long val, unsigned decimals);
+
+/* Hamlib internal use, BCD lookup tables for misc.c */
+extern const unsigned char num_bin2bcd[100];
+extern const unsigned char num_bcd2bin[256];
+
+__END_DECLS
+
+#endif /* _NUMCODEC_H */
@@ -37,11 +37,17 @@
 #include <stdio.h>
 #include <sys/types.h>
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
 /* This is libtool's dl wrapper */
 #include <ltdl.h>
 
 #include <hamlib/rig.h>
 
+#include "lock.h"
+
 #ifndef PATH_MAX
 # define PATH_MAX       1024
 #endif
@@ -55,12 +61,22 @@
  * that is backend that were not known by Hamlib at compile time.
  * Maybe, riglist.h should reserve some numbers for them? --SF
  */
+typedef rig_model_t (* be_probe_all_t)(hamlib_port_t*, rig_probe_func_t, rig_ptr_t);
+
 static struct {
 	int be_num;
 	const char *be_name;
-	rig_model_t (* be_probe_all)(hamlib_port_t*, rig_probe_func_t, rig_ptr_t);
+	be_probe_all_t be_probe_all;
 } rig_backend_list[RIG_BACKEND_MAX] = RIG_BACKEND_LIST;
 
+/*
+ * Probing order of the backends, most likely first.
+ * These ones send a single command per baud rate, whereas icom
+ * goes through all the CI-V addresses, hence is kept for the end.
+ * The backends not listed here are probed afterwards.
+ */
+static const char *probe_order[] = { "kenwood", "yaesu", "uniden", "icom", NULL };
+
 /*
  * This struct to keep track of known rig models.
  * It is chained, and used in a hash table, see below.
@@ -96,21 +112,28 @@ int HAMLIB_API rig_register(const struct rig_caps *caps)
 
 	rig_debug(RIG_DEBUG_VERBOSE, "rig_register (%d)\n",caps->rig_model);
 
-#ifndef DONT_WANT_DUP_CHECK
-	if (rig_get_caps(caps->rig_model)!=NULL)
-		return -RIG_EINVAL;
-#endif
-
 	p = (struct rig_list*)malloc(sizeof(struct rig_list));
 	if (!p)
 		return -RIG_ENOMEM;
 
+	hamlib_registry_lock();
+
+#ifndef DONT_WANT_DUP_CHECK
+	if (rig_get_caps(caps->rig_model)!=NULL) {
+		hamlib_registry_unlock();
+		free(p);
+		return -RIG_EINVAL;
+	}
+#endif
+
 	hval = HASH_FUNC(caps->rig_model);
 	p->caps = caps;
 	p->handle = NULL;
 	p->next = rig_hash_table[hval];
 	rig_hash_table[hval] = p;
 
+	hamlib_registry_unlock();
+
 	return RIG_OK;
 }
 
@@ -122,13 +145,18 @@ int HAMLIB_API rig_register(const struct rig_caps *caps)
 const struct rig_caps * HAMLIB_API rig_get_caps(rig_model_t rig_model)
 {
 	struct rig_list *p;
+	const struct rig_caps *caps = NULL;
 
+	hamlib_registry_lock();
 	for (p = rig_hash_table[HASH_FUNC(rig_model)]; p; p=p->next) {
-		if (p->caps->rig_model == rig_model)
-			return p->caps;
+		if (p->caps->rig_model == rig_model) {
+			caps = p->caps;
+			break;
+		}
 	}
+	hamlib_registry_unlock();
 
-	return NULL;	/* sorry, caps not registered! */
+	return caps;	/* NULL if caps not registered! */
 }
 
 /*
@@ -161,10 +189,13 @@ int HAMLIB_API rig_check_backend(rig_model_t rig_model)
 	int be_idx;
 	int retval;
 
-	/* already loaded ? */
+	/* already loaded ? loaded at most once, by the first rig_init */
+	hamlib_registry_lock();
 	caps = rig_get_caps(rig_model);
-	if (caps)
+	if (caps) {
+		hamlib_registry_unlock();
 		return RIG_OK;
+	}
 
 	be_idx = rig_lookup_backend(rig_model);
 
@@ -175,11 +206,14 @@ int HAMLIB_API rig_check_backend(rig_model_t rig_model)
 		rig_debug(RIG_DEBUG_VERBOSE, "rig_check_backend: unsupported "
 					"backend %d for model %d\n",
 					RIG_BACKEND_NUM(rig_model), rig_model);
+		hamlib_registry_unlock();
 		return -RIG_ENAVAIL;
 	}
 
 	retval = rig_load_backend(rig_backend_list[be_idx].be_name);
 
+	hamlib_registry_unlock();
+
 	return retval;
 }
 
@@ -192,6 +226,7 @@ int HAMLIB_API rig_unregister(rig_model_t rig_model)
 
 	hval = HASH_FUNC(rig_model);
 	q = NULL;
+	hamlib_registry_lock();
 	for (p = rig_hash_table[hval]; p; p=p->next) {
 		if (p->caps->rig_model == rig_model) {
 			if (q == NULL)
@@ -199,11 +234,13 @@ int HAMLIB_API rig_unregister(rig_model_t rig_model)
 			else
 				q->next = p->next;
 
+			hamlib_registry_unlock();
 			free(p);
 			return RIG_OK;
 		}
 		q = p;
 	}
+	hamlib_registry_unlock();
 
 	return -RIG_EINVAL;	/* sorry, caps not registered! */
 }
@@ -220,11 +257,15 @@ int HAMLIB_API rig_list_foreach(int (*cfunc)(const struct rig_caps*, rig_ptr_t),
 	if (!cfunc)
 		return -RIG_EINVAL;
 
+	hamlib_registry_lock();
 	for (i=0; i<RIGLSTHASHSZ; i++) {
 		for (p=rig_hash_table[i]; p; p=p->next)
-			if ((*cfunc)(p->caps,data) == 0)
+			if ((*cfunc)(p->caps,data) == 0) {
+				hamlib_registry_unlock();
 				return RIG_OK;
+			}
 	}
+	hamlib_registry_unlock();
 
 	return RIG_OK;
 }
@@ -235,22 +276,55 @@ static int dummy_rig_probe(const hamlib_port_t *p, rig_model_t model, rig_ptr_t
 	return RIG_OK;
 }
 
+/*
+ * Copy the probe functions of the loaded backends, in probing order,
+ * so that no lock is held while probing.
+ */
+static int get_probe_funcs(be_probe_all_t funcs[RIG_BACKEND_MAX])
+{
+	int i, j, n = 0;
+
+	hamlib_registry_lock();
+
+	for (j=0; probe_order[j]; j++) {
+		for (i=0; i<RIG_BACKEND_MAX && rig_backend_list[i].be_name; i++) {
+			if (rig_backend_list[i].be_probe_all &&
+					!strcmp(rig_backend_list[i].be_name, probe_order[j]))
+				funcs[n++] = rig_backend_list[i].be_probe_all;
+		}
+	}
+	for (i=0; i<RIG_BACKEND_MAX && rig_backend_list[i].be_name; i++) {
+		if (!rig_backend_list[i].be_probe_all)
+			continue;
+		for (j=0; probe_order[j]; j++)
+			if (!strcmp(rig_backend_list[i].be_name, probe_order[j]))
+				break;
+		if (!probe_order[j])
+			funcs[n++] = rig_backend_list[i].be_probe_all;
+	}
+
+	hamlib_registry_unlock();
+
+	return n;
+}
+
 /*
  * rig_probe_first
  * called straight by rig_probe
  */
 rig_model_t rig_probe_first(hamlib_port_t *p)
 {
-	int i;
+	be_probe_all_t funcs[RIG_BACKEND_MAX];
+	int i, n;
 	rig_model_t model;
 
-	for (i=0; i<RIG_BACKEND_MAX && rig_backend_list[i].be_name; i++) {
-		if (rig_backend_list[i].be_probe_all) {
-			model = (*rig_backend_list[i].be_probe_all)(p, dummy_rig_probe, (rig_ptr_t)NULL);
-			/* stop at first one found */
-			if (model != RIG_MODEL_NONE)
-				return model;
-		}
+	n = get_probe_funcs(funcs);
+
+	for (i=0; i<n; i++) {
+		model = (*funcs[i])(p, dummy_rig_probe, (rig_ptr_t)NULL);
+		/* stop at first one found */
+		if (model != RIG_MODEL_NONE)
+			return model;
 	}
 	return RIG_MODEL_NONE;
 }
@@ -261,14 +335,132 @@ rig_model_t rig_probe_first(hamlib_port_t *p)
  */
 int rig_probe_all_backends(hamlib_port_t *p, rig_probe_func_t cfunc, rig_ptr_t data)
 {
+	be_probe_all_t funcs[RIG_BACKEND_MAX];
+	int i, n;
+
+	n = get_probe_funcs(funcs);
+
+	for (i=0; i<n; i++)
+		(*funcs[i])(p, cfunc, data);
+
+	return RIG_OK;
+}
+
+/*
+ * State shared by the workers of rig_probe_ports_backends
+ */
+struct probe_ports {
+	be_probe_all_t funcs[RIG_BACKEND_MAX];
+	int nfuncs;
+	rig_probe_func_t cfunc;
+	rig_ptr_t data;
+	int found;
+#ifdef HAVE_PTHREAD
+	pthread_mutex_t mutex;	/* serializes cfunc calls and found */
+#endif
+};
+
+struct probe_job {
+	struct probe_ports *pp;
+	hamlib_port_t *port;
+#ifdef HAVE_PTHREAD
+	pthread_t thread;
+	int started;
+#endif
+};
+
+/* the user callback is never called concurrently */
+static int probe_ports_cb(const hamlib_port_t *p, rig_model_t model, rig_ptr_t data)
+{
+	struct probe_ports *pp = (struct probe_ports *)data;
+	int ret = RIG_OK;
+
+#ifdef HAVE_PTHREAD
+	pthread_mutex_lock(&pp->mutex);
+#endif
+	if (pp->cfunc)
+		ret = (*pp->cfunc)(p, model, pp->data);
+#ifdef HAVE_PTHREAD
+	pthread_mutex_unlock(&pp->mutex);
+#endif
+
+	return ret;
+}
+
+/* probe one port, stopping at the first backend identifying a rig */
+static void *probe_port(void *arg)
+{
+	struct probe_job *job = (struct probe_job *)arg;
+	struct probe_ports *pp = job->pp;
+	rig_model_t model = RIG_MODEL_NONE;
 	int i;
 
-	for (i=0; i<RIG_BACKEND_MAX && rig_backend_list[i].be_name; i++) {
-		if (rig_backend_list[i].be_probe_all) {
-			(*rig_backend_list[i].be_probe_all)(p, cfunc, data);
+	for (i=0; i<pp->nfuncs && model == RIG_MODEL_NONE; i++)
+		model = (*pp->funcs[i])(job->port, probe_ports_cb, (rig_ptr_t)pp);
+
+	if (model != RIG_MODEL_NONE) {
+#ifdef HAVE_PTHREAD
+		pthread_mutex_lock(&pp->mutex);
+#endif
+		pp->found++;
+#ifdef HAVE_PTHREAD
+		pthread_mutex_unlock(&pp->mutex);
+#endif
+	}
+
+	return NULL;
+}
+
+/*
+ * rig_probe_ports_backends
+ * called straight by rig_probe_ports
+ *
+ * One worker thread per port. Should a thread fail to start,
+ * its port is probed by the calling thread.
+ */
+int rig_probe_ports_backends(hamlib_port_t ports[], int n, rig_probe_func_t cfunc, rig_ptr_t data)
+{
+	struct probe_ports pp;
+	struct probe_job *jobs;
+	int i;
+
+	jobs = calloc(n, sizeof(struct probe_job));
+	if (!jobs)
+		return -RIG_ENOMEM;
+
+	pp.nfuncs = get_probe_funcs(pp.funcs);
+	pp.cfunc = cfunc;
+	pp.data = data;
+	pp.found = 0;
+#ifdef HAVE_PTHREAD
+	pthread_mutex_init(&pp.mutex, NULL);
+#endif
+
+	for (i=0; i<n; i++) {
+		jobs[i].pp = &pp;
+		jobs[i].port = &ports[i];
+#ifdef HAVE_PTHREAD
+		jobs[i].started = pthread_create(&jobs[i].thread, NULL,
+					probe_port, &jobs[i]) == 0;
+#endif
+	}
+
+	for (i=0; i<n; i++) {
+#ifdef HAVE_PTHREAD
+		if (jobs[i].started) {
+			pthread_join(jobs[i].thread, NULL);
+			continue;
 		}
+#endif
+		probe_port(&jobs[i]);
 	}
-	return RIG_OK;
+
+#ifdef HAVE_PTHREAD
+	pthread_mutex_destroy(&pp.mutex);
+#endif
+	free(jobs);
+
+	return pp.found;
 }
 
 
@@ -311,7 +503,7 @@ static int rig_check_backend_version(const lt_dlhandle be_handle, const char *be
  * rig_load_backend
  * Dynamically load a rig backend through dlopen mechanism
  */
-int HAMLIB_API rig_load_backend(const char *be_name)
+static int do_rig_load_backend(const char *be_name)
 {
 # define PREFIX "hamlib-"
 
@@ -386,3 +578,14 @@ int HAMLIB_API rig_load_backend(const char *be_name)
  	return status;
 }
 
+int HAMLIB_API rig_load_backend(const char *be_name)
+{
+	int status;
+
+	hamlib_registry_lock();
+	status = do_rig_load_backend(be_name);
+	hamlib_registry_unlock();
+
+	return status;
+}
+
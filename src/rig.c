@@ -35,6 +35,11 @@
  * Hamlib provides a user-callable API, a set of "front-end" routines that
  * call rig-specific "back-end" routines which actually communicate with
  * the physical rig.
+ *
+ * A handle may be used from several threads when Hamlib is built with
+ * pthread and a compiler supporting the GCC cleanup attribute (GCC, clang),
+ * the front-end routines locking it for the duration of the call.
+ * Otherwise, the application has to serialize the calls on each handle.
  */
 
 /*! \page rig Rig (radio) interface
@@ -58,6 +63,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <sys/time.h>
 
 
 #include "hamlib/rig.h"
@@ -67,6 +73,7 @@
 #include "network.h"
 #include "event.h"
 #include "cm108.h"
+#include "lock.h"
 
 /**
  * \brief Hamlib release number
@@ -136,6 +143,7 @@ struct opened_rig_l {
 		struct opened_rig_l *next;
 };
 static struct opened_rig_l *opened_rig_list = { NULL };
+HAMLIB_MUTEX(opened_rig_lock)
 
 /*
  * Careful, the order must be the same as their RIG_E* counterpart!
@@ -177,8 +185,10 @@ static int add_opened_rig(RIG *rig)
 	if (!p)
 		return -RIG_ENOMEM;
 	p->rig = rig;
+	HAMLIB_MUTEX_LOCK(opened_rig_lock);
 	p->next = opened_rig_list;
 	opened_rig_list = p;
+	HAMLIB_MUTEX_UNLOCK(opened_rig_lock);
 
 	return RIG_OK;
 }
@@ -188,6 +198,7 @@ static int remove_opened_rig(RIG *rig)
 	struct opened_rig_l *p,*q;
 	q = NULL;
 
+	HAMLIB_MUTEX_LOCK(opened_rig_lock);
 	for (p=opened_rig_list; p; p=p->next) {
 		if (p->rig == rig) {
 			if (q == NULL) {
@@ -195,11 +206,13 @@ static int remove_opened_rig(RIG *rig)
 			} else {
 				q->next = p->next;
 			}
+			HAMLIB_MUTEX_UNLOCK(opened_rig_lock);
 			free(p);
 			return RIG_OK;
 		}
 		q = p;
 	}
+	HAMLIB_MUTEX_UNLOCK(opened_rig_lock);
 	return -RIG_EINVAL;	/* Not found in list ! */
 }
 
@@ -217,6 +230,8 @@ static int remove_opened_rig(RIG *rig)
  *  If \a data is not needed, then it can be set to NULL.
  *  The processing of the opened rig table is stopped
  *  when cfunc() returns 0.
+ *  With pthread, the table is locked meanwhile, so it is called from
+ *  the event thread, not from the signal handlers.
  * \internal
  *
  * \return always RIG_OK.
@@ -226,10 +241,13 @@ int foreach_opened_rig(int (*cfunc)(RIG *, rig_ptr_t), rig_ptr_t data)
 {
 	struct opened_rig_l *p;
 
+	HAMLIB_MUTEX_LOCK(opened_rig_lock);
+
 	for (p=opened_rig_list; p; p=p->next) {
 		if ((*cfunc)(p->rig,data) == 0)
-			return RIG_OK;
+			break;
 	}
+	HAMLIB_MUTEX_UNLOCK(opened_rig_lock);
 	return RIG_OK;
 }
 
@@ -298,6 +316,8 @@ RIG * HAMLIB_API rig_init(rig_model_t rig_model)
            that we now what we are doing */
 	rig->caps = (struct rig_caps *) caps;
 
+	rig->state.lock = hamlib_lock_new();
+
 	/*
 	 * populate the rig->state
 	 * TODO: read the Preferences here!
@@ -349,25 +369,27 @@ RIG * HAMLIB_API rig_init(rig_model_t rig_model)
 	rs->vfo_comp = 0.0;	/* override it with preferences */
 	rs->current_vfo = RIG_VFO_CURR;	/* we don't know yet! */
 	rs->tx_vfo = RIG_VFO_CURR;	/* we don't know yet! */
+	rs->current_ptt = RIG_PTT_OFF;
 	rs->transceive = RIG_TRN_OFF;
 	rs->poll_interval = 500;
 	/* should it be a parameter to rig_init ? --SF */
 	rs->itu_region = RIG_ITU_REGION2;
 
+	/*
+	 * The tables are shared with caps, until rig_copy_tables().
+	 * caps is const, the casts are fine as long as the backends
+	 * do call rig_copy_tables() before modifying them.
+	 */
 	switch(rs->itu_region) {
 		case RIG_ITU_REGION1:
-			memcpy(rs->tx_range_list, caps->tx_range_list1,
-					sizeof(struct freq_range_list)*FRQRANGESIZ);
-			memcpy(rs->rx_range_list, caps->rx_range_list1,
-					sizeof(struct freq_range_list)*FRQRANGESIZ);
+			rs->tx_range_list = (freq_range_t *) caps->tx_range_list1;
+			rs->rx_range_list = (freq_range_t *) caps->rx_range_list1;
 			break;
 		case RIG_ITU_REGION2:
 		case RIG_ITU_REGION3:
 		default:
-			memcpy(rs->tx_range_list, caps->tx_range_list2,
-					sizeof(struct freq_range_list)*FRQRANGESIZ);
-			memcpy(rs->rx_range_list, caps->rx_range_list2,
-					sizeof(struct freq_range_list)*FRQRANGESIZ);
+			rs->tx_range_list = (freq_range_t *) caps->tx_range_list2;
+			rs->rx_range_list = (freq_range_t *) caps->rx_range_list2;
 			break;
 	}
 
@@ -382,12 +404,10 @@ RIG * HAMLIB_API rig_init(rig_model_t rig_model)
 			rs->mode_list |= rs->tx_range_list[i].modes;
 	}
 
-	memcpy(rs->preamp, caps->preamp, sizeof(int)*MAXDBLSTSIZ);
-	memcpy(rs->attenuator, caps->attenuator, sizeof(int)*MAXDBLSTSIZ);
-	memcpy(rs->tuning_steps, caps->tuning_steps,
-				sizeof(struct tuning_step_list)*TSLSTSIZ);
-	memcpy(rs->filters, caps->filters,
-				sizeof(struct filter_list)*FLTLSTSIZ);
+	rs->preamp = (int *) caps->preamp;
+	rs->attenuator = (int *) caps->attenuator;
+	rs->tuning_steps = (struct tuning_step_list *) caps->tuning_steps;
+	rs->filters = (struct filter_list *) caps->filters;
 	memcpy(&rs->str_cal, &caps->str_cal,
 				sizeof(cal_table_t));
 
@@ -425,6 +445,8 @@ RIG * HAMLIB_API rig_init(rig_model_t rig_model)
 		if (retcode != RIG_OK) {
 			rig_debug(RIG_DEBUG_VERBOSE,"rig:backend_init failed!\n");
 			/* cleanup and exit */
+			hamlib_lock_free(rig->state.lock);
+			free(rig->state.tables);
 			free(rig);
 			return NULL;
 		}
@@ -461,6 +483,8 @@ int HAMLIB_API rig_open(RIG *rig)
 	if (!rig || !rig->caps)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 	rs = &rig->state;
 
@@ -580,6 +604,15 @@ int HAMLIB_API rig_open(RIG *rig)
 		}
 	}
 
+	/*
+	 * the tables are final once the backend is open,
+	 * the lookups scan them if they cannot be indexed
+	 */
+	status = rig_index_tables(rig);
+	if (status != RIG_OK)
+		rig_debug(RIG_DEBUG_WARN, "rig_open: cannot index the tables: %s\n",
+				rigerror(status));
+
 	/*
 	 * trigger state->current_vfo first retrieval
 	 */
@@ -624,6 +657,8 @@ int HAMLIB_API rig_close(RIG *rig)
 	if (!rig || !rig->caps)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 	rs = &rig->state;
 
@@ -694,6 +729,9 @@ int HAMLIB_API rig_close(RIG *rig)
 
 	remove_opened_rig(rig);
 
+	free(rs->index);
+	rs->index = NULL;
+
 	rs->comm_state = 0;
 
 	return RIG_OK;
@@ -732,11 +770,275 @@ int HAMLIB_API rig_cleanup(RIG *rig)
 	if (rig->caps->rig_cleanup)
 		rig->caps->rig_cleanup(rig);
 
+	hamlib_lock_free(rig->state.lock);
+	free(rig->state.tables);
 	free(rig);
 
 	return RIG_OK;
 }
 
+#ifndef DOC_HIDDEN
+
+struct rig_tables {
+	freq_range_t rx_range_list[FRQRANGESIZ];
+	freq_range_t tx_range_list[FRQRANGESIZ];
+	struct tuning_step_list tuning_steps[TSLSTSIZ];
+	struct filter_list filters[FLTLSTSIZ];
+	int preamp[MAXDBLSTSIZ];
+	int attenuator[MAXDBLSTSIZ];
+};
+
+#endif /* !DOC_HIDDEN */
+
+/**
+ * \brief give the rig state its own copy of the caps tables
+ * \param rig	The #RIG handle
+ *
+ * The frequency ranges, tuning steps, filters, preamp and attenuator
+ * tables of the rig state are shared with the caps, ie. with all the
+ * handles of the same model, which saves memory.
+ * A backend learning them from the rig, eg. at open time, has to call
+ * rig_copy_tables() before modifying them, so that it works on a
+ * private copy of their current content (copy-on-write).
+ * Calling it again is harmless. The copy is freed by rig_cleanup().
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_init(), rig_cleanup()
+ */
+
+int HAMLIB_API rig_copy_tables(RIG *rig)
+{
+	struct rig_state *rs;
+	struct rig_tables *t;
+
+	if (!rig || !rig->caps)
+		return -RIG_EINVAL;
+
+	rs = &rig->state;
+	if (rs->tables)
+		return RIG_OK;
+
+	t = malloc(sizeof(struct rig_tables));
+	if (!t)
+		return -RIG_ENOMEM;
+
+	memcpy(t->rx_range_list, rs->rx_range_list, sizeof(t->rx_range_list));
+	memcpy(t->tx_range_list, rs->tx_range_list, sizeof(t->tx_range_list));
+	memcpy(t->tuning_steps, rs->tuning_steps, sizeof(t->tuning_steps));
+	memcpy(t->filters, rs->filters, sizeof(t->filters));
+	memcpy(t->preamp, rs->preamp, sizeof(t->preamp));
+	memcpy(t->attenuator, rs->attenuator, sizeof(t->attenuator));
+
+	rs->rx_range_list = t->rx_range_list;
+	rs->tx_range_list = t->tx_range_list;
+	rs->tuning_steps = t->tuning_steps;
+	rs->filters = t->filters;
+	rs->preamp = t->preamp;
+	rs->attenuator = t->attenuator;
+	rs->tables = t;
+
+	return RIG_OK;
+}
+
+#ifndef DOC_HIDDEN
+
+#define INDEX_MODES	32	/* bits of rmode_t */
+#define INDEX_BOUNDS	(2*FRQRANGESIZ)
+
+#if FRQRANGESIZ > 32
+#error "the range index holds the range numbers in 32 bit masks"
+#endif
+
+/*
+ * The starts and ends of a range list, sorted, split the frequencies
+ * into elementary intervals: each bound, then the open interval up to
+ * the next bound. Each one has the mask of the ranges including it,
+ * in list order, the first one matching the mode being the answer of
+ * rig_get_range().
+ */
+struct range_index {
+	int nbounds;
+	freq_t bound[INDEX_BOUNDS];
+	unsigned long at[INDEX_BOUNDS];		/* ranges including bound[i] */
+	unsigned long after[INDEX_BOUNDS];	/* ranges including ]bound[i],bound[i+1][ */
+	rmode_t modes;				/* modes of all the ranges */
+};
+
+struct rig_index {
+	struct range_index rx;
+	struct range_index tx;
+	/* answers of the passband and resolution lookups, per mode bit */
+	pbwidth_t normal[INDEX_MODES];
+	pbwidth_t narrow[INDEX_MODES];
+	pbwidth_t wide[INDEX_MODES];
+	shortfreq_t resolution[INDEX_MODES];
+};
+
+/* bit number of a single mode, -1 for none or several modes */
+static int mode_bit(rmode_t mode)
+{
+	int bit;
+
+	if (mode == 0 || (mode & (mode - 1)) != 0)
+		return -1;
+	for (bit = 0; !(mode & (1UL << bit)); bit++)
+		;
+	return bit;
+}
+
+static void index_ranges(struct range_index *ri, const freq_range_t range_list[])
+{
+	freq_t b;
+	int i, j, n;
+
+	memset(ri, 0, sizeof(struct range_index));
+
+	/* sorted bounds, without duplicates */
+	for (n=0; n<FRQRANGESIZ; n++) {
+		if (range_list[n].start == 0 && range_list[n].end == 0)
+			break;
+		ri->modes |= range_list[n].modes;
+		for (j=0; j<2; j++) {
+			b = j ? range_list[n].end : range_list[n].start;
+			for (i=ri->nbounds; i>0 && ri->bound[i-1] > b; i--)
+				;
+			if (i>0 && ri->bound[i-1] == b)
+				continue;
+			memmove(&ri->bound[i+1], &ri->bound[i],
+					(ri->nbounds-i)*sizeof(freq_t));
+			ri->bound[i] = b;
+			ri->nbounds++;
+		}
+	}
+
+	for (i=0; i<ri->nbounds; i++) {
+		for (j=0; j<n; j++) {
+			if (range_list[j].start <= ri->bound[i] &&
+					range_list[j].end >= ri->bound[i])
+				ri->at[i] |= 1UL << j;
+			if (i+1 < ri->nbounds &&
+					range_list[j].start <= ri->bound[i] &&
+					range_list[j].end >= ri->bound[i+1])
+				ri->after[i] |= 1UL << j;
+		}
+	}
+}
+
+static const freq_range_t *
+index_get_range(const struct range_index *ri, const freq_range_t range_list[],
+		freq_t freq, rmode_t mode)
+{
+	unsigned long ranges;
+	int lo, hi, mid, i;
+
+	if (!(ri->modes & mode) || ri->nbounds == 0 || freq < ri->bound[0])
+		return NULL;
+
+	/* last bound <= freq */
+	lo = 0;
+	hi = ri->nbounds;
+	while (hi - lo > 1) {
+		mid = (lo + hi) / 2;
+		if (ri->bound[mid] <= freq)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	ranges = ri->bound[lo] == freq ? ri->at[lo] : ri->after[lo];
+
+	for (i=0; ranges; i++, ranges >>= 1) {
+		if ((ranges & 1) && (range_list[i].modes & mode))
+			return &range_list[i];
+	}
+	return NULL;
+}
+
+/*
+ * look up freq/mode in the rx or tx range list of the rig state,
+ * through the index when the rig is open
+ */
+static const freq_range_t *
+rig_state_range(RIG *rig, int tx, freq_t freq, rmode_t mode)
+{
+	const struct rig_state *rs = &rig->state;
+
+	if (!rs->index)
+		return rig_get_range(tx ? rs->tx_range_list : rs->rx_range_list,
+				freq, mode);
+
+	if (tx)
+		return index_get_range(&rs->index->tx, rs->tx_range_list, freq, mode);
+	return index_get_range(&rs->index->rx, rs->rx_range_list, freq, mode);
+}
+
+#endif /* !DOC_HIDDEN */
+
+/**
+ * \brief index the tables of the rig state for the lookups
+ * \param rig	The #RIG handle
+ *
+ * Builds the lookup index of the frequency ranges, the filters and the
+ * tuning steps of the rig state: the range lookups of the frontend are
+ * then a binary search, and rig_passband_normal(), rig_passband_narrow(),
+ * rig_passband_wide() and rig_get_resolution() a table read for a single
+ * mode.
+ * rig_open() calls it once the backend is open, and rig_close() frees
+ * the index. A backend modifying the tables of an open rig has to call
+ * it again, see rig_copy_tables().
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_open(), rig_copy_tables()
+ */
+
+int HAMLIB_API rig_index_tables(RIG *rig)
+{
+	struct rig_state *rs;
+	struct rig_index *idx;
+	rmode_t mode;
+	int bit, i;
+
+	if (!rig || !rig->caps)
+		return -RIG_EINVAL;
+
+	rs = &rig->state;
+
+	idx = rs->index;
+	if (!idx) {
+		idx = malloc(sizeof(struct rig_index));
+		if (!idx)
+			return -RIG_ENOMEM;
+	}
+	/* the lookups scan the tables while it is built */
+	rs->index = NULL;
+
+	index_ranges(&idx->rx, rs->rx_range_list);
+	index_ranges(&idx->tx, rs->tx_range_list);
+
+	for (bit=0; bit<INDEX_MODES; bit++) {
+		mode = (rmode_t)(1UL << bit);
+		idx->normal[bit] = rig_passband_normal(rig, mode);
+		idx->narrow[bit] = rig_passband_narrow(rig, mode);
+		idx->wide[bit] = rig_passband_wide(rig, mode);
+		idx->resolution[bit] = -RIG_EINVAL;
+		for (i=0; i<TSLSTSIZ && rs->tuning_steps[i].ts; i++) {
+			if (rs->tuning_steps[i].modes & mode) {
+				idx->resolution[bit] = rs->tuning_steps[i].ts;
+				break;
+			}
+		}
+	}
+
+	rs->index = idx;
+
+	return RIG_OK;
+}
+
 
 /**
  * \brief set the frequency of the target VFO
@@ -745,6 +1047,8 @@ int HAMLIB_API rig_cleanup(RIG *rig)
  * \param freq	The frequency to set to
  *
  * Sets the frequency of the target VFO.
+ * With the "range_check" conf set, a frequency out of the rx and tx ranges
+ * is rejected without asking the rig.
  *
  * \return RIG_OK if the operation has been sucessful, otherwise
  * a negative value if an error occured (in which case, cause is
@@ -756,13 +1060,28 @@ int HAMLIB_API rig_cleanup(RIG *rig)
 int HAMLIB_API rig_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
 {
 	const struct rig_caps *caps;
+	const struct rig_index *idx;
 	int retcode;
 	vfo_t curr_vfo;
 
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
+	idx = rig->state.index;
+
+	/* no round trip to the rig for a frequency it cannot tune */
+	if (rig->state.range_check && idx &&
+			!index_get_range(&idx->rx, rig->state.rx_range_list, freq,
+				idx->rx.modes) &&
+			!index_get_range(&idx->tx, rig->state.tx_range_list, freq,
+				idx->tx.modes)) {
+		rig_debug(RIG_DEBUG_ERR, "rig_set_freq: %.0f Hz out of the ranges\n",
+				freq);
+		return -RIG_EINVAL;
+	}
 
 	if (rig->state.vfo_comp != 0.0)
 		freq += (freq_t)((double)rig->state.vfo_comp * freq);
@@ -817,6 +1136,8 @@ int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
 	if (CHECK_RIG_ARG(rig) || !freq)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_freq == NULL)
@@ -856,6 +1177,8 @@ int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
  *
  * Sets the mode and associated passband of the target VFO.
  * The passband \a width must be supported by the backend of the rig.
+ * With the "range_check" conf set, a mode out of the rx and tx ranges
+ * is rejected without asking the rig.
  *
  * \return RIG_OK if the operation has been sucessful, otherwise
  * a negative value if an error occured (in which case, cause is
@@ -867,13 +1190,24 @@ int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
 int HAMLIB_API rig_set_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
 {
 	const struct rig_caps *caps;
+	const struct rig_index *idx;
 	int retcode;
 	vfo_t curr_vfo;
 
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
+	idx = rig->state.index;
+
+	if (rig->state.range_check && idx &&
+			!(mode & (idx->rx.modes | idx->tx.modes))) {
+		rig_debug(RIG_DEBUG_ERR, "rig_set_mode: mode %s not supported\n",
+				rig_strrmode(mode));
+		return -RIG_EINVAL;
+	}
 
 	if (caps->set_mode == NULL)
 		return -RIG_ENAVAIL;
@@ -932,6 +1266,8 @@ int HAMLIB_API rig_get_mode(RIG *rig, vfo_t vfo, rmode_t *mode, pbwidth_t *width
 	if (CHECK_RIG_ARG(rig) || !mode || !width)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_mode == NULL)
@@ -988,6 +1324,10 @@ pbwidth_t HAMLIB_API rig_passband_normal(RIG *rig, rmode_t mode)
 
 	rs = &rig->state;
 
+	i = mode_bit(mode);
+	if (rs->index && i >= 0)
+		return rs->index->normal[i];
+
 	for (i=0; i<FLTLSTSIZ && rs->filters[i].modes; i++) {
 		if (rs->filters[i].modes & mode) {
 			return rs->filters[i].width;
@@ -1023,6 +1363,10 @@ pbwidth_t HAMLIB_API rig_passband_narrow(RIG *rig, rmode_t mode)
 
 	rs = &rig->state;
 
+	i = mode_bit(mode);
+	if (rs->index && i >= 0)
+		return rs->index->narrow[i];
+
 	for (i=0; i<FLTLSTSIZ-1 && rs->filters[i].modes; i++) {
 		if (rs->filters[i].modes & mode) {
 			normal = rs->filters[i].width;
@@ -1065,6 +1409,10 @@ pbwidth_t HAMLIB_API rig_passband_wide(RIG *rig, rmode_t mode)
 
 	rs = &rig->state;
 
+	i = mode_bit(mode);
+	if (rs->index && i >= 0)
+		return rs->index->wide[i];
+
 	for (i=0; i<FLTLSTSIZ-1 && rs->filters[i].modes; i++) {
 		if (rs->filters[i].modes & mode) {
 			normal = rs->filters[i].width;
@@ -1105,6 +1453,8 @@ int HAMLIB_API rig_set_vfo(RIG *rig, vfo_t vfo)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_vfo == NULL)
@@ -1140,6 +1490,8 @@ int HAMLIB_API rig_get_vfo(RIG *rig, vfo_t *vfo)
 	if (CHECK_RIG_ARG(rig) || !vfo)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_vfo == NULL)
@@ -1174,6 +1526,8 @@ int HAMLIB_API rig_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	switch (rig->state.pttport.type.ptt) {
@@ -1186,8 +1540,10 @@ int HAMLIB_API rig_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
 		    return -RIG_ENIMPL;
 
 		if ((caps->targetable_vfo&RIG_TARGETABLE_PURE) ||
-				vfo == RIG_VFO_CURR || vfo == rig->state.current_vfo)
-		    return caps->set_ptt(rig, vfo, ptt);
+				vfo == RIG_VFO_CURR || vfo == rig->state.current_vfo) {
+			retcode = caps->set_ptt(rig, vfo, ptt);
+			break;
+		}
 
 		if (!caps->set_vfo)
 		return -RIG_ENTARGET;
@@ -1198,21 +1554,23 @@ int HAMLIB_API rig_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
 
 		retcode = caps->set_ptt(rig, vfo, ptt);
 		caps->set_vfo(rig, curr_vfo);
-		return retcode;
-
 		break;
 
 	case RIG_PTT_SERIAL_DTR:
-		return ser_set_dtr(&rig->state.pttport, ptt!=RIG_PTT_OFF);
+		retcode = ser_set_dtr(&rig->state.pttport, ptt!=RIG_PTT_OFF);
+		break;
 
 	case RIG_PTT_SERIAL_RTS:
-		return ser_set_rts(&rig->state.pttport, ptt!=RIG_PTT_OFF);
+		retcode = ser_set_rts(&rig->state.pttport, ptt!=RIG_PTT_OFF);
+		break;
 
 	case RIG_PTT_PARALLEL:
-		return par_ptt_set(&rig->state.pttport, ptt);
+		retcode = par_ptt_set(&rig->state.pttport, ptt);
+		break;
 
 	case RIG_PTT_CM108:
-		return cm108_ptt_set(&rig->state.pttport, ptt);
+		retcode = cm108_ptt_set(&rig->state.pttport, ptt);
+		break;
 
 	case RIG_PTT_NONE:
 		return -RIG_ENAVAIL;	/* not available */
@@ -1220,7 +1578,10 @@ int HAMLIB_API rig_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
 		return -RIG_EINVAL;
 	}
 
-	return RIG_OK;
+	if (retcode == RIG_OK)
+		rig->state.current_ptt = ptt;
+
+	return retcode;
 }
 
 /**
@@ -1246,6 +1607,8 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 	if (CHECK_RIG_ARG(rig) || !ptt)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	switch (rig->state.pttport.type.ptt) {
@@ -1255,8 +1618,10 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 			return -RIG_ENIMPL;
 
 		if ((caps->targetable_vfo&RIG_TARGETABLE_PURE) ||
-				vfo == RIG_VFO_CURR || vfo == rig->state.current_vfo)
-			return caps->get_ptt(rig, vfo, ptt);
+				vfo == RIG_VFO_CURR || vfo == rig->state.current_vfo) {
+			retcode = caps->get_ptt(rig, vfo, ptt);
+			break;
+		}
 
 		if (!caps->set_vfo)
 			return -RIG_ENTARGET;
@@ -1267,37 +1632,45 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 
 		retcode = caps->get_ptt(rig, vfo, ptt);
 		caps->set_vfo(rig, curr_vfo);
-		return retcode;
-
 		break;
 
 	case RIG_PTT_SERIAL_RTS:
-		if (caps->get_ptt)
-			return caps->get_ptt(rig, vfo, ptt);
+		if (caps->get_ptt) {
+			retcode = caps->get_ptt(rig, vfo, ptt);
+			break;
+		}
 
 		retcode = ser_get_rts(&rig->state.pttport, &status);
 		*ptt = status ? RIG_PTT_ON : RIG_PTT_OFF;
-		return retcode;
+		break;
 
 	case RIG_PTT_SERIAL_DTR:
-		if (caps->get_ptt)
-			return caps->get_ptt(rig, vfo, ptt);
+		if (caps->get_ptt) {
+			retcode = caps->get_ptt(rig, vfo, ptt);
+			break;
+		}
 
 		retcode = ser_get_dtr(&rig->state.pttport, &status);
 		*ptt = status ? RIG_PTT_ON : RIG_PTT_OFF;
-		return retcode;
+		break;
 
 	case RIG_PTT_PARALLEL:
-		if (caps->get_ptt)
-			return caps->get_ptt(rig, vfo, ptt);
+		if (caps->get_ptt) {
+			retcode = caps->get_ptt(rig, vfo, ptt);
+			break;
+		}
 
-		return par_ptt_get(&rig->state.pttport, ptt);
+		retcode = par_ptt_get(&rig->state.pttport, ptt);
+		break;
 
 	case RIG_PTT_CM108:
-		if (caps->get_ptt)
-			return caps->get_ptt(rig, vfo, ptt);
+		if (caps->get_ptt) {
+			retcode = caps->get_ptt(rig, vfo, ptt);
+			break;
+		}
 
-		return cm108_ptt_get(&rig->state.pttport, ptt);
+		retcode = cm108_ptt_get(&rig->state.pttport, ptt);
+		break;
 
 	case RIG_PTT_NONE:
 		return -RIG_ENAVAIL;	/* not available */
@@ -1306,7 +1679,10 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 		return -RIG_EINVAL;
 	}
 
-	return RIG_OK;
+	if (retcode == RIG_OK)
+		rig->state.current_ptt = *ptt;
+
+	return retcode;
 }
 
 /**
@@ -1331,6 +1707,8 @@ int HAMLIB_API rig_get_dcd(RIG *rig, vfo_t vfo, dcd_t *dcd)
 	if (CHECK_RIG_ARG(rig) || !dcd)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	switch (rig->state.dcdport.type.dcd) {
@@ -1408,6 +1786,8 @@ int HAMLIB_API rig_set_rptr_shift(RIG *rig, vfo_t vfo, rptr_shift_t rptr_shift)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_rptr_shift == NULL)
@@ -1452,6 +1832,8 @@ int HAMLIB_API rig_get_rptr_shift(RIG *rig, vfo_t vfo, rptr_shift_t *rptr_shift)
 	if (CHECK_RIG_ARG(rig) || !rptr_shift)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_rptr_shift == NULL)
@@ -1497,6 +1879,8 @@ int HAMLIB_API rig_set_rptr_offs(RIG *rig, vfo_t vfo, shortfreq_t rptr_offs)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_rptr_offs == NULL)
@@ -1542,6 +1926,8 @@ int HAMLIB_API rig_get_rptr_offs(RIG *rig, vfo_t vfo, shortfreq_t *rptr_offs)
 	if (CHECK_RIG_ARG(rig) || !rptr_offs)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_rptr_offs == NULL)
@@ -1588,6 +1974,8 @@ int HAMLIB_API rig_set_split_freq(RIG *rig, vfo_t vfo, freq_t tx_freq)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_split_freq &&
@@ -1656,6 +2044,8 @@ int HAMLIB_API rig_get_split_freq(RIG *rig, vfo_t vfo, freq_t *tx_freq)
 	if (CHECK_RIG_ARG(rig) || !tx_freq)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_split_freq &&
@@ -1727,6 +2117,8 @@ int HAMLIB_API rig_set_split_mode(RIG *rig, vfo_t vfo, rmode_t tx_mode, pbwidth_
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_split_mode &&
@@ -1801,6 +2193,8 @@ int HAMLIB_API rig_get_split_mode(RIG *rig, vfo_t vfo, rmode_t *tx_mode, pbwidth
 	if (CHECK_RIG_ARG(rig) || !tx_mode || !tx_width)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_split_mode &&
@@ -1875,6 +2269,8 @@ int HAMLIB_API rig_set_split_vfo(RIG *rig, vfo_t vfo, split_t split, vfo_t tx_vf
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_split_vfo == NULL)
@@ -1929,6 +2325,8 @@ int HAMLIB_API rig_get_split_vfo(RIG *rig, vfo_t vfo, split_t *split, vfo_t *tx_
 	if (CHECK_RIG_ARG(rig) || !split || !tx_vfo)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_split_vfo == NULL)
@@ -1977,6 +2375,8 @@ int HAMLIB_API rig_set_rit(RIG *rig, vfo_t vfo, shortfreq_t rit)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_rit == NULL)
@@ -2022,6 +2422,8 @@ int HAMLIB_API rig_get_rit(RIG *rig, vfo_t vfo, shortfreq_t *rit)
 	if (CHECK_RIG_ARG(rig) || !rit)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_rit == NULL)
@@ -2067,6 +2469,8 @@ int HAMLIB_API rig_set_xit(RIG *rig, vfo_t vfo, shortfreq_t xit)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_xit == NULL)
@@ -2112,6 +2516,8 @@ int HAMLIB_API rig_get_xit(RIG *rig, vfo_t vfo, shortfreq_t *xit)
 	if (CHECK_RIG_ARG(rig) || !xit)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_xit == NULL)
@@ -2159,6 +2565,8 @@ int HAMLIB_API rig_set_ts(RIG *rig, vfo_t vfo, shortfreq_t ts)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_ts == NULL)
@@ -2204,6 +2612,8 @@ int HAMLIB_API rig_get_ts(RIG *rig, vfo_t vfo, shortfreq_t *ts)
 	if (CHECK_RIG_ARG(rig) || !ts)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_ts == NULL)
@@ -2253,6 +2663,8 @@ int HAMLIB_API rig_set_ant(RIG *rig, vfo_t vfo, ant_t ant)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_ant == NULL)
@@ -2298,6 +2710,8 @@ int HAMLIB_API rig_get_ant(RIG *rig, vfo_t vfo, ant_t *ant)
 	if (CHECK_RIG_ARG(rig) || !ant)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_ant == NULL)
@@ -2348,10 +2762,12 @@ int HAMLIB_API rig_power2mW(RIG *rig, unsigned int *mwpower, float power, freq_t
 	if (!rig || !rig->caps || !mwpower || power<0.0 || power>1.0)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	if (rig->caps->power2mW != NULL)
 		return rig->caps->power2mW(rig, mwpower, power, freq, mode);
 
-	txrange = rig_get_range(rig->state.tx_range_list, freq, mode);
+	txrange = rig_state_range(rig, 1, freq, mode);
 	if (!txrange) {
 		/*
 		 * freq is not on the tx range!
@@ -2389,10 +2805,12 @@ int HAMLIB_API rig_mW2power(RIG *rig, float *power, unsigned int mwpower, freq_t
 	if (!rig || !rig->caps || !power || mwpower<=0)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	if (rig->caps->mW2power != NULL)
 		return rig->caps->mW2power(rig, power, mwpower, freq, mode);
 
-	txrange = rig_get_range(rig->state.tx_range_list, freq, mode);
+	txrange = rig_state_range(rig, 1, freq, mode);
 	if (!txrange) {
 		/*
 		 * freq is not on the tx range!
@@ -2430,6 +2848,10 @@ shortfreq_t HAMLIB_API rig_get_resolution(RIG *rig, rmode_t mode)
 
 	rs = &rig->state;
 
+	i = mode_bit(mode);
+	if (rs->index && i >= 0)
+		return rs->index->resolution[i];
+
 	for (i=0; i<TSLSTSIZ && rs->tuning_steps[i].ts; i++) {
 		if (rs->tuning_steps[i].modes & mode)
 			return rs->tuning_steps[i].ts;
@@ -2460,6 +2882,8 @@ int HAMLIB_API rig_set_powerstat(RIG *rig, powerstat_t status)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	if (rig->caps->set_powerstat == NULL)
 		return -RIG_ENAVAIL;
 
@@ -2486,6 +2910,8 @@ int HAMLIB_API rig_get_powerstat(RIG *rig, powerstat_t *status)
 	if (CHECK_RIG_ARG(rig) || !status)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	if (rig->caps->get_powerstat == NULL)
 		return -RIG_ENAVAIL;
 
@@ -2512,6 +2938,8 @@ int HAMLIB_API rig_reset(RIG *rig, reset_t reset)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	if (rig->caps->reset == NULL)
 		return -RIG_ENAVAIL;
 
@@ -2520,6 +2948,7 @@ int HAMLIB_API rig_reset(RIG *rig, reset_t reset)
 
 extern int rig_probe_first(hamlib_port_t *p);
 extern int rig_probe_all_backends(hamlib_port_t *p, rig_probe_func_t cfunc, rig_ptr_t data);
+extern int rig_probe_ports_backends(hamlib_port_t ports[], int n, rig_probe_func_t cfunc, rig_ptr_t data);
 /**
  * \brief try to guess a rig
  * \param port		A pointer describing a port linking the host to the rig
@@ -2567,6 +2996,40 @@ int HAMLIB_API rig_probe_all(hamlib_port_t *port, rig_probe_func_t cfunc, rig_pt
 	return rig_probe_all_backends(port, cfunc, data);
 }
 
+/**
+ * \brief try to guess the rigs on several ports at once
+ * \param ports	Array of the ports to probe
+ * \param n	Number of ports in \a ports
+ * \param cfunc	Function to be called each time a rig is found, may be NULL
+ * \param data	Arbitrary data passed to cfunc
+ *
+ *  Like rig_probe(), but the ports are probed in parallel, one thread
+ *  per port, so that the whole scan takes the time of the slowest port.
+ *  The backends are tried in the order of likelihood, and each port is
+ *  done with as soon as a rig has been identified on it.
+ *
+ *  \a cfunc is called as soon as a rig is found, from the thread of
+ *  the port, but never concurrently. Only the loaded backends are tried,
+ *  see rig_load_all_backends().
+ *  The pathname, type and serial data bits of each port must be set,
+ *  the other fields are changed while probing.
+ *
+ * \warning this is really Experimental, same as rig_probe()
+ *
+ * \return the number of ports a rig has been found on, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_probe(), rig_probe_all()
+ */
+int HAMLIB_API rig_probe_ports(hamlib_port_t ports[], int n, rig_probe_func_t cfunc, rig_ptr_t data)
+{
+	if (!ports || n <= 0)
+		return -RIG_EINVAL;
+
+	return rig_probe_ports_backends(ports, n, cfunc, data);
+}
+
 /**
  * \brief check retrieval ability of VFO operations
  * \param rig	The rig handle
@@ -2616,6 +3079,8 @@ int HAMLIB_API rig_vfo_op(RIG *rig, vfo_t vfo, vfo_op_t op)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->vfo_op == NULL || !rig_has_vfo_op(rig,op))
@@ -2687,6 +3152,8 @@ int HAMLIB_API rig_scan(RIG *rig, vfo_t vfo, scan_t scan, int ch)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->scan == NULL ||
@@ -2733,6 +3200,8 @@ int HAMLIB_API rig_send_dtmf(RIG *rig, vfo_t vfo, const char *digits)
 	if (CHECK_RIG_ARG(rig) || !digits)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->send_dtmf == NULL)
@@ -2779,6 +3248,8 @@ int HAMLIB_API rig_recv_dtmf(RIG *rig, vfo_t vfo, char *digits, int *length)
 	if (CHECK_RIG_ARG(rig) || !digits || !length)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->recv_dtmf == NULL)
@@ -2824,6 +3295,8 @@ int HAMLIB_API rig_send_morse(RIG *rig, vfo_t vfo, const char *msg)
 	if (CHECK_RIG_ARG(rig) || !msg)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->send_morse == NULL)
@@ -2893,10 +3366,182 @@ const char* HAMLIB_API rig_get_info(RIG *rig)
 	if (CHECK_RIG_ARG(rig))
 		return NULL;
 
+	RIG_LOCK(rig);
+
 	if (rig->caps->get_info == NULL)
 		return NULL;
 
 	return rig->caps->get_info(rig);
 }
 
+/**
+ * \brief get the I/O statistics of the rig port
+ * \param rig	The rig handle
+ * \param stats	The location where to store the statistics
+ *
+ * Retrieves the I/O counters and latency histograms collected
+ * on the rig communication port since rig_open().
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa port_stats_t, rot_get_port_stats()
+ */
+int HAMLIB_API rig_get_port_stats(RIG *rig, port_stats_t *stats)
+{
+	if (CHECK_RIG_ARG(rig) || !stats)
+		return -RIG_EINVAL;
+
+	RIG_LOCK(rig);
+
+	*stats = rig->state.rigport.stats;
+
+	return RIG_OK;
+}
+
+/**
+ * \brief time left before the rig accepts the next command
+ * \param rig	The rig handle
+ *
+ *  Rigs needing a write_delay between bytes or a post_write_delay
+ *  between commands, like older Yaesu, are paced by deadlines: after a
+ *  command, the next one waits only for what is left of the delay.
+ *  An event loop driving several rigs may call this to arm a timer
+ *  instead of blocking in the next call. It does not take the handle,
+ *  so that it never blocks either.
+ *
+ *  Only the wait before a command is covered. The bytes of a command
+ *  are still paced by write_delay sleeping, holding the handle, so a
+ *  call sending n bytes blocks for (n-1)*write_delay mS anyway.
+ *
+ * \return the time in mS before the next command is sent without waiting,
+ * 0 if it would be now, otherwise a negative value if an error occured.
+ *
+ * \sa rig_get_port_stats()
+ */
+int HAMLIB_API rig_write_wait(RIG *rig)
+{
+	if (CHECK_RIG_ARG(rig))
+		return -RIG_EINVAL;
+
+	return port_write_wait(&rig->state.rigport);
+}
+
+/* a field the rig cannot tell is left out of the snapshot */
+static int snapshot_skip(int retcode)
+{
+	return retcode == -RIG_ENAVAIL || retcode == -RIG_ENIMPL ||
+		retcode == -RIG_ENTARGET;
+}
+
+/**
+ * \brief get the state of the rig at once
+ * \param rig	The rig handle
+ * \param vfo	The target VFO
+ * \param snap	The location where to store the state
+ *
+ *  Retrieves in one call what a client polls every cycle: the current
+ *  VFO, and the frequency, mode, PTT and split status of \a vfo.
+ *  Backends able to, e.g. from the Kenwood IF answer, read it all in
+ *  one or two exchanges; the fields they leave out are read one by
+ *  one as rig_get_vfo(), rig_get_freq(), etc. would. The fields the rig
+ *  cannot tell are not flagged in \a snap->fields.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_get_freq(), rig_get_mode(), rig_get_ptt(), rig_get_split_vfo()
+ */
+int HAMLIB_API rig_get_snapshot(RIG *rig, vfo_t vfo, rig_snapshot_t *snap)
+{
+	const struct rig_caps *caps;
+	struct rig_state *rs;
+	struct timeval tv;
+	int retcode;
+
+	if (CHECK_RIG_ARG(rig) || !snap)
+		return -RIG_EINVAL;
+
+	RIG_LOCK(rig);
+
+	caps = rig->caps;
+	rs = &rig->state;
+
+	memset(snap, 0, sizeof(rig_snapshot_t));
+
+	if (caps->get_snapshot) {
+		retcode = caps->get_snapshot(rig, vfo, snap);
+		if (retcode != RIG_OK && !snapshot_skip(retcode))
+			return retcode;
+		if (retcode != RIG_OK)
+			snap->fields = 0;
+
+		/* as the individual calls would have done */
+		if (snap->fields & RIG_SNAPSHOT_VFO)
+			rs->current_vfo = snap->vfo;
+		if ((snap->fields & RIG_SNAPSHOT_FREQ) && rs->vfo_comp != 0.0)
+			snap->freq += (freq_t)(rs->vfo_comp * snap->freq);
+		if ((snap->fields & RIG_SNAPSHOT_MODE) &&
+				snap->width == RIG_PASSBAND_NORMAL &&
+				snap->mode != RIG_MODE_NONE)
+			snap->width = rig_passband_normal(rig, snap->mode);
+		if (vfo == RIG_VFO_CURR || vfo == rs->current_vfo) {
+			if (snap->fields & RIG_SNAPSHOT_FREQ)
+				rs->current_freq = snap->freq;
+			if (snap->fields & RIG_SNAPSHOT_MODE) {
+				rs->current_mode = snap->mode;
+				rs->current_width = snap->width;
+			}
+		}
+	}
+
+	if (!(snap->fields & RIG_SNAPSHOT_VFO)) {
+		retcode = rig_get_vfo(rig, &snap->vfo);
+		if (retcode == RIG_OK)
+			snap->fields |= RIG_SNAPSHOT_VFO;
+		else if (!snapshot_skip(retcode))
+			return retcode;
+	}
+
+	if (!(snap->fields & RIG_SNAPSHOT_FREQ)) {
+		retcode = rig_get_freq(rig, vfo, &snap->freq);
+		if (retcode == RIG_OK)
+			snap->fields |= RIG_SNAPSHOT_FREQ;
+		else if (!snapshot_skip(retcode))
+			return retcode;
+	}
+
+	if (!(snap->fields & RIG_SNAPSHOT_MODE)) {
+		retcode = rig_get_mode(rig, vfo, &snap->mode, &snap->width);
+		if (retcode == RIG_OK)
+			snap->fields |= RIG_SNAPSHOT_MODE;
+		else if (!snapshot_skip(retcode))
+			return retcode;
+	}
+
+	if (!(snap->fields & RIG_SNAPSHOT_PTT)) {
+		retcode = rig_get_ptt(rig, vfo, &snap->ptt);
+		if (retcode == RIG_OK)
+			snap->fields |= RIG_SNAPSHOT_PTT;
+		else if (!snapshot_skip(retcode))
+			return retcode;
+	}
+
+	if (!(snap->fields & RIG_SNAPSHOT_SPLIT)) {
+		retcode = rig_get_split_vfo(rig, vfo, &snap->split, &snap->tx_vfo);
+		if (retcode == RIG_OK)
+			snap->fields |= RIG_SNAPSHOT_SPLIT;
+		else if (!snapshot_skip(retcode))
+			return retcode;
+	}
+
+	gettimeofday(&tv, NULL);
+	snap->date.tv_sec = tv.tv_sec;
+	snap->date.tv_usec = tv.tv_usec;
+
+	return RIG_OK;
+}
+
 /*! @} */
@@ -0,0 +1,561 @@
+/*
+ *  Hamlib Interface - shared memory rig state publication
+ *  Copyright (c) 2026 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/**
+ * \addtogroup rig
+ * @{
+ */
+
+/**
+ * \file rigshm.c
+ * \brief Shared memory rig state publication
+ *
+ * The segment is a plain file mapped with mmap(). It holds a single
+ * writer seqlock: the publisher makes the sequence count odd, updates
+ * the snapshot, then makes it even again. A reader copies the snapshot
+ * and retries when the count was odd or changed meanwhile.
+ *
+ * There must be only one process publishing to a segment. Within it,
+ * the threads publishing at the same time are serialized by a mutex
+ * of the handle: a rig_shm_publish_rig() finding it taken, e.g. from
+ * a transceive callback on the event thread while a client thread
+ * publishes, leaves the update to the thread holding it, which takes
+ * a fresh snapshot once more before returning.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+#include <sys/stat.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <hamlib/rig.h>
+#include <hamlib/rigshm.h>
+
+#include "lock.h"
+
+
+#define RIG_SHM_MAGIC	0x48534d31	/* "HSM1" */
+
+/* how many times a reader spins over a torn update before giving up */
+#define RIG_SHM_READ_RETRY	10000
+
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1))
+#define shm_barrier()	__sync_synchronize()
+#define shm_take_flag(f)	__sync_lock_test_and_set((f), 0)
+#else
+#define shm_barrier()	do { } while (0)
+#define shm_take_flag(f)	shm_take_flag_plain(f)
+
+static int shm_take_flag_plain(volatile int *f)
+{
+	int v = *f;
+
+	*f = 0;
+	return v;
+}
+#endif
+
+/*
+ * Layout of the mapped file
+ */
+struct rig_shm_segment {
+	unsigned int magic;
+	unsigned int snap_size;		/* sizeof(struct rig_shm_snapshot) */
+	volatile unsigned int seq;	/* odd while an update is in progress */
+	unsigned int reserved;
+	struct rig_shm_snapshot snap;
+};
+
+struct rig_shm {
+	struct rig_shm_segment *seg;
+	int fd;
+	int writer;
+	rig_model_t rig_model;
+	unsigned long serial;
+#ifdef HAVE_PTHREAD
+	pthread_mutex_t mutex;		/* serializes the publishing threads */
+	volatile int dirty;		/* publish_rig left to the mutex holder */
+#else
+	volatile sig_atomic_t busy;
+	volatile sig_atomic_t dirty;
+#endif
+};
+
+
+#ifdef HAVE_SYS_MMAN_H
+
+static rig_shm_t *shm_map(const char *path, int writer)
+{
+	rig_shm_t *shm;
+	struct stat st;
+	void *addr;
+
+	shm = calloc(1, sizeof(rig_shm_t));
+	if (!shm)
+		return NULL;
+
+	shm->writer = writer;
+#ifdef HAVE_PTHREAD
+	pthread_mutex_init(&shm->mutex, NULL);
+#endif
+	shm->fd = open(path, writer ? O_RDWR|O_CREAT : O_RDONLY, 0644);
+	if (shm->fd < 0) {
+		rig_debug(RIG_DEBUG_ERR, "%s: open '%s' failed: %s\n", __func__,
+					path, strerror(errno));
+		free(shm);
+		return NULL;
+	}
+
+	if (writer) {
+		if (ftruncate(shm->fd, sizeof(struct rig_shm_segment)) < 0) {
+			rig_debug(RIG_DEBUG_ERR, "%s: ftruncate failed: %s\n", __func__,
+					strerror(errno));
+			goto err_close;
+		}
+	} else {
+		if (fstat(shm->fd, &st) < 0 ||
+				st.st_size < (off_t)sizeof(struct rig_shm_segment)) {
+			rig_debug(RIG_DEBUG_ERR, "%s: '%s' is not a rig state segment\n",
+					__func__, path);
+			goto err_close;
+		}
+	}
+
+	addr = mmap(NULL, sizeof(struct rig_shm_segment),
+				writer ? PROT_READ|PROT_WRITE : PROT_READ,
+				MAP_SHARED, shm->fd, 0);
+	if (addr == MAP_FAILED) {
+		rig_debug(RIG_DEBUG_ERR, "%s: mmap failed: %s\n", __func__,
+					strerror(errno));
+		goto err_close;
+	}
+	shm->seg = addr;
+
+	return shm;
+
+err_close:
+	close(shm->fd);
+#ifdef HAVE_PTHREAD
+	pthread_mutex_destroy(&shm->mutex);
+#endif
+	free(shm);
+	return NULL;
+}
+
+#endif	/* HAVE_SYS_MMAN_H */
+
+
+/**
+ * \brief create the shared memory segment for publishing
+ * \param path		file to map, RIG_SHM_DEFAULT_PATH if NULL
+ * \param rig_model	rig model to advertise to readers
+ *
+ * Creates (or reuses) the segment file, and initializes it so that
+ * readers see an empty snapshot until rig_shm_publish() is called.
+ *
+ * \return a handle to the segment, or NULL if mapping failed
+ * or is not supported on this platform.
+ *
+ * \sa rig_shm_publish(), rig_shm_close()
+ */
+rig_shm_t * HAMLIB_API rig_shm_create(const char *path, rig_model_t rig_model)
+{
+#ifdef HAVE_SYS_MMAN_H
+	rig_shm_t *shm;
+	struct rig_shm_segment *seg;
+
+	rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+	shm = shm_map(path ? path : RIG_SHM_DEFAULT_PATH, 1);
+	if (!shm)
+		return NULL;
+
+	shm->rig_model = rig_model;
+	seg = shm->seg;
+
+	/* readers catching an odd count will retry until the end of the init */
+	seg->seq |= 1;
+	shm_barrier();
+	seg->magic = RIG_SHM_MAGIC;
+	seg->snap_size = sizeof(struct rig_shm_snapshot);
+	memset(&seg->snap, 0, sizeof(struct rig_shm_snapshot));
+	seg->snap.rig_model = rig_model;
+	shm_barrier();
+	seg->seq++;
+
+	return shm;
+#else
+	rig_debug(RIG_DEBUG_ERR, "%s: shared memory not supported\n", __func__);
+	return NULL;
+#endif
+}
+
+/**
+ * \brief attach to a shared memory segment for reading
+ * \param path	file to map, RIG_SHM_DEFAULT_PATH if NULL
+ *
+ * Maps read-only a segment created by rig_shm_create(),
+ * possibly from another process.
+ *
+ * \return a handle to the segment, or NULL if it does not exist
+ * or is not a rig state segment.
+ *
+ * \sa rig_shm_read(), rig_shm_close()
+ */
+rig_shm_t * HAMLIB_API rig_shm_attach(const char *path)
+{
+#ifdef HAVE_SYS_MMAN_H
+	rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+	return shm_map(path ? path : RIG_SHM_DEFAULT_PATH, 0);
+#else
+	rig_debug(RIG_DEBUG_ERR, "%s: shared memory not supported\n", __func__);
+	return NULL;
+#endif
+}
+
+/**
+ * \brief release a shared memory segment handle
+ * \param shm	The segment handle
+ *
+ * Unmaps the segment. The file itself is left in place, so that readers
+ * still attached keep seeing the last published state.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured.
+ */
+int HAMLIB_API rig_shm_close(rig_shm_t *shm)
+{
+	if (!shm)
+		return -RIG_EINVAL;
+
+#ifdef HAVE_SYS_MMAN_H
+	munmap((void *)shm->seg, sizeof(struct rig_shm_segment));
+	close(shm->fd);
+#endif
+#ifdef HAVE_PTHREAD
+	pthread_mutex_destroy(&shm->mutex);
+#endif
+	free(shm);
+
+	return RIG_OK;
+}
+
+/* the update of the segment, the caller being the only writer */
+static void shm_publish(rig_shm_t *shm, const struct rig_shm_snapshot *snap)
+{
+	struct rig_shm_segment *seg = shm->seg;
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+
+	seg->seq++;
+	shm_barrier();
+
+	seg->snap = *snap;
+	seg->snap.rig_model = shm->rig_model;
+	seg->snap.serial = ++shm->serial;
+	seg->snap.tv_sec = tv.tv_sec;
+	seg->snap.tv_usec = tv.tv_usec;
+
+	shm_barrier();
+	seg->seq++;
+}
+
+/**
+ * \brief publish a rig state snapshot
+ * \param shm	The segment handle, created by rig_shm_create()
+ * \param snap	The state to publish
+ *
+ * Copies \a snap to the segment under the seqlock. The serial and
+ * date fields are filled in by this function.
+ *
+ * Several threads may publish at the same time, they wait for each
+ * other. So this function must not be called while holding the rig
+ * published by rig_shm_publish_rig() from another thread, e.g. from
+ * one of its event callbacks.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured.
+ *
+ * \sa rig_shm_publish_rig()
+ */
+int HAMLIB_API rig_shm_publish(rig_shm_t *shm, const struct rig_shm_snapshot *snap)
+{
+	if (!shm || !snap || !shm->writer)
+		return -RIG_EINVAL;
+
+#ifdef HAVE_PTHREAD
+	pthread_mutex_lock(&shm->mutex);
+#endif
+	shm_publish(shm, snap);
+#ifdef HAVE_PTHREAD
+	pthread_mutex_unlock(&shm->mutex);
+#endif
+
+	return RIG_OK;
+}
+
+/**
+ * \brief fill a snapshot with the live state of a rig
+ * \param rig	The rig handle
+ * \param snap	The location where to store the state
+ *
+ * Copies the current VFO, frequency, mode, passband, PTT and Tx VFO
+ * as last known by the frontend, without any access to the rig port.
+ * The serial and date fields are zeroed.
+ * The handle is locked meanwhile, so the snapshot may be taken from
+ * another thread than the ones using the rig.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured.
+ */
+int HAMLIB_API rig_shm_snapshot_rig(RIG *rig, struct rig_shm_snapshot *snap)
+{
+	if (!rig || !rig->caps || !snap)
+		return -RIG_EINVAL;
+
+	RIG_LOCK(rig);
+
+	memset(snap, 0, sizeof(struct rig_shm_snapshot));
+	snap->rig_model = rig->caps->rig_model;
+	snap->vfo = rig->state.current_vfo;
+	snap->freq = rig->state.current_freq;
+	snap->mode = rig->state.current_mode;
+	snap->width = rig->state.current_width;
+	snap->ptt = rig->state.current_ptt;
+	snap->tx_vfo = rig->state.tx_vfo;
+
+	return RIG_OK;
+}
+
+/**
+ * \brief publish the live state of a rig
+ * \param shm	The segment handle, created by rig_shm_create()
+ * \param rig	The rig handle
+ *
+ * Publishes the current VFO, frequency, mode, passband, PTT and Tx VFO
+ * as last known by the frontend, without any access to the rig port.
+ *
+ * This function may be called from event callbacks, and from several
+ * threads at the same time. It never waits for another publication:
+ * when one is in progress, the update is left to the thread making it,
+ * which publishes once more with fresh values before returning.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured.
+ *
+ * \sa rig_shm_publish()
+ */
+int HAMLIB_API rig_shm_publish_rig(rig_shm_t *shm, RIG *rig)
+{
+	struct rig_shm_snapshot snap;
+	int retcode;
+
+	if (!shm || !rig || !shm->writer)
+		return -RIG_EINVAL;
+
+#ifdef HAVE_PTHREAD
+	/*
+	 * The holder of the mutex takes the flag before each snapshot, and
+	 * looks at it again once unlocked, so that an update flagged while
+	 * it was unlocking is not lost.
+	 */
+	shm->dirty = 1;
+	shm_barrier();
+	while (shm->dirty && pthread_mutex_trylock(&shm->mutex) == 0) {
+		while (shm_take_flag(&shm->dirty)) {
+			retcode = rig_shm_snapshot_rig(rig, &snap);
+			if (retcode != RIG_OK) {
+				pthread_mutex_unlock(&shm->mutex);
+				return retcode;
+			}
+			shm_publish(shm, &snap);
+		}
+		pthread_mutex_unlock(&shm->mutex);
+		shm_barrier();
+	}
+#else
+	/* called again from a signal handler, while publishing */
+	if (shm->busy) {
+		shm->dirty = 1;
+		return RIG_OK;
+	}
+	shm->busy = 1;
+
+	do {
+		shm->dirty = 0;
+
+		retcode = rig_shm_snapshot_rig(rig, &snap);
+		if (retcode == RIG_OK)
+			shm_publish(shm, &snap);
+	} while (retcode == RIG_OK && shm->dirty);
+
+	shm->busy = 0;
+
+	if (retcode != RIG_OK)
+		return retcode;
+#endif
+
+	return RIG_OK;
+}
+
+/**
+ * \brief read a consistent rig state snapshot
+ * \param shm	The segment handle, from rig_shm_attach() or rig_shm_create()
+ * \param snap	The location where to store the state
+ *
+ * Lock-free read of the segment. No system call is involved.
+ *
+ * \return RIG_OK if the operation has been sucessful, -RIG_EPROTO
+ * if the segment was not initialized by a compatible publisher,
+ * -RIG_ETIMEOUT if no consistent copy could be obtained (e.g. the
+ * publisher died in the middle of an update).
+ */
+int HAMLIB_API rig_shm_read(const rig_shm_t *shm, struct rig_shm_snapshot *snap)
+{
+	const struct rig_shm_segment *seg;
+	unsigned int seq1, seq2;
+	int retry;
+
+	if (!shm || !snap)
+		return -RIG_EINVAL;
+
+	seg = shm->seg;
+
+	for (retry = 0; retry < RIG_SHM_READ_RETRY; retry++) {
+		seq1 = seg->seq;
+		if (seq1 & 1)
+			continue;
+		shm_barrier();
+
+		if (seg->magic != RIG_SHM_MAGIC ||
+				seg->snap_size != sizeof(struct rig_shm_snapshot))
+			return -RIG_EPROTO;
+		*snap = seg->snap;
+
+		shm_barrier();
+		seq2 = seg->seq;
+		if (seq1 == seq2)
+			return RIG_OK;
+	}
+
+	return -RIG_ETIMEOUT;
+}
+
+/**
+ * \brief encode a snapshot as a state datagram
+ * \param buf		The output buffer
+ * \param len		Size of \a buf, RIG_SHM_DGRAM_MAX is always enough
+ * \param snap		The state to encode
+ * \param keyframe	Non-zero for a periodic keyframe, zero for an update
+ *
+ * The datagram is a single line of text, e.g.
+ * "HSTATE1 U 42 1 1 14074000 2 2400 0 1 1334329200 250000\n",
+ * holding the kind (K for keyframe, U for update), serial, rig model,
+ * VFO, frequency in Hz, mode, passband, PTT, Tx VFO and date.
+ * Numbers are written without decimal separator, so the encoding does
+ * not depend on the locale.
+ *
+ * \return the length of the datagram, or a negative value if an error occured.
+ *
+ * \sa rig_shm_decode()
+ */
+int HAMLIB_API rig_shm_encode(char *buf, int len, const struct rig_shm_snapshot *snap, int keyframe)
+{
+	int n;
+
+	if (!buf || !snap)
+		return -RIG_EINVAL;
+
+	n = snprintf(buf, len, "%s %c %lu %d %x %.0f %x %ld %d %x %ld %ld\n",
+			RIG_SHM_DGRAM_MAGIC, keyframe ? 'K' : 'U',
+			snap->serial, snap->rig_model, (unsigned)snap->vfo, snap->freq,
+			(unsigned)snap->mode, snap->width, snap->ptt, (unsigned)snap->tx_vfo,
+			snap->tv_sec, snap->tv_usec);
+	if (n < 0 || n >= len)
+		return -RIG_ETRUNC;
+
+	return n;
+}
+
+/**
+ * \brief decode a state datagram
+ * \param buf		The datagram, nul terminated
+ * \param snap		The location where to store the state
+ * \param keyframe	The location where to store the kind of datagram, may be NULL
+ *
+ * \return RIG_OK if the operation has been sucessful, -RIG_EPROTO
+ * if \a buf is not a state datagram.
+ *
+ * \sa rig_shm_encode()
+ */
+int HAMLIB_API rig_shm_decode(const char *buf, struct rig_shm_snapshot *snap, int *keyframe)
+{
+	char kind;
+	unsigned vfo, mode, tx_vfo;
+	int ptt, n;
+
+	if (!buf || !snap)
+		return -RIG_EINVAL;
+
+	if (strncmp(buf, RIG_SHM_DGRAM_MAGIC " ", sizeof(RIG_SHM_DGRAM_MAGIC)))
+		return -RIG_EPROTO;
+
+	n = sscanf(buf + sizeof(RIG_SHM_DGRAM_MAGIC),
+			"%c %lu %d %x %lf %x %ld %d %x %ld %ld",
+			&kind, &snap->serial, &snap->rig_model, &vfo, &snap->freq,
+			&mode, &snap->width, &ptt, &tx_vfo,
+			&snap->tv_sec, &snap->tv_usec);
+	if (n != 11 || (kind != 'K' && kind != 'U'))
+		return -RIG_EPROTO;
+
+	snap->vfo = vfo;
+	snap->mode = mode;
+	snap->ptt = ptt;
+	snap->tx_vfo = tx_vfo;
+	if (keyframe)
+		*keyframe = kind == 'K';
+
+	return RIG_OK;
+}
+
+/** @} */
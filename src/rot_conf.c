@@ -43,6 +43,7 @@
 
 #include "rot_conf.h"
 #include "token.h"
+#include "lock.h"
 
 
 /*
@@ -67,6 +68,10 @@ static const struct confparams rotfrontend_cfg_params[] = {
 	{ TOK_RETRY, "retry", "Retry", "Max number of retry",
 			"0", RIG_CONF_NUMERIC, { .n = { 0, 10, 1 } }
 	},
+	{ TOK_TIMEOUT_ADAPTIVE, "timeout_adaptive", "Adaptive timeout",
+			"Shorten the timeout to the observed response times, timeout being the ceiling",
+			"0", RIG_CONF_CHECKBUTTON, { }
+	},
 
 	{ TOK_MIN_AZ, "min_az", "Minimum azimuth",
 			"Minimum rotator azimuth in degrees",
@@ -84,6 +89,14 @@ static const struct confparams rotfrontend_cfg_params[] = {
 			"Maximum rotator elevation in degrees",
 			"90", RIG_CONF_NUMERIC, { .n = { -90, 180, .001 } }
 	},
+	{ TOK_POS_INTERVAL, "pos_interval", "Position interval",
+			"Min delay in ms between two positions sent, the last one set being kept meanwhile, 0 to send each one",
+			"0", RIG_CONF_NUMERIC, { .n = { 0, 10000, 1 } }
+	},
+	{ TOK_POS_DEADBAND, "pos_deadband", "Position deadband",
+			"Positions closer than that to the previous one in degrees are dropped",
+			"0", RIG_CONF_NUMERIC, { .n = { 0, 90, .001 } }
+	},
 
 	{ RIG_CONF_END, NULL, }
 };
@@ -153,6 +166,11 @@ int frontrot_set_conf(ROT *rot, token_t token, const char *val)
 			return -RIG_EINVAL;
 		rs->rotport.retry = val_i;
 		break;
+	case TOK_TIMEOUT_ADAPTIVE:
+		if (1 != sscanf(val, "%d", &val_i))
+			return -RIG_EINVAL;
+		rs->rotport.timeout_adaptive = val_i ? 1 : 0;
+		break;
 
 	case TOK_SERIAL_SPEED:
 		if (rs->rotport.type.rig != RIG_PORT_SERIAL)
@@ -216,6 +234,16 @@ int frontrot_set_conf(ROT *rot, token_t token, const char *val)
 	case TOK_MAX_EL:
 		rs->max_el = atof(val);
 		break;
+	case TOK_POS_INTERVAL:
+		if (1 != sscanf(val, "%d", &val_i) || val_i < 0)
+			return -RIG_EINVAL;
+		rs->pos_interval = val_i;
+		break;
+	case TOK_POS_DEADBAND:
+		rs->pos_deadband = atof(val);
+		if (rs->pos_deadband < 0)
+			rs->pos_deadband = 0;
+		break;
 
 	default:
 		return -RIG_EINVAL;
@@ -253,6 +281,9 @@ int frontrot_get_conf(ROT *rot, token_t token, char *val)
 	case TOK_RETRY:
 		sprintf(val, "%d", rs->rotport.retry);
 		break;
+	case TOK_TIMEOUT_ADAPTIVE:
+		sprintf(val, "%d", rs->rotport.timeout_adaptive);
+		break;
 	case TOK_SERIAL_SPEED:
 		if (rs->rotport.type.rig != RIG_PORT_SERIAL)
 			return -RIG_EINVAL;
@@ -304,6 +335,12 @@ int frontrot_get_conf(ROT *rot, token_t token, char *val)
 	case TOK_MAX_EL:
 		sprintf(val, "%f", rs->max_el);
 		break;
+	case TOK_POS_INTERVAL:
+		sprintf(val, "%d", rs->pos_interval);
+		break;
+	case TOK_POS_DEADBAND:
+		sprintf(val, "%f", rs->pos_deadband);
+		break;
 	default:
 		return -RIG_EINVAL;
 	}
@@ -413,6 +450,8 @@ int HAMLIB_API rot_set_conf(ROT *rot, token_t token, const char *val)
 	if (!rot || !rot->caps)
 		return -RIG_EINVAL;
 
+	ROT_LOCK(rot);
+
 	if (rig_need_debug(RIG_DEBUG_VERBOSE)) {
 		const struct confparams *cfp;
 		char tokenstr[12];
@@ -451,6 +490,8 @@ int HAMLIB_API rot_get_conf(ROT *rot, token_t token, char *val)
 	if (!rot || !rot->caps || !val)
 		return -RIG_EINVAL;
 
+	ROT_LOCK(rot);
+
 	if (IS_TOKEN_FRONTEND(token))
 		return frontrot_get_conf(rot, token, val);
 
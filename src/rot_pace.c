@@ -0,0 +1,351 @@
+/*
+ *  Hamlib Interface - rotator set-point coalescing
+ *  Copyright (c) 2026 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+
+#include <hamlib/rotator.h>
+#include "rot_pace.h"
+#include "lock.h"
+
+#ifdef HAVE_PTHREAD
+#define PACE_LOCK(p) pthread_mutex_lock(&(p)->mutex)
+#define PACE_UNLOCK(p) pthread_mutex_unlock(&(p)->mutex)
+#else
+#define PACE_LOCK(p) ((void)0)
+#define PACE_UNLOCK(p) ((void)0)
+#endif
+
+struct rot_pace {
+	ROT *rot;
+#ifdef HAVE_PTHREAD
+	pthread_mutex_t mutex;	/* protects the fields below */
+	pthread_cond_t cond;	/* a position or quit to handle */
+	pthread_t thread;
+	int running;
+	int quit;
+#endif
+	int pending;		/* az/el not sent yet */
+	azimuth_t az;
+	elevation_t el;
+	int has_last;		/* last_az/last_el taken, sent or pending */
+	azimuth_t last_az;
+	elevation_t last_el;
+	unsigned gen;		/* bumped by rot_pace_cancel */
+	struct timeval next_date;	/* nothing sent before, tv_sec 0 if now */
+	int error;		/* of a position sent in the background */
+	rot_pos_stats_t stats;
+};
+
+
+/* uS before next_date, 0 when passed */
+static long pace_due_us(const struct rot_pace *pace)
+{
+	struct timeval tv;
+	long us;
+
+	if (pace->next_date.tv_sec == 0)
+		return 0;
+
+	gettimeofday(&tv, NULL);
+	us = (pace->next_date.tv_sec - tv.tv_sec)*1000000L +
+		(pace->next_date.tv_usec - tv.tv_usec);
+
+	return us > 0 ? us : 0;
+}
+
+/*
+ * Send a position to the backend, with the handle locked, unless
+ * cancelled meanwhile. Called with pace->mutex unlocked.
+ */
+static int pace_send(struct rot_pace *pace, azimuth_t az, elevation_t el,
+		unsigned gen)
+{
+	ROT *rot = pace->rot;
+	int interval = rot->state.pos_interval;
+	rig_ptr_t lock;
+	struct timeval tv;
+	int ret = RIG_OK;
+	int stale;
+
+	lock = hamlib_lock(rot->state.lock);
+
+	PACE_LOCK(pace);
+	stale = gen != pace->gen;
+	PACE_UNLOCK(pace);
+
+	if (!stale)
+		ret = rot->caps->set_position(rot, az, el);
+
+	hamlib_unlock(lock);
+
+	if (stale)
+		return RIG_OK;
+
+	rot_debug(RIG_DEBUG_TRACE, "%s: %.2f/%.2f sent\n", __func__, az, el);
+
+	gettimeofday(&tv, NULL);
+	tv.tv_usec += interval*1000L;
+	tv.tv_sec += tv.tv_usec / 1000000;
+	tv.tv_usec %= 1000000;
+
+	PACE_LOCK(pace);
+	if (interval > 0)
+		pace->next_date = tv;
+	pace->stats.sent++;
+	if (ret != RIG_OK)
+		pace->stats.errors++;
+	PACE_UNLOCK(pace);
+
+	return ret;
+}
+
+#ifdef HAVE_PTHREAD
+static void *pace_thread(void *arg)
+{
+	struct rot_pace *pace = (struct rot_pace *)arg;
+	struct timespec ts;
+	azimuth_t az;
+	elevation_t el;
+	unsigned gen;
+	long us;
+	int ret;
+
+	pthread_mutex_lock(&pace->mutex);
+
+	while (!pace->quit) {
+		if (!pace->pending) {
+			pthread_cond_wait(&pace->cond, &pace->mutex);
+			continue;
+		}
+
+		us = pace_due_us(pace);
+		if (us > 0) {
+			ts.tv_sec = pace->next_date.tv_sec;
+			ts.tv_nsec = pace->next_date.tv_usec * 1000L;
+			pthread_cond_timedwait(&pace->cond, &pace->mutex, &ts);
+			continue;
+		}
+
+		az = pace->az;
+		el = pace->el;
+		gen = pace->gen;
+		pace->pending = 0;
+
+		pthread_mutex_unlock(&pace->mutex);
+		ret = pace_send(pace, az, el, gen);
+		pthread_mutex_lock(&pace->mutex);
+
+		/* reported by the next rot_set_position() */
+		if (ret != RIG_OK)
+			pace->error = ret;
+	}
+
+	pthread_mutex_unlock(&pace->mutex);
+
+	return NULL;
+}
+#endif
+
+int rot_pace_start(ROT *rot)
+{
+	struct rot_state *rs = &rot->state;
+	struct rot_pace *pace = rs->pace;
+
+	if (rs->pos_interval <= 0 && rs->pos_deadband <= 0) {
+		rot_pace_free(rot);
+		return RIG_OK;
+	}
+
+	if (!pace) {
+		pace = calloc(1, sizeof(struct rot_pace));
+		if (!pace)
+			return -RIG_ENOMEM;
+#ifdef HAVE_PTHREAD
+		pthread_mutex_init(&pace->mutex, NULL);
+		pthread_cond_init(&pace->cond, NULL);
+#endif
+		pace->rot = rot;
+		rs->pace = pace;
+	}
+
+	pace->pending = 0;
+	pace->has_last = 0;
+	pace->next_date.tv_sec = 0;
+	pace->error = RIG_OK;
+	memset(&pace->stats, 0, sizeof(pace->stats));
+
+#ifdef HAVE_PTHREAD
+	pace->quit = 0;
+	pace->running = 0;
+	/* only the rate limiting needs a thread */
+	if (rs->pos_interval > 0)
+		pace->running = pthread_create(&pace->thread, NULL,
+				pace_thread, pace) == 0;
+	if (rs->pos_interval > 0 && !pace->running)
+		rot_debug(RIG_DEBUG_WARN, "%s: no thread, positions sent "
+				"by the next calls\n", __func__);
+#endif
+
+	return RIG_OK;
+}
+
+int rot_pace_set(ROT *rot, azimuth_t az, elevation_t el)
+{
+	struct rot_state *rs = &rot->state;
+	struct rot_pace *pace = rs->pace;
+	unsigned gen;
+	int ret;
+
+	PACE_LOCK(pace);
+
+	pace->stats.requests++;
+
+	/* a failure in the background is reported once */
+	ret = pace->error;
+	pace->error = RIG_OK;
+
+	if (pace->has_last &&
+			fabsf(az - pace->last_az) < rs->pos_deadband &&
+			fabsf(el - pace->last_el) < rs->pos_deadband) {
+		pace->stats.dropped++;
+		PACE_UNLOCK(pace);
+		return ret;
+	}
+
+	if (pace->pending)
+		pace->stats.coalesced++;
+
+	pace->pending = 1;
+	pace->az = pace->last_az = az;
+	pace->el = pace->last_el = el;
+	pace->has_last = 1;
+
+#ifdef HAVE_PTHREAD
+	if (pace->running) {
+		pthread_cond_signal(&pace->cond);
+		PACE_UNLOCK(pace);
+		return ret;
+	}
+#endif
+
+	/* no thread, send it now if due, otherwise keep it for later */
+	if (pace_due_us(pace) > 0) {
+		PACE_UNLOCK(pace);
+		return ret;
+	}
+
+	pace->pending = 0;
+	gen = pace->gen;
+	PACE_UNLOCK(pace);
+
+	return pace_send(pace, az, el, gen);
+}
+
+void rot_pace_cancel(ROT *rot)
+{
+	struct rot_pace *pace = rot->state.pace;
+
+	if (!pace)
+		return;
+
+	PACE_LOCK(pace);
+	pace->gen++;
+	pace->pending = 0;
+	pace->has_last = 0;
+	PACE_UNLOCK(pace);
+}
+
+void rot_pace_stop(ROT *rot)
+{
+	struct rot_pace *pace = rot->state.pace;
+	azimuth_t az;
+	elevation_t el;
+	unsigned gen;
+	int pending;
+
+	if (!pace)
+		return;
+
+#ifdef HAVE_PTHREAD
+	if (pace->running) {
+		PACE_LOCK(pace);
+		pace->quit = 1;
+		pthread_cond_signal(&pace->cond);
+		PACE_UNLOCK(pace);
+		pthread_join(pace->thread, NULL);
+		pace->running = 0;
+	}
+#endif
+
+	PACE_LOCK(pace);
+	pending = pace->pending;
+	az = pace->az;
+	el = pace->el;
+	gen = pace->gen;
+	pace->pending = 0;
+	PACE_UNLOCK(pace);
+
+	/* the last position is the one that matters */
+	if (pending)
+		pace_send(pace, az, el, gen);
+
+	rot_debug(RIG_DEBUG_VERBOSE, "%s: %lu position(s) set, %lu sent, "
+			"%lu coalesced, %lu dropped, %lu error(s)\n", __func__,
+			pace->stats.requests, pace->stats.sent,
+			pace->stats.coalesced, pace->stats.dropped,
+			pace->stats.errors);
+}
+
+void rot_pace_free(ROT *rot)
+{
+	struct rot_pace *pace = rot->state.pace;
+
+	if (!pace)
+		return;
+
+#ifdef HAVE_PTHREAD
+	pthread_cond_destroy(&pace->cond);
+	pthread_mutex_destroy(&pace->mutex);
+#endif
+	free(pace);
+	rot->state.pace = NULL;
+}
+
+int rot_pace_get_stats(ROT *rot, rot_pos_stats_t *stats)
+{
+	struct rot_pace *pace = rot->state.pace;
+
+	if (!pace)
+		return -RIG_ENAVAIL;
+
+	PACE_LOCK(pace);
+	*stats = pace->stats;
+	PACE_UNLOCK(pace);
+
+	return RIG_OK;
+}
@@ -0,0 +1,55 @@
+/*
+ *  Hamlib Interface - rotator set-point coalescing header
+ *  Copyright (c) 2026 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef _ROT_PACE_H
+#define _ROT_PACE_H 1
+
+#include <hamlib/rotator.h>
+
+__BEGIN_DECLS
+
+/*
+ * Coalescing of the positions set on a rotator, according to
+ * rs->pos_interval and rs->pos_deadband, rs->pace being its state.
+ *
+ * rot_pace_start is called by rot_open, it sets up rs->pace when
+ *	either is set, otherwise positions go straight to the backend.
+ * rot_pace_set keeps the position as the next one to send, unless
+ *	within the deadband of the previous one. It is sent by a
+ *	thread, no more often than pos_interval. Without threads, it is
+ *	sent right away when due, otherwise left for a later call.
+ * rot_pace_cancel forgets the position not sent yet, for the motion
+ *	commands overriding it. It is called with the handle locked.
+ * rot_pace_stop is called by rot_close, before locking the handle,
+ *	and sends the position left.
+ * rot_pace_free releases rs->pace, once stopped.
+ * rot_pace_get_stats does not lock the handle, never blocking either.
+ */
+extern int rot_pace_start(ROT *rot);
+extern int rot_pace_set(ROT *rot, azimuth_t az, elevation_t el);
+extern void rot_pace_cancel(ROT *rot);
+extern void rot_pace_stop(ROT *rot);
+extern void rot_pace_free(ROT *rot);
+extern int rot_pace_get_stats(ROT *rot, rot_pos_stats_t *stats);
+
+__END_DECLS
+
+#endif /* _ROT_PACE_H */
@@ -42,6 +42,7 @@
 #include <ltdl.h>
 
 #include <hamlib/rotator.h>
+#include "lock.h"
 
 
 #ifndef PATH_MAX
@@ -99,21 +100,28 @@ int HAMLIB_API rot_register(const struct rot_caps *caps)
 
 	rot_debug(RIG_DEBUG_VERBOSE, "rot_register (%d)\n",caps->rot_model);
 
-#ifndef DONT_WANT_DUP_CHECK
-	if (rot_get_caps(caps->rot_model)!=NULL)
-		return -RIG_EINVAL;
-#endif
-
 	p = (struct rot_list*)malloc(sizeof(struct rot_list));
 	if (!p)
 		return -RIG_ENOMEM;
 
+	hamlib_registry_lock();
+
+#ifndef DONT_WANT_DUP_CHECK
+	if (rot_get_caps(caps->rot_model)!=NULL) {
+		hamlib_registry_unlock();
+		free(p);
+		return -RIG_EINVAL;
+	}
+#endif
+
 	hval = HASH_FUNC(caps->rot_model);
 	p->caps = caps;
 	p->handle = NULL;
 	p->next = rot_hash_table[hval];
 	rot_hash_table[hval] = p;
 
+	hamlib_registry_unlock();
+
 	return RIG_OK;
 }
 
@@ -125,12 +133,18 @@ int HAMLIB_API rot_register(const struct rot_caps *caps)
 const struct rot_caps * HAMLIB_API rot_get_caps(rot_model_t rot_model)
 {
 	struct rot_list *p;
+	const struct rot_caps *caps = NULL;
 
+	hamlib_registry_lock();
 	for (p = rot_hash_table[HASH_FUNC(rot_model)]; p; p=p->next) {
-		if (p->caps->rot_model == rot_model)
-			return p->caps;
+		if (p->caps->rot_model == rot_model) {
+			caps = p->caps;
+			break;
+		}
 	}
-	return NULL;	/* sorry, caps not registered! */
+	hamlib_registry_unlock();
+
+	return caps;	/* NULL if caps not registered! */
 }
 
 /*
@@ -162,10 +176,13 @@ int HAMLIB_API rot_check_backend(rot_model_t rot_model)
 	int be_idx;
 	int retval;
 
-	/* already loaded ? */
+	/* already loaded ? loaded at most once, by the first rot_init */
+	hamlib_registry_lock();
 	caps = rot_get_caps(rot_model);
-	if (caps)
+	if (caps) {
+		hamlib_registry_unlock();
 		return RIG_OK;
+	}
 
 	be_idx = rot_lookup_backend(rot_model);
 
@@ -176,11 +193,14 @@ int HAMLIB_API rot_check_backend(rot_model_t rot_model)
 		rot_debug(RIG_DEBUG_VERBOSE, "rot_check_backend: unsupported "
 					"backend %d for model %d\n",
 					ROT_BACKEND_NUM(rot_model), rot_model);
+		hamlib_registry_unlock();
 		return -RIG_ENAVAIL;
 	}
 
 	retval = rot_load_backend(rot_backend_list[be_idx].be_name);
 
+	hamlib_registry_unlock();
+
 	return retval;
 }
 
@@ -193,17 +213,21 @@ int HAMLIB_API rot_unregister(rot_model_t rot_model)
 
 	hval = HASH_FUNC(rot_model);
 	q = NULL;
+	hamlib_registry_lock();
 	for (p = rot_hash_table[hval]; p; p=p->next) {
 		if (p->caps->rot_model == rot_model) {
 			if (q == NULL)
 				rot_hash_table[hval] = p->next;
 			else
 				q->next = p->next;
+			hamlib_registry_unlock();
 			free(p);
 			return RIG_OK;
 		}
 		q = p;
 	}
+	hamlib_registry_unlock();
+
 	return -RIG_EINVAL;	/* sorry, caps not registered! */
 }
 
@@ -219,11 +243,15 @@ int HAMLIB_API rot_list_foreach(int (*cfunc)(const struct rot_caps*, rig_ptr_t),
 	if (!cfunc)
 		return -RIG_EINVAL;
 
+	hamlib_registry_lock();
 	for (i=0; i<ROTLSTHASHSZ; i++) {
 		for (p=rot_hash_table[i]; p; p=p->next)
-			if ((*cfunc)(p->caps,data) == 0)
+			if ((*cfunc)(p->caps,data) == 0) {
+				hamlib_registry_unlock();
 				return RIG_OK;
+			}
 	}
+	hamlib_registry_unlock();
 	return RIG_OK;
 }
 
@@ -263,7 +291,7 @@ int rot_load_all_backends()
  * rot_load_backend
  * Dynamically load a rot backend through dlopen mechanism
  */
-int HAMLIB_API rot_load_backend(const char *be_name)
+static int do_rot_load_backend(const char *be_name)
 {
 # define PREFIX "hamlib-"
 
@@ -346,3 +374,14 @@ int HAMLIB_API rot_load_backend(const char *be_name)
  	return status;
 }
 
+int HAMLIB_API rot_load_backend(const char *be_name)
+{
+	int status;
+
+	hamlib_registry_lock();
+	status = do_rot_load_backend(be_name);
+	hamlib_registry_unlock();
+
+	return status;
+}
+
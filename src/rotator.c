@@ -61,6 +61,8 @@
 #include "network.h"
 #include "rot_conf.h"
 #include "token.h"
+#include "lock.h"
+#include "rot_pace.h"
 
 
 #ifndef DOC_HIDDEN
@@ -93,6 +95,7 @@ struct opened_rot_l {
 		struct opened_rot_l *next;
 };
 static struct opened_rot_l *opened_rot_list = { NULL };
+HAMLIB_MUTEX(opened_rot_lock)
 
 /*
  * track which rot is opened (with rot_open)
@@ -105,8 +108,10 @@ static int add_opened_rot(ROT *rot)
 	if (!p)
 			return -RIG_ENOMEM;
 	p->rot = rot;
+	HAMLIB_MUTEX_LOCK(opened_rot_lock);
 	p->next = opened_rot_list;
 	opened_rot_list = p;
+	HAMLIB_MUTEX_UNLOCK(opened_rot_lock);
 	return RIG_OK;
 }
 
@@ -115,6 +120,7 @@ static int remove_opened_rot(ROT *rot)
 	struct opened_rot_l *p,*q;
 	q = NULL;
 
+	HAMLIB_MUTEX_LOCK(opened_rot_lock);
 	for (p=opened_rot_list; p; p=p->next) {
 		if (p->rot == rot) {
 			if (q == NULL) {
@@ -122,11 +128,13 @@ static int remove_opened_rot(ROT *rot)
 			} else {
 				q->next = p->next;
 			}
+			HAMLIB_MUTEX_UNLOCK(opened_rot_lock);
 			free(p);
 			return RIG_OK;
 		}
 		q = p;
 	}
+	HAMLIB_MUTEX_UNLOCK(opened_rot_lock);
 	return -RIG_EINVAL;	/* Not found in list ! */
 }
 #endif /* !DOC_HIDDEN */
@@ -154,10 +162,12 @@ int foreach_opened_rot(int (*cfunc)(ROT *, rig_ptr_t), rig_ptr_t data)
 {
 	struct opened_rot_l *p;
 
+	HAMLIB_MUTEX_LOCK(opened_rot_lock);
 	for (p=opened_rot_list; p; p=p->next) {
 		if ((*cfunc)(p->rot,data) == 0)
-			return RIG_OK;
+			break;
 	}
+	HAMLIB_MUTEX_UNLOCK(opened_rot_lock);
 	return RIG_OK;
 }
 
@@ -206,6 +216,8 @@ ROT * HAMLIB_API rot_init(rot_model_t rot_model)
            that we now what we are doing */
 	rot->caps = (struct rot_caps *) caps;
 
+	rot->state.lock = hamlib_lock_new();
+
 	/*
 	 * populate the rot->state
 	 * TODO: read the Preferences here!
@@ -261,6 +273,7 @@ ROT * HAMLIB_API rot_init(rot_model_t rot_model)
 		if (retcode != RIG_OK) {
 			rot_debug(RIG_DEBUG_VERBOSE,"rot:backend_init failed!\n");
 			/* cleanup and exit */
+			hamlib_lock_free(rot->state.lock);
 			free(rot);
 			return NULL;
 		}
@@ -297,6 +310,8 @@ int HAMLIB_API rot_open(ROT *rot)
 	if (!rot || !rot->caps)
 		return -RIG_EINVAL;
 
+	ROT_LOCK(rot);
+
 	caps = rot->caps;
 	rs = &rot->state;
 
@@ -363,7 +378,7 @@ int HAMLIB_API rot_open(ROT *rot)
 		}
 	}
 
-	return RIG_OK;
+	return rot_pace_start(rot);
 }
 
 /**
@@ -390,6 +405,12 @@ int HAMLIB_API rot_close(ROT *rot)
 	if (!rot || !rot->caps)
 		return -RIG_EINVAL;
 
+	/* before locking, the position left is sent in the background */
+	if (rot->state.comm_state)
+		rot_pace_stop(rot);
+
+	ROT_LOCK(rot);
+
 	caps = rot->caps;
 	rs = &rot->state;
 
@@ -465,6 +486,9 @@ int HAMLIB_API rot_cleanup(ROT *rot)
 	if (rot->caps->rot_cleanup)
 		rot->caps->rot_cleanup(rot);
 
+	rot_pace_free(rot);
+
+	hamlib_lock_free(rot->state.lock);
 	free(rot);
 
 	return RIG_OK;
@@ -478,11 +502,18 @@ int HAMLIB_API rot_cleanup(ROT *rot)
  *
  * Sets the azimuth and elevation of the rotator.
  *
+ * With the "pos_interval" conf set, the call does not wait for the
+ * rotator: the position is kept and sent by the frontend no more often
+ * than that, a later position replacing it meanwhile. With "pos_deadband",
+ * a position closer than that to the previous one is dropped. Either
+ * suits trackers setting the position many times a second. A failure
+ * to send is then returned by the next call.
+ *
  * \return RIG_OK if the operation has been sucessful, otherwise
  * a negative value if an error occured (in which case, cause is
  * set appropriately).
  *
- * \sa rot_get_position()
+ * \sa rot_get_position(), rot_get_pos_stats()
  */
 
 int HAMLIB_API rot_set_position (ROT *rot, azimuth_t azimuth, elevation_t elevation)
@@ -503,6 +534,12 @@ int HAMLIB_API rot_set_position (ROT *rot, azimuth_t azimuth, elevation_t elevat
 	if (caps->set_position == NULL)
 		return -RIG_ENAVAIL;
 
+	/* not waiting for the handle, taken while sending */
+	if (rs->pace)
+		return rot_pace_set(rot, azimuth, elevation);
+
+	ROT_LOCK(rot);
+
 	return caps->set_position(rot, azimuth, elevation);
 }
 
@@ -528,6 +565,8 @@ int HAMLIB_API rot_get_position (ROT *rot, azimuth_t *azimuth, elevation_t *elev
 	if (CHECK_ROT_ARG(rot) || !azimuth || !elevation)
 		return -RIG_EINVAL;
 
+	ROT_LOCK(rot);
+
 	caps = rot->caps;
 
 	if (caps->get_position == NULL)
@@ -555,11 +594,15 @@ int HAMLIB_API rot_park (ROT *rot)
 	if (CHECK_ROT_ARG(rot))
 		return -RIG_EINVAL;
 
+	ROT_LOCK(rot);
+
 	caps = rot->caps;
 
 	if (caps->park == NULL)
 		return -RIG_ENAVAIL;
 
+	rot_pace_cancel(rot);
+
 	return caps->park(rot);
 }
 
@@ -582,11 +625,15 @@ int HAMLIB_API rot_stop (ROT *rot)
 	if (CHECK_ROT_ARG(rot))
 		return -RIG_EINVAL;
 
+	ROT_LOCK(rot);
+
 	caps = rot->caps;
 
 	if (caps->stop == NULL)
 		return -RIG_ENAVAIL;
 
+	rot_pace_cancel(rot);
+
 	return caps->stop(rot);
 }
 
@@ -610,11 +657,15 @@ int HAMLIB_API rot_reset (ROT *rot, rot_reset_t reset)
 	if (CHECK_ROT_ARG(rot))
 		return -RIG_EINVAL;
 
+	ROT_LOCK(rot);
+
 	caps = rot->caps;
 
 	if (caps->reset == NULL)
 		return -RIG_ENAVAIL;
 
+	rot_pace_cancel(rot);
+
 	return caps->reset(rot, reset);
 }
 
@@ -634,11 +685,15 @@ int HAMLIB_API rot_move (ROT *rot, int direction, int speed)
         if (CHECK_ROT_ARG(rot))
             return -RIG_EINVAL;
 
+        ROT_LOCK(rot);
+
         caps = rot->caps;
 
         if (caps->move == NULL)
             return -RIG_ENAVAIL;
 
+        rot_pace_cancel(rot);
+
         return caps->move(rot, direction, speed);
 }
 
@@ -658,10 +713,61 @@ const char* HAMLIB_API rot_get_info(ROT *rot)
 	if (CHECK_ROT_ARG(rot))
 		return NULL;
 
+	ROT_LOCK(rot);
+
 	if (rot->caps->get_info == NULL)
 		return NULL;
 
 	return rot->caps->get_info(rot);
 }
 
+/**
+ * \brief get the I/O statistics of the rotator port
+ * \param rot	The rot handle
+ * \param stats	The location where to store the statistics
+ *
+ * Retrieves the I/O counters and latency histograms collected
+ * on the rotator communication port since rot_open().
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa port_stats_t, rig_get_port_stats()
+ */
+int HAMLIB_API rot_get_port_stats(ROT *rot, port_stats_t *stats)
+{
+	if (CHECK_ROT_ARG(rot) || !stats)
+		return -RIG_EINVAL;
+
+	ROT_LOCK(rot);
+
+	*stats = rot->state.rotport.stats;
+
+	return RIG_OK;
+}
+
+/**
+ * \brief get the statistics of the positions set on the rotator
+ * \param rot	The rot handle
+ * \param stats	The location where to store the statistics
+ *
+ * Retrieves how many positions were sent since rot_open(), and how many
+ * were coalesced or dropped, with the "pos_interval" or "pos_deadband"
+ * conf set. It does not wait for a position being sent.
+ *
+ * \return RIG_OK if the operation has been sucessful, -RIG_ENAVAIL when
+ * the positions are not coalesced, otherwise a negative value if an error
+ * occured.
+ *
+ * \sa rot_set_position(), rot_pos_stats_t
+ */
+int HAMLIB_API rot_get_pos_stats(ROT *rot, rot_pos_stats_t *stats)
+{
+	if (CHECK_ROT_ARG(rot) || !stats)
+		return -RIG_EINVAL;
+
+	return rot_pace_get_stats(rot, stats);
+}
+
 /*! @} */
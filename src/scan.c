@@ -0,0 +1,364 @@
+/** \addtogroup rig
+ * @{
+ */
+
+/**
+ * \file src/scan.c
+ * \brief Software scan engine
+ * \author the Hamlib Group
+ * \date 2026
+ *
+ * Hamlib interface is a frontend implementing wrapper functions.
+ *
+ */
+
+/*
+ *  Hamlib Interface - software scan
+ *  Copyright (c) 2026 by the Hamlib Group
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include <hamlib/rig.h>
+#include "lock.h"
+
+#ifndef DOC_HIDDEN
+
+#define CHECK_RIG_ARG(r) (!(r) || !(r)->caps || !(r)->state.comm_state)
+
+#define SCAN_HIT_STOP 2
+
+/*
+ * How a channel gets tuned, picked once before scanning
+ */
+enum tune_method {
+	TUNE_FREQ,	/* frequency list, set_freq */
+	TUNE_MEM,	/* memory list, set_mem */
+	TUNE_CHANNEL	/* memory list without set_mem, cached channel data */
+};
+
+struct scan_ctx {
+	RIG *rig;
+	const struct rig_sw_scan *scan;
+	enum tune_method method;
+	channel_t *chans;	/* TUNE_CHANNEL only */
+};
+
+static long elapsed_ms(const struct timeval *t)
+{
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+	return (now.tv_sec - t->tv_sec)*1000 + (now.tv_usec - t->tv_usec)/1000;
+}
+
+static int tune(struct scan_ctx *ctx, int idx)
+{
+	RIG *rig = ctx->rig;
+	const struct rig_sw_scan *scan = ctx->scan;
+	channel_t *chan;
+	int retcode;
+
+	switch (ctx->method) {
+	case TUNE_FREQ:
+		return rig_set_freq(rig, RIG_VFO_CURR, scan->freqs[idx]);
+
+	case TUNE_MEM:
+		return rig_set_mem(rig, RIG_VFO_CURR, scan->channels[idx]);
+
+	case TUNE_CHANNEL:
+		chan = &ctx->chans[idx];
+		retcode = rig_set_freq(rig, RIG_VFO_CURR, chan->freq);
+		if (retcode == RIG_OK && chan->mode != RIG_MODE_NONE)
+			retcode = rig_set_mode(rig, RIG_VFO_CURR, chan->mode, chan->width);
+		return retcode;
+	}
+
+	return -RIG_EINTERNAL;
+}
+
+/*
+ * Sample the stop condition.
+ * Returns 1 on hit, 0 otherwise, or a negative error code.
+ */
+static int sample(struct scan_ctx *ctx, value_t *val)
+{
+	RIG *rig = ctx->rig;
+	const struct rig_sw_scan *scan = ctx->scan;
+	dcd_t dcd;
+	int retcode;
+
+	val->i = 0;
+
+	switch (scan->stop) {
+	case RIG_SW_SCAN_STOP_DCD:
+		retcode = rig_get_dcd(rig, RIG_VFO_CURR, &dcd);
+		if (retcode != RIG_OK)
+			return retcode;
+		val->i = dcd;
+		return dcd == RIG_DCD_ON;
+
+	case RIG_SW_SCAN_STOP_LEVEL:
+		retcode = rig_get_level(rig, RIG_VFO_CURR, scan->level, val);
+		if (retcode != RIG_OK)
+			return retcode;
+		if (RIG_LEVEL_IS_FLOAT(scan->level))
+			return val->f >= scan->threshold.f;
+		return val->i >= scan->threshold.i;
+
+	case RIG_SW_SCAN_STOP_NONE:
+		if (scan->level != RIG_LEVEL_NONE) {
+			retcode = rig_get_level(rig, RIG_VFO_CURR, scan->level, val);
+			if (retcode != RIG_OK)
+				return retcode;
+		}
+		return 1;
+	}
+
+	return -RIG_EINVAL;
+}
+
+/*
+ * One channel: tune, settle, sample, and report the hit.
+ * The handle is held for the whole step, so that other threads
+ * get a chance in between channels, but not in the middle of one.
+ * Returns 1 on hit, 0 otherwise, or a negative error code,
+ * SCAN_HIT_STOP when the hit callback asked to stop.
+ */
+static int scan_step(struct scan_ctx *ctx, int idx)
+{
+	RIG *rig = ctx->rig;
+	const struct rig_sw_scan *scan = ctx->scan;
+	struct timeval hit_start;
+	freq_t freq;
+	value_t val;
+	int retcode, hit;
+
+	RIG_LOCK(rig);
+
+	retcode = tune(ctx, idx);
+	if (retcode != RIG_OK)
+		return retcode;
+
+	if (scan->dwell > 0)
+		usleep(scan->dwell*1000);
+
+	hit = sample(ctx, &val);
+	if (hit <= 0)
+		return hit;
+
+	if (scan->hit_cb) {
+		switch (ctx->method) {
+		case TUNE_FREQ:
+			freq = scan->freqs[idx];
+			break;
+		case TUNE_CHANNEL:
+			freq = ctx->chans[idx].freq;
+			break;
+		default:
+			retcode = rig_get_freq(rig, RIG_VFO_CURR, &freq);
+			if (retcode != RIG_OK)
+				freq = 0;
+			break;
+		}
+		if (scan->hit_cb(rig, scan->vfo, idx, freq, val, scan->arg) != RIG_OK)
+			return SCAN_HIT_STOP;
+	}
+
+	/* stay on the hit while it lasts */
+	if (scan->hold > 0 && scan->stop != RIG_SW_SCAN_STOP_NONE) {
+		gettimeofday(&hit_start, NULL);
+		while (elapsed_ms(&hit_start) < scan->hold) {
+			usleep(scan->dwell > 0 ? scan->dwell*1000 : 10000);
+			retcode = sample(ctx, &val);
+			if (retcode < 0)
+				return retcode;
+			if (!retcode)
+				break;
+		}
+	}
+
+	return 1;
+}
+
+/*
+ * Read the channels once, so that tuning them does not cost
+ * a get_channel transaction each time.
+ */
+static int load_channels(struct scan_ctx *ctx)
+{
+	const struct rig_sw_scan *scan = ctx->scan;
+	int i, retcode;
+
+	ctx->chans = calloc(scan->count, sizeof(channel_t));
+	if (!ctx->chans)
+		return -RIG_ENOMEM;
+
+	for (i = 0; i < scan->count; i++) {
+		ctx->chans[i].vfo = RIG_VFO_MEM;
+		ctx->chans[i].channel_num = scan->channels[i];
+		retcode = rig_get_channel(ctx->rig, &ctx->chans[i]);
+		if (retcode != RIG_OK)
+			return retcode;
+	}
+
+	return RIG_OK;
+}
+
+#endif /* !DOC_HIDDEN */
+
+
+/**
+ * \brief scan a list of frequencies or memory channels
+ * \param rig	The rig handle
+ * \param scan	The scan description
+ *
+ *  Scans the frequencies \a scan->freqs, or else the memory channels
+ *  \a scan->channels, \a scan->passes times, stopping on each channel
+ *  meeting the \a scan->stop condition, the squelch open or a level
+ *  at or above \a scan->threshold.
+ *
+ *  Unlike rig_scan(), which starts the scan of the rig, the scan is
+ *  sequenced by the frontend, so that it works on any rig able to
+ *  tune and report DCD or a level, over arbitrary lists.
+ *  The fastest primitives are used: the VFO is selected only once,
+ *  memory channels are selected by rig_set_mem() when available,
+ *  otherwise read once and tuned by frequency and mode, channels
+ *  flagged RIG_CHFLAG_SKIP being skipped; rig_get_dcd() reads the
+ *  DCD line of the dcd port when there is one.
+ *
+ *  \a scan->hit_cb is called on each hit, \a scan->stats_cb after
+ *  each pass with the channels per second achieved. Returning anything
+ *  but RIG_OK from them stops the scan, so an endless scan (\a passes
+ *  0) needs at least one of them. The scan also ends after a pass
+ *  where every channel was skipped.
+ *  The rig handle is released between channels.
+ *
+ * \return the number of hits if the operation has been sucessful,
+ * otherwise a negative value if an error occured (in which case,
+ * cause is set appropriately).
+ *
+ * \sa rig_scan(), rig_get_dcd(), rig_get_level()
+ */
+
+int HAMLIB_API rig_sw_scan(RIG *rig, const struct rig_sw_scan *scan)
+{
+	const struct rig_caps *caps;
+	struct scan_ctx ctx;
+	struct timeval pass_start;
+	vfo_t curr_vfo;
+	long ms;
+	int retcode, i, pass, scanned, pass_hits, hits = 0;
+
+	if (CHECK_RIG_ARG(rig) || !scan || scan->count <= 0 ||
+			(!scan->freqs && !scan->channels))
+		return -RIG_EINVAL;
+
+	if (scan->stop == RIG_SW_SCAN_STOP_LEVEL &&
+			scan->level == RIG_LEVEL_NONE)
+		return -RIG_EINVAL;
+
+	/* nothing could ever stop it */
+	if (scan->passes <= 0 && !scan->hit_cb && !scan->stats_cb)
+		return -RIG_EINVAL;
+
+	caps = rig->caps;
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.rig = rig;
+	ctx.scan = scan;
+	if (scan->freqs)
+		ctx.method = TUNE_FREQ;
+	else if (caps->set_mem)
+		ctx.method = TUNE_MEM;
+	else
+		ctx.method = TUNE_CHANNEL;
+
+	curr_vfo = rig->state.current_vfo;
+	if (scan->vfo != RIG_VFO_CURR && scan->vfo != curr_vfo) {
+		retcode = rig_set_vfo(rig, scan->vfo);
+		if (retcode != RIG_OK)
+			return retcode;
+	}
+
+	if (ctx.method == TUNE_CHANNEL) {
+		retcode = load_channels(&ctx);
+		if (retcode != RIG_OK) {
+			hits = retcode;
+			goto done;
+		}
+	}
+
+	for (pass = 1; scan->passes <= 0 || pass <= scan->passes; pass++) {
+		gettimeofday(&pass_start, NULL);
+		scanned = 0;
+		pass_hits = 0;
+
+		for (i = 0; i < scan->count; i++) {
+			if (ctx.method == TUNE_CHANNEL &&
+					(ctx.chans[i].flags & RIG_CHFLAG_SKIP))
+				continue;
+
+			retcode = scan_step(&ctx, i);
+			if (retcode == SCAN_HIT_STOP) {
+				hits++;
+				goto done;
+			}
+			if (retcode < 0) {
+				rig_debug(RIG_DEBUG_ERR, "%s: channel %d: %s\n",
+						__func__, i, rigerror(retcode));
+				hits = retcode;
+				goto done;
+			}
+			scanned++;
+			pass_hits += retcode;
+			hits += retcode;
+		}
+
+		if (scanned == 0) {
+			rig_debug(RIG_DEBUG_WARN, "%s: every channel skipped\n",
+					__func__);
+			break;
+		}
+
+		if (scan->stats_cb) {
+			ms = elapsed_ms(&pass_start);
+			if (scan->stats_cb(rig, pass, pass_hits,
+					ms > 0 ? scanned*1000.0/ms : scanned*1000.0,
+					scan->arg) != RIG_OK)
+				break;
+		}
+	}
+
+done:
+	free(ctx.chans);
+
+	if (scan->vfo != RIG_VFO_CURR && scan->vfo != curr_vfo)
+		rig_set_vfo(rig, curr_vfo);
+
+	return hits;
+}
+
+/*! @} */
@@ -47,6 +47,7 @@
 
 #include "hamlib/rig.h"
 #include "cal.h"
+#include "lock.h"
 
 
 #ifndef DOC_HIDDEN
@@ -82,6 +83,8 @@ int HAMLIB_API rig_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_level == NULL || !rig_has_set_level(rig,level))
@@ -136,6 +139,8 @@ int HAMLIB_API rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
 	if (CHECK_RIG_ARG(rig) || !val)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_level == NULL || !rig_has_get_level(rig,level))
@@ -175,6 +180,99 @@ int HAMLIB_API rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
 	return retcode;
 }
 
+/*
+ * Levels read with the VFO already selected, by the backend in one go
+ * for those it can, then one by one.
+ */
+static int get_levels(RIG *rig, vfo_t vfo, setting_t levels, value_t *vals)
+{
+	const struct rig_caps *caps = rig->caps;
+	setting_t setting;
+	value_t rawstr;
+	int i, retcode;
+
+	if (caps->get_levels) {
+		retcode = caps->get_levels(rig, vfo, &levels, vals);
+		if (retcode != RIG_OK)
+			return retcode;
+	}
+
+	for (i = 0; i < RIG_SETTING_MAX && levels; i++) {
+		setting = rig_idx2setting(i);
+		if (!(levels & setting))
+			continue;
+
+		/* calibrated S-meter reading, as in rig_get_level() */
+		if (setting == RIG_LEVEL_STRENGTH &&
+				(caps->has_get_level & RIG_LEVEL_STRENGTH) == 0 &&
+				rig_has_get_level(rig,RIG_LEVEL_RAWSTR) &&
+				rig->state.str_cal.size) {
+			retcode = caps->get_level(rig, vfo, RIG_LEVEL_RAWSTR, &rawstr);
+			if (retcode == RIG_OK)
+				vals[i].i = (int)rig_raw2val(rawstr.i, &rig->state.str_cal);
+		} else {
+			retcode = caps->get_level(rig, vfo, setting, &vals[i]);
+		}
+		if (retcode != RIG_OK)
+			return retcode;
+
+		levels &= ~setting;
+	}
+
+	return RIG_OK;
+}
+
+/**
+ * \brief get the values of several levels
+ * \param rig	The rig handle
+ * \param vfo	The target VFO
+ * \param levels	The levels to get, ORed
+ * \param vals	The location where to store their values, indexed by
+ * rig_setting2idx(), of RIG_SETTING_MAX elements
+ *
+ *  Retrieves the values of several levels, as rig_get_level() would,
+ *  the VFO being selected only once. Backends able to, read several
+ *  levels in one exchange with the rig, e.g. for the meters of a panel.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately), the values of the levels after the failing one
+ * being left unset.
+ *
+ * \sa rig_get_level(), rig_get_funcs()
+ */
+int HAMLIB_API rig_get_levels(RIG *rig, vfo_t vfo, setting_t levels, value_t *vals)
+{
+	const struct rig_caps *caps;
+	int retcode;
+	vfo_t curr_vfo;
+
+	if (CHECK_RIG_ARG(rig) || !vals || !levels)
+		return -RIG_EINVAL;
+
+	RIG_LOCK(rig);
+
+	caps = rig->caps;
+
+	if (caps->get_level == NULL || rig_has_get_level(rig,levels) != levels)
+		return -RIG_ENAVAIL;
+
+	if ((caps->targetable_vfo&RIG_TARGETABLE_PURE) ||
+			vfo == RIG_VFO_CURR || vfo == rig->state.current_vfo)
+		return get_levels(rig, vfo, levels, vals);
+
+	if (!caps->set_vfo)
+		return -RIG_ENTARGET;
+	curr_vfo = rig->state.current_vfo;
+	retcode = caps->set_vfo(rig, vfo);
+	if (retcode != RIG_OK)
+		return retcode;
+
+	retcode = get_levels(rig, vfo, levels, vals);
+	caps->set_vfo(rig, curr_vfo);
+	return retcode;
+}
+
 /**
  * \brief set a radio parameter
  * \param rig	The rig handle
@@ -196,6 +294,8 @@ int HAMLIB_API rig_set_parm(RIG *rig, setting_t parm, value_t val)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	if (rig->caps->set_parm == NULL || !rig_has_set_parm(rig,parm))
 		return -RIG_ENAVAIL;
 
@@ -223,6 +323,8 @@ int HAMLIB_API rig_get_parm(RIG *rig, setting_t parm, value_t *val)
 	if (CHECK_RIG_ARG(rig) || !val)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	if (rig->caps->get_parm == NULL || !rig_has_get_parm(rig,parm))
 		return -RIG_ENAVAIL;
 
@@ -403,6 +505,8 @@ int HAMLIB_API rig_set_func(RIG *rig, vfo_t vfo, setting_t func, int status)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_func == NULL || !rig_has_set_func(rig,func))
@@ -452,6 +556,8 @@ int HAMLIB_API rig_get_func(RIG *rig, vfo_t vfo, setting_t func, int *status)
 	if (CHECK_RIG_ARG(rig) || !func)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_func == NULL || !rig_has_get_func(rig,func))
@@ -473,6 +579,87 @@ int HAMLIB_API rig_get_func(RIG *rig, vfo_t vfo, setting_t func, int *status)
 	return retcode;
 }
 
+/* as get_levels() */
+static int get_funcs(RIG *rig, vfo_t vfo, setting_t funcs, setting_t *status)
+{
+	const struct rig_caps *caps = rig->caps;
+	setting_t setting;
+	int i, retcode, fstatus;
+
+	*status = 0;
+
+	if (caps->get_funcs) {
+		retcode = caps->get_funcs(rig, vfo, &funcs, status);
+		if (retcode != RIG_OK)
+			return retcode;
+	}
+
+	for (i = 0; i < RIG_SETTING_MAX && funcs; i++) {
+		setting = rig_idx2setting(i);
+		if (!(funcs & setting))
+			continue;
+
+		retcode = caps->get_func(rig, vfo, setting, &fstatus);
+		if (retcode != RIG_OK)
+			return retcode;
+		if (fstatus)
+			*status |= setting;
+
+		funcs &= ~setting;
+	}
+
+	return RIG_OK;
+}
+
+/**
+ * \brief get the status of several functions
+ * \param rig	The rig handle
+ * \param vfo	The target VFO
+ * \param funcs	The functions to get the status, ORed
+ * \param status	The location where to store the functions on, ORed
+ *
+ *  Retrieves the status of several functions, as rig_get_func() would,
+ *  the VFO being selected only once. Backends able to, read several
+ *  functions in one exchange with the rig.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_get_func(), rig_get_levels()
+ */
+int HAMLIB_API rig_get_funcs(RIG *rig, vfo_t vfo, setting_t funcs, setting_t *status)
+{
+	const struct rig_caps *caps;
+	int retcode;
+	vfo_t curr_vfo;
+
+	if (CHECK_RIG_ARG(rig) || !status || !funcs)
+		return -RIG_EINVAL;
+
+	RIG_LOCK(rig);
+
+	caps = rig->caps;
+
+	if (caps->get_func == NULL || rig_has_get_func(rig,funcs) != funcs)
+		return -RIG_ENAVAIL;
+
+	if ((caps->targetable_vfo&RIG_TARGETABLE_FUNC) ||
+			vfo == RIG_VFO_CURR || vfo == rig->state.current_vfo)
+		return get_funcs(rig, vfo, funcs, status);
+
+	if (!caps->set_vfo)
+		return -RIG_ENTARGET;
+	curr_vfo = rig->state.current_vfo;
+	retcode = caps->set_vfo(rig, vfo);
+	if (retcode != RIG_OK)
+		return retcode;
+
+	retcode = get_funcs(rig, vfo, funcs, status);
+	caps->set_vfo(rig, curr_vfo);
+	return retcode;
+}
+
 /**
  * \brief set a radio level extra parameter
  * \param rig	The rig handle
@@ -497,6 +684,8 @@ int HAMLIB_API rig_set_ext_level(RIG *rig, vfo_t vfo, token_t token, value_t val
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_ext_level == NULL)
@@ -542,6 +731,8 @@ int HAMLIB_API rig_get_ext_level(RIG *rig, vfo_t vfo, token_t token, value_t *va
 	if (CHECK_RIG_ARG(rig) || !val)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_ext_level == NULL)
@@ -582,6 +773,8 @@ int HAMLIB_API rig_set_ext_parm(RIG *rig, token_t token, value_t val)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	if (rig->caps->set_ext_parm == NULL)
 		return -RIG_ENAVAIL;
 
@@ -607,6 +800,8 @@ int HAMLIB_API rig_get_ext_parm(RIG *rig, token_t token, value_t *val)
 	if (CHECK_RIG_ARG(rig) || !val)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	if (rig->caps->get_ext_parm == NULL)
 		return -RIG_ENAVAIL;
 
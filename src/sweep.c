@@ -0,0 +1,503 @@
+/** \addtogroup rig
+ * @{
+ */
+
+/**
+ * \file src/sweep.c
+ * \brief Sweep and measurement engine
+ * \author the Hamlib Group
+ * \date 2026
+ *
+ * Hamlib interface is a frontend implementing wrapper functions.
+ *
+ */
+
+/*
+ *  Hamlib Interface - sweep and measurement
+ *  Copyright (c) 2026 by the Hamlib Group
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/rotator.h>
+#include "lock.h"
+
+#ifndef DOC_HIDDEN
+
+#define CHECK_RIG_ARG(r) (!(r) || !(r)->caps || !(r)->state.comm_state)
+#define CHECK_ROT_ARG(r) (!(r) || !(r)->caps || !(r)->state.comm_state)
+
+#define SWEEP_STOP 1
+
+#define SWEEP_POLL_MS	10	/* level reading period while settling */
+#define ROT_POLL_MIN_MS	20	/* rotator position polling, while moving */
+#define ROT_POLL_MAX_MS	500	/* rotator position polling, backed off */
+#define ROT_TIMEOUT_MS	60000
+#define ROT_TOLERANCE	1.0
+
+struct sweep_ctx {
+	RIG *rig;
+	ROT *rot;			/* rig_sweep_rot() only */
+	const struct rig_sweep *sweep;
+	int count;			/* frequency points */
+	int points;			/* points measured so far */
+	freq_t freq;			/* tuned frequency, 0 if not tuned */
+	int keyed;
+	double idle;			/* level read before keying */
+	struct timeval tuned;		/* settle time origin */
+};
+
+static long elapsed_ms(const struct timeval *t)
+{
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+	return (now.tv_sec - t->tv_sec)*1000 + (now.tv_usec - t->tv_usec)/1000;
+}
+
+static double level_value(setting_t level, value_t val)
+{
+	return RIG_LEVEL_IS_FLOAT(level) ? val.f : val.i;
+}
+
+/*
+ * Number of frequency points, or a negative error code
+ */
+static int sweep_count(const struct rig_sweep *sweep)
+{
+	double n;
+
+	if (sweep->level == RIG_LEVEL_NONE)
+		return -RIG_EINVAL;
+
+	if (sweep->start == 0 || sweep->step == 0 || sweep->stop == sweep->start)
+		return 1;
+
+	n = (sweep->stop - sweep->start) / sweep->step;
+	if (n < 0 || n >= INT_MAX)
+		return -RIG_EINVAL;
+
+	/* the stop frequency is included, despite rounding */
+	return (int)floor(n + 1e-6) + 1;
+}
+
+static int sweep_tune(struct sweep_ctx *ctx, int i)
+{
+	const struct rig_sweep *sweep = ctx->sweep;
+	freq_t freq;
+	int retcode;
+
+	if (sweep->start != 0) {
+		freq = sweep->start + i * sweep->step;
+		if (freq != ctx->freq) {
+			retcode = rig_set_freq(ctx->rig, RIG_VFO_CURR, freq);
+			if (retcode != RIG_OK)
+				return retcode;
+			ctx->freq = freq;
+		}
+	}
+	gettimeofday(&ctx->tuned, NULL);
+
+	return RIG_OK;
+}
+
+static int sweep_key(struct sweep_ctx *ctx, ptt_t ptt)
+{
+	value_t val;
+	int retcode;
+
+	if (!ctx->sweep->ptt || ctx->keyed == (ptt == RIG_PTT_ON))
+		return RIG_OK;
+
+	/* a meter not yet driven reads this, e.g. SWR just after keying */
+	if (ptt == RIG_PTT_ON) {
+		retcode = rig_get_level(ctx->rig, RIG_VFO_CURR, ctx->sweep->level, &val);
+		if (retcode != RIG_OK)
+			return retcode;
+		ctx->idle = level_value(ctx->sweep->level, val);
+	}
+
+	retcode = rig_set_ptt(ctx->rig, RIG_VFO_CURR, ptt);
+	if (retcode != RIG_OK)
+		return retcode;
+
+	ctx->keyed = ptt == RIG_PTT_ON;
+	/* the level settles once transmitting */
+	if (ctx->keyed)
+		gettimeofday(&ctx->tuned, NULL);
+
+	return RIG_OK;
+}
+
+/*
+ * Wait for the level to settle, then sample it.
+ * The handle is held for the whole measurement.
+ */
+static int sweep_measure(struct sweep_ctx *ctx, struct rig_sweep_point *pt)
+{
+	RIG *rig = ctx->rig;
+	const struct rig_sweep *sweep = ctx->sweep;
+	double prev, cur, sum;
+	value_t val;
+	long ms;
+	int retcode, n;
+
+	RIG_LOCK(rig);
+
+	ms = elapsed_ms(&ctx->tuned);
+	if (ms < sweep->settle_min)
+		usleep((sweep->settle_min - ms)*1000);
+
+	retcode = rig_get_level(rig, RIG_VFO_CURR, sweep->level, &val);
+	if (retcode != RIG_OK)
+		return retcode;
+	cur = level_value(sweep->level, val);
+
+	pt->settled = 1;
+	if (sweep->settle_max > 0) {
+		pt->settled = 0;
+		while (elapsed_ms(&ctx->tuned) < sweep->settle_max) {
+			usleep(SWEEP_POLL_MS*1000);
+			prev = cur;
+			retcode = rig_get_level(rig, RIG_VFO_CURR, sweep->level, &val);
+			if (retcode != RIG_OK)
+				return retcode;
+			cur = level_value(sweep->level, val);
+			if (fabs(cur - prev) <= sweep->settle_tol &&
+					!(ctx->keyed &&
+					fabs(cur - ctx->idle) <= sweep->settle_tol)) {
+				pt->settled = 1;
+				break;
+			}
+		}
+	}
+	pt->settle = elapsed_ms(&ctx->tuned);
+
+	sum = cur;
+	for (n = 1; n < sweep->samples; n++) {
+		retcode = rig_get_level(rig, RIG_VFO_CURR, sweep->level, &val);
+		if (retcode != RIG_OK)
+			return retcode;
+		sum += level_value(sweep->level, val);
+	}
+
+	if (RIG_LEVEL_IS_FLOAT(sweep->level))
+		pt->val.f = sum / n;
+	else
+		pt->val.i = (int)floor(sum / n + 0.5);
+
+	return RIG_OK;
+}
+
+/*
+ * Sweep the frequencies once.
+ * The next frequency is tuned before handing the current point to the
+ * callback, so that the rig settles while the application processes it.
+ * Returns RIG_OK, SWEEP_STOP when the callback asked to stop,
+ * or a negative error code.
+ */
+static int sweep_run(struct sweep_ctx *ctx)
+{
+	const struct rig_sweep *sweep = ctx->sweep;
+	struct rig_sweep_point pt;
+	azimuth_t az;
+	elevation_t el;
+	int i, retcode;
+
+	retcode = sweep_tune(ctx, 0);
+	if (retcode == RIG_OK)
+		retcode = sweep_key(ctx, RIG_PTT_ON);
+
+	for (i = 0; retcode == RIG_OK && i < ctx->count; i++) {
+		memset(&pt, 0, sizeof(pt));
+		pt.idx = ctx->points;
+		pt.freq = ctx->freq;
+
+		retcode = sweep_measure(ctx, &pt);
+		if (retcode != RIG_OK)
+			break;
+
+		if (ctx->rot && rot_get_position(ctx->rot, &az, &el) == RIG_OK) {
+			pt.azimuth = az;
+			pt.elevation = el;
+		}
+		ctx->points++;
+
+		retcode = sweep_key(ctx, RIG_PTT_OFF);
+		if (retcode == RIG_OK && i+1 < ctx->count)
+			retcode = sweep_tune(ctx, i+1);
+		if (retcode != RIG_OK)
+			break;
+
+		if (sweep->point_cb && sweep->point_cb(ctx->rig, &pt, sweep->arg) != RIG_OK)
+			return SWEEP_STOP;
+
+		if (i+1 < ctx->count)
+			retcode = sweep_key(ctx, RIG_PTT_ON);
+	}
+
+	if (ctx->keyed)
+		sweep_key(ctx, RIG_PTT_OFF);
+
+	return retcode;
+}
+
+/*
+ * Select the VFO and the mode of the sweep, saving the current VFO
+ */
+static int sweep_setup(struct sweep_ctx *ctx, vfo_t *curr_vfo)
+{
+	RIG *rig = ctx->rig;
+	const struct rig_sweep *sweep = ctx->sweep;
+	int retcode;
+
+	*curr_vfo = rig->state.current_vfo;
+	if (sweep->vfo != RIG_VFO_CURR && sweep->vfo != *curr_vfo) {
+		retcode = rig_set_vfo(rig, sweep->vfo);
+		if (retcode != RIG_OK)
+			return retcode;
+	}
+
+	if (sweep->mode != RIG_MODE_NONE)
+		return rig_set_mode(rig, RIG_VFO_CURR, sweep->mode, RIG_PASSBAND_NORMAL);
+
+	return RIG_OK;
+}
+
+static void sweep_restore(struct sweep_ctx *ctx, vfo_t curr_vfo)
+{
+	const struct rig_sweep *sweep = ctx->sweep;
+
+	if (sweep->vfo != RIG_VFO_CURR && sweep->vfo != curr_vfo)
+		rig_set_vfo(ctx->rig, curr_vfo);
+}
+
+static int rot_reached(azimuth_t az, elevation_t el, azimuth_t target_az,
+		elevation_t target_el, float tolerance)
+{
+	return fabs(az - target_az) <= tolerance && fabs(el - target_el) <= tolerance;
+}
+
+/*
+ * Wait for the rotator to reach its position, polling it often while it
+ * moves, less and less when it does not, up to timeout without moving.
+ */
+static int rot_wait(ROT *rot, azimuth_t target_az, elevation_t target_el,
+		float tolerance, int timeout)
+{
+	struct timeval moved;
+	azimuth_t az, last_az = 0;
+	elevation_t el, last_el = 0;
+	int retcode, poll = ROT_POLL_MIN_MS, first = 1;
+
+	gettimeofday(&moved, NULL);
+
+	for (;;) {
+		retcode = rot_get_position(rot, &az, &el);
+		if (retcode != RIG_OK)
+			return retcode;
+		if (rot_reached(az, el, target_az, target_el, tolerance))
+			return RIG_OK;
+
+		if (first || fabs(az - last_az) > 0.01 || fabs(el - last_el) > 0.01) {
+			gettimeofday(&moved, NULL);
+			poll = ROT_POLL_MIN_MS;
+		} else {
+			if (elapsed_ms(&moved) > timeout)
+				return -RIG_ETIMEOUT;
+			poll = poll*2 > ROT_POLL_MAX_MS ? ROT_POLL_MAX_MS : poll*2;
+		}
+		first = 0;
+		last_az = az;
+		last_el = el;
+
+		usleep(poll*1000);
+	}
+}
+
+#endif /* !DOC_HIDDEN */
+
+
+/**
+ * \brief sweep a frequency range, measuring a level
+ * \param rig	The rig handle
+ * \param sweep	The sweep description
+ *
+ *  Tunes from \a sweep->start to \a sweep->stop by \a sweep->step,
+ *  and measures \a sweep->level at each frequency, transmitting during
+ *  the measurement when \a sweep->ptt is set, eg. for RIG_LEVEL_SWR.
+ *
+ *  Instead of a fixed delay, the level is read repeatedly after tuning
+ *  until it settles, two successive readings being within
+ *  \a sweep->settle_tol, then \a sweep->samples readings are averaged.
+ *  When transmitting, the level must also have moved away from the
+ *  value read before keying, which a slow meter still shows at first.
+ *  The next frequency is tuned before \a sweep->point_cb gets the
+ *  current point, overlapping the settling with the application work.
+ *  Returning anything but RIG_OK from the callback stops the sweep.
+ *
+ * \return the number of points measured if the operation has been
+ * sucessful, otherwise a negative value if an error occured (in which
+ * case, cause is set appropriately).
+ *
+ * \sa rig_sweep_rot(), rig_sw_scan(), rig_get_level()
+ */
+
+int HAMLIB_API rig_sweep(RIG *rig, const struct rig_sweep *sweep)
+{
+	struct sweep_ctx ctx;
+	vfo_t curr_vfo;
+	int retcode;
+
+	if (CHECK_RIG_ARG(rig) || !sweep)
+		return -RIG_EINVAL;
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.rig = rig;
+	ctx.sweep = sweep;
+	ctx.count = sweep_count(sweep);
+	if (ctx.count < 0)
+		return ctx.count;
+
+	retcode = sweep_setup(&ctx, &curr_vfo);
+	if (retcode == RIG_OK)
+		retcode = sweep_run(&ctx);
+
+	sweep_restore(&ctx, curr_vfo);
+
+	return retcode < 0 ? retcode : ctx.points;
+}
+
+/**
+ * \brief sweep a level against the rotator position
+ * \param rig	The rig handle
+ * \param rot	The rotator handle
+ * \param sweep	The frequency sweep, a single point usually
+ * \param rsweep	The rotator sweep description
+ *
+ *  Like rig_sweep(), along with the rotator positions.
+ *  With \a rsweep->az_step, the rotator is stepped from
+ *  \a rsweep->az_start to \a rsweep->az_stop, and the frequencies
+ *  swept once it has reached each position.
+ *  Otherwise the rotator turns in one go, and the frequencies are
+ *  swept over and over while it moves.
+ *  The position of the rotator, polled as it moves rather than at
+ *  fixed intervals, is reported along with each point.
+ *
+ * \return the number of points measured if the operation has been
+ * sucessful, otherwise a negative value if an error occured (in which
+ * case, cause is set appropriately).
+ *
+ * \sa rig_sweep(), rot_set_position()
+ */
+
+int HAMLIB_API rig_sweep_rot(RIG *rig, ROT *rot, const struct rig_sweep *sweep,
+		const struct rot_sweep *rsweep)
+{
+	struct sweep_ctx ctx;
+	vfo_t curr_vfo;
+	azimuth_t az;
+	elevation_t el;
+	float tolerance;
+	int timeout, retcode, i, count;
+
+	if (CHECK_RIG_ARG(rig) || CHECK_ROT_ARG(rot) || !sweep || !rsweep)
+		return -RIG_EINVAL;
+
+	tolerance = rsweep->tolerance > 0 ? rsweep->tolerance : ROT_TOLERANCE;
+	timeout = rsweep->timeout > 0 ? rsweep->timeout : ROT_TIMEOUT_MS;
+
+	count = 1;
+	if (rsweep->az_step != 0) {
+		double n = (rsweep->az_stop - rsweep->az_start) / rsweep->az_step;
+		if (n < 0)
+			return -RIG_EINVAL;
+		count = (int)floor(n + 1e-6) + 1;
+	}
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.rig = rig;
+	ctx.rot = rot;
+	ctx.sweep = sweep;
+	ctx.count = sweep_count(sweep);
+	if (ctx.count < 0)
+		return ctx.count;
+
+	retcode = sweep_setup(&ctx, &curr_vfo);
+
+	/* stepped */
+	for (i = 0; retcode == RIG_OK && rsweep->az_step != 0 && i < count; i++) {
+		az = rsweep->az_start + i * rsweep->az_step;
+		retcode = rot_set_position(rot, az, rsweep->elevation);
+		if (retcode == RIG_OK)
+			retcode = rot_wait(rot, az, rsweep->elevation, tolerance, timeout);
+		if (retcode == RIG_OK)
+			retcode = sweep_run(&ctx);
+	}
+
+	/* continuous */
+	if (retcode == RIG_OK && rsweep->az_step == 0) {
+		struct timeval moved;
+		azimuth_t last_az;
+
+		retcode = rot_set_position(rot, rsweep->az_start, rsweep->elevation);
+		if (retcode == RIG_OK)
+			retcode = rot_wait(rot, rsweep->az_start, rsweep->elevation,
+					tolerance, timeout);
+		if (retcode == RIG_OK)
+			retcode = rot_set_position(rot, rsweep->az_stop, rsweep->elevation);
+
+		last_az = rsweep->az_start;
+		gettimeofday(&moved, NULL);
+
+		while (retcode == RIG_OK) {
+			retcode = sweep_run(&ctx);
+			if (retcode != RIG_OK)
+				break;
+
+			retcode = rot_get_position(rot, &az, &el);
+			if (retcode != RIG_OK)
+				break;
+			if (rot_reached(az, el, rsweep->az_stop, rsweep->elevation, tolerance))
+				break;
+
+			if (fabs(az - last_az) > 0.01) {
+				last_az = az;
+				gettimeofday(&moved, NULL);
+			} else if (elapsed_ms(&moved) > timeout) {
+				retcode = -RIG_ETIMEOUT;
+			}
+		}
+	}
+
+	sweep_restore(&ctx, curr_vfo);
+
+	return retcode < 0 ? retcode : ctx.points;
+}
+
+/*! @} */
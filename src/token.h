@@ -63,6 +63,12 @@
 #define TOK_TIMEOUT		TOKEN_FRONTEND(14)
 /** \brief Number of retries permitted */
 #define TOK_RETRY		TOKEN_FRONTEND(15)
+/** \brief Adapt timeout to observed response times */
+#define TOK_TIMEOUT_ADAPTIVE	TOKEN_FRONTEND(16)
+/** \brief I/O trace file */
+#define TOK_TRACE_FILE	TOKEN_FRONTEND(17)
+/** \brief I/O trace mode: record or replay */
+#define TOK_TRACE_MODE	TOKEN_FRONTEND(18)
 /** \brief Serial speed - "baud rate" */
 #define TOK_SERIAL_SPEED	TOKEN_FRONTEND(20)
 /** \brief No. data bits per serial character */
@@ -96,6 +102,8 @@
 #define TOK_VFO_COMP	TOKEN_FRONTEND(110)
 /** \brief rig: polling interval (units?) */
 #define TOK_POLL_INTERVAL	TOKEN_FRONTEND(111)
+/** \brief rig: reject the frequencies and modes out of the tables locally */
+#define TOK_RANGE_CHECK	TOKEN_FRONTEND(112)
 /** \brief rig: International Telecommunications Union region no. */
 #define TOK_ITU_REGION	TOKEN_FRONTEND(120)
 /*
@@ -110,6 +118,10 @@
 #define TOK_MIN_EL	TOKEN_FRONTEND(112)
 /** \brief rot: Maximum Elevation */
 #define TOK_MAX_EL	TOKEN_FRONTEND(113)
+/** \brief rot: Minimum interval between two positions sent */
+#define TOK_POS_INTERVAL	TOKEN_FRONTEND(114)
+/** \brief rot: Deadband of the positions set */
+#define TOK_POS_DEADBAND	TOKEN_FRONTEND(115)
 
 
 #endif /* _TOKEN_H */
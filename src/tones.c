@@ -38,6 +38,7 @@
 
 #include "hamlib/rig.h"
 #include "tones.h"
+#include "lock.h"
 
 #if !defined(_WIN32) && !defined(__CYGWIN__)
 
@@ -107,6 +108,8 @@ int HAMLIB_API rig_set_ctcss_tone(RIG *rig, vfo_t vfo, tone_t tone)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_ctcss_tone == NULL)
@@ -156,6 +159,8 @@ int HAMLIB_API rig_get_ctcss_tone(RIG *rig, vfo_t vfo, tone_t *tone)
 	if (CHECK_RIG_ARG(rig) || !tone)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_ctcss_tone == NULL)
@@ -201,6 +206,8 @@ int HAMLIB_API rig_set_dcs_code(RIG *rig, vfo_t vfo, tone_t code)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_dcs_code == NULL)
@@ -245,6 +252,8 @@ int HAMLIB_API rig_get_dcs_code(RIG *rig, vfo_t vfo, tone_t *code)
 	if (CHECK_RIG_ARG(rig) || !code)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_dcs_code == NULL)
@@ -298,6 +307,8 @@ int HAMLIB_API rig_set_ctcss_sql(RIG *rig, vfo_t vfo, tone_t tone)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_ctcss_sql == NULL)
@@ -347,6 +358,8 @@ int HAMLIB_API rig_get_ctcss_sql(RIG *rig, vfo_t vfo, tone_t *tone)
 	if (CHECK_RIG_ARG(rig) || !tone)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_ctcss_sql == NULL)
@@ -392,6 +405,8 @@ int HAMLIB_API rig_set_dcs_sql(RIG *rig, vfo_t vfo, tone_t code)
 	if (CHECK_RIG_ARG(rig))
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->set_dcs_sql == NULL)
@@ -436,6 +451,8 @@ int HAMLIB_API rig_get_dcs_sql(RIG *rig, vfo_t vfo, tone_t *code)
 	if (CHECK_RIG_ARG(rig) || !code)
 		return -RIG_EINVAL;
 
+	RIG_LOCK(rig);
+
 	caps = rig->caps;
 
 	if (caps->get_dcs_sql == NULL)
@@ -0,0 +1,437 @@
+/*
+ *  Hamlib Interface - I/O trace record/replay
+ *  Copyright (c) 2026 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/time.h>
+
+#include <hamlib/rig.h>
+
+#include "trace.h"
+
+/*
+ * Trace file format:
+ *
+ *	magic "HLTRACE" followed by the format version, 1
+ *	records, each made of:
+ *		direction, TRACE_TX or TRACE_RX
+ *		delay in uS since the previous record, varint
+ *		length, varint
+ *		the bytes
+ *
+ * Varints are 7 bits per byte, least significant first, the MSB
+ * being set on every byte but the last.
+ * Consecutive bytes of the same direction are gathered in a single
+ * record, unless they are more than TRACE_SPLIT_US apart.
+ */
+#define TRACE_MAGIC "HLTRACE\001"
+#define TRACE_MAGIC_LEN 8
+#define TRACE_SPLIT_US 5000
+#define TRACE_BUFSZ 4096
+
+struct trace {
+	/* recording */
+	FILE *f;
+	char dir;			/* of the pending record, 0 if none */
+	struct timeval start;		/* date of its first byte */
+	struct timeval last;		/* date of its last byte */
+	struct timeval prev;		/* date of the previous record */
+	size_t len;
+	unsigned char buf[TRACE_BUFSZ];
+
+	/* replaying */
+	unsigned char *data;		/* the whole trace file */
+	size_t size;
+	size_t next;			/* offset of the next record */
+	char cur_dir;			/* current record, 0 at end of trace */
+	unsigned long cur_delay;
+	const unsigned char *cur_bytes;
+	size_t cur_len;
+	size_t cur_off;			/* bytes already written/fed */
+	int wfd;			/* write end of the pipe */
+	struct timeval ref;		/* replay date of the previous record */
+};
+
+static long tv_diff_us(const struct timeval *a, const struct timeval *b)
+{
+	return (a->tv_sec - b->tv_sec)*1000000L + (a->tv_usec - b->tv_usec);
+}
+
+static void tv_add_us(struct timeval *tv, unsigned long us)
+{
+	tv->tv_sec += us / 1000000;
+	tv->tv_usec += us % 1000000;
+	if (tv->tv_usec >= 1000000) {
+		tv->tv_sec++;
+		tv->tv_usec -= 1000000;
+	}
+}
+
+static void put_varint(FILE *f, unsigned long v)
+{
+	do {
+		unsigned char c = v & 0x7f;
+
+		v >>= 7;
+		if (v)
+			c |= 0x80;
+		putc(c, f);
+	} while (v);
+}
+
+static int get_varint(struct trace *t, unsigned long *v)
+{
+	int shift = 0;
+	unsigned char c;
+
+	*v = 0;
+	do {
+		if (t->next >= t->size || shift > 8*sizeof(long) - 7)
+			return -1;
+		c = t->data[t->next++];
+		*v |= (unsigned long)(c & 0x7f) << shift;
+		shift += 7;
+	} while (c & 0x80);
+
+	return 0;
+}
+
+static void record_flush(struct trace *t)
+{
+	long delay;
+
+	if (!t->dir)
+		return;
+
+	delay = tv_diff_us(&t->start, &t->prev);
+	if (delay < 0)
+		delay = 0;
+
+	putc(t->dir, t->f);
+	put_varint(t->f, delay);
+	put_varint(t->f, t->len);
+	fwrite(t->buf, 1, t->len, t->f);
+
+	t->prev = t->start;
+	t->dir = 0;
+	t->len = 0;
+}
+
+void trace_record(hamlib_port_t *p, char dir, const void *buf, size_t len)
+{
+	struct trace *t = (struct trace *)p->trace;
+	const unsigned char *b = buf;
+	struct timeval now;
+	size_t n;
+
+	if (!t || !t->f)
+		return;
+
+	gettimeofday(&now, NULL);
+
+	while (len > 0) {
+		if (t->dir != dir || t->len == TRACE_BUFSZ ||
+				tv_diff_us(&now, &t->last) > TRACE_SPLIT_US) {
+			record_flush(t);
+			t->dir = dir;
+			t->start = now;
+		}
+		n = TRACE_BUFSZ - t->len;
+		if (n > len)
+			n = len;
+		memcpy(t->buf + t->len, b, n);
+		t->len += n;
+		t->last = now;
+		b += n;
+		len -= n;
+	}
+}
+
+/*
+ * Make the record at t->next current
+ */
+static void replay_next(struct trace *t)
+{
+	unsigned long len;
+
+	t->cur_dir = 0;
+	t->cur_off = 0;
+	t->cur_len = 0;
+
+	if (t->next >= t->size)
+		return;
+
+	t->cur_dir = t->data[t->next++];
+	if ((t->cur_dir != TRACE_TX && t->cur_dir != TRACE_RX) ||
+			get_varint(t, &t->cur_delay) < 0 ||
+			get_varint(t, &len) < 0 || len > t->size - t->next) {
+		rig_debug(RIG_DEBUG_ERR, "%s: corrupted trace at offset %lu\n",
+				__func__, (unsigned long)t->next);
+		t->cur_dir = 0;
+		t->next = t->size;
+		return;
+	}
+	t->cur_bytes = t->data + t->next;
+	t->cur_len = len;
+	t->next += len;
+}
+
+static int replay_open(hamlib_port_t *p, struct trace *t)
+{
+#if defined(WIN32) && !defined(HAVE_TERMIOS_H)
+	/* select() does not work on pipes */
+	return -RIG_ENIMPL;
+#else
+	FILE *f;
+	long size;
+	int fds[2];
+
+	f = fopen(p->trace_file, "rb");
+	if (!f) {
+		rig_debug(RIG_DEBUG_ERR, "%s: cannot open %s: %s\n",
+				__func__, p->trace_file, strerror(errno));
+		return -RIG_EIO;
+	}
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	rewind(f);
+
+	t->data = size > 0 ? malloc(size) : NULL;
+	if (!t->data) {
+		fclose(f);
+		return -RIG_ENOMEM;
+	}
+	t->size = fread(t->data, 1, size, f);
+	fclose(f);
+
+	if (t->size < TRACE_MAGIC_LEN ||
+			memcmp(t->data, TRACE_MAGIC, TRACE_MAGIC_LEN)) {
+		rig_debug(RIG_DEBUG_ERR, "%s: %s is not a trace file\n",
+				__func__, p->trace_file);
+		free(t->data);
+		return -RIG_EINVAL;
+	}
+	t->next = TRACE_MAGIC_LEN;
+
+	if (pipe(fds) < 0) {
+		free(t->data);
+		return -RIG_EIO;
+	}
+	fcntl(fds[0], F_SETFL, O_NONBLOCK);
+	fcntl(fds[1], F_SETFL, O_NONBLOCK);
+	p->fd = fds[0];
+	t->wfd = fds[1];
+
+	gettimeofday(&t->ref, NULL);
+	replay_next(t);
+
+	return RIG_OK;
+#endif
+}
+
+int trace_open(hamlib_port_t *p)
+{
+	struct trace *t;
+	int ret;
+
+	if (p->trace_mode == RIG_TRACE_NONE)
+		return RIG_OK;
+
+	t = calloc(1, sizeof(struct trace));
+	if (!t)
+		return -RIG_ENOMEM;
+
+	if (p->trace_mode == RIG_TRACE_RECORD) {
+		t->f = fopen(p->trace_file, "wb");
+		if (!t->f) {
+			rig_debug(RIG_DEBUG_ERR, "%s: cannot create %s: %s\n",
+					__func__, p->trace_file, strerror(errno));
+			free(t);
+			return -RIG_EIO;
+		}
+		fwrite(TRACE_MAGIC, 1, TRACE_MAGIC_LEN, t->f);
+		gettimeofday(&t->prev, NULL);
+	} else {
+		ret = replay_open(p, t);
+		if (ret != RIG_OK) {
+			free(t);
+			return ret;
+		}
+	}
+
+	p->trace = t;
+
+	return RIG_OK;
+}
+
+int trace_close(hamlib_port_t *p)
+{
+	struct trace *t = (struct trace *)p->trace;
+	int closed_fd = 0;
+
+	if (!t)
+		return 0;
+
+	if (t->f) {
+		record_flush(t);
+		fclose(t->f);
+	}
+	if (t->data) {
+		close(p->fd);
+		close(t->wfd);
+		p->fd = -1;
+		free(t->data);
+		closed_fd = 1;
+	}
+	free(t);
+	p->trace = NULL;
+
+	return closed_fd;
+}
+
+/*
+ * Feed the current reply into the pipe, at once.
+ * Returns 0 when the pipe is full, -1 on error.
+ */
+static int replay_feed_record(struct trace *t)
+{
+	ssize_t n;
+
+	while (t->cur_off < t->cur_len) {
+		n = write(t->wfd, t->cur_bytes + t->cur_off, t->cur_len - t->cur_off);
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return 0;
+		if (n <= 0)
+			return -1;
+		t->cur_off += n;
+	}
+	replay_next(t);
+
+	return 1;
+}
+
+/*
+ * Drop the replies left unread in the pipe, as a receive overrun
+ * would, to make room for the next ones.
+ * Returns the number of bytes dropped.
+ */
+static size_t replay_drain(hamlib_port_t *p)
+{
+	unsigned char buf[512];
+	size_t dropped = 0;
+	ssize_t n;
+
+	while ((n = read(p->fd, buf, sizeof(buf))) > 0)
+		dropped += n;
+
+	rig_debug(RIG_DEBUG_WARN, "%s: %lu byte(s) of replies not read, "
+			"dropped\n", __func__, (unsigned long)dropped);
+
+	return dropped;
+}
+
+ssize_t trace_replay_write(hamlib_port_t *p, const void *buf, size_t count)
+{
+	struct trace *t = (struct trace *)p->trace;
+	const unsigned char *b = buf;
+	size_t done = 0, n;
+	int ret;
+
+	while (done < count) {
+		/* replies the backend did not wait for */
+		while (t->cur_dir == TRACE_RX) {
+			ret = replay_feed_record(t);
+			if (ret == 0 && replay_drain(p) > 0)
+				continue;
+			if (ret <= 0)
+				break;
+		}
+
+		if (t->cur_dir == TRACE_RX) {
+			rig_debug(RIG_DEBUG_ERR, "%s: cannot feed the replies: %s\n",
+					__func__, strerror(errno));
+			break;
+		}
+		if (t->cur_dir != TRACE_TX) {
+			rig_debug(RIG_DEBUG_ERR, "%s: write past the end of the trace\n",
+					__func__);
+			break;
+		}
+		n = t->cur_len - t->cur_off;
+		if (n > count - done)
+			n = count - done;
+		if (memcmp(t->cur_bytes + t->cur_off, b + done, n)) {
+			rig_debug(RIG_DEBUG_ERR, "%s: write differs from the trace "
+					"at offset %lu\n", __func__,
+					(unsigned long)(t->cur_bytes - t->data + t->cur_off));
+			break;
+		}
+		t->cur_off += n;
+		done += n;
+		if (t->cur_off == t->cur_len)
+			replay_next(t);
+	}
+
+	gettimeofday(&t->ref, NULL);
+
+	if (done < count)
+		errno = EPROTO;
+
+	return done;
+}
+
+void trace_replay_feed(hamlib_port_t *p, struct timeval *tv)
+{
+	struct trace *t = (struct trace *)p->trace;
+	struct timeval now, due;
+	long wait;
+
+	while (t->cur_dir == TRACE_RX) {
+		if (p->trace_mode == RIG_TRACE_REPLAY_REALTIME && t->cur_off == 0) {
+			due = t->ref;
+			tv_add_us(&due, t->cur_delay);
+			gettimeofday(&now, NULL);
+			wait = tv_diff_us(&due, &now);
+			if (wait > 0) {
+				/* not there yet, the caller will time out */
+				if (tv && wait > tv->tv_sec*1000000L + tv->tv_usec)
+					return;
+				usleep(wait);
+				if (tv) {
+					wait = tv->tv_sec*1000000L + tv->tv_usec - wait;
+					tv->tv_sec = wait / 1000000;
+					tv->tv_usec = wait % 1000000;
+				}
+			}
+			t->ref = due;
+		}
+		if (replay_feed_record(t) <= 0)
+			return;
+	}
+}
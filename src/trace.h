@@ -0,0 +1,62 @@
+/*
+ *  Hamlib Interface - I/O trace record/replay header
+ *  Copyright (c) 2026 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef _TRACE_H
+#define _TRACE_H 1
+
+#include <sys/types.h>
+#include <sys/time.h>
+#include <hamlib/rig.h>
+
+__BEGIN_DECLS
+
+/*
+ * Record/replay of the I/O of a port, according to p->trace_mode,
+ * hooked in iofunc.c.
+ *
+ * trace_open is called by port_open, once the port is open when
+ *	recording, instead of opening it when replaying. In the latter
+ *	case, p->fd is the read end of a pipe the replies are fed into.
+ * trace_close returns 1 when it has closed p->fd (replay).
+ * trace_record appends the bytes sent (TRACE_TX) or received
+ *	(TRACE_RX) to the trace.
+ * trace_replay_write checks the bytes written by the backend against
+ *	the trace, and returns how many of them match.
+ * trace_replay_feed is to be called before waiting for the port,
+ *	it feeds the pipe with the replies due within *tv, and
+ *	updates *tv.
+ */
+#define TRACE_TX 'W'
+#define TRACE_RX 'R'
+
+extern int trace_open(hamlib_port_t *p);
+extern int trace_close(hamlib_port_t *p);
+extern void trace_record(hamlib_port_t *p, char dir, const void *buf, size_t len);
+extern ssize_t trace_replay_write(hamlib_port_t *p, const void *buf, size_t count);
+extern void trace_replay_feed(hamlib_port_t *p, struct timeval *tv);
+
+#define TRACE_REPLAYING(p) ((p)->trace && \
+		((p)->trace_mode == RIG_TRACE_REPLAY || \
+		 (p)->trace_mode == RIG_TRACE_REPLAY_REALTIME))
+
+__END_DECLS
+
+#endif /* _TRACE_H */
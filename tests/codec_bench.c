@@ -0,0 +1,136 @@
+/*
+ * Hamlib numeric codec micro benchmark
+ *
+ * Compares the numeric field codec with the sprintf/sscanf calls
+ * and the digit-at-a-time BCD loops it replaces.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <hamlib/rig.h>
+#include <sys/time.h>
+#include "misc.h"
+#include "numcodec.h"
+
+#define LOOP_COUNT 1000000
+
+static struct timeval tv1;
+
+static void bench_start(void)
+{
+	gettimeofday(&tv1, NULL);
+}
+
+static void bench_end(const char *name, unsigned loops, unsigned long long sink)
+{
+	struct timeval tv2;
+	double elapsed;
+
+	gettimeofday(&tv2, NULL);
+	elapsed = tv2.tv_sec - tv1.tv_sec + (tv2.tv_usec - tv1.tv_usec)/1000000.0;
+	printf("%-28s %8.1f ns/op   (%llu)\n", name, elapsed*1e9/loops, sink % 10);
+}
+
+/* former to_bcd/from_bcd, one digit at a time */
+static void ref_to_bcd(unsigned char bcd_data[], unsigned long long freq, unsigned bcd_len)
+{
+	int i;
+	unsigned char a;
+
+	for (i=0; i < bcd_len/2; i++) {
+		a = freq%10;
+		freq /= 10;
+		a |= (freq%10)<<4;
+		freq /= 10;
+		bcd_data[i] = a;
+	}
+}
+
+static unsigned long long ref_from_bcd(const unsigned char bcd_data[], unsigned bcd_len)
+{
+	int i;
+	freq_t f = 0;
+
+	for (i=(bcd_len/2)-1; i >= 0; i--) {
+		f *= 10;
+		f += bcd_data[i]>>4;
+		f *= 10;
+		f += bcd_data[i] & 0x0f;
+	}
+	return f;
+}
+
+int main (int argc, char *argv[])
+{
+	unsigned loops = LOOP_COUNT;
+	unsigned long long sink = 0, v;
+	unsigned char bcd[5];
+	char buf[32];
+	freq_t f;
+	unsigned i;
+
+	if (argc > 1)
+		loops = atoi(argv[1]);
+
+	printf("Perform %u loops...\n", loops);
+
+	bench_start();
+	for (i = 0; i < loops; i++) {
+		sprintf(buf, "%011ld", (long)(14000000 + i));
+		sink += buf[10];
+	}
+	bench_end("sprintf %011ld", loops, sink);
+
+	bench_start();
+	for (i = 0; i < loops; i++) {
+		num_to_dec(buf, 14000000 + i, 11);
+		sink += buf[10];
+	}
+	bench_end("num_to_dec", loops, sink);
+
+	strcpy(buf, "00014074000");
+	bench_start();
+	for (i = 0; i < loops; i++) {
+		buf[10] = '0' + (i & 7);
+		sscanf(buf, "%"SCNfreq, &f);
+		sink += (unsigned long long)f;
+	}
+	bench_end("sscanf %"SCNfreq, loops, sink);
+
+	bench_start();
+	for (i = 0; i < loops; i++) {
+		buf[10] = '0' + (i & 7);
+		num_scan_freq(buf, &f);
+		sink += (unsigned long long)f;
+	}
+	bench_end("num_scan_freq", loops, sink);
+
+	bench_start();
+	for (i = 0; i < loops; i++) {
+		buf[10] = '0' + (i & 7);
+		num_from_dec(buf, 11, &v);
+		sink += v;
+	}
+	bench_end("num_from_dec", loops, sink);
+
+	bench_start();
+	for (i = 0; i < loops; i++) {
+		ref_to_bcd(bcd, 146520000 + i, 10);
+		sink += ref_from_bcd(bcd, 10);
+	}
+	bench_end("byte loop to/from_bcd", loops, sink);
+
+	bench_start();
+	for (i = 0; i < loops; i++) {
+		to_bcd(bcd, 146520000 + i, 10);
+		sink += from_bcd(bcd, 10);
+	}
+	bench_end("table to/from_bcd", loops, sink);
+
+	return 0;
+}
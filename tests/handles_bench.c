@@ -0,0 +1,95 @@
+/*
+ * Hamlib memory footprint benchmark
+ *
+ * Heap used by many RIG handles, dummy and netrigctl ones, with the
+ * caps tables shared, and with a private copy of them in each handle,
+ * as a backend overriding them gets.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <hamlib/rig.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#define HANDLE_COUNT 10000
+
+/* heap in use, in bytes, -1 if unknown */
+static long heap_used(void)
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+	return (long)mallinfo2().uordblks;
+#elif defined(__GLIBC__)
+	return (long)mallinfo().uordblks;
+#else
+	return -1;
+#endif
+}
+
+static int bench(const char *name, rig_model_t model, int copy, RIG **rigs, int count)
+{
+	long before, after;
+	int i;
+
+	before = heap_used();
+
+	for (i = 0; i < count; i++) {
+		rigs[i] = rig_init(model);
+		if (!rigs[i]) {
+			fprintf(stderr, "%s: rig_init failed\n", name);
+			return 1;
+		}
+		if (copy && rig_copy_tables(rigs[i]) != RIG_OK) {
+			fprintf(stderr, "%s: rig_copy_tables failed\n", name);
+			return 1;
+		}
+	}
+
+	after = heap_used();
+	if (before >= 0)
+		printf("%-28s %10ld bytes total %8ld bytes/handle\n", name,
+				after - before, (after - before) / count);
+	else
+		printf("%-28s heap usage not available\n", name);
+
+	for (i = 0; i < count; i++)
+		rig_cleanup(rigs[i]);
+
+	return 0;
+}
+
+int main (int argc, char *argv[])
+{
+	int count = HANDLE_COUNT;
+	RIG **rigs;
+
+	if (argc > 1)
+		count = atoi(argv[1]);
+	if (count <= 0)
+		return 1;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+	rig_load_all_backends();
+
+	rigs = calloc(count, sizeof(RIG *));
+	if (!rigs)
+		return 1;
+
+	printf("%d handles, sizeof(RIG) = %lu bytes\n", count,
+			(unsigned long)sizeof(RIG));
+
+	if (bench("dummy, shared tables", RIG_MODEL_DUMMY, 0, rigs, count) ||
+			bench("netrigctl, shared tables", RIG_MODEL_NETRIGCTL, 0, rigs, count) ||
+			bench("dummy, own tables", RIG_MODEL_DUMMY, 1, rigs, count))
+		return 1;
+
+	free(rigs);
+
+	return 0;
+}
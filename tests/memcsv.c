@@ -37,6 +37,7 @@
 #include <hamlib/rig.h>
 #include "misc.h"
 #include "sprintflst.h"
+#include "memdiff.h"
 
 
 /*
@@ -56,9 +57,11 @@ static int set_channel_data(RIG *rig, channel_t *chan,  char **line_key, char **
 static char* mystrtok( char *s, char delim );
 static int  tokenize_line( char *line, char **token_list, size_t siz, char delim );
 static int find_on_list( char **list, char *what );
+static int csv_read (RIG *rig, const char *infilename, mem_chan_cb_t chan_cb, void *arg);
 
 int csv_save (RIG *rig, const char *outfilename);
-int csv_load (RIG *rig, const char *infilename);
+int csv_load (RIG *rig, const char *infilename, struct mem_image *img);
+int csv_load_image (RIG *rig, const char *infilename, struct mem_image *img);
 int csv_parm_save (RIG *rig, const char *outfilename);
 int csv_parm_load (RIG *rig, const char *infilename);
 
@@ -83,15 +86,39 @@ int csv_save (RIG *rig, const char *outfilename)
 	return status;
 }
 
-/**  csv_load assumes the first line in a csv file is a key line,
+/**  Load the channels of a csv file into the rig memory.
+     \param rig - a pointer to the rig
+     \param infilename - a string with a file name to read from
+     \param img - the memory image of the rig, only channels differing
+           from it are written, or NULL to write them all
+*/
+int csv_load (RIG *rig, const char *infilename, struct mem_image *img)
+{
+    return csv_read(rig, infilename, mem_load_chan, img);
+}
+
+/**  Fill a memory image from a csv file saved from the rig,
+     instead of reading the rig memory.
+     \param rig - a pointer to the rig
+     \param infilename - a string with a file name to read from
+     \param img - the memory image to fill
+*/
+int csv_load_image (RIG *rig, const char *infilename, struct mem_image *img)
+{
+    return csv_read(rig, infilename, mem_image_store, img);
+}
+
+/**  csv_read assumes the first line in a csv file is a key line,
      defining entries and their number. First line should not 
      contain 'empty column', i.e. two adjacent commas.
      Each next line should contain the same number of entries.
      However, empty columns (two adjacent commas) are allowed.
      \param rig - a pointer to the rig
-     \param infilename - a string with a file name to write to
+     \param infilename - a string with a file name to read from
+     \param chan_cb - called for each channel read
+     \param arg - passed to chan_cb
 */
-int csv_load (RIG *rig, const char *infilename)
+static int csv_read (RIG *rig, const char *infilename, mem_chan_cb_t chan_cb, void *arg)
 {
     int status = RIG_OK;
     FILE *f;
@@ -134,7 +161,7 @@ int csv_load (RIG *rig, const char *infilename)
       set_channel_data( rig, &chan, key_list, value_list );
  
       /* Write a rig memory */
-      status=rig_set_channel(rig, &chan);
+      status=chan_cb(rig, &chan, arg);
 
       if (status != RIG_OK ) {
             fprintf( stderr, "rig_get_channel: error = %s \n", rigerror(status));
@@ -521,7 +548,7 @@ int set_channel_data(RIG *rig, channel_t *chan, char **line_key_list, char **lin
    int i,j,n;
    
    memset(chan,0,sizeof(channel_t));
-   chan->vfo = RIG_VFO_CURR;
+   chan->vfo = RIG_VFO_MEM;
    
    i = find_on_list( line_key_list, "num" );
    if( i < 0 ){
@@ -549,8 +576,11 @@ int set_channel_data(RIG *rig, channel_t *chan, char **line_key_list, char **lin
     if (mem_caps->channel_desc) {
         i = find_on_list( line_key_list,  "channel_desc" );
         if( i >= 0 ){
-           strncpy( chan->channel_desc, line_data_list[ i ], rig->caps->chan_desc_sz-1 );
-           chan->channel_desc[ rig->caps->chan_desc_sz ] = '\0';
+           size_t desc_sz = rig->caps->chan_desc_sz > 0 &&
+                   rig->caps->chan_desc_sz < MAXCHANDESC ?
+                   rig->caps->chan_desc_sz : MAXCHANDESC-1;
+           strncpy( chan->channel_desc, line_data_list[ i ], desc_sz );
+           chan->channel_desc[ desc_sz ] = '\0';
         }
     }
     if (mem_caps->ant) {
@@ -0,0 +1,262 @@
+/*
+ * memdiff.c - (C) Stephane Fillod 2003-2012
+ *
+ * This program exercises the backup and restore of a radio
+ * using Hamlib. Incremental load: only the channels differing
+ * from the memory image of the radio are written.
+ *
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <hamlib/rig.h>
+#include "memdiff.h"
+
+/*
+ * external prototype
+ */
+
+extern int all;
+
+
+int mem_image_init(RIG *rig, struct mem_image *img)
+{
+	const chan_t *chan_list = rig->state.chan_list;
+	int i;
+
+	memset(img, 0, sizeof(*img));
+
+	for (i=0; i<CHANLSTSIZ && !RIG_IS_CHAN_END(chan_list[i]); i++) {
+		if (chan_list[i].end >= img->size)
+			img->size = chan_list[i].end + 1;
+	}
+	if (img->size == 0)
+		return -RIG_EINVAL;
+
+	img->chans = calloc(img->size, sizeof(channel_t));
+	img->valid = calloc(img->size, sizeof(char));
+	if (!img->chans || !img->valid) {
+		mem_image_free(img);
+		return -RIG_ENOMEM;
+	}
+
+	return RIG_OK;
+}
+
+void mem_image_free(struct mem_image *img)
+{
+	int i;
+
+	if (img->chans) {
+		for (i=0; i<img->size; i++)
+			free(img->chans[i].ext_levels);
+		free(img->chans);
+	}
+	free(img->valid);
+	img->chans = NULL;
+	img->valid = NULL;
+	img->size = 0;
+}
+
+
+/*
+ * Each channel is read right into its slot of the image,
+ * ext_levels allocated by the backend included.
+ */
+static int read_image_chan(RIG *rig, channel_t **chan_pp, int channel_num,
+		const chan_t *chan_list, rig_ptr_t arg)
+{
+	struct mem_image *img = arg;
+	channel_t *chan = *chan_pp;
+	int n;
+
+	if (chan != NULL) {
+		/* *chan_pp has just been read */
+		n = chan->channel_num;
+		if (n < 0 || n >= img->size)
+			return -RIG_EINVAL;
+
+		if (chan != &img->chans[n]) {
+			/* the previous channel was empty, move it to its slot */
+			free(img->chans[n].ext_levels);
+			img->chans[n] = *chan;
+			memset(chan, 0, sizeof(channel_t));
+			img->valid[chan - img->chans] = 0;
+		}
+		if (!img->valid[n]) {
+			img->valid[n] = 1;
+			img->reads++;
+		}
+	}
+
+	if (channel_num < 0 || channel_num >= img->size)
+		return -RIG_EINVAL;
+
+	*chan_pp = &img->chans[channel_num];
+
+	return RIG_OK;
+}
+
+/**  Read the memory image from the radio. Backends able to read
+     the whole memory at once, by cloning, do it in one go.
+     \param rig - a pointer to the rig
+     \param img - an image initialized by mem_image_init
+     \return RIG_OK on success, negative value on error
+*/
+int mem_image_read(RIG *rig, struct mem_image *img)
+{
+	return rig_get_chan_all_cb(rig, read_image_chan, img);
+}
+
+/**  Store a channel read from a file into the image, when the file
+     is a backup of the current content of the radio.
+*/
+int mem_image_store(RIG *rig, channel_t *chan, void *arg)
+{
+	struct mem_image *img = arg;
+	channel_t *slot;
+	int n = chan->channel_num;
+
+	if (n < 0 || n >= img->size)
+		return RIG_OK;
+
+	slot = &img->chans[n];
+	free(slot->ext_levels);
+	*slot = *chan;
+	slot->ext_levels = NULL;
+	if (!img->valid[n]) {
+		img->valid[n] = 1;
+		img->reads++;
+	}
+
+	return RIG_OK;
+}
+
+
+#define FIELD_DIFFERS(cap, field) ((all || mem_caps->cap) && a->field != b->field)
+
+/**  Compare two channels, on the fields supported by their memory type,
+     or all the fields saved in a file when bypassing mem_caps.
+     Fields unset by the files are compared as such, e.g. the repeater
+     offset only counts when the repeater shift is on.
+     \return 1 when they differ, 0 otherwise
+*/
+int chan_differs(RIG *rig, const channel_t *a, const channel_t *b)
+{
+	const chan_t *chan_cap;
+	const channel_cap_t *mem_caps;
+
+	if (a->channel_num != b->channel_num)
+		return 1;
+
+	chan_cap = rig_lookup_mem_caps(rig, a->channel_num);
+	if (!chan_cap)
+		return 1;
+	mem_caps = &chan_cap->mem_caps;
+
+	if (FIELD_DIFFERS(bank_num, bank_num) ||
+			FIELD_DIFFERS(ant, ant) ||
+			FIELD_DIFFERS(freq, freq) ||
+			FIELD_DIFFERS(mode, mode) ||
+			FIELD_DIFFERS(width, width) ||
+			FIELD_DIFFERS(tx_freq, tx_freq) ||
+			FIELD_DIFFERS(tx_mode, tx_mode) ||
+			FIELD_DIFFERS(tx_width, tx_width) ||
+			FIELD_DIFFERS(split, split) ||
+			FIELD_DIFFERS(rptr_shift, rptr_shift) ||
+			FIELD_DIFFERS(tuning_step, tuning_step) ||
+			FIELD_DIFFERS(rit, rit) ||
+			FIELD_DIFFERS(xit, xit) ||
+			FIELD_DIFFERS(funcs, funcs) ||
+			FIELD_DIFFERS(ctcss_tone, ctcss_tone) ||
+			FIELD_DIFFERS(ctcss_sql, ctcss_sql) ||
+			FIELD_DIFFERS(dcs_code, dcs_code) ||
+			FIELD_DIFFERS(dcs_sql, dcs_sql) ||
+			FIELD_DIFFERS(scan_group, scan_group) ||
+			FIELD_DIFFERS(flags, flags))
+		return 1;
+
+	if (a->split == RIG_SPLIT_ON && FIELD_DIFFERS(tx_vfo, tx_vfo))
+		return 1;
+
+	if (a->rptr_shift != RIG_RPT_SHIFT_NONE && FIELD_DIFFERS(rptr_offs, rptr_offs))
+		return 1;
+
+	if ((all || mem_caps->channel_desc) &&
+			strncmp(a->channel_desc, b->channel_desc, MAXCHANDESC))
+		return 1;
+
+	return 0;
+}
+
+/**  Load a channel read from a file into the radio. With an image,
+     the channel is written only when it differs from the image,
+     which is kept up to date. Without one, it is always written.
+     \param rig - a pointer to the rig
+     \param chan - the channel read from the file
+     \param arg - the struct mem_image, or NULL
+     \return RIG_OK on success, negative value on error
+*/
+int mem_load_chan(RIG *rig, channel_t *chan, void *arg)
+{
+	struct mem_image *img = arg;
+	struct ext_list *ext_levels;
+	channel_t *slot = NULL;
+	int n = chan->channel_num;
+	int status;
+
+	if (!img)
+		return rig_set_channel(rig, chan);
+
+	if (n >= 0 && n < img->size) {
+		slot = &img->chans[n];
+		if (img->valid[n] && !chan_differs(rig, chan, slot)) {
+			img->skips++;
+			return RIG_OK;
+		}
+	}
+
+	/* the file has no ext_levels, keep the ones of the radio */
+	if (slot && !chan->ext_levels)
+		chan->ext_levels = slot->ext_levels;
+
+	status = rig_set_channel(rig, chan);
+
+	if (slot && chan->ext_levels == slot->ext_levels)
+		chan->ext_levels = NULL;
+
+	if (status != RIG_OK)
+		return status;
+
+	img->writes++;
+
+	if (slot) {
+		ext_levels = slot->ext_levels;
+		*slot = *chan;
+		slot->ext_levels = ext_levels;
+		img->valid[n] = 1;
+	}
+
+	return RIG_OK;
+}
@@ -0,0 +1,55 @@
+/*
+ * memdiff.h - (C) Stephane Fillod 2003-2012
+ *
+ * Memory image of a radio, for the incremental load of rigmem.
+ *
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _MEMDIFF_H
+#define _MEMDIFF_H 1
+
+#include <hamlib/rig.h>
+
+__BEGIN_DECLS
+
+/*
+ * Content of the memory channels of the radio, as last read from it,
+ * or from a file saved from it, indexed by channel number.
+ */
+struct mem_image {
+	channel_t *chans;
+	char *valid;		/* chans[n] holds the content of channel n */
+	int size;		/* highest channel number + 1 */
+	int reads;		/* channels read into the image */
+	int writes;		/* channels written to the radio */
+	int skips;		/* channels left unchanged */
+};
+
+/* called by the file readers for each channel */
+typedef int (*mem_chan_cb_t) (RIG *rig, channel_t *chan, void *arg);
+
+extern int mem_image_init(RIG *rig, struct mem_image *img);
+extern void mem_image_free(struct mem_image *img);
+extern int mem_image_read(RIG *rig, struct mem_image *img);
+extern int mem_image_store(RIG *rig, channel_t *chan, void *img);
+extern int mem_load_chan(RIG *rig, channel_t *chan, void *img);
+extern int chan_differs(RIG *rig, const channel_t *a, const channel_t *b);
+
+__END_DECLS
+
+#endif	/* _MEMDIFF_H */
@@ -30,70 +30,116 @@
 
 #include <hamlib/rig.h>
 #include "misc.h"
+#include "memdiff.h"
 
 #ifdef HAVE_XML2
 #include <libxml/parser.h>
 #include <libxml/tree.h>
+#include <libxml/xmlreader.h>
 
 static int set_chan(RIG *rig, channel_t *chan ,xmlNodePtr node);
+static int xml_read (RIG *my_rig, const char *infilename, mem_chan_cb_t chan_cb, void *arg);
 #endif
 
 
-int xml_load (RIG *my_rig, const char *infilename)
+/*
+ * Load the channels into the rig memory. With an image of the memory,
+ * only the channels differing from it are written.
+ */
+int xml_load (RIG *my_rig, const char *infilename, struct mem_image *img)
+{
+#ifdef HAVE_XML2
+	return xml_read(my_rig, infilename, mem_load_chan, img);
+#else
+	return -RIG_ENAVAIL;
+#endif
+}
+
+/*
+ * Fill the image of the memory from a file saved from the rig.
+ */
+int xml_load_image (RIG *my_rig, const char *infilename, struct mem_image *img)
 {
 #ifdef HAVE_XML2
-	xmlDocPtr Doc;
+	return xml_read(my_rig, infilename, mem_image_store, img);
+#else
+	return -RIG_ENAVAIL;
+#endif
+}
+
+#ifdef HAVE_XML2
+/*
+ * The file is streamed, each channel element being expanded
+ * on its own while the rest of the document is not kept.
+ */
+static int xml_read (RIG *my_rig, const char *infilename, mem_chan_cb_t chan_cb, void *arg)
+{
+	xmlTextReaderPtr reader;
 	xmlNodePtr node;
+	const char *name;
+	int ret, depth, in_channels = 0, found_channels = 0;
 
-	/* load xlm Doc */
-	Doc=xmlParseFile(infilename);
-	if(Doc==NULL) {
+	reader=xmlReaderForFile(infilename, NULL, 0);
+	if(reader==NULL) {
 		fprintf(stderr,"xmlParse failed\n");
 		exit(2);
 	}
 
-	node=xmlDocGetRootElement(Doc);
-	if (node == NULL) {
-		fprintf(stderr,"get root failed\n");
-		exit(2);
-        }
-	if(strcmp((char *) node->name, "hamlib")) {
-		fprintf(stderr,"no hamlib tag found\n");
-		exit(2);
-	}
-	for(node=node->xmlChildrenNode;node!=NULL;node=node->next) {
-		if(xmlNodeIsText(node)) continue;
-		if(strcmp((char *) node->name, "channels")==0)
-			break;
-	}
-	if(node==NULL) {
-		fprintf(stderr,"no channels\n");
-		exit(2);
-	}
-	for(node=node->xmlChildrenNode;node!=NULL;node=node->next) {
+	while ((ret = xmlTextReaderRead(reader)) == 1) {
 		channel_t chan;
 		int status;
 
-		if(xmlNodeIsText(node)) continue;
+		if (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT)
+			continue;
+
+		name = (const char *) xmlTextReaderConstName(reader);
+		depth = xmlTextReaderDepth(reader);
+
+		if (depth == 0) {
+			if(strcmp(name, "hamlib")) {
+				fprintf(stderr,"no hamlib tag found\n");
+				exit(2);
+			}
+			continue;
+		}
+		if (depth == 1) {
+			in_channels = strcmp(name, "channels")==0;
+			found_channels |= in_channels;
+			continue;
+		}
+		if (depth != 2 || !in_channels)
+			continue;
+
+		node = xmlTextReaderExpand(reader);
+		if (node == NULL)
+			break;
 
 		set_chan(my_rig,&chan,node);
 
-		status=rig_set_channel(my_rig, &chan);
+		status=chan_cb(my_rig, &chan, arg);
 
 		if (status != RIG_OK ) {
-			printf("rig_get_channel: error = %s \n", rigerror(status));
+			printf("rig_set_channel: error = %s \n", rigerror(status));
+			xmlFreeTextReader(reader);
 			return status;
 		}
 	}
 
-        xmlFreeDoc(Doc);
+	xmlFreeTextReader(reader);
 	xmlCleanupParser();
 
+	if (ret != 0) {
+		fprintf(stderr,"xmlParse failed\n");
+		exit(2);
+	}
+	if(!found_channels) {
+		fprintf(stderr,"no channels\n");
+		exit(2);
+	}
+
 	return 0;
-#else
-	return -RIG_ENAVAIL;
-#endif
 }
+#endif
 
 int xml_parm_load (RIG *my_rig, const char *infilename)
 {
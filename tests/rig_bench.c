@@ -1,5 +1,12 @@
 /*
  * Hamlib rig_bench program
+ *
+ * usage: rig_bench [rig_model [trace_file [trace_mode]]]
+ *
+ * With a trace file, the session is recorded into it (trace_mode
+ * "Record"), or replayed from it, without any rig ("Replay", the
+ * default, or "Realtime"). A recorded session can then benchmark
+ * the backend alone.
  */
 
 #include <stdio.h>
@@ -62,6 +69,17 @@ int main (int argc, char *argv[])
 
 	strncpy(my_rig->state.rigport.pathname,SERIAL_PORT,FILPATHLEN - 1);
 
+	if (argc > 2) {
+		rig_set_conf(my_rig, rig_token_lookup(my_rig, "trace_file"), argv[2]);
+		retcode = rig_set_conf(my_rig, rig_token_lookup(my_rig, "trace_mode"),
+				argc > 3 ? argv[3] : "Replay");
+		if (retcode != RIG_OK) {
+			printf("trace_mode: error = %s\n", rigerror(retcode));
+			exit(2);
+		}
+		printf("Trace %s, %s\n", argv[2], argc > 3 ? argv[3] : "Replay");
+	}
+
 	retcode = rig_open(my_rig);
 	if (retcode != RIG_OK) {
 		printf("rig_open: error = %s\n", rigerror(retcode));
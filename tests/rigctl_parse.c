@@ -34,6 +34,7 @@
 #include <unistd.h>
 #include <ctype.h>
 #include <errno.h>
+#include <sys/time.h>
 
 #include <getopt.h>
 
@@ -129,8 +130,10 @@ declare_proto_rig(power2mW);
 declare_proto_rig(mW2power);
 declare_proto_rig(set_level);
 declare_proto_rig(get_level);
+declare_proto_rig(get_levels);
 declare_proto_rig(set_func);
 declare_proto_rig(get_func);
+declare_proto_rig(get_funcs);
 declare_proto_rig(set_parm);
 declare_proto_rig(get_parm);
 declare_proto_rig(set_bank);
@@ -146,6 +149,8 @@ declare_proto_rig(get_info);
 declare_proto_rig(dump_caps);
 declare_proto_rig(dump_conf);
 declare_proto_rig(dump_state);
+declare_proto_rig(dump_port_stats);
+declare_proto_rig(dump_stats);
 declare_proto_rig(set_ant);
 declare_proto_rig(get_ant);
 declare_proto_rig(reset);
@@ -203,6 +208,8 @@ static struct test_table test_list[] = {
 	{ 0x91, "get_ctcss_sql",    get_ctcss_sql,  ARG_OUT, "CTCSS Sql" },
 	{ 0x92, "set_dcs_sql",      set_dcs_sql,    ARG_IN, "DCS Sql" },
 	{ 0x93, "get_dcs_sql",      get_dcs_sql,    ARG_OUT, "DCS Sql" },
+	{ 0x94, "get_levels",       get_levels,     ARG_IN1|ARG_IN_LINE|ARG_OUT2, "Levels", "Level Values" },
+	{ 0x95, "get_funcs",        get_funcs,      ARG_IN1|ARG_IN_LINE|ARG_OUT2, "Funcs", "Func Status" },
 	{ 'V', "set_vfo",           set_vfo,        ARG_IN|ARG_NOVFO, "VFO" },
 	{ 'v', "get_vfo",           get_vfo,        ARG_OUT, "VFO" },
 	{ 'T', "set_ptt",           set_ptt,        ARG_IN, "PTT" },
@@ -232,6 +239,8 @@ static struct test_table test_list[] = {
 	{ '1', "dump_caps",         dump_caps,      ARG_NOVFO },
 	{ '3', "dump_conf",         dump_conf,      ARG_NOVFO },
 	{ 0x8f,"dump_state",        dump_state,     ARG_OUT|ARG_NOVFO },
+	{ 0x8c,"dump_port_stats",   dump_port_stats, ARG_NOVFO },
+	{ 0x96,"dump_stats",        dump_stats,     ARG_NOVFO },	/* rigctld only */
 	{ 0xf0,"chk_vfo",           chk_vfo,        ARG_NOVFO },	/* rigctld only--check for VFO mode */
 	{ 0xf1,"halt",              halt,           ARG_NOVFO },	/* rigctld only--halt the daemon */
 	{ 0x00, "", NULL },
@@ -354,6 +363,15 @@ extern int vfo_mode;
 extern char send_cmd_term;
 int ext_resp = 0;
 unsigned char resp_sep = '\n';      /* Default response separator */
+void (*rigctl_post_cmd_hook)(RIG *) = NULL;
+void (*rigctl_cmd_stats_hook)(RIG *, unsigned char, const char *, int,
+		unsigned long, unsigned long) = NULL;
+int (*rigctl_dump_stats_hook)(RIG *, FILE *) = NULL;
+
+static unsigned long elapsed_us(const struct timeval *from, const struct timeval *to)
+{
+	return (to->tv_sec - from->tv_sec) * 1000000L + (to->tv_usec - from->tv_usec);
+}
 
 int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc)
 {
@@ -366,6 +384,7 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc)
 	char arg3[MAXARGSZ+1], *p3;
 	static int last_was_ret = 1;
 	vfo_t vfo = RIG_VFO_CURR;
+	struct timeval lock_date, run_date, done_date;
 
 	if (interactive) {
 		if (prompt)
@@ -548,12 +567,16 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc)
 	}
 
 	/*
-	 * mutex locking needed because rigctld is multithreaded
-	 * and hamlib is not MT-safe
+	 * mutex locking needed because rigctld is multithreaded:
+	 * hamlib serializes each call, but a command may be made
+	 * of several calls, which must not interleave with the
+	 * ones of another client
 	 */
+	gettimeofday(&lock_date, NULL);
 #ifdef HAVE_PTHREAD
 	pthread_mutex_lock(&rig_mutex);
 #endif
+	gettimeofday(&run_date, NULL);
 
 	if (!prompt)
 		rig_debug(RIG_DEBUG_TRACE, "rigctl(d): %c '%s' '%s' '%s' '%s'\n",
@@ -580,11 +603,20 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc)
 	retcode = (*cmd_entry->rig_routine)(my_rig, fout, fin, interactive,
 					cmd_entry, vfo, p1, p2 ? p2 : "", p3 ? p3 : "");
 
+	if (retcode == RIG_OK && rigctl_post_cmd_hook)
+		(*rigctl_post_cmd_hook)(my_rig);
+
+	gettimeofday(&done_date, NULL);
+
+	/* still holding the rig, not to wait on the command of another client */
+	if (rigctl_cmd_stats_hook)
+		(*rigctl_cmd_stats_hook)(my_rig, cmd, cmd_entry->name, retcode,
+				elapsed_us(&lock_date, &run_date),
+				elapsed_us(&run_date, &done_date));
 #ifdef HAVE_PTHREAD
 	pthread_mutex_unlock(&rig_mutex);
 #endif
 
-
 	if (retcode != RIG_OK) {
 		/* only for rigctld */
 		if (interactive && !prompt) {
@@ -1388,6 +1420,53 @@ declare_proto_rig(get_level)
 	return status;
 }
 
+#define LIST_SEP " ,\t"
+
+/* '0x94' */
+declare_proto_rig(get_levels)
+{
+	int status;
+	setting_t level, levels = RIG_LEVEL_NONE;
+	value_t vals[RIG_SETTING_MAX];
+	char list[MAXARGSZ + 1];
+	char *name;
+
+	if (!strcmp(arg1, "?")) {
+		char s[SPRINTF_MAX_SIZE];
+		sprintf_level(s, rig->state.has_get_level);
+		fprintf(fout, "%s\n", s);
+		return RIG_OK;
+	}
+
+	strncpy(list, arg1, MAXARGSZ);
+	list[MAXARGSZ] = '\0';
+	for (name = strtok(list, LIST_SEP); name; name = strtok(NULL, LIST_SEP)) {
+		level = rig_parse_level(name);
+		if (level == RIG_LEVEL_NONE)
+			return -RIG_EINVAL;
+		levels |= level;
+	}
+
+	status = rig_get_levels(rig, vfo, levels, vals);
+	if (status != RIG_OK)
+		return status;
+
+	/* in the order asked */
+	strncpy(list, arg1, MAXARGSZ);
+	list[MAXARGSZ] = '\0';
+	for (name = strtok(list, LIST_SEP); name; name = strtok(NULL, LIST_SEP)) {
+		level = rig_parse_level(name);
+		if (interactive && prompt)
+			fprintf(fout, "%s: ", rig_strlevel(level));
+		if (RIG_LEVEL_IS_FLOAT(level))
+			fprintf(fout, "%f\n", vals[rig_setting2idx(level)].f);
+		else
+			fprintf(fout, "%d\n", vals[rig_setting2idx(level)].i);
+	}
+
+	return status;
+}
+
 /* 'U' */
 declare_proto_rig(set_func)
 {
@@ -1437,6 +1516,47 @@ declare_proto_rig(get_func)
 	return status;
 }
 
+/* '0x95' */
+declare_proto_rig(get_funcs)
+{
+	int status;
+	setting_t func, funcs = RIG_FUNC_NONE, funcs_on;
+	char list[MAXARGSZ + 1];
+	char *name;
+
+	if (!strcmp(arg1, "?")) {
+		char s[SPRINTF_MAX_SIZE];
+		sprintf_func(s, rig->state.has_get_func);
+		fprintf(fout, "%s\n", s);
+		return RIG_OK;
+	}
+
+	strncpy(list, arg1, MAXARGSZ);
+	list[MAXARGSZ] = '\0';
+	for (name = strtok(list, LIST_SEP); name; name = strtok(NULL, LIST_SEP)) {
+		func = rig_parse_func(name);
+		if (func == RIG_FUNC_NONE)
+			return -RIG_EINVAL;
+		funcs |= func;
+	}
+
+	status = rig_get_funcs(rig, vfo, funcs, &funcs_on);
+	if (status != RIG_OK)
+		return status;
+
+	/* in the order asked */
+	strncpy(list, arg1, MAXARGSZ);
+	list[MAXARGSZ] = '\0';
+	for (name = strtok(list, LIST_SEP); name; name = strtok(NULL, LIST_SEP)) {
+		func = rig_parse_func(name);
+		if (interactive && prompt)
+			fprintf(fout, "%s: ", rig_strfunc(func));
+		fprintf(fout, "%d\n", (funcs_on & func) ? 1 : 0);
+	}
+
+	return status;
+}
+
 /* 'P' */
 declare_proto_rig(set_parm)
 {
@@ -2113,6 +2233,51 @@ declare_proto_rig(dump_conf)
 	return RIG_OK;
 }
 
+static void dump_port_hist(FILE *fout, const char *name, const unsigned long *hist)
+{
+	int i;
+
+	fprintf(fout, "%s:", name);
+	for (i = 0; i < RIG_PORT_STATS_HIST; i++)
+		fprintf(fout, " %lu", hist[i]);
+	fprintf(fout, "\n");
+}
+
+/* '0x8c' */
+declare_proto_rig(dump_port_stats)
+{
+	int status;
+	port_stats_t stats;
+
+	status = rig_get_port_stats(rig, &stats);
+	if (status != RIG_OK)
+		return status;
+
+	fprintf(fout, "Writes: %lu\n", stats.writes);
+	fprintf(fout, "Reads: %lu\n", stats.reads);
+	fprintf(fout, "Transactions: %lu\n", stats.transactions);
+	fprintf(fout, "Bytes out: %lu\n", stats.bytes_out);
+	fprintf(fout, "Bytes in: %lu\n", stats.bytes_in);
+	fprintf(fout, "Timeouts: %lu\n", stats.timeouts);
+	fprintf(fout, "Errors: %lu\n", stats.errors);
+	fprintf(fout, "Retries: %lu\n", stats.retries);
+	fprintf(fout, "Write time us: %llu\n", stats.write_us);
+	/* log2 buckets: <1ms, [1,2)ms, [2,4)ms, ... */
+	dump_port_hist(fout, "TTFB histogram", stats.ttfb);
+	dump_port_hist(fout, "Complete histogram", stats.complete);
+
+	return RIG_OK;
+}
+
+/* '0x96' */
+declare_proto_rig(dump_stats)
+{
+	if (!rigctl_dump_stats_hook)
+		return -RIG_ENAVAIL;
+
+	return (*rigctl_dump_stats_hook)(rig, fout);
+}
+
 /* 'Y' */
 declare_proto_rig(set_ant)
 {
@@ -47,4 +47,16 @@ int set_conf(RIG *my_rig, char *conf_parms);
 
 int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc);
 
+/* called after each successful command, under the rig mutex */
+extern void (*rigctl_post_cmd_hook)(RIG *);
+
+/* called after each command, still under the rig mutex, with the command,
+ * its return code, and the time spent waiting for the rig mutex and
+ * running the command, in uS */
+extern void (*rigctl_cmd_stats_hook)(RIG *, unsigned char cmd, const char *name,
+		int retcode, unsigned long wait_us, unsigned long run_us);
+
+/* output of the dump_stats command, rigctld only */
+extern int (*rigctl_dump_stats_hook)(RIG *, FILE *);
+
 #endif	/* RIGCTL_PARSE_H */
@@ -31,6 +31,8 @@
 #include <unistd.h>
 #include <ctype.h>
 #include <errno.h>
+#include <time.h>
+#include <sys/time.h>
 
 #include <getopt.h>
 
@@ -57,6 +59,7 @@
 #endif
 
 #include <hamlib/rig.h>
+#include <hamlib/rigshm.h>
 #include "misc.h"
 #include "iofunc.h"
 #include "serial.h"
@@ -70,7 +73,7 @@
  * NB: do NOT use -W since it's reserved by POSIX.
  * TODO: add an option to read from a file
  */
-#define SHORT_OPTIONS "m:r:p:d:P:D:s:c:T:t:C:lLuoevhV"
+#define SHORT_OPTIONS "m:r:p:d:P:D:s:c:T:t:C:S:M:x:lLuoevhV"
 static struct option long_options[] =
 {
 	{"model",       1, 0, 'm'},
@@ -84,6 +87,9 @@ static struct option long_options[] =
 	{"listen-addr", 1, 0, 'T'},
 	{"port",        1, 0, 't'},
 	{"set-conf",    1, 0, 'C'},
+	{"shm-file",    1, 0, 'S'},
+	{"mcast-addr",  1, 0, 'M'},
+	{"metrics-addr",1, 0, 'x'},
 	{"list",        0, 0, 'l'},
 	{"show-conf",   0, 0, 'L'},
 	{"dump-caps",   0, 0, 'u'},
@@ -104,6 +110,25 @@ struct handle_data {
 
 void * handle_socket(void * arg);
 void usage(void);
+static void publish_state(RIG *rig);
+static int mcast_open(const char *addr);
+static void mcast_send_state(RIG *rig, int keyframe);
+#ifdef HAVE_PTHREAD
+static void * mcast_keyframe_thread(void *arg);
+#endif
+static int state_freq_event(RIG *rig, vfo_t vfo, freq_t freq, rig_ptr_t arg);
+static int state_mode_event(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width, rig_ptr_t arg);
+static int state_vfo_event(RIG *rig, vfo_t vfo, rig_ptr_t arg);
+static int state_ptt_event(RIG *rig, vfo_t vfo, ptt_t ptt, rig_ptr_t arg);
+static struct client_stats * stats_client_open(const char *peer);
+static void stats_client_close(struct client_stats *cs);
+static void stats_cmd_event(RIG *rig, unsigned char cmd, const char *name,
+		int retcode, unsigned long wait_us, unsigned long run_us);
+static int stats_print(RIG *rig, FILE *fout);
+static int metrics_open(const char *addr);
+#ifdef HAVE_PTHREAD
+static void * metrics_thread(void *arg);
+#endif
 
 int interactive = 1;    /* no cmd because of daemon */
 int prompt = 0;         /* Daemon mode for rigparse return string */
@@ -114,6 +139,61 @@ char send_cmd_term = '\r';  /* send_cmd termination char */
 
 const char *portno = "4532";
 const char *src_addr = NULL; /* INADDR_ANY */
+const char *shm_file = NULL; /* no state publication */
+const char *mcast_addr = NULL; /* no state broadcast */
+const char *metrics_addr = NULL; /* no metrics listener */
+
+static rig_shm_t *state_shm = NULL;
+
+/* keyframe period of the multicast state broadcast, in seconds */
+#define MCAST_KEYFRAME_PERIOD 1
+
+static int mcast_sock = -1;
+static struct sockaddr_storage mcast_dest;
+static socklen_t mcast_destlen;
+static struct rig_shm_snapshot mcast_last;
+static volatile int mcast_dirty;
+static volatile int mcast_keyframe_pending;
+#ifdef HAVE_PTHREAD
+static pthread_mutex_t mcast_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/*
+ * Statistics of the daemon, see stats_print().  Each client thread
+ * counts in its own block, so that the command path takes no lock
+ * but for the copy of the port statistics; stats_mutex guards the
+ * list of blocks, on connection, disconnection and dump, and that
+ * copy.  It is never held while printing.
+ */
+#define STATS_HIST RIG_PORT_STATS_HIST
+
+struct client_stats {
+	struct client_stats *next;
+	char peer[64];
+	time_t since;
+	unsigned long cmds[256];	/* by command char */
+	unsigned long errors;
+	unsigned long timeouts;
+	unsigned long long wait_us;	/* waiting for the rig mutex */
+	unsigned long long run_us;	/* running the commands */
+	unsigned long wait_hist[STATS_HIST];
+	unsigned long run_hist[STATS_HIST];
+};
+
+static struct client_stats *stats_clients;	/* connected clients */
+static struct client_stats stats_closed;	/* sum of the disconnected ones */
+static unsigned long stats_connections;
+static port_stats_t stats_port;		/* as of the last command */
+static const char *stats_cmd_names[256];
+static time_t stats_start;
+#ifdef HAVE_PTHREAD
+static pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t stats_key;
+#else
+static struct client_stats *stats_current;
+#endif
+
+static int metrics_sock = -1;
 
 #define MAXCONFLEN 128
 
@@ -259,6 +339,27 @@ int main (int argc, char *argv[])
 				}
 				src_addr = optarg;
 				break;
+			case 'S':
+				if (!optarg) {
+					usage();	/* wrong arg count */
+					exit(1);
+				}
+				shm_file = optarg;
+				break;
+			case 'M':
+				if (!optarg) {
+					usage();	/* wrong arg count */
+					exit(1);
+				}
+				mcast_addr = optarg;
+				break;
+			case 'x':
+				if (!optarg) {
+					usage();	/* wrong arg count */
+					exit(1);
+				}
+				metrics_addr = optarg;
+				break;
 			case 'o':
 				vfo_mode++;
 				break;
@@ -354,6 +455,80 @@ int main (int argc, char *argv[])
 	rig_debug(RIG_DEBUG_VERBOSE, "Backend version: %s, Status: %s\n",
 			my_rig->caps->version, rig_strstatus(my_rig->caps->status));
 
+	/*
+	 * Publish rig state to local readers and/or to a multicast group,
+	 * updated after each command and on transceive events.
+	 */
+	if (shm_file) {
+		state_shm = rig_shm_create(shm_file, my_rig->caps->rig_model);
+		if (!state_shm) {
+			fprintf(stderr, "Cannot create shared memory file '%s'\n", shm_file);
+			exit(2);
+		}
+	}
+	if (mcast_addr) {
+		if (mcast_open(mcast_addr) != 0) {
+			fprintf(stderr, "Cannot open multicast group '%s'\n", mcast_addr);
+			exit(2);
+		}
+#ifdef HAVE_PTHREAD
+		{
+			pthread_t thread;
+			pthread_attr_t attr;
+
+			pthread_attr_init(&attr);
+			pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+			retcode = pthread_create(&thread, &attr, mcast_keyframe_thread, my_rig);
+			if (retcode != 0) {
+				rig_debug(RIG_DEBUG_ERR, "pthread_create: %s\n", strerror(retcode));
+				exit(2);
+			}
+		}
+#endif
+	}
+	if (shm_file || mcast_addr) {
+		rig_set_freq_callback(my_rig, state_freq_event, NULL);
+		rig_set_mode_callback(my_rig, state_mode_event, NULL);
+		rig_set_vfo_callback(my_rig, state_vfo_event, NULL);
+		rig_set_ptt_callback(my_rig, state_ptt_event, NULL);
+		rigctl_post_cmd_hook = publish_state;
+		publish_state(my_rig);
+	}
+
+	/*
+	 * Statistics, dumped by the dump_stats command and served
+	 * as plain text to whoever connects to the metrics listener.
+	 */
+	stats_start = time(NULL);
+#ifdef HAVE_PTHREAD
+	pthread_key_create(&stats_key, NULL);
+#endif
+	rigctl_cmd_stats_hook = stats_cmd_event;
+	rigctl_dump_stats_hook = stats_print;
+	rig_get_port_stats(my_rig, &stats_port);
+
+	if (metrics_addr) {
+#ifdef HAVE_PTHREAD
+		pthread_t thread;
+		pthread_attr_t attr;
+
+		if (metrics_open(metrics_addr) != 0) {
+			fprintf(stderr, "Cannot open metrics listener '%s'\n", metrics_addr);
+			exit(2);
+		}
+		pthread_attr_init(&attr);
+		pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+		retcode = pthread_create(&thread, &attr, metrics_thread, my_rig);
+		if (retcode != 0) {
+			rig_debug(RIG_DEBUG_ERR, "pthread_create: %s\n", strerror(retcode));
+			exit(2);
+		}
+#else
+		fprintf(stderr, "The metrics listener needs thread support\n");
+		exit(2);
+#endif
+	}
+
 #ifdef __MINGW32__
 # ifndef SO_OPENTYPE
 #  define SO_OPENTYPE     0x7008
@@ -461,6 +636,13 @@ int main (int argc, char *argv[])
 	rig_close(my_rig); /* close port */
 	rig_cleanup(my_rig); /* if you care about memory */
 
+	if (state_shm)
+		rig_shm_close(state_shm);
+	if (mcast_sock >= 0)
+		close(mcast_sock);
+	if (metrics_sock >= 0)
+		close(metrics_sock);
+
 #ifdef __MINGW32__
 	WSACleanup();
 #endif
@@ -475,10 +657,17 @@ int main (int argc, char *argv[])
 void * handle_socket(void *arg)
 {
 	struct handle_data *handle_data_arg = (struct handle_data *)arg;
+	struct client_stats *stats;
+	char peer[64];
 	FILE *fsockin;
 	FILE *fsockout;
 	int retcode;
 
+	snprintf(peer, sizeof(peer), "%s:%d",
+			inet_ntoa(handle_data_arg->cli_addr.sin_addr),
+			ntohs(handle_data_arg->cli_addr.sin_port));
+	stats = stats_client_open(peer);
+
 #ifdef __MINGW32__
 	int sock_osfhandle = _open_osfhandle(handle_data_arg->sock, _O_RDONLY);
 	if (sock_osfhandle == -1) {
@@ -528,6 +717,7 @@ handle_exit:
 	close(handle_data_arg->sock);
 #endif
 	free(arg);
+	stats_client_close(stats);
 
 #ifdef HAVE_PTHREAD
 	pthread_exit(NULL);
@@ -535,6 +725,533 @@ handle_exit:
 	return NULL;
 }
 
+/*
+ * Rig state publication
+ */
+static void publish_state(RIG *rig)
+{
+	if (state_shm)
+		rig_shm_publish_rig(state_shm, rig);
+	if (mcast_sock >= 0)
+		mcast_send_state(rig, 0);
+}
+
+/*
+ * Prepare the UDP socket sending to GROUP[:PORT]
+ */
+static int mcast_open(const char *addr)
+{
+	struct addrinfo hints, *res;
+	char host[FILPATHLEN];
+	char *port;
+	unsigned char ttl = 1;	/* stay on the LAN */
+	int retcode;
+
+	strncpy(host, addr, FILPATHLEN - 1);
+	host[FILPATHLEN - 1] = '\0';
+	/* search last ':', because IPv6 may have some */
+	port = strrchr(host, ':');
+	if (port && strchr(host, ':') == port)
+		*port++ = '\0';
+	else
+		port = (char *)portno;
+
+	memset(&hints, 0, sizeof(struct addrinfo));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_DGRAM;
+
+	retcode = getaddrinfo(host, port, &hints, &res);
+	if (retcode != 0) {
+		fprintf(stderr, "getaddrinfo: %s\n", gai_strerror(retcode));
+		return -1;
+	}
+
+	mcast_sock = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+	if (mcast_sock < 0) {
+		freeaddrinfo(res);
+		return -1;
+	}
+	if (res->ai_family == AF_INET)
+		setsockopt(mcast_sock, IPPROTO_IP, IP_MULTICAST_TTL,
+				(char *)&ttl, sizeof(ttl));
+
+	memcpy(&mcast_dest, res->ai_addr, res->ai_addrlen);
+	mcast_destlen = res->ai_addrlen;
+	freeaddrinfo(res);
+
+	return 0;
+}
+
+/*
+ * Send the rig state to the group, when it changed since the last
+ * datagram, or unconditionally for a keyframe.
+ *
+ * The update, keyframe included, is flagged first. When another thread
+ * is sending, e.g. the event thread from a transceive callback while a
+ * client thread publishes, or the keyframe thread, it is left to that
+ * sender, which looks at the flags again once it has unlocked, so that
+ * an update flagged meanwhile is not lost.
+ */
+static void mcast_send_state(RIG *rig, int keyframe)
+{
+	struct rig_shm_snapshot snap;
+	struct timeval tv;
+	char buf[RIG_SHM_DGRAM_MAX];
+	int len;
+
+	if (keyframe)
+		mcast_keyframe_pending = 1;
+	mcast_dirty = 1;
+
+	while (mcast_dirty) {
+#ifdef HAVE_PTHREAD
+		if (pthread_mutex_trylock(&mcast_mutex) != 0)
+			return;
+#endif
+		mcast_dirty = 0;
+		keyframe = mcast_keyframe_pending;
+		mcast_keyframe_pending = 0;
+		/* under the handle lock */
+		rig_shm_snapshot_rig(rig, &snap);
+
+		if (keyframe || snap.vfo != mcast_last.vfo ||
+				snap.freq != mcast_last.freq ||
+				snap.mode != mcast_last.mode ||
+				snap.width != mcast_last.width ||
+				snap.ptt != mcast_last.ptt ||
+				snap.tx_vfo != mcast_last.tx_vfo) {
+			gettimeofday(&tv, NULL);
+			snap.serial = mcast_last.serial + 1;
+			snap.tv_sec = tv.tv_sec;
+			snap.tv_usec = tv.tv_usec;
+			mcast_last = snap;
+
+			len = rig_shm_encode(buf, sizeof(buf), &snap, keyframe);
+			if (len > 0 && sendto(mcast_sock, buf, len, 0,
+					(struct sockaddr *)&mcast_dest, mcast_destlen) < 0)
+				rig_debug(RIG_DEBUG_WARN, "sendto: %s\n", strerror(errno));
+		}
+#ifdef HAVE_PTHREAD
+		pthread_mutex_unlock(&mcast_mutex);
+#endif
+	}
+}
+
+#ifdef HAVE_PTHREAD
+/*
+ * Periodic keyframe, so that late listeners and those having lost
+ * a datagram catch up.
+ */
+static void * mcast_keyframe_thread(void *arg)
+{
+	RIG *rig = (RIG *)arg;
+
+	for (;;) {
+		sleep(MCAST_KEYFRAME_PERIOD);
+		mcast_send_state(rig, 1);
+	}
+
+	return NULL;
+}
+#endif
+
+static int state_freq_event(RIG *rig, vfo_t vfo, freq_t freq, rig_ptr_t arg)
+{
+	if (vfo == RIG_VFO_CURR || vfo == rig->state.current_vfo)
+		rig->state.current_freq = freq;
+	publish_state(rig);
+	return RIG_OK;
+}
+
+static int state_mode_event(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width, rig_ptr_t arg)
+{
+	if (vfo == RIG_VFO_CURR || vfo == rig->state.current_vfo) {
+		rig->state.current_mode = mode;
+		rig->state.current_width = width;
+	}
+	publish_state(rig);
+	return RIG_OK;
+}
+
+static int state_vfo_event(RIG *rig, vfo_t vfo, rig_ptr_t arg)
+{
+	rig->state.current_vfo = vfo;
+	publish_state(rig);
+	return RIG_OK;
+}
+
+static int state_ptt_event(RIG *rig, vfo_t vfo, ptt_t ptt, rig_ptr_t arg)
+{
+	rig->state.current_ptt = ptt;
+	publish_state(rig);
+	return RIG_OK;
+}
+
+/*
+ * Statistics
+ */
+static struct client_stats * stats_client_open(const char *peer)
+{
+	struct client_stats *cs;
+
+	cs = calloc(1, sizeof(struct client_stats));
+	if (!cs)
+		return NULL;
+
+	snprintf(cs->peer, sizeof(cs->peer), "%s", peer);
+	cs->since = time(NULL);
+
+#ifdef HAVE_PTHREAD
+	pthread_mutex_lock(&stats_mutex);
+#endif
+	cs->next = stats_clients;
+	stats_clients = cs;
+	stats_connections++;
+#ifdef HAVE_PTHREAD
+	pthread_mutex_unlock(&stats_mutex);
+	pthread_setspecific(stats_key, cs);
+#else
+	stats_current = cs;
+#endif
+
+	return cs;
+}
+
+static void stats_add(struct client_stats *sum, const struct client_stats *cs)
+{
+	int i;
+
+	for (i = 0; i < 256; i++)
+		sum->cmds[i] += cs->cmds[i];
+	sum->errors += cs->errors;
+	sum->timeouts += cs->timeouts;
+	sum->wait_us += cs->wait_us;
+	sum->run_us += cs->run_us;
+	for (i = 0; i < STATS_HIST; i++) {
+		sum->wait_hist[i] += cs->wait_hist[i];
+		sum->run_hist[i] += cs->run_hist[i];
+	}
+}
+
+static void stats_client_close(struct client_stats *cs)
+{
+	struct client_stats **p;
+
+	if (!cs)
+		return;
+
+#ifdef HAVE_PTHREAD
+	pthread_setspecific(stats_key, NULL);
+	pthread_mutex_lock(&stats_mutex);
+#else
+	stats_current = NULL;
+#endif
+	for (p = &stats_clients; *p; p = &(*p)->next) {
+		if (*p == cs) {
+			*p = cs->next;
+			break;
+		}
+	}
+	/* the counters of the client outlive its connection */
+	stats_add(&stats_closed, cs);
+#ifdef HAVE_PTHREAD
+	pthread_mutex_unlock(&stats_mutex);
+#endif
+
+	free(cs);
+}
+
+/* log2 buckets, as the port statistics: <1ms, [1,2)ms, [2,4)ms, ... */
+static int stats_bucket(unsigned long us)
+{
+	unsigned long ms = us / 1000;
+	int i = 0;
+
+	while (ms && i < STATS_HIST - 1) {
+		ms >>= 1;
+		i++;
+	}
+	return i;
+}
+
+/*
+ * Counts a command in the block of the calling client thread,
+ * without locking, the thread being the only writer of its block.
+ */
+static void stats_cmd_event(RIG *rig, unsigned char cmd, const char *name,
+		int retcode, unsigned long wait_us, unsigned long run_us)
+{
+	struct client_stats *cs;
+	port_stats_t port;
+
+#ifdef HAVE_PTHREAD
+	cs = (struct client_stats *)pthread_getspecific(stats_key);
+#else
+	cs = stats_current;
+#endif
+	if (!cs)
+		return;
+
+	/*
+	 * Copied here, the rig being held anyway, rather than on each
+	 * dump, which would wait for the command in progress.
+	 */
+	if (rig_get_port_stats(rig, &port) == RIG_OK) {
+#ifdef HAVE_PTHREAD
+		pthread_mutex_lock(&stats_mutex);
+#endif
+		stats_port = port;
+#ifdef HAVE_PTHREAD
+		pthread_mutex_unlock(&stats_mutex);
+#endif
+	}
+
+	stats_cmd_names[cmd] = name;
+	cs->cmds[cmd]++;
+	if (retcode != RIG_OK)
+		cs->errors++;
+	if (retcode == -RIG_ETIMEOUT)
+		cs->timeouts++;
+	cs->wait_us += wait_us;
+	cs->run_us += run_us;
+	cs->wait_hist[stats_bucket(wait_us)]++;
+	cs->run_hist[stats_bucket(run_us)]++;
+}
+
+static unsigned long stats_cmds(const struct client_stats *cs)
+{
+	unsigned long n = 0;
+	int i;
+
+	for (i = 0; i < 256; i++)
+		n += cs->cmds[i];
+	return n;
+}
+
+/* a histogram of seconds, the sum being left out when negative */
+static void stats_print_hist(FILE *fout, const char *name,
+		const unsigned long *hist, double sum)
+{
+	unsigned long count = 0;
+	int i;
+
+	fprintf(fout, "# TYPE %s histogram\n", name);
+	for (i = 0; i < STATS_HIST - 1; i++) {
+		count += hist[i];
+		fprintf(fout, "%s_bucket{le=\"%g\"} %lu\n", name,
+				(1 << i) / 1000.0, count);
+	}
+	count += hist[i];
+	fprintf(fout, "%s_bucket{le=\"+Inf\"} %lu\n", name, count);
+	if (sum >= 0)
+		fprintf(fout, "%s_sum %.6f\n", name, sum);
+	fprintf(fout, "%s_count %lu\n", name, count);
+}
+
+/* what is printed of a connected client */
+struct client_line {
+	char peer[64];
+	time_t since;
+	unsigned long cmds;
+	unsigned long errors;
+	unsigned long long wait_us;
+};
+
+/*
+ * Dumps the statistics in the Prometheus text format: the daemon
+ * totals, the counters of each connected client, and the statistics
+ * of the rig port as of the last command.  They are copied under
+ * stats_mutex, then printed, a slow reader holding up no one.
+ */
+static int stats_print(RIG *rig, FILE *fout)
+{
+	struct client_stats sum, *cs;
+	struct client_line *lines;
+	unsigned long connections;
+	port_stats_t port;
+	time_t now = time(NULL);
+	int i, nclients = 0;
+
+#ifdef HAVE_PTHREAD
+	pthread_mutex_lock(&stats_mutex);
+#endif
+	sum = stats_closed;
+	for (cs = stats_clients; cs; cs = cs->next) {
+		stats_add(&sum, cs);
+		nclients++;
+	}
+	lines = calloc(nclients + 1, sizeof(struct client_line));
+	for (cs = stats_clients, i = 0; lines && cs; cs = cs->next, i++) {
+		memcpy(lines[i].peer, cs->peer, sizeof(lines[i].peer));
+		lines[i].since = cs->since;
+		lines[i].cmds = stats_cmds(cs);
+		lines[i].errors = cs->errors;
+		lines[i].wait_us = cs->wait_us;
+	}
+	connections = stats_connections;
+	port = stats_port;
+#ifdef HAVE_PTHREAD
+	pthread_mutex_unlock(&stats_mutex);
+#endif
+
+	fprintf(fout, "# TYPE rigctld_uptime_seconds gauge\n");
+	fprintf(fout, "rigctld_uptime_seconds %ld\n", (long)(now - stats_start));
+	fprintf(fout, "# TYPE rigctld_clients gauge\n");
+	fprintf(fout, "rigctld_clients %d\n", nclients);
+	fprintf(fout, "# TYPE rigctld_connections_total counter\n");
+	fprintf(fout, "rigctld_connections_total %lu\n", connections);
+
+	fprintf(fout, "# TYPE rigctld_commands_total counter\n");
+	for (i = 0; i < 256; i++)
+		if (sum.cmds[i])
+			fprintf(fout, "rigctld_commands_total{command=\"%s\"} %lu\n",
+					stats_cmd_names[i], sum.cmds[i]);
+	fprintf(fout, "# TYPE rigctld_errors_total counter\n");
+	fprintf(fout, "rigctld_errors_total %lu\n", sum.errors);
+	fprintf(fout, "# TYPE rigctld_timeouts_total counter\n");
+	fprintf(fout, "rigctld_timeouts_total %lu\n", sum.timeouts);
+	stats_print_hist(fout, "rigctld_mutex_wait_seconds", sum.wait_hist,
+			sum.wait_us / 1e6);
+	stats_print_hist(fout, "rigctld_command_seconds", sum.run_hist,
+			sum.run_us / 1e6);
+
+	/* none but the totals when out of memory */
+	if (!lines)
+		nclients = 0;
+	fprintf(fout, "# TYPE rigctld_client_commands_total counter\n");
+	for (i = 0; i < nclients; i++)
+		fprintf(fout, "rigctld_client_commands_total{client=\"%s\"} %lu\n",
+				lines[i].peer, lines[i].cmds);
+	fprintf(fout, "# TYPE rigctld_client_errors_total counter\n");
+	for (i = 0; i < nclients; i++)
+		fprintf(fout, "rigctld_client_errors_total{client=\"%s\"} %lu\n",
+				lines[i].peer, lines[i].errors);
+	fprintf(fout, "# TYPE rigctld_client_mutex_wait_seconds_total counter\n");
+	for (i = 0; i < nclients; i++)
+		fprintf(fout, "rigctld_client_mutex_wait_seconds_total{client=\"%s\"} %.6f\n",
+				lines[i].peer, lines[i].wait_us / 1e6);
+	fprintf(fout, "# TYPE rigctld_client_connected_seconds gauge\n");
+	for (i = 0; i < nclients; i++)
+		fprintf(fout, "rigctld_client_connected_seconds{client=\"%s\"} %ld\n",
+				lines[i].peer, (long)(now - lines[i].since));
+	free(lines);
+
+	fprintf(fout, "# TYPE rigctld_port_transactions_total counter\n");
+	fprintf(fout, "rigctld_port_transactions_total %lu\n", port.transactions);
+	fprintf(fout, "# TYPE rigctld_port_timeouts_total counter\n");
+	fprintf(fout, "rigctld_port_timeouts_total %lu\n", port.timeouts);
+	fprintf(fout, "# TYPE rigctld_port_errors_total counter\n");
+	fprintf(fout, "rigctld_port_errors_total %lu\n", port.errors);
+	fprintf(fout, "# TYPE rigctld_port_retries_total counter\n");
+	fprintf(fout, "rigctld_port_retries_total %lu\n", port.retries);
+	stats_print_hist(fout, "rigctld_port_ttfb_seconds", port.ttfb, -1);
+	stats_print_hist(fout, "rigctld_port_complete_seconds", port.complete, -1);
+
+	return RIG_OK;
+}
+
+/*
+ * Prepare the TCP socket of the metrics listener, on [HOST:]PORT
+ */
+static int metrics_open(const char *addr)
+{
+	struct addrinfo hints, *res;
+	char host[FILPATHLEN];
+	char *port;
+	int reuseaddr = 1;
+	int retcode;
+
+	strncpy(host, addr, FILPATHLEN - 1);
+	host[FILPATHLEN - 1] = '\0';
+	/* search last ':', because IPv6 may have some */
+	port = strrchr(host, ':');
+	if (port)
+		*port++ = '\0';
+	else
+		port = host;
+
+	memset(&hints, 0, sizeof(struct addrinfo));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = AI_PASSIVE;
+
+	retcode = getaddrinfo(port != host ? host : NULL, port, &hints, &res);
+	if (retcode != 0) {
+		fprintf(stderr, "getaddrinfo: %s\n", gai_strerror(retcode));
+		return -1;
+	}
+
+	metrics_sock = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+	if (metrics_sock < 0) {
+		freeaddrinfo(res);
+		return -1;
+	}
+	setsockopt(metrics_sock, SOL_SOCKET, SO_REUSEADDR,
+			(char *)&reuseaddr, sizeof(reuseaddr));
+	if (bind(metrics_sock, res->ai_addr, res->ai_addrlen) < 0 ||
+			listen(metrics_sock, 4) < 0) {
+		rig_debug(RIG_DEBUG_ERR, "metrics listener: %s\n", strerror(errno));
+		freeaddrinfo(res);
+		return -1;
+	}
+	freeaddrinfo(res);
+
+	return 0;
+}
+
+#ifdef HAVE_PTHREAD
+/*
+ * Serves the statistics to each connection, then closes it.
+ * An HTTP request, as sent by a Prometheus scraper, gets a
+ * response header first.
+ */
+static void * metrics_thread(void *arg)
+{
+	RIG *rig = (RIG *)arg;
+	struct timeval tv;
+	fd_set rfds;
+	char req[16];
+	FILE *fout;
+	int sock, http;
+
+	for (;;) {
+		sock = accept(metrics_sock, NULL, NULL);
+		if (sock < 0) {
+			if (errno != EINTR)
+				break;
+			continue;
+		}
+
+		/* a plain client sends nothing */
+		FD_ZERO(&rfds);
+		FD_SET(sock, &rfds);
+		tv.tv_sec = 0;
+		tv.tv_usec = 200*1000;
+		http = select(sock + 1, &rfds, NULL, NULL, &tv) > 0 &&
+			recv(sock, req, sizeof(req), 0) >= 3 &&
+			!strncmp(req, "GET", 3);
+
+#ifdef __MINGW32__
+		fout = _fdopen(_open_osfhandle(sock, 0), "wb");
+#else
+		fout = fdopen(sock, "wb");
+#endif
+		if (!fout) {
+			close(sock);
+			continue;
+		}
+		if (http)
+			fprintf(fout, "HTTP/1.0 200 OK\r\n"
+					"Content-Type: text/plain; version=0.0.4\r\n\r\n");
+		stats_print(rig, fout);
+		fclose(fout);
+	}
+
+	rig_debug(RIG_DEBUG_ERR, "metrics listener: %s\n", strerror(errno));
+	return NULL;
+}
+#endif
+
 void usage(void)
 {
 	printf("Usage: rigctld [OPTION]...\n"
@@ -553,6 +1270,9 @@ void usage(void)
 	"  -t, --port=NUM             set TCP listening port, default %s\n"
 	"  -T, --listen-addr=IPADDR   set listening IP address, default ANY\n"
 	"  -C, --set-conf=PARM=VAL    set config parameters\n"
+	"  -S, --shm-file=FILE        publish rig state in shared memory FILE\n"
+	"  -M, --mcast-addr=GROUP[:PORT] broadcast rig state to multicast GROUP\n"
+	"  -x, --metrics-addr=[HOST:]PORT serve statistics as text on PORT\n"
 	"  -L, --show-conf            list all config parameters\n"
 	"  -l, --list                 list all model numbers and exit\n"
 	"  -u, --dump-caps            dump capabilities and exit\n"
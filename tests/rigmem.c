@@ -38,6 +38,7 @@
 #include <hamlib/rig.h>
 #include "misc.h"
 #include "sprintflst.h"
+#include "memdiff.h"
 
 #define MAXNAMSIZ 32
 #define MAXNBOPT 100	/* max number of different options */
@@ -48,12 +49,14 @@
  */
 
 extern int xml_save (RIG *rig, const char *outfilename);
-extern int xml_load (RIG *rig, const char *infilename);
+extern int xml_load (RIG *rig, const char *infilename, struct mem_image *img);
+extern int xml_load_image (RIG *rig, const char *infilename, struct mem_image *img);
 extern int xml_parm_save (RIG *rig, const char *outfilename);
 extern int xml_parm_load (RIG *rig, const char *infilename);
 
 extern int csv_save (RIG *rig, const char *outfilename);
-extern int csv_load (RIG *rig, const char *infilename);
+extern int csv_load (RIG *rig, const char *infilename, struct mem_image *img);
+extern int csv_load_image (RIG *rig, const char *infilename, struct mem_image *img);
 extern int csv_parm_save (RIG *rig, const char *outfilename);
 extern int csv_parm_load (RIG *rig, const char *infilename);
 
@@ -65,13 +68,15 @@ void version();
 int set_conf(RIG *rig, char *conf_parms);
 
 int clear_chans (RIG *rig, const char *infilename);
+int load_chans (RIG *rig, const char *infilename, const char *image_file,
+		int xml, int no_diff);
 
 /*
  * Reminder: when adding long options,
  * 		keep up to date SHORT_OPTIONS, usage()'s output and man page. thanks.
  * NB: do NOT use -W since it's reserved by POSIX.
  */
-#define SHORT_OPTIONS "m:r:s:c:C:p:axvhV"
+#define SHORT_OPTIONS "m:r:s:c:C:p:i:naxvhV"
 static struct option long_options[] =
 {
 	{"model",    1, 0, 'm'},
@@ -80,6 +85,8 @@ static struct option long_options[] =
 	{"civaddr",  1, 0, 'c'},
 	{"set-conf", 1, 0, 'C'},
 	{"set-separator", 1, 0, 'p'},
+	{"image",    1, 0, 'i'},
+	{"no-diff",  0, 0, 'n'},
 	{"all",  0, 0, 'a'},
 #ifdef HAVE_XML2
 	{"xml",  0, 0, 'x'},
@@ -101,8 +108,8 @@ int main (int argc, char *argv[])
 
 	int retcode;		/* generic return code from functions */
 
-	int verbose = 0, xml = 0;
-	const char *rig_file=NULL;
+	int verbose = 0, xml = 0, no_diff = 0;
+	const char *rig_file=NULL, *image_file=NULL;
 	int serial_rate = 0;
 	char *civaddr = NULL;	/* NULL means no need to set conf */
 	char conf_parms[MAXCONFLEN] = "";
@@ -168,6 +175,16 @@ int main (int argc, char *argv[])
 					}
 					csv_sep = optarg[0];
 					break;
+			case 'i':
+					if (!optarg) {
+						usage();	/* wrong arg count */
+						exit(1);
+					}
+					image_file = optarg;
+					break;
+			case 'n':
+					no_diff++;
+					break;
 			case 'a':
 					all++;
 					break;
@@ -258,10 +275,7 @@ int main (int argc, char *argv[])
 			retcode = csv_save(rig, argv[optind+1]);
 	} else
 	if (!strcmp(argv[optind], "load")) {
-		if (xml)
-			retcode = xml_load(rig, argv[optind+1]);
-		else
-			retcode = csv_load(rig, argv[optind+1]);
+		retcode = load_chans(rig, argv[optind+1], image_file, xml, no_diff);
 	} else
 	if (!strcmp(argv[optind], "save_parm")) {
 		if (xml)
@@ -314,6 +328,9 @@ void usage()
 	"  -c, --civaddr=ID           set CI-V address, decimal (for Icom rigs only)\n"
 	"  -C, --set-conf=PARM=VAL    set config parameters\n"
 	"  -p, --set-separator=SEP    set character separator instead of the CSV comma\n"
+	"  -i, --image=FILE           on load, diff against FILE, saved from the radio,\n"
+	"                             instead of reading the radio memory\n"
+	"  -n, --no-diff              on load, write all the channels, changed or not\n"
 	"  -a, --all                  bypass mem_caps, apply to all fields of channel_t\n"
 #ifdef HAVE_XML2
 	"  -x, --xml                  use XML format instead of CSV\n"
@@ -360,6 +377,45 @@ int set_conf(RIG *rig, char *conf_parms)
 }
 
 
+/*
+ * Writes only the channels differing from the current memory content,
+ * read from the radio, or from image_file when the radio memory
+ * has not changed since it was saved there.
+ */
+int load_chans (RIG *rig, const char *infilename, const char *image_file,
+		int xml, int no_diff)
+{
+	struct mem_image img;
+	int ret;
+
+	if (no_diff)
+		return xml ? xml_load(rig, infilename, NULL) :
+			csv_load(rig, infilename, NULL);
+
+	ret = mem_image_init(rig, &img);
+	if (ret != RIG_OK)
+		return ret;
+
+	if (image_file)
+		ret = xml ? xml_load_image(rig, image_file, &img) :
+			csv_load_image(rig, image_file, &img);
+	else
+		ret = mem_image_read(rig, &img);
+
+	if (ret == RIG_OK) {
+		rig_debug(RIG_DEBUG_VERBOSE, "%d channel(s) in the memory image\n",
+				img.reads);
+		ret = xml ? xml_load(rig, infilename, &img) :
+			csv_load(rig, infilename, &img);
+		printf("%d channel(s) written, %d unchanged\n",
+				img.writes, img.skips);
+	}
+
+	mem_image_free(&img);
+
+	return ret;
+}
+
 /*
  * Pretty nasty, clears everything you have in rig memory
  */
@@ -46,6 +46,7 @@ static void usage();
 static void version();
 static int set_conf_rig(RIG *rig, char *conf_parms);
 static int set_conf_rot(ROT *rot, char *conf_parms);
+static int print_strength(RIG *rig, const struct rig_sweep_point *pt, rig_ptr_t arg);
 
 /*
  * Reminder: when adding long options,
@@ -91,9 +92,8 @@ int main (int argc, char *argv[])
 	char rot_conf_parms[MAXCONFLEN] = "";
 
 	/* int with_rot = 1; */
-	azimuth_t azimuth;
-	elevation_t elevation;
-	unsigned step = 1000000;	/* 1e6 us */
+	struct rig_sweep sweep;
+	struct rot_sweep rsweep;
 
 	while(1) {
 		int c;
@@ -281,33 +281,27 @@ int main (int argc, char *argv[])
 
 
 	/*******************************/
+	memset(&sweep, 0, sizeof(sweep));
+	sweep.vfo = RIG_VFO_CURR;
+	sweep.level = RIG_LEVEL_STRENGTH;
+	sweep.samples = 1;
+	sweep.point_cb = print_strength;
+	/* no time step: as fast as the rig reports */
 	if (optind < argc)
-		step = atof(argv[optind])*1e6;
-
-	fprintf(stderr,"Setting rotator to azimuth %.1f°\n",rot->state.min_az);
-	rot_set_position (rot, rot->state.min_az, 0);
-	fprintf(stderr,"Wait for rotator to move...\n");
-	rot_get_position (rot, &azimuth, &elevation);
-	while (fabs(azimuth - rot->state.min_az) > 1.) {
-		rot_get_position (rot, &azimuth, &elevation);
-		usleep(step);
-	}
+		sweep.settle_min = atof(argv[optind])*1000;
 
-	fprintf(stderr,"Now initiating full 360° rotation...\n");
-	rot_set_position (rot, rot->state.max_az, 0);
+	memset(&rsweep, 0, sizeof(rsweep));
+	rsweep.az_start = rot->state.min_az;
+	rsweep.az_stop = rot->state.max_az;
 
 	/* TODO: check CW or CCW */
 	/* disable AGC? */
 
-	while (fabs(rot->state.max_az - azimuth) > 1.) {
-		value_t strength;
-
-		rig_get_level(rig,RIG_VFO_CURR,RIG_LEVEL_STRENGTH,&strength);
-
-		rot_get_position (rot, &azimuth, &elevation);
-
-		printf("%.1f %d\n", azimuth, strength.i);
-	}
+	fprintf(stderr,"Rotating from azimuth %.1f° to %.1f°...\n",
+			rsweep.az_start, rsweep.az_stop);
+	retcode = rig_sweep_rot(rig, rot, &sweep, &rsweep);
+	if (retcode < 0)
+		fprintf(stderr,"rig_sweep_rot: error = %s \n", rigerror(retcode));
 
 	rig_close(rig);
 	rot_close(rot);
@@ -317,6 +311,14 @@ int main (int argc, char *argv[])
 
 
 
+int print_strength(RIG *rig, const struct rig_sweep_point *pt, rig_ptr_t arg)
+{
+	printf("%.1f %d\n", pt->azimuth, pt->val.i);
+	fflush(stdout);
+
+	return RIG_OK;
+}
+
 void version()
 {
 	printf("rigsmtr, %s\n\n", hamlib_version);
@@ -0,0 +1,241 @@
+
+/*
+ * Stress test of the frontend locking, to be run under ThreadSanitizer:
+ * several threads hammering private dummy rigs, a shared dummy rig,
+ * a shared dummy rotator, while other threads init/open/close/cleanup
+ * handles, the debug output being enabled.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <hamlib/rig.h>
+#include <hamlib/rotator.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+
+#define NTHREADS 4
+#define LOOPS 2000
+#define CHURN_LOOPS 100
+
+static RIG *shared_rig;
+static ROT *shared_rot;
+static int errors;
+static pthread_mutex_t errors_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void fail(const char *what, int id, int ret)
+{
+	pthread_mutex_lock(&errors_mutex);
+	fprintf(stderr, "thread %d: %s: %s\n", id, what, rigerror(ret));
+	errors++;
+	pthread_mutex_unlock(&errors_mutex);
+}
+
+/* the frequencies written to the shared rig by each thread */
+static freq_t thread_freq(int id)
+{
+	return 14000000 + 1000 * id;
+}
+
+static void *private_rig_thread(void *arg)
+{
+	int id = (int)(long)arg;
+	RIG *rig;
+	freq_t freq;
+	rmode_t mode;
+	pbwidth_t width;
+	int i, ret;
+
+	rig = rig_init(RIG_MODEL_DUMMY);
+	if (!rig) {
+		fail("rig_init", id, -RIG_EINVAL);
+		return NULL;
+	}
+	ret = rig_open(rig);
+	if (ret != RIG_OK) {
+		fail("rig_open", id, ret);
+		rig_cleanup(rig);
+		return NULL;
+	}
+
+	for (i = 0; i < LOOPS; i++) {
+		ret = rig_set_freq(rig, RIG_VFO_CURR, 7000000 + i);
+		if (ret == RIG_OK)
+			ret = rig_get_freq(rig, RIG_VFO_CURR, &freq);
+		if (ret != RIG_OK) {
+			fail("private freq", id, ret);
+			break;
+		}
+		if (freq != 7000000 + i) {
+			fail("private freq mismatch", id, -RIG_EINTERNAL);
+			break;
+		}
+		ret = rig_set_mode(rig, RIG_VFO_CURR, i & 1 ? RIG_MODE_USB : RIG_MODE_CW,
+				RIG_PASSBAND_NORMAL);
+		if (ret == RIG_OK)
+			ret = rig_get_mode(rig, RIG_VFO_CURR, &mode, &width);
+		if (ret != RIG_OK) {
+			fail("private mode", id, ret);
+			break;
+		}
+	}
+
+	rig_close(rig);
+	rig_cleanup(rig);
+	return NULL;
+}
+
+static void *shared_rig_thread(void *arg)
+{
+	int id = (int)(long)arg;
+	freq_t freq;
+	value_t val;
+	int i, j, ret;
+
+	for (i = 0; i < LOOPS; i++) {
+		ret = rig_set_freq(shared_rig, RIG_VFO_CURR, thread_freq(id));
+		if (ret == RIG_OK)
+			ret = rig_get_freq(shared_rig, RIG_VFO_CURR, &freq);
+		if (ret != RIG_OK) {
+			fail("shared freq", id, ret);
+			break;
+		}
+		/* any thread may have written in between, but not garbage */
+		for (j = 0; j < NTHREADS; j++)
+			if (freq == thread_freq(j))
+				break;
+		if (j == NTHREADS) {
+			fail("shared freq torn", id, -RIG_EINTERNAL);
+			break;
+		}
+		val.f = 0.5;
+		ret = rig_set_level(shared_rig, RIG_VFO_CURR, RIG_LEVEL_AF, val);
+		if (ret == RIG_OK)
+			ret = rig_get_level(shared_rig, RIG_VFO_CURR, RIG_LEVEL_AF, &val);
+		if (ret != RIG_OK) {
+			fail("shared level", id, ret);
+			break;
+		}
+	}
+	return NULL;
+}
+
+static void *shared_rot_thread(void *arg)
+{
+	int id = (int)(long)arg;
+	azimuth_t az;
+	elevation_t el;
+	int i, ret;
+
+	for (i = 0; i < LOOPS / 10; i++) {
+		ret = rot_set_position(shared_rot, 10 * id, 5 * id);
+		if (ret == RIG_OK)
+			ret = rot_get_position(shared_rot, &az, &el);
+		if (ret != RIG_OK) {
+			fail("shared rot", id, ret);
+			break;
+		}
+	}
+	return NULL;
+}
+
+static void *churn_thread(void *arg)
+{
+	int id = (int)(long)arg;
+	RIG *rig;
+	ROT *rot;
+	int i;
+
+	for (i = 0; i < CHURN_LOOPS; i++) {
+		rig = rig_init(RIG_MODEL_DUMMY);
+		rot = rot_init(ROT_MODEL_DUMMY);
+		if (!rig || !rot) {
+			fail("churn init", id, -RIG_EINVAL);
+			break;
+		}
+		rig_open(rig);
+		rot_open(rot);
+		rig_close(rig);
+		rot_close(rot);
+		rig_cleanup(rig);
+		rot_cleanup(rot);
+	}
+	return NULL;
+}
+
+static int run(const char *name, void *(*func)(void *))
+{
+	pthread_t th[NTHREADS];
+	long i;
+
+	printf("%s\n", name);
+	for (i = 0; i < NTHREADS; i++) {
+		if (pthread_create(&th[i], NULL, func, (void *)i) != 0) {
+			fprintf(stderr, "pthread_create failed\n");
+			return 1;
+		}
+	}
+	for (i = 0; i < NTHREADS; i++)
+		pthread_join(th[i], NULL);
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *devnull;
+	int ret;
+
+	/* exercise the debug lock, without flooding the test log */
+	devnull = fopen("/dev/null", "w");
+	if (devnull)
+		rig_set_debug_file(devnull);
+	rig_set_debug(devnull ? RIG_DEBUG_TRACE : RIG_DEBUG_NONE);
+
+	shared_rig = rig_init(RIG_MODEL_DUMMY);
+	shared_rot = rot_init(ROT_MODEL_DUMMY);
+	if (!shared_rig || !shared_rot) {
+		fprintf(stderr, "init failed\n");
+		return 1;
+	}
+	ret = rig_open(shared_rig);
+	if (ret == RIG_OK)
+		ret = rot_open(shared_rot);
+	if (ret != RIG_OK) {
+		fprintf(stderr, "open failed: %s\n", rigerror(ret));
+		return 1;
+	}
+
+	if (run("private rigs", private_rig_thread) ||
+			run("shared rig", shared_rig_thread) ||
+			run("shared rotator", shared_rot_thread) ||
+			run("init/cleanup churn", churn_thread))
+		return 1;
+
+	rig_close(shared_rig);
+	rig_cleanup(shared_rig);
+	rot_close(shared_rot);
+	rot_cleanup(shared_rot);
+
+	rig_set_debug_file(NULL);
+	if (devnull)
+		fclose(devnull);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
+
+#else	/* !HAVE_PTHREAD */
+
+int main(int argc, char *argv[])
+{
+	printf("no pthread support, nothing to test\n");
+	return 0;
+}
+
+#endif	/* !HAVE_PTHREAD */
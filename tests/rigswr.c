@@ -44,6 +44,7 @@
 static void usage();
 static void version();
 static int set_conf(RIG *rig, char *conf_parms);
+static int print_swr(RIG *rig, const struct rig_sweep_point *pt, rig_ptr_t arg);
 
 /*
  * Reminder: when adding long options,
@@ -82,9 +83,9 @@ int main (int argc, char *argv[])
 	int serial_rate = 0;
 	char *civaddr = NULL;	/* NULL means no need to set conf */
 	char conf_parms[MAXCONFLEN] = "";
-	freq_t freq,freqstop;
 	freq_t step=kHz(100);
 	value_t pwr;
+	struct rig_sweep sweep;
 
 	while(1) {
 		int c;
@@ -232,29 +233,34 @@ int main (int argc, char *argv[])
 		printf("Opened rig model %d, '%s'\n", rig->caps->rig_model,
 					rig->caps->model_name);
 
-	freq=atof(argv[optind++]);
-	freqstop=atof(argv[optind++]);
+	memset(&sweep, 0, sizeof(sweep));
+	sweep.vfo = RIG_VFO_CURR;
+	sweep.start = atof(argv[optind++]);
+	sweep.stop = atof(argv[optind++]);
 	if (optind < argc)
 		step=atof(argv[optind]);
-
-	rig_set_freq(rig,RIG_VFO_CURR,freq);
-	rig_set_mode(rig,RIG_VFO_CURR,RIG_MODE_CW,RIG_PASSBAND_NORMAL);
+	sweep.step = step;
+	sweep.mode = RIG_MODE_CW;
+	sweep.level = RIG_LEVEL_SWR;
+	sweep.ptt = 1;
+	/*
+	 * transmit until the SWR reading settles away from its value
+	 * before keying, at most 0.5 second
+	 */
+	sweep.settle_min = 50;
+	sweep.settle_max = 500;
+	sweep.settle_tol = 0.05;
+	sweep.samples = 1;
+	sweep.point_cb = print_swr;
+
+	rig_set_freq(rig,RIG_VFO_CURR,sweep.start);
 
 	pwr.f = 0.25;	/* 25% of RF POWER */
 	rig_set_level(rig,RIG_VFO_CURR,RIG_LEVEL_RFPOWER,pwr);
 
-	while(freq<=freqstop) {
-		value_t swr;
-
-		rig_set_ptt(rig,RIG_VFO_CURR,RIG_PTT_ON);
-		usleep(500000);
-		rig_get_level(rig,RIG_VFO_CURR,RIG_LEVEL_SWR,&swr);
-		rig_set_ptt(rig,RIG_VFO_CURR,RIG_PTT_OFF);
-
-		printf("%10.0f %4.2f\n",freq,swr.f);
-		freq+=step;
-		rig_set_freq(rig,RIG_VFO_CURR,freq);
-	}
+	retcode = rig_sweep(rig, &sweep);
+	if (retcode < 0)
+		fprintf(stderr,"rig_sweep: error = %s \n", rigerror(retcode));
 
 	rig_close(rig);
 
@@ -263,6 +269,14 @@ int main (int argc, char *argv[])
 
 
 
+int print_swr(RIG *rig, const struct rig_sweep_point *pt, rig_ptr_t arg)
+{
+	printf("%10.0f %4.2f\n",pt->freq,pt->val.f);
+	fflush(stdout);
+
+	return RIG_OK;
+}
+
 void version()
 {
 	printf("rigswr, %s\n\n", hamlib_version);
@@ -450,8 +450,10 @@ int rotctl_parse(ROT *my_rot, FILE *fin, FILE *fout, char *argv[], int argc)
 	}
 
 	/*
-	 * mutex locking needed because rigctld is multithreaded
-	 * and hamlib is not MT-safe
+	 * mutex locking needed because rigctld is multithreaded:
+	 * hamlib serializes each call, but a command may be made
+	 * of several calls, which must not interleave with the
+	 * ones of another client
 	 */
 #ifdef HAVE_PTHREAD
 	pthread_mutex_lock(&rot_mutex);
@@ -0,0 +1,85 @@
+/*
+ * Hamlib Si570 tuning micro benchmark
+ *
+ * Tunes per second of the kit Si570 backends, register computation
+ * only, for a sweep by 1 Hz steps: full divider search on every tune,
+ * against smooth tune reusing the dividers within 3500 ppm.
+ * The USB transfer, the same in both cases, is not counted.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <hamlib/rig.h>
+#include <sys/time.h>
+#include "si570avrusb.h"
+
+#define LOOP_COUNT 1000000
+#define MULTIPLIER 4
+#define START_FREQ 7.0	/* MHz */
+#define STEP 1e-6	/* MHz */
+
+static struct timeval tv1;
+
+static void bench_start(void)
+{
+	gettimeofday(&tv1, NULL);
+}
+
+static void bench_end(const char *name, unsigned loops, unsigned sink)
+{
+	struct timeval tv2;
+	double elapsed;
+
+	gettimeofday(&tv2, NULL);
+	elapsed = tv2.tv_sec - tv1.tv_sec + (tv2.tv_usec - tv1.tv_usec)/1000000.0;
+	printf("%-28s %12.0f tunes/s   (%u)\n", name, loops/elapsed, sink % 10);
+}
+
+int main (int argc, char *argv[])
+{
+	unsigned loops = LOOP_COUNT;
+	unsigned sink = 0, divider_changes = 0;
+	struct solution sol, cached;
+	unsigned char buffer[6];
+	double f, center = 0;
+	unsigned i;
+
+	if (argc > 1)
+		loops = atoi(argv[1]);
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	printf("Perform %u tunes from %.3f MHz by %.0f Hz steps...\n",
+			loops, START_FREQ, STEP*1e6);
+
+	bench_start();
+	for (i = 0; i < loops; i++) {
+		f = (START_FREQ + i*STEP) * MULTIPLIER;
+		si570_calc_dividers(SI570_NOMINAL_XTALL_FREQ, f, &sol);
+		si570_set_registers(&sol, buffer);
+		sink += buffer[5];
+	}
+	bench_end("full divider search", loops, sink);
+
+	bench_start();
+	for (i = 0; i < loops; i++) {
+		f = (START_FREQ + i*STEP) * MULTIPLIER;
+		if (!si570_smooth_tune(SI570_NOMINAL_XTALL_FREQ, f, center,
+					&cached, &sol)) {
+			si570_calc_dividers(SI570_NOMINAL_XTALL_FREQ, f, &sol);
+			cached = sol;
+			center = f;
+			divider_changes++;
+		}
+		si570_set_registers(&sol, buffer);
+		sink += buffer[5];
+	}
+	bench_end("smooth tune", loops, sink);
+	printf("%u divider change(s) in smooth tune\n", divider_changes);
+
+	return 0;
+}
@@ -0,0 +1,160 @@
+
+/*
+ * Very simple test program to check the numeric field codec
+ * against the sprintf/sscanf and byte loop BCD conversions it replaces.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <hamlib/rig.h>
+#include "misc.h"
+#include "numcodec.h"
+
+static int errors;
+
+#define CHECK(cond, ...) do { \
+		if (!(cond)) { \
+			fprintf(stderr, __VA_ARGS__); \
+			errors++; \
+		} \
+	} while (0)
+
+/* former to_bcd/from_bcd, one digit at a time */
+static void ref_to_bcd(unsigned char bcd_data[], unsigned long long freq, unsigned bcd_len)
+{
+	int i;
+	unsigned char a;
+
+	for (i=0; i < bcd_len/2; i++) {
+		a = freq%10;
+		freq /= 10;
+		a |= (freq%10)<<4;
+		freq /= 10;
+		bcd_data[i] = a;
+	}
+	if (bcd_len&1) {
+		bcd_data[i] &= 0xf0;
+		bcd_data[i] |= freq%10;
+	}
+}
+
+static unsigned long long ref_from_bcd(const unsigned char bcd_data[], unsigned bcd_len)
+{
+	int i;
+	unsigned long long f = 0;
+
+	if (bcd_len&1)
+		f = bcd_data[bcd_len/2] & 0x0f;
+
+	for (i=(bcd_len/2)-1; i >= 0; i--) {
+		f *= 10;
+		f += bcd_data[i]>>4;
+		f *= 10;
+		f += bcd_data[i] & 0x0f;
+	}
+	return f;
+}
+
+static void check_dec(unsigned long long v, unsigned width)
+{
+	char buf[32], ref[32];
+	unsigned long long back;
+	char *end;
+
+	end = num_to_dec(buf, v, width);
+	sprintf(ref, "%0*llu", width, v);
+	CHECK(!strcmp(buf, ref), "num_to_dec(%s,%u) = '%s'\n", ref, width, buf);
+	CHECK(end == buf + strlen(ref), "num_to_dec(%s,%u) bad end\n", ref, width);
+
+	CHECK(num_from_dec(buf, strlen(buf), &back) == RIG_OK && back == v,
+			"num_from_dec('%s') failed\n", buf);
+}
+
+static void check_bcd(unsigned long long v, unsigned digits)
+{
+	unsigned char b[16], ref[16];
+
+	memset(b, 0xa5, sizeof(b));
+	memset(ref, 0xa5, sizeof(ref));
+	to_bcd(b, v, digits);
+	ref_to_bcd(ref, v, digits);
+	CHECK(!memcmp(b, ref, sizeof(b)), "to_bcd(%llu,%u) mismatch\n",
+			v, digits);
+	CHECK(from_bcd(b, digits) == ref_from_bcd(ref, digits),
+			"from_bcd(%llu,%u) mismatch\n", v, digits);
+
+	to_bcd_be(b, v, digits);
+	CHECK(from_bcd_be(b, digits) == ref_from_bcd(ref, digits),
+			"bcd_be(%llu,%u) mismatch\n", v, digits);
+}
+
+int main (int argc, char *argv[])
+{
+	static const char *freqs[] = {
+		"14074000", "00014074000", " 7000000", "+145500000",
+		"-1500", "1296.125", "0", "10368100000", NULL
+	};
+	unsigned long long v;
+	unsigned char b[2];
+	char buf[32];
+	freq_t f;
+	double ref;
+	int i, n;
+
+	/* decimal fields */
+	for (v = 0; v < 100000; v += 7)
+		check_dec(v, 5);
+	for (v = 1, i = 0; i < 19; i++, v *= 10) {
+		check_dec(v, 11);
+		check_dec(v - 1, 8);
+		check_dec(v + 3, 1);
+	}
+	check_dec(18446744073709551615ULL, 0);
+
+	CHECK(num_from_dec("12a4", 4, &v) == -RIG_EPROTO, "num_from_dec accepted '12a4'\n");
+	CHECK(num_from_dec("    ", 4, &v) == -RIG_EPROTO, "num_from_dec accepted blanks\n");
+
+	/* frequency fields */
+	for (i = 0; freqs[i]; i++) {
+		n = num_scan_freq(freqs[i], &f);
+		sscanf(freqs[i], "%lf", &ref);
+		CHECK(n == strlen(freqs[i]) && f == ref,
+				"num_scan_freq('%s') = %d, %f\n", freqs[i], n, f);
+	}
+	CHECK(num_scan_freq(".;", &f) == -RIG_EPROTO, "num_scan_freq accepted '.'\n");
+
+	/* fixed-point */
+	num_to_fixed(buf, 14074000, 6);
+	CHECK(!strcmp(buf, "14.074000"), "num_to_fixed = '%s'\n", buf);
+	num_to_fixed(buf, -50, 3);
+	CHECK(!strcmp(buf, "-0.050"), "num_to_fixed = '%s'\n", buf);
+	num_to_fixed(buf, 1296, 0);
+	CHECK(!strcmp(buf, "1296"), "num_to_fixed = '%s'\n", buf);
+	num_to_fixed(buf, 50, 5);
+	CHECK(!strcmp(buf, "0.00050"), "num_to_fixed = '%s'\n", buf);
+
+	/* BCD, every byte value decodes as the byte loop did */
+	for (i = 0; i < 256; i++) {
+		b[0] = i;
+		CHECK(from_bcd(b, 2) == ref_from_bcd(b, 2), "from_bcd(%02x) mismatch\n", i);
+		CHECK(from_bcd_be(b, 2) == ref_from_bcd(b, 2), "from_bcd_be(%02x) mismatch\n", i);
+	}
+	for (v = 1, i = 0; i < 19; i++, v *= 10) {
+		check_bcd(v, 10);
+		check_bcd(v - 1, 9);
+		check_bcd(v * 7 / 3, 20);
+		check_bcd(146520000 + i, 6);
+	}
+
+	if (errors)
+		fprintf(stderr, "%d errors\n", errors);
+	else
+		printf("numeric codec OK\n");
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,174 @@
+
+/*
+ * Test program of the load generator of the dummy rig: the operations
+ * take the configured latency, the errors and timeouts are injected at
+ * the configured rates, and the rig tunes itself at the event rate,
+ * reporting it by freq_event in transceive mode.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <hamlib/rig.h>
+
+#define LOOPS 10
+
+static int errors;
+
+static double elapsed_ms(const struct timeval *start)
+{
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+	return (now.tv_sec - start->tv_sec) * 1000.0 +
+		(now.tv_usec - start->tv_usec) / 1000.0;
+}
+
+static int set_conf(RIG *rig, const char *name, const char *val)
+{
+	return rig_set_conf(rig, rig_token_lookup(rig, name), val);
+}
+
+static volatile int freq_events;
+static volatile freq_t event_freq;
+
+static int freq_event(RIG *rig, vfo_t vfo, freq_t freq, rig_ptr_t arg)
+{
+	freq_events++;
+	event_freq = freq;
+	return RIG_OK;
+}
+
+int main(int argc, char *argv[])
+{
+	struct timeval start;
+	freq_t freq, freq2;
+	double ms;
+	RIG *rig;
+	int i, ret;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	rig = rig_init(RIG_MODEL_DUMMY);
+	if (!rig || rig_open(rig) != RIG_OK) {
+		fprintf(stderr, "cannot open the dummy rig\n");
+		return 1;
+	}
+
+	printf("latency\n");
+	set_conf(rig, "get_latency", "5");
+	set_conf(rig, "set_latency", "10");
+	set_conf(rig, "jitter", "2");
+	set_conf(rig, "jitter_dist", "Normal");
+	gettimeofday(&start, NULL);
+	for (i = 0; i < LOOPS; i++) {
+		rig_get_freq(rig, RIG_VFO_CURR, &freq);
+		rig_set_freq(rig, RIG_VFO_CURR, freq);
+	}
+	ms = elapsed_ms(&start);
+	printf("  %d get and set in %.0f ms\n", LOOPS, ms);
+	if (ms < LOOPS * 10) {
+		fprintf(stderr, "latency not taken, %.0f ms\n", ms);
+		errors++;
+	}
+	if (set_conf(rig, "jitter_dist", "Gaussian") != -RIG_EINVAL) {
+		fprintf(stderr, "unknown jitter distribution accepted\n");
+		errors++;
+	}
+	set_conf(rig, "get_latency", "0");
+	set_conf(rig, "set_latency", "0");
+	set_conf(rig, "jitter", "0");
+
+	printf("errors\n");
+	set_conf(rig, "error_rate", "1");
+	ret = rig_get_freq(rig, RIG_VFO_CURR, &freq);
+	printf("  %s\n", rigerror(ret));
+	if (ret != -RIG_EPROTO) {
+		fprintf(stderr, "error not injected: %s\n", rigerror(ret));
+		errors++;
+	}
+	set_conf(rig, "error_rate", "0");
+
+	/* an op failing leaves the rig as it was */
+	rig_set_freq(rig, RIG_VFO_CURR, MHz(14.074));
+	rig_set_ts(rig, RIG_VFO_CURR, kHz(1));
+	set_conf(rig, "error_rate", "1");
+	ret = rig_vfo_op(rig, RIG_VFO_CURR, RIG_OP_UP);
+	set_conf(rig, "error_rate", "0");
+	rig_get_freq(rig, RIG_VFO_CURR, &freq);
+	if (ret != -RIG_EPROTO || freq != MHz(14.074)) {
+		fprintf(stderr, "UP op: %s, %.0f Hz\n", rigerror(ret), freq);
+		errors++;
+	}
+	ret = rig_vfo_op(rig, RIG_VFO_CURR, RIG_OP_UP);
+	rig_get_freq(rig, RIG_VFO_CURR, &freq);
+	if (ret != RIG_OK || freq != MHz(14.075)) {
+		fprintf(stderr, "UP op: %s, %.0f Hz\n", rigerror(ret), freq);
+		errors++;
+	}
+
+	printf("timeouts\n");
+	set_conf(rig, "timeout_rate", "1");
+	ret = rig_set_freq(rig, RIG_VFO_CURR, MHz(14.074));
+	printf("  %s\n", rigerror(ret));
+	if (ret != -RIG_ETIMEOUT) {
+		fprintf(stderr, "timeout not injected: %s\n", rigerror(ret));
+		errors++;
+	}
+	set_conf(rig, "timeout_rate", "0");
+
+	printf("events\n");
+	rig_set_freq(rig, RIG_VFO_CURR, MHz(14.074));
+	set_conf(rig, "event_rate", "100");
+	usleep(100*1000);
+	rig_get_freq(rig, RIG_VFO_CURR, &freq);
+	set_conf(rig, "event_rate", "0");
+	rig_get_freq(rig, RIG_VFO_CURR, &freq2);
+	printf("  tuned to %.0f Hz\n", freq);
+	if (freq <= MHz(14.074) || freq2 != freq) {
+		fprintf(stderr, "rig not tuned by the events, %.0f Hz then %.0f Hz\n",
+				freq, freq2);
+		errors++;
+	}
+
+	printf("transceive events\n");
+	rig_set_freq_callback(rig, freq_event, NULL);
+	ret = rig_set_trn(rig, RIG_TRN_RIG);
+	set_conf(rig, "event_rate", "50");
+	usleep(200*1000);
+	set_conf(rig, "event_rate", "0");
+	i = freq_events;
+	printf("  %d event(s), tuned to %.0f Hz\n", i, event_freq);
+	/* 10 steps, with room for a loaded host */
+	if (ret != RIG_OK || i < 5 || i > 11 || event_freq <= freq ||
+			event_freq != rig->state.current_freq) {
+		fprintf(stderr, "transceive: %s, %d event(s), %.0f Hz\n",
+				rigerror(ret), i, event_freq);
+		errors++;
+	}
+	rig_get_freq(rig, RIG_VFO_CURR, &freq);
+	if (freq != event_freq) {
+		fprintf(stderr, "event at %.0f Hz, rig on %.0f Hz\n", event_freq, freq);
+		errors++;
+	}
+	ret = rig_set_trn(rig, RIG_TRN_OFF);
+	set_conf(rig, "event_rate", "50");
+	usleep(100*1000);
+	set_conf(rig, "event_rate", "0");
+	if (ret != RIG_OK || freq_events != i) {
+		fprintf(stderr, "events after transceive off: %d\n", freq_events - i);
+		errors++;
+	}
+
+	rig_close(rig);
+	rig_cleanup(rig);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,279 @@
+/*
+ * Test program of the Kenwood Auto-Information mode: a fake TS-2000 on
+ * a pseudo terminal sends AI frames along with its replies, which the
+ * transactions skip without retrying, then on its own, the frames
+ * firing the callbacks in both cases, last through SIGIO and the event
+ * thread of the frontend. The answers to a batch of commands are
+ * matched to them whatever their order, the one missing read again.
+ */
+
+#define _GNU_SOURCE	/* posix_openpt, cfmakeraw */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <hamlib/rig.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+
+/* VFO A, 14.074 MHz, RX, USB */
+#define IF_RX "IF00014074000     +000000000020000000;"
+/* VFO B, 14.250 MHz, TX, USB */
+#define IF_TX "IF00014250000     +000000000121000000;"
+
+static int master;
+static volatile int stop;
+static int errors;
+
+struct events {
+	int freqs, modes, vfos, ptts;
+	vfo_t freq_vfo, vfo;
+	freq_t freq;
+	rmode_t mode;
+	ptt_t ptt;
+};
+
+static const char *fake_reply(const char *cmd)
+{
+	if (!strcmp(cmd, "ID;"))
+		return "ID019;";
+	if (!strcmp(cmd, "IF;"))
+		return IF_RX;
+	/* VFO B and mode changed on the rig, just before the reply */
+	if (!strcmp(cmd, "FA;"))
+		return "FB00007040000;MD3;FA00014074000;";
+	/* reordered, NR not answered in the batch */
+	if (!strcmp(cmd, "NB;PR;NR;"))
+		return "PR1;FA00007050000;NB0;";
+	if (!strcmp(cmd, "NR;"))
+		return "NR1;";
+	if (!strcmp(cmd, "AI1;") || !strcmp(cmd, "AI0;"))
+		return cmd;
+	return "?;";
+}
+
+static void *fake_rig_thread(void *arg)
+{
+	char buf[64];
+	const char *reply;
+	int len = 0, ret;
+
+	while (!stop) {
+		ret = read(master, buf + len, sizeof(buf) - 1 - len);
+		if (ret <= 0) {
+			usleep(1000);
+			continue;
+		}
+		len += ret;
+		buf[len] = '\0';
+		if (buf[len - 1] == ';') {
+			reply = fake_reply(buf);
+			ret = write(master, reply, strlen(reply));
+			len = 0;
+		}
+		if (len >= sizeof(buf) - 1)
+			len = 0;
+	}
+	return NULL;
+}
+
+static int freq_cb(RIG *rig, vfo_t vfo, freq_t freq, rig_ptr_t arg)
+{
+	struct events *ev = (struct events *)arg;
+
+	ev->freqs++;
+	ev->freq_vfo = vfo;
+	ev->freq = freq;
+	return RIG_OK;
+}
+
+static int mode_cb(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width, rig_ptr_t arg)
+{
+	struct events *ev = (struct events *)arg;
+
+	ev->modes++;
+	ev->mode = mode;
+	return RIG_OK;
+}
+
+static int vfo_cb(RIG *rig, vfo_t vfo, rig_ptr_t arg)
+{
+	struct events *ev = (struct events *)arg;
+
+	ev->vfos++;
+	ev->vfo = vfo;
+	return RIG_OK;
+}
+
+static int ptt_cb(RIG *rig, vfo_t vfo, ptt_t ptt, rig_ptr_t arg)
+{
+	struct events *ev = (struct events *)arg;
+
+	ev->ptts++;
+	ev->ptt = ptt;
+	return RIG_OK;
+}
+
+int main(int argc, char *argv[])
+{
+	struct events ev;
+	port_stats_t stats;
+	struct termios t;
+	pthread_t thread;
+	unsigned long retries;
+	setting_t status;
+	freq_t freq;
+	RIG *rig;
+	int slave, ret, i;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) || unlockpt(master)) {
+		printf("no pseudo terminal available, skipping\n");
+		return 0;
+	}
+	slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+	if (slave < 0) {
+		printf("no pseudo terminal available, skipping\n");
+		return 0;
+	}
+	tcgetattr(slave, &t);
+	cfmakeraw(&t);
+	tcsetattr(slave, TCSANOW, &t);
+	fcntl(master, F_SETFL, O_NONBLOCK);
+
+	if (pthread_create(&thread, NULL, fake_rig_thread, NULL) != 0)
+		return 1;
+
+	rig = rig_init(RIG_MODEL_TS2000);
+	if (!rig) {
+		fprintf(stderr, "no TS-2000 backend\n");
+		return 1;
+	}
+	strncpy(rig->state.rigport.pathname, ptsname(master), FILPATHLEN - 1);
+	rig->state.rigport.post_write_delay = 0;
+	ret = rig_open(rig);
+	if (ret != RIG_OK) {
+		fprintf(stderr, "rig_open: %s\n", rigerror(ret));
+		return 1;
+	}
+
+	memset(&ev, 0, sizeof(ev));
+	rig_set_freq_callback(rig, freq_cb, &ev);
+	rig_set_mode_callback(rig, mode_cb, &ev);
+	rig_set_vfo_callback(rig, vfo_cb, &ev);
+	rig_set_ptt_callback(rig, ptt_cb, &ev);
+
+	/* AI on, decoded by hand instead of by the SIGIO handler */
+	rig->state.transceive = RIG_TRN_RIG;
+
+	printf("AI frames along with a reply\n");
+	rig_get_port_stats(rig, &stats);
+	retries = stats.retries;
+	ret = rig_get_freq(rig, RIG_VFO_A, &freq);
+	rig_get_port_stats(rig, &stats);
+	printf("  %.0f Hz, %lu retries, B at %.0f Hz, mode %s\n", freq,
+			stats.retries - retries, ev.freq, rig_strrmode(ev.mode));
+	if (ret != RIG_OK || freq != 14074000) {
+		fprintf(stderr, "get_freq: %s, %.0f Hz\n", rigerror(ret), freq);
+		errors++;
+	}
+	if (stats.retries != retries) {
+		fprintf(stderr, "AI frames retried\n");
+		errors++;
+	}
+	if (ev.freqs != 1 || ev.freq_vfo != RIG_VFO_B || ev.freq != 7040000 ||
+			ev.modes != 1 || ev.mode != RIG_MODE_CW ||
+			rig->state.current_mode != RIG_MODE_CW) {
+		fprintf(stderr, "AI frames not decoded\n");
+		errors++;
+	}
+
+	printf("AI frames on their own\n");
+	memset(&ev, 0, sizeof(ev));
+	ret = write(master, IF_TX "FR1;", strlen(IF_TX "FR1;"));
+	ret = rig->caps->decode_event(rig);
+	printf("  %s %.0f Hz, mode %s, PTT %d\n", rig_strvfo(ev.vfo), ev.freq,
+			rig_strrmode(ev.mode), ev.ptt);
+	if (ret != RIG_OK) {
+		fprintf(stderr, "decode_event: %s\n", rigerror(ret));
+		errors++;
+	}
+	if (ev.vfos != 2 || ev.vfo != RIG_VFO_B || ev.freqs != 1 ||
+			ev.freq != 14250000 || ev.modes != 1 ||
+			ev.mode != RIG_MODE_USB || ev.ptts != 1 ||
+			ev.ptt != RIG_PTT_ON || rig->state.current_vfo != RIG_VFO_B) {
+		fprintf(stderr, "AI frames not decoded, %d VFO %d freq %d mode "
+				"%d PTT event(s)\n", ev.vfos, ev.freqs, ev.modes,
+				ev.ptts);
+		errors++;
+	}
+
+	printf("AI frames along with a batch\n");
+	memset(&ev, 0, sizeof(ev));
+	status = 0;
+	ret = rig_get_funcs(rig, RIG_VFO_CURR,
+			RIG_FUNC_NB | RIG_FUNC_COMP | RIG_FUNC_NR, &status);
+	printf("  NB %d COMP %d NR %d, A at %.0f Hz\n",
+			(status & RIG_FUNC_NB) ? 1 : 0,
+			(status & RIG_FUNC_COMP) ? 1 : 0,
+			(status & RIG_FUNC_NR) ? 1 : 0, ev.freq);
+	if (ret != RIG_OK || status != (RIG_FUNC_COMP | RIG_FUNC_NR)) {
+		fprintf(stderr, "get_funcs: %s, status 0x%llx\n", rigerror(ret),
+				(unsigned long long)status);
+		errors++;
+	}
+	if (ev.freqs != 1 || ev.freq != 7050000) {
+		fprintf(stderr, "AI frame of the batch not decoded\n");
+		errors++;
+	}
+
+	rig->state.transceive = RIG_TRN_OFF;
+
+	printf("AI frames through SIGIO\n");
+	ret = rig_set_trn(rig, RIG_TRN_RIG);
+	if (ret != RIG_OK) {
+		fprintf(stderr, "set_trn: %s\n", rigerror(ret));
+		errors++;
+	}
+	memset(&ev, 0, sizeof(ev));
+	ret = write(master, "FA00007074000;", 14);
+	for (i = 0; i < 100 && ev.freqs == 0; i++)
+		usleep(10*1000);
+	printf("  %s %.0f Hz after %d ms\n", rig_strvfo(ev.freq_vfo), ev.freq,
+			i*10);
+	if (ev.freqs != 1 || ev.freq_vfo != RIG_VFO_A || ev.freq != 7074000) {
+		fprintf(stderr, "AI frame not decoded by the event thread\n");
+		errors++;
+	}
+	rig_set_trn(rig, RIG_TRN_OFF);
+
+	rig_close(rig);
+	rig_cleanup(rig);
+	stop = 1;
+	pthread_join(thread, NULL);
+	close(slave);
+	close(master);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
+
+#else	/* !HAVE_PTHREAD */
+
+int main(int argc, char *argv[])
+{
+	printf("no pthread support, nothing to test\n");
+	return 0;
+}
+
+#endif	/* !HAVE_PTHREAD */
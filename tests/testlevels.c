@@ -0,0 +1,94 @@
+
+/*
+ * Test program of rig_get_levels() and rig_get_funcs() on the dummy rig,
+ * the values read at once matching the ones read one by one.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <hamlib/rig.h>
+
+static int errors;
+
+int main(int argc, char *argv[])
+{
+	value_t vals[RIG_SETTING_MAX], val;
+	setting_t levels, funcs, status;
+	RIG *rig;
+	int ret;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	rig = rig_init(RIG_MODEL_DUMMY);
+	if (!rig || rig_open(rig) != RIG_OK) {
+		fprintf(stderr, "cannot open the dummy rig\n");
+		return 1;
+	}
+
+	val.f = 0.5;
+	rig_set_level(rig, RIG_VFO_CURR, RIG_LEVEL_RFPOWER, val);
+	val.i = 600;
+	rig_set_level(rig, RIG_VFO_CURR, RIG_LEVEL_CWPITCH, val);
+	rig_set_func(rig, RIG_VFO_CURR, RIG_FUNC_NB, 1);
+	rig_set_func(rig, RIG_VFO_CURR, RIG_FUNC_COMP, 0);
+
+	printf("levels\n");
+	levels = RIG_LEVEL_RFPOWER | RIG_LEVEL_CWPITCH | RIG_LEVEL_STRENGTH;
+	memset(vals, 0, sizeof(vals));
+	ret = rig_get_levels(rig, RIG_VFO_CURR, levels, vals);
+	printf("  RFPOWER %f CWPITCH %d STRENGTH %d\n",
+			vals[rig_setting2idx(RIG_LEVEL_RFPOWER)].f,
+			vals[rig_setting2idx(RIG_LEVEL_CWPITCH)].i,
+			vals[rig_setting2idx(RIG_LEVEL_STRENGTH)].i);
+	if (ret != RIG_OK ||
+			vals[rig_setting2idx(RIG_LEVEL_RFPOWER)].f != 0.5 ||
+			vals[rig_setting2idx(RIG_LEVEL_CWPITCH)].i != 600) {
+		fprintf(stderr, "levels: %s\n", rigerror(ret));
+		errors++;
+	}
+	/* the S-Meter of the dummy rig is noisy, only a range is checked */
+	rig_get_level(rig, RIG_VFO_CURR, RIG_LEVEL_STRENGTH, &val);
+	if (vals[rig_setting2idx(RIG_LEVEL_STRENGTH)].i < -60 ||
+			vals[rig_setting2idx(RIG_LEVEL_STRENGTH)].i > 20) {
+		fprintf(stderr, "levels: STRENGTH %d, %d one by one\n",
+				vals[rig_setting2idx(RIG_LEVEL_STRENGTH)].i, val.i);
+		errors++;
+	}
+
+	/* SQLSTAT is not readable on the dummy rig */
+	ret = rig_get_levels(rig, RIG_VFO_CURR, levels | RIG_LEVEL_SQLSTAT, vals);
+	if (ret != -RIG_ENAVAIL) {
+		fprintf(stderr, "unavailable level: %s\n", rigerror(ret));
+		errors++;
+	}
+
+	printf("funcs\n");
+	funcs = RIG_FUNC_NB | RIG_FUNC_COMP;
+	status = RIG_FUNC_COMP;
+	ret = rig_get_funcs(rig, RIG_VFO_CURR, funcs, &status);
+	printf("  NB %d COMP %d\n", (status & RIG_FUNC_NB) ? 1 : 0,
+			(status & RIG_FUNC_COMP) ? 1 : 0);
+	if (ret != RIG_OK || status != RIG_FUNC_NB) {
+		fprintf(stderr, "funcs: %s, status 0x%llx\n", rigerror(ret),
+				(unsigned long long)status);
+		errors++;
+	}
+
+	/* TUNER is not readable on the dummy rig */
+	ret = rig_get_funcs(rig, RIG_VFO_CURR, funcs | RIG_FUNC_TUNER, &status);
+	if (ret != -RIG_ENAVAIL) {
+		fprintf(stderr, "unavailable func: %s\n", rigerror(ret));
+		errors++;
+	}
+
+	rig_close(rig);
+	rig_cleanup(rig);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,133 @@
+
+/*
+ * Test program of the multicast follower of the NET rigctl backend, fed
+ * with datagrams as rigctld --mcast-addr sends them: the reordered ones
+ * are dropped, and a state no longer refreshed times out.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <hamlib/rig.h>
+#include <hamlib/rigshm.h>
+
+#define GROUP "239.255.45.99"
+#define PORT 45999
+
+static int errors;
+static int sock;
+static struct sockaddr_in group;
+
+static int send_state(unsigned long serial, freq_t freq)
+{
+	struct rig_shm_snapshot snap;
+	char buf[RIG_SHM_DGRAM_MAX];
+	int len;
+
+	memset(&snap, 0, sizeof(snap));
+	snap.rig_model = RIG_MODEL_DUMMY;
+	snap.vfo = RIG_VFO_A;
+	snap.freq = freq;
+	snap.mode = RIG_MODE_USB;
+	snap.serial = serial;
+	len = rig_shm_encode(buf, sizeof(buf), &snap, 0);
+	if (len <= 0)
+		return -1;
+	if (sendto(sock, buf, len, 0, (struct sockaddr *)&group,
+				sizeof(group)) != len)
+		return -1;
+	/* on its way through the loopback */
+	usleep(20*1000);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	freq_t freq;
+	RIG *rig;
+	int ret;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	sock = socket(AF_INET, SOCK_DGRAM, 0);
+	memset(&group, 0, sizeof(group));
+	group.sin_family = AF_INET;
+	group.sin_port = htons(PORT);
+	group.sin_addr.s_addr = inet_addr(GROUP);
+
+	rig = rig_init(RIG_MODEL_NETRIGCTL);
+	if (!rig) {
+		fprintf(stderr, "no NET rigctl backend\n");
+		return 1;
+	}
+	rig_set_conf(rig, rig_token_lookup(rig, "multicast"), "1");
+	snprintf(rig->state.rigport.pathname, FILPATHLEN, "%s:%d", GROUP, PORT);
+	rig->state.rigport.timeout = 200;
+	if (sock < 0 || rig_open(rig) != RIG_OK ||
+			send_state(5, MHz(14.074)) != 0) {
+		printf("no multicast available, skipping\n");
+		return 0;
+	}
+
+	ret = rig_get_freq(rig, RIG_VFO_CURR, &freq);
+	if (ret == -RIG_ETIMEOUT) {
+		printf("multicast not looped back, skipping\n");
+		return 0;
+	}
+
+	printf("state\n");
+	printf("  %.0f Hz\n", freq);
+	if (ret != RIG_OK || freq != MHz(14.074)) {
+		fprintf(stderr, "state: %s, %.0f Hz\n", rigerror(ret), freq);
+		errors++;
+	}
+
+	printf("reordered datagram\n");
+	send_state(4, MHz(7.040));
+	ret = rig_get_freq(rig, RIG_VFO_CURR, &freq);
+	printf("  %.0f Hz\n", freq);
+	if (ret != RIG_OK || freq != MHz(14.074)) {
+		fprintf(stderr, "state rolled back: %s, %.0f Hz\n", rigerror(ret),
+				freq);
+		errors++;
+	}
+	send_state(6, MHz(7.040));
+	ret = rig_get_freq(rig, RIG_VFO_CURR, &freq);
+	if (ret != RIG_OK || freq != MHz(7.040)) {
+		fprintf(stderr, "newer state: %s, %.0f Hz\n", rigerror(ret), freq);
+		errors++;
+	}
+
+	printf("stale state\n");
+	sleep(3);
+	ret = rig_get_freq(rig, RIG_VFO_CURR, &freq);
+	printf("  %s\n", rigerror(ret));
+	if (ret != -RIG_ETIMEOUT) {
+		fprintf(stderr, "stale state answered: %s\n", rigerror(ret));
+		errors++;
+	}
+	/* rigctld restarted, counting from 1 again */
+	send_state(1, MHz(3.573));
+	ret = rig_get_freq(rig, RIG_VFO_CURR, &freq);
+	if (ret != RIG_OK || freq != MHz(3.573)) {
+		fprintf(stderr, "restarted state: %s, %.0f Hz\n", rigerror(ret),
+				freq);
+		errors++;
+	}
+
+	rig_close(rig);
+	rig_cleanup(rig);
+	close(sock);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
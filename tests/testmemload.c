@@ -0,0 +1,155 @@
+
+/*
+ * Test program of the incremental memory load of rigmem, on the dummy
+ * rig: a CSV backup loaded back writes only the channels changed since,
+ * the memory image being read from the rig or from the backup itself.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <hamlib/rig.h>
+#include "memdiff.h"
+
+#define CSV_FILE "testmemload.csv"
+#define CHAN_FREQ(n) (MHz(144) + (n) * kHz(25))
+
+int all;	/* used by memcsv.c */
+
+extern int csv_save (RIG *rig, const char *outfilename);
+extern int csv_load (RIG *rig, const char *infilename, struct mem_image *img);
+extern int csv_load_image (RIG *rig, const char *infilename, struct mem_image *img);
+
+static int errors;
+
+static int set_chan_freq(RIG *rig, int n, freq_t freq)
+{
+	channel_t chan;
+	int ret;
+
+	memset(&chan, 0, sizeof(chan));
+	chan.vfo = RIG_VFO_MEM;
+	chan.channel_num = n;
+	ret = rig_get_channel(rig, &chan);
+	if (ret == RIG_OK) {
+		chan.freq = freq;
+		ret = rig_set_channel(rig, &chan);
+	}
+	free(chan.ext_levels);
+
+	return ret;
+}
+
+static freq_t get_chan_freq(RIG *rig, int n)
+{
+	channel_t chan;
+
+	memset(&chan, 0, sizeof(chan));
+	chan.vfo = RIG_VFO_MEM;
+	chan.channel_num = n;
+	if (rig_get_channel(rig, &chan) != RIG_OK)
+		return RIG_FREQ_NONE;
+	free(chan.ext_levels);
+
+	return chan.freq;
+}
+
+static void check_load(const char *name, int ret, const struct mem_image *img,
+		int writes, int skips)
+{
+	printf("%s: %d written, %d unchanged\n", name, img->writes, img->skips);
+	if (ret != RIG_OK) {
+		fprintf(stderr, "%s: %s\n", name, rigerror(ret));
+		errors++;
+	} else if (img->writes != writes || img->skips != skips) {
+		fprintf(stderr, "%s: %d written, %d unchanged, expected %d and %d\n",
+				name, img->writes, img->skips, writes, skips);
+		errors++;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	struct mem_image img;
+	RIG *rig;
+	int i, count, ret;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	rig = rig_init(RIG_MODEL_DUMMY);
+	if (!rig || rig_open(rig) != RIG_OK) {
+		fprintf(stderr, "cannot open the dummy rig\n");
+		return 1;
+	}
+	rig_set_vfo(rig, RIG_VFO_MEM);
+	count = rig_mem_count(rig);
+
+	for (i = 0; i < 19; i++)
+		set_chan_freq(rig, i, CHAN_FREQ(i));
+
+	if (csv_save(rig, CSV_FILE) != RIG_OK) {
+		fprintf(stderr, "cannot save to " CSV_FILE "\n");
+		return 1;
+	}
+
+	/* nothing changed */
+	mem_image_init(rig, &img);
+	ret = mem_image_read(rig, &img);
+	if (ret != RIG_OK || img.reads != count) {
+		fprintf(stderr, "image read: %d channel(s), %s\n", img.reads,
+				rigerror(ret));
+		errors++;
+	}
+	ret = csv_load(rig, CSV_FILE, &img);
+	check_load("unchanged", ret, &img, 0, count);
+	mem_image_free(&img);
+
+	/* one channel changed on the rig */
+	set_chan_freq(rig, 5, MHz(430));
+	mem_image_init(rig, &img);
+	mem_image_read(rig, &img);
+	ret = csv_load(rig, CSV_FILE, &img);
+	check_load("one change", ret, &img, 1, count - 1);
+	if (get_chan_freq(rig, 5) != CHAN_FREQ(5)) {
+		fprintf(stderr, "channel 5 not restored: %.0f Hz\n",
+				get_chan_freq(rig, 5));
+		errors++;
+	}
+
+	/* the image follows the writes */
+	img.writes = img.skips = 0;
+	ret = csv_load(rig, CSV_FILE, &img);
+	check_load("reloaded", ret, &img, 0, count);
+	mem_image_free(&img);
+
+	/* image from the backup, nothing read from the rig */
+	mem_image_init(rig, &img);
+	ret = csv_load_image(rig, CSV_FILE, &img);
+	if (ret != RIG_OK || img.reads != count) {
+		fprintf(stderr, "image load: %d channel(s), %s\n", img.reads,
+				rigerror(ret));
+		errors++;
+	}
+	ret = csv_load(rig, CSV_FILE, &img);
+	check_load("image file", ret, &img, 0, count);
+	mem_image_free(&img);
+
+	/* frequency in the mem_caps of channel 1 */
+	if (chan_differs(rig, &(channel_t){ .channel_num = 1, .freq = MHz(145) },
+				&(channel_t){ .channel_num = 1, .freq = MHz(145) }) ||
+			!chan_differs(rig, &(channel_t){ .channel_num = 1, .freq = MHz(145) },
+				&(channel_t){ .channel_num = 1, .freq = MHz(146) })) {
+		fprintf(stderr, "chan_differs failed\n");
+		errors++;
+	}
+
+	rig_close(rig);
+	rig_cleanup(rig);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
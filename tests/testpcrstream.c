@@ -0,0 +1,210 @@
+
+/*
+ * Test program of the auto update mode of the PCR receivers: a fake
+ * PCR-100 on a pseudo terminal streams its status, which decode_event
+ * keeps in memory for the getters, firing the DCD callback, and the
+ * status frames still on their way when the stream is turned off are
+ * decoded before the reply.
+ */
+
+#define _GNU_SOURCE	/* posix_openpt, cfmakeraw */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <hamlib/rig.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+
+/* S-Meter at 0xa0, squelch opening then closing, DTMF 5 */
+#define STREAM "I1A0\r\nI007\r\nI305\r\nI004\r\n"
+
+static int master;
+static volatile int stop;
+static int errors;
+
+struct events {
+	int dcds;
+	dcd_t dcd;
+};
+
+static const char *fake_reply(const char *cmd)
+{
+	if (!strcmp(cmd, "H1?\n") || !strcmp(cmd, "H101\n"))
+		return "H101\r\n";
+	if (!strcmp(cmd, "G2?\n"))
+		return "G210\r\n";
+	if (!strcmp(cmd, "G4?\n"))
+		return "G412\r\n";
+	if (!strcmp(cmd, "GD?\n"))
+		return "GD00\r\n";
+	if (!strcmp(cmd, "GE?\n"))
+		return "GE08\r\n";
+	/* the stream is still running when turned off */
+	if (!strcmp(cmd, "G300\n"))
+		return "I150\r\nI004\r\nG000\r\n";
+	/* no ack in auto update mode */
+	if (!strcmp(cmd, "G301\n") || !strcmp(cmd, "H100\n"))
+		return "";
+	return "G000\r\n";
+}
+
+static void *fake_rig_thread(void *arg)
+{
+	char buf[64];
+	const char *reply;
+	int len = 0, ret;
+
+	while (!stop) {
+		ret = read(master, buf + len, sizeof(buf) - 1 - len);
+		if (ret <= 0) {
+			usleep(1000);
+			continue;
+		}
+		len += ret;
+		buf[len] = '\0';
+		if (buf[len - 1] == '\n') {
+			reply = fake_reply(buf);
+			ret = write(master, reply, strlen(reply));
+			len = 0;
+		}
+		if (len >= sizeof(buf) - 1)
+			len = 0;
+	}
+	return NULL;
+}
+
+static int dcd_cb(RIG *rig, vfo_t vfo, dcd_t dcd, rig_ptr_t arg)
+{
+	struct events *ev = (struct events *)arg;
+
+	ev->dcds++;
+	ev->dcd = dcd;
+	return RIG_OK;
+}
+
+int main(int argc, char *argv[])
+{
+	struct events ev;
+	struct termios t;
+	pthread_t thread;
+	char digits[8];
+	int slave, ret, len;
+	value_t val;
+	dcd_t dcd;
+	RIG *rig;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) || unlockpt(master)) {
+		printf("no pseudo terminal available, skipping\n");
+		return 0;
+	}
+	slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+	if (slave < 0) {
+		printf("no pseudo terminal available, skipping\n");
+		return 0;
+	}
+	tcgetattr(slave, &t);
+	cfmakeraw(&t);
+	tcsetattr(slave, TCSANOW, &t);
+	fcntl(master, F_SETFL, O_NONBLOCK);
+
+	if (pthread_create(&thread, NULL, fake_rig_thread, NULL) != 0)
+		return 1;
+
+	rig = rig_init(RIG_MODEL_PCR100);
+	if (!rig) {
+		fprintf(stderr, "no PCR-100 backend\n");
+		return 1;
+	}
+	strncpy(rig->state.rigport.pathname, ptsname(master), FILPATHLEN - 1);
+	rig->state.rigport.parm.serial.rate = 9600;
+	ret = rig_open(rig);
+	if (ret != RIG_OK) {
+		fprintf(stderr, "rig_open: %s\n", rigerror(ret));
+		return 1;
+	}
+
+	memset(&ev, 0, sizeof(ev));
+	rig_set_dcd_callback(rig, dcd_cb, &ev);
+
+	/* auto update on, decoded by hand instead of by the SIGIO handler */
+	ret = rig->caps->set_trn(rig, RIG_TRN_RIG);
+	if (ret != RIG_OK) {
+		fprintf(stderr, "set_trn: %s\n", rigerror(ret));
+		errors++;
+	}
+	usleep(100*1000);
+
+	printf("status stream\n");
+	ret = write(master, STREAM, strlen(STREAM));
+	ret = rig->caps->decode_event(rig);
+	rig_get_level(rig, RIG_VFO_CURR, RIG_LEVEL_RAWSTR, &val);
+	rig_get_dcd(rig, RIG_VFO_CURR, &dcd);
+	/* filled up, so that the backend has to terminate the digits */
+	memset(digits, 'X', sizeof(digits) - 1);
+	digits[sizeof(digits) - 1] = '\0';
+	len = sizeof(digits) - 1;
+	rig_recv_dtmf(rig, RIG_VFO_CURR, digits, &len);
+	printf("  RAWSTR %d, DCD %d, %d DCD event(s), DTMF \"%s\"\n", val.i,
+			dcd, ev.dcds, digits);
+	if (ret != RIG_OK) {
+		fprintf(stderr, "decode_event: %s\n", rigerror(ret));
+		errors++;
+	}
+	if (val.i != 0xa0 || dcd != RIG_DCD_OFF || strcmp(digits, "5")) {
+		fprintf(stderr, "stream not decoded\n");
+		errors++;
+	}
+	if (ev.dcds != 2 || ev.dcd != RIG_DCD_OFF) {
+		fprintf(stderr, "DCD events not fired\n");
+		errors++;
+	}
+
+	/* the DTMF tones are read once */
+	len = sizeof(digits);
+	rig_recv_dtmf(rig, RIG_VFO_CURR, digits, &len);
+	if (len != 0 || digits[0] != '\0') {
+		fprintf(stderr, "DTMF tones read twice\n");
+		errors++;
+	}
+
+	printf("stream turned off\n");
+	ret = rig->caps->set_trn(rig, RIG_TRN_OFF);
+	rig_get_level(rig, RIG_VFO_CURR, RIG_LEVEL_RAWSTR, &val);
+	printf("  %s, RAWSTR %d\n", rigerror(ret), val.i);
+	if (ret != RIG_OK || val.i != 0x50) {
+		fprintf(stderr, "set_trn: %s, RAWSTR %d\n", rigerror(ret), val.i);
+		errors++;
+	}
+
+	rig_close(rig);
+	rig_cleanup(rig);
+	stop = 1;
+	pthread_join(thread, NULL);
+	close(slave);
+	close(master);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
+
+#else	/* !HAVE_PTHREAD */
+
+int main(int argc, char *argv[])
+{
+	printf("no pthread support, nothing to test\n");
+	return 0;
+}
+
+#endif	/* !HAVE_PTHREAD */
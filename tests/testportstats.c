@@ -0,0 +1,200 @@
+
+/*
+ * Test program of the port statistics and of the adaptive timeout:
+ * a fake rig on a pseudo terminal answers commands after a delay,
+ * which the latency histograms show, data it sends on its own stays
+ * out of them, and lost answers time out early, backing off until
+ * an answer comes back.
+ */
+
+#define _GNU_SOURCE	/* posix_openpt, cfmakeraw */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <sys/time.h>
+#include <hamlib/rig.h>
+#include "iofunc.h"
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+
+#define REPLY_DELAY_MS 20
+/* the bucket of REPLY_DELAY_MS, [16,32) mS */
+#define REPLY_BUCKET 5
+#define SAMPLES 16
+
+static int master;
+static volatile int stop;
+static int errors;
+
+/* "FA;" is answered after REPLY_DELAY_MS, "LOST;" never */
+static void *fake_rig_thread(void *arg)
+{
+	char buf[64];
+	int len = 0, ret;
+
+	while (!stop) {
+		ret = read(master, buf + len, sizeof(buf) - 1 - len);
+		if (ret <= 0) {
+			usleep(1000);
+			continue;
+		}
+		len += ret;
+		buf[len] = '\0';
+		if (!strcmp(buf, "FA;")) {
+			usleep(REPLY_DELAY_MS*1000);
+			ret = write(master, "FA00014074000;", 14);
+		}
+		if (buf[len - 1] == ';' || len >= sizeof(buf) - 1)
+			len = 0;
+	}
+	return NULL;
+}
+
+static unsigned long hist_count(const unsigned long *hist, int from, int to)
+{
+	unsigned long n = 0;
+	int i;
+
+	for (i = from; i <= to; i++)
+		n += hist[i];
+	return n;
+}
+
+/* returns the elapsed time in mS, or -1 on error */
+static long command(hamlib_port_t *p, const char *cmd, int *ret)
+{
+	struct timeval t1, t2;
+	char buf[64];
+
+	if (write_block(p, cmd, strlen(cmd)) != RIG_OK)
+		return -1;
+	gettimeofday(&t1, NULL);
+	*ret = read_string(p, buf, sizeof(buf), ";", 1);
+	gettimeofday(&t2, NULL);
+	return (t2.tv_sec - t1.tv_sec)*1000 + (t2.tv_usec - t1.tv_usec)/1000;
+}
+
+int main(int argc, char *argv[])
+{
+	hamlib_port_t port;
+	port_stats_t *st = &port.stats;
+	struct termios t;
+	pthread_t thread;
+	char buf[64];
+	long ms, lost;
+	int slave, ret, i;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) || unlockpt(master)) {
+		printf("no pseudo terminal available, skipping\n");
+		return 0;
+	}
+	slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+	if (slave < 0) {
+		printf("no pseudo terminal available, skipping\n");
+		return 0;
+	}
+	tcgetattr(slave, &t);
+	cfmakeraw(&t);
+	tcsetattr(slave, TCSANOW, &t);
+	fcntl(master, F_SETFL, O_NONBLOCK);
+
+	if (pthread_create(&thread, NULL, fake_rig_thread, NULL) != 0)
+		return 1;
+
+	memset(&port, 0, sizeof(port));
+	port.type.rig = RIG_PORT_SERIAL;
+	port.parm.serial.rate = 9600;
+	port.parm.serial.data_bits = 8;
+	port.parm.serial.stop_bits = 1;
+	port.timeout = 1000;
+	port.timeout_adaptive = 1;
+	strncpy(port.pathname, ptsname(master), FILPATHLEN - 1);
+	ret = port_open(&port);
+	if (ret != RIG_OK) {
+		fprintf(stderr, "port_open: %s\n", rigerror(ret));
+		return 1;
+	}
+
+	printf("histograms\n");
+	for (i = 0; i < SAMPLES; i++) {
+		if (command(&port, "FA;", &ret) < 0 || ret != 14) {
+			fprintf(stderr, "FA; not answered: %d\n", ret);
+			errors++;
+			break;
+		}
+	}
+	printf("  %lu transactions, %lu in [16,32) mS, %lu later\n",
+			st->transactions,
+			hist_count(st->complete, REPLY_BUCKET, REPLY_BUCKET),
+			hist_count(st->complete, REPLY_BUCKET + 1,
+				RIG_PORT_STATS_HIST - 1));
+	/* never earlier than the delay, maybe later on a loaded host */
+	if (st->transactions != SAMPLES ||
+			hist_count(st->complete, 0, RIG_PORT_STATS_HIST - 1) != SAMPLES ||
+			hist_count(st->complete, 0, REPLY_BUCKET - 1) != 0 ||
+			hist_count(st->ttfb, 0, REPLY_BUCKET - 1) != 0) {
+		fprintf(stderr, "wrong histograms\n");
+		errors++;
+	}
+
+	printf("data sent by the rig on its own\n");
+	ret = write(master, "FB00007040000;", 14);
+	ret = read_string(&port, buf, sizeof(buf), ";", 1);
+	if (ret != 14 || st->reads != SAMPLES + 1 ||
+			hist_count(st->complete, 0, RIG_PORT_STATS_HIST - 1) != SAMPLES ||
+			hist_count(st->ttfb, 0, RIG_PORT_STATS_HIST - 1) != SAMPLES) {
+		fprintf(stderr, "unsolicited read in the histograms\n");
+		errors++;
+	}
+
+	printf("lost answers\n");
+	lost = command(&port, "LOST;", &ret);
+	ms = command(&port, "LOST;", &ret);
+	printf("  timed out after %ld then %ld mS, backoff %d\n", lost, ms,
+			port.timeout_backoff);
+	/* twice the upper bound of the bucket, then doubled */
+	if (lost < 0 || lost >= port.timeout / 2 || ms <= lost ||
+			port.timeout_backoff != 2 || st->timeouts != 2) {
+		fprintf(stderr, "no adaptive timeout\n");
+		errors++;
+	}
+
+	printf("answers back\n");
+	if (command(&port, "FA;", &ret) < 0 || ret != 14 ||
+			port.timeout_backoff != 0) {
+		fprintf(stderr, "no recovery: %d, backoff %d\n", ret,
+				port.timeout_backoff);
+		errors++;
+	}
+
+	port_close(&port, port.type.rig);
+	stop = 1;
+	pthread_join(thread, NULL);
+	close(slave);
+	close(master);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
+
+#else	/* !HAVE_PTHREAD */
+
+int main(int argc, char *argv[])
+{
+	printf("no pthread support, nothing to test\n");
+	return 0;
+}
+
+#endif	/* !HAVE_PTHREAD */
@@ -0,0 +1,178 @@
+
+/*
+ * Test program of rig_probe_ports(), with fake Kenwood rigs
+ * answering on pseudo terminals, and a port which does not exist.
+ */
+
+#define _GNU_SOURCE	/* posix_openpt, cfmakeraw */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <termios.h>
+#include <hamlib/rig.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+
+#define NPTYS 2
+
+struct fake_rig {
+	const char *id;		/* reply to "ID;" */
+	rig_model_t model;	/* expected model */
+	int master;
+	int slave;		/* kept open, so that master never gets EIO */
+	char pathname[FILPATHLEN];
+	int found;
+	pthread_t thread;
+};
+
+static struct fake_rig fakes[NPTYS] = {
+	{ "ID019;", RIG_MODEL_TS2000 },
+	{ "ID020;", RIG_MODEL_TS480 },
+};
+
+static volatile int stop;
+static int in_callback;
+static int errors;
+
+static void *fake_rig_thread(void *arg)
+{
+	struct fake_rig *fake = (struct fake_rig *)arg;
+	char buf[64];
+	int len = 0, ret;
+
+	while (!stop) {
+		ret = read(fake->master, buf + len, sizeof(buf) - 1 - len);
+		if (ret <= 0) {
+			usleep(1000);
+			continue;
+		}
+		len += ret;
+		buf[len] = '\0';
+		if (strstr(buf, "ID;")) {
+			ret = write(fake->master, fake->id, strlen(fake->id));
+			len = 0;
+		} else if (len >= sizeof(buf) - 1) {
+			len = 0;
+		}
+	}
+	return NULL;
+}
+
+static int open_fake(struct fake_rig *fake)
+{
+	struct termios t;
+
+	fake->master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (fake->master < 0 || grantpt(fake->master) || unlockpt(fake->master))
+		return -1;
+	strncpy(fake->pathname, ptsname(fake->master), FILPATHLEN - 1);
+
+	fake->slave = open(fake->pathname, O_RDWR | O_NOCTTY);
+	if (fake->slave < 0)
+		return -1;
+	tcgetattr(fake->slave, &t);
+	cfmakeraw(&t);
+	tcsetattr(fake->slave, TCSANOW, &t);
+
+	fcntl(fake->master, F_SETFL, O_NONBLOCK);
+
+	return pthread_create(&fake->thread, NULL, fake_rig_thread, fake);
+}
+
+static int probe_cb(const hamlib_port_t *port, rig_model_t model, rig_ptr_t data)
+{
+	int i;
+
+	if (in_callback++) {
+		fprintf(stderr, "callback called concurrently\n");
+		errors++;
+	}
+
+	printf("%s: model %d\n", port->pathname, model);
+
+	for (i = 0; i < NPTYS; i++) {
+		if (!strcmp(port->pathname, fakes[i].pathname)) {
+			if (model != fakes[i].model) {
+				fprintf(stderr, "%s: expected model %d\n",
+						port->pathname, fakes[i].model);
+				errors++;
+			}
+			fakes[i].found++;
+		}
+	}
+	(*(int *)data)++;
+
+	in_callback--;
+	return RIG_OK;
+}
+
+int main(int argc, char *argv[])
+{
+	hamlib_port_t ports[NPTYS + 1];
+	int i, ret, calls = 0;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+	rig_load_all_backends();
+
+	memset(ports, 0, sizeof(ports));
+	for (i = 0; i < NPTYS; i++) {
+		if (open_fake(&fakes[i]) != 0) {
+			printf("no pseudo terminal available, skipping\n");
+			return 0;
+		}
+		ports[i].type.rig = RIG_PORT_SERIAL;
+		ports[i].parm.serial.data_bits = 8;
+		strncpy(ports[i].pathname, fakes[i].pathname, FILPATHLEN - 1);
+	}
+	/* nobody there */
+	ports[NPTYS].type.rig = RIG_PORT_SERIAL;
+	ports[NPTYS].parm.serial.data_bits = 8;
+	strncpy(ports[NPTYS].pathname, "/dev/nonexistent-hamlib-port", FILPATHLEN - 1);
+
+	ret = rig_probe_ports(ports, NPTYS + 1, probe_cb, (rig_ptr_t)&calls);
+
+	stop = 1;
+	for (i = 0; i < NPTYS; i++) {
+		pthread_join(fakes[i].thread, NULL);
+		if (fakes[i].found != 1) {
+			fprintf(stderr, "%s: found %d times\n", fakes[i].pathname,
+					fakes[i].found);
+			errors++;
+		}
+		close(fakes[i].slave);
+		close(fakes[i].master);
+	}
+
+	if (ret != NPTYS || calls != NPTYS) {
+		fprintf(stderr, "rig_probe_ports returned %d, %d callback calls, "
+				"expected %d\n", ret, calls, NPTYS);
+		errors++;
+	}
+
+	if (rig_probe_ports(NULL, 1, probe_cb, NULL) != -RIG_EINVAL) {
+		fprintf(stderr, "NULL ports accepted\n");
+		errors++;
+	}
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
+
+#else	/* !HAVE_PTHREAD */
+
+int main(int argc, char *argv[])
+{
+	printf("no pthread support, nothing to test\n");
+	return 0;
+}
+
+#endif	/* !HAVE_PTHREAD */
@@ -0,0 +1,136 @@
+
+/*
+ * Test program of the lookup index of the rig tables on the dummy rig:
+ * the indexed passband and resolution lookups match the table scans,
+ * and with range_check set, rig_set_freq() and rig_set_mode() reject
+ * what the ranges do not cover, overlapping ranges included.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <hamlib/rig.h>
+
+#define MODES (RIG_MODE_AM|RIG_MODE_SSB|RIG_MODE_FM|RIG_MODE_CW)
+
+static const freq_range_t ranges[] = {
+	{ kHz(150), MHz(30), RIG_MODE_AM|RIG_MODE_SSB, -1, -1, RIG_VFO_A, 0 },
+	{ MHz(50), MHz(54), RIG_MODE_SSB|RIG_MODE_FM, -1, -1, RIG_VFO_A, 0 },
+	{ MHz(28), MHz(60), RIG_MODE_FM, -1, -1, RIG_VFO_A, 0 },
+	{ MHz(144), MHz(148), RIG_MODE_FM, -1, -1, RIG_VFO_A, 0 },
+	{ MHz(146), MHz(146), RIG_MODE_CW, -1, -1, RIG_VFO_A, 0 },
+	RIG_FRNG_END,
+};
+
+static int errors;
+
+int main(int argc, char *argv[])
+{
+	pbwidth_t normal[32], narrow[32], wide[32];
+	shortfreq_t resolution[32];
+	freq_t freqs[5*sizeof(ranges)/sizeof(ranges[0])];
+	rmode_t mode;
+	RIG *rig;
+	int i, n, ret, in_range;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	rig = rig_init(RIG_MODEL_DUMMY);
+	if (!rig) {
+		fprintf(stderr, "no dummy rig\n");
+		return 1;
+	}
+
+	/* table scans, not indexed until open */
+	for (i = 0; i < 32; i++) {
+		mode = (rmode_t)(1UL << i);
+		normal[i] = rig_passband_normal(rig, mode);
+		narrow[i] = rig_passband_narrow(rig, mode);
+		wide[i] = rig_passband_wide(rig, mode);
+		resolution[i] = rig_get_resolution(rig, mode);
+	}
+
+	if (rig_open(rig) != RIG_OK) {
+		fprintf(stderr, "cannot open the dummy rig\n");
+		return 1;
+	}
+
+	printf("passbands\n");
+	printf("  CW %ld %ld %ld Hz\n", (long)rig_passband_narrow(rig, RIG_MODE_CW),
+			(long)rig_passband_normal(rig, RIG_MODE_CW),
+			(long)rig_passband_wide(rig, RIG_MODE_CW));
+	for (i = 0; i < 32; i++) {
+		mode = (rmode_t)(1UL << i);
+		if (rig_passband_normal(rig, mode) != normal[i] ||
+				rig_passband_narrow(rig, mode) != narrow[i] ||
+				rig_passband_wide(rig, mode) != wide[i] ||
+				rig_get_resolution(rig, mode) != resolution[i]) {
+			fprintf(stderr, "mode 0x%lx: indexed lookup differs\n",
+					(unsigned long)mode);
+			errors++;
+		}
+	}
+	/* several modes at once are still scanned */
+	if (rig_passband_normal(rig, RIG_MODE_AM|RIG_MODE_CW) != kHz(2.4)) {
+		fprintf(stderr, "AM|CW passband %ld\n",
+				(long)rig_passband_normal(rig, RIG_MODE_AM|RIG_MODE_CW));
+		errors++;
+	}
+
+	/* overlapping ranges of our own, indexed again */
+	rig_copy_tables(rig);
+	memcpy(rig->state.rx_range_list, ranges, sizeof(ranges));
+	rig_index_tables(rig);
+	rig_set_conf(rig, rig_token_lookup(rig, "range_check"), "1");
+
+	printf("frequencies\n");
+	n = 0;
+	for (i = 0; !RIG_IS_FRNG_END(ranges[i]); i++) {
+		freqs[n++] = ranges[i].start - 1;
+		freqs[n++] = ranges[i].start;
+		freqs[n++] = (ranges[i].start + ranges[i].end) / 2;
+		freqs[n++] = ranges[i].end;
+		freqs[n++] = ranges[i].end + 1;
+	}
+	for (i = 0; i < n; i++) {
+		in_range = rig_get_range(ranges, freqs[i], MODES) != NULL;
+		ret = rig_set_freq(rig, RIG_VFO_CURR, freqs[i]);
+		if (in_range ? ret != RIG_OK : ret != -RIG_EINVAL) {
+			fprintf(stderr, "%.0f Hz: %s\n", freqs[i], rigerror(ret));
+			errors++;
+		}
+	}
+	ret = rig_set_freq(rig, RIG_VFO_CURR, MHz(40));
+	printf("  40 MHz: %s\n", rigerror(ret));
+
+	printf("modes\n");
+	ret = rig_set_mode(rig, RIG_VFO_CURR, RIG_MODE_WFM, RIG_PASSBAND_NORMAL);
+	printf("  WFM: %s\n", rigerror(ret));
+	if (ret != -RIG_EINVAL) {
+		fprintf(stderr, "WFM not rejected\n");
+		errors++;
+	}
+	ret = rig_set_mode(rig, RIG_VFO_CURR, RIG_MODE_USB, RIG_PASSBAND_NORMAL);
+	if (ret != RIG_OK) {
+		fprintf(stderr, "USB: %s\n", rigerror(ret));
+		errors++;
+	}
+
+	/* the rig has the last word without range_check */
+	rig_set_conf(rig, rig_token_lookup(rig, "range_check"), "0");
+	ret = rig_set_freq(rig, RIG_VFO_CURR, MHz(40));
+	if (ret != RIG_OK) {
+		fprintf(stderr, "40 MHz without range_check: %s\n", rigerror(ret));
+		errors++;
+	}
+
+	rig_close(rig);
+	rig_cleanup(rig);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+
+/*
+ * Test program of the coalescing of the positions set on a rotator,
+ * on the dummy rotator: a tracker setting the position at 50 Hz by tiny
+ * steps, the positions sent at most every 200 mS, dropped within 0.2°.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <hamlib/rotator.h>
+
+#define CALLS		50
+#define CALL_MS		20
+#define INTERVAL_MS	200
+#define AZ_STEP		0.05
+
+static int errors;
+
+static long elapsed_ms(const struct timeval *start)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return (tv.tv_sec - start->tv_sec)*1000 + (tv.tv_usec - start->tv_usec)/1000;
+}
+
+static void print_stats(const char *name, const rot_pos_stats_t *stats)
+{
+	printf("%s: %lu set, %lu sent, %lu coalesced, %lu dropped, %lu error(s)\n",
+			name, stats->requests, stats->sent, stats->coalesced,
+			stats->dropped, stats->errors);
+}
+
+int main(int argc, char *argv[])
+{
+	rot_pos_stats_t stats;
+	struct timeval start;
+	azimuth_t az, last_az;
+	elevation_t el;
+	ROT *rot;
+	int i, ret;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	rot = rot_init(ROT_MODEL_DUMMY);
+	if (!rot || rot_open(rot) != RIG_OK) {
+		fprintf(stderr, "cannot open the dummy rotator\n");
+		return 1;
+	}
+	if (rot_get_pos_stats(rot, &stats) != -RIG_ENAVAIL) {
+		fprintf(stderr, "positions coalesced by default\n");
+		errors++;
+	}
+	rot_close(rot);
+
+	rot_set_conf(rot, rot_token_lookup(rot, "pos_interval"), "200");
+	rot_set_conf(rot, rot_token_lookup(rot, "pos_deadband"), "0.2");
+	if (rot_open(rot) != RIG_OK) {
+		fprintf(stderr, "cannot reopen the dummy rotator\n");
+		return 1;
+	}
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < CALLS; i++) {
+		ret = rot_set_position(rot, i * AZ_STEP, 0);
+		if (ret != RIG_OK) {
+			fprintf(stderr, "set_position: %s\n", rigerror(ret));
+			errors++;
+		}
+		usleep(CALL_MS*1000);
+	}
+
+	rot_get_pos_stats(rot, &stats);
+	print_stats("tracking", &stats);
+	if (stats.requests != CALLS ||
+			stats.sent > elapsed_ms(&start)/INTERVAL_MS + 1 ||
+			stats.coalesced == 0 || stats.dropped == 0 ||
+			stats.sent + stats.coalesced + stats.dropped + 1 < CALLS) {
+		fprintf(stderr, "bad statistics\n");
+		errors++;
+	}
+
+	/* the last position left is sent */
+	usleep(2*INTERVAL_MS*1000);
+	rot_get_pos_stats(rot, &stats);
+	print_stats("settled", &stats);
+	if (stats.sent + stats.coalesced + stats.dropped != CALLS) {
+		fprintf(stderr, "position left unsent\n");
+		errors++;
+	}
+
+	/* wait for the dummy rotator to get there */
+	last_az = -1;
+	for (i = 0; i < 40; i++) {
+		rot_get_position(rot, &az, &el);
+		if (az == last_az)
+			break;
+		last_az = az;
+		usleep(100*1000);
+	}
+	printf("stopped at %.2f°\n", az);
+	if (fabs(az - (CALLS-1) * AZ_STEP) >= 0.2) {
+		fprintf(stderr, "stopped at %.2f°, %.2f° expected\n",
+				az, (CALLS-1) * AZ_STEP);
+		errors++;
+	}
+
+	/* out of range, still checked right away */
+	if (rot_set_position(rot, 720, 0) != -RIG_EINVAL) {
+		fprintf(stderr, "out of range position accepted\n");
+		errors++;
+	}
+
+	rot_close(rot);
+	rot_cleanup(rot);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,190 @@
+
+/*
+ * Test program of the software scan engine rig_sw_scan(), on the dummy
+ * rig, whose S-Meter is above -21 dB below 7 MHz, and below it
+ * from 50 MHz up.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <hamlib/rig.h>
+
+static const freq_t freqs[] = { MHz(145), MHz(3.6), MHz(432), MHz(146), MHz(1.9) };
+#define NFREQS (sizeof(freqs)/sizeof(freqs[0]))
+
+/* memory channel and its frequency */
+static const int channels[] = { 3, 7, 12 };
+static const freq_t chan_freqs[] = { MHz(439.1), MHz(3.7), MHz(145.5) };
+#define NCHANS (sizeof(channels)/sizeof(channels[0]))
+
+struct result {
+	int hits;
+	int hit_idx[16];
+	freq_t hit_freq[16];
+	int stop_after;		/* hits before stopping, 0 for never */
+	int passes;
+	double cps;
+};
+
+static int errors;
+
+static int hit_cb(RIG *rig, vfo_t vfo, int idx, freq_t freq, value_t val,
+		rig_ptr_t arg)
+{
+	struct result *res = (struct result *)arg;
+
+	printf("  hit: #%d %.0f Hz, %d dB\n", idx, freq, val.i);
+	if (res->hits < 16) {
+		res->hit_idx[res->hits] = idx;
+		res->hit_freq[res->hits] = freq;
+	}
+	res->hits++;
+
+	return res->stop_after && res->hits >= res->stop_after ? -RIG_EINVAL : RIG_OK;
+}
+
+static int stats_cb(RIG *rig, int pass, int hits, double cps, rig_ptr_t arg)
+{
+	struct result *res = (struct result *)arg;
+
+	printf("  pass %d: %d hit(s), %.0f channels/s\n", pass, hits, cps);
+	res->passes = pass;
+	res->cps = cps;
+
+	return RIG_OK;
+}
+
+static void init_scan(struct rig_sw_scan *scan, struct result *res)
+{
+	memset(scan, 0, sizeof(*scan));
+	memset(res, 0, sizeof(*res));
+	scan->vfo = RIG_VFO_CURR;
+	scan->passes = 1;
+	scan->stop = RIG_SW_SCAN_STOP_LEVEL;
+	scan->level = RIG_LEVEL_STRENGTH;
+	scan->threshold.i = -21;
+	scan->hit_cb = hit_cb;
+	scan->stats_cb = stats_cb;
+	scan->arg = (rig_ptr_t)res;
+}
+
+static void check_hits(const char *name, int ret, const struct result *res,
+		int nhits, const int *idx, const freq_t *freq)
+{
+	int i;
+
+	if (ret != nhits || res->hits != nhits) {
+		fprintf(stderr, "%s: returned %d, %d hit(s), expected %d\n",
+				name, ret, res->hits, nhits);
+		errors++;
+		return;
+	}
+	for (i = 0; i < nhits; i++) {
+		if (res->hit_idx[i] != idx[i] || res->hit_freq[i] != freq[i]) {
+			fprintf(stderr, "%s: hit %d is #%d %.0f Hz, expected #%d %.0f Hz\n",
+					name, i, res->hit_idx[i], res->hit_freq[i],
+					idx[i], freq[i]);
+			errors++;
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	static const int freq_hit_idx[] = { 1, 4, 1, 4 };
+	static const freq_t freq_hit_freq[] = { MHz(3.6), MHz(1.9), MHz(3.6), MHz(1.9) };
+	static const int mem_hit_idx[] = { 1 };
+	static const freq_t mem_hit_freq[] = { MHz(3.7) };
+	struct rig_sw_scan scan;
+	struct result res;
+	RIG *rig;
+	int i, ret;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	rig = rig_init(RIG_MODEL_DUMMY);
+	if (!rig || rig_open(rig) != RIG_OK) {
+		fprintf(stderr, "cannot open the dummy rig\n");
+		return 1;
+	}
+
+	printf("frequency scan\n");
+	init_scan(&scan, &res);
+	scan.freqs = freqs;
+	scan.count = NFREQS;
+	scan.passes = 2;
+	ret = rig_sw_scan(rig, &scan);
+	check_hits("frequency scan", ret, &res, 4, freq_hit_idx, freq_hit_freq);
+	if (res.passes != 2 || res.cps <= 0) {
+		fprintf(stderr, "frequency scan: %d pass(es), %.0f channels/s\n",
+				res.passes, res.cps);
+		errors++;
+	}
+
+	printf("stop from the hit callback\n");
+	init_scan(&scan, &res);
+	scan.freqs = freqs;
+	scan.count = NFREQS;
+	scan.passes = 0;
+	res.stop_after = 1;
+	ret = rig_sw_scan(rig, &scan);
+	check_hits("stopped scan", ret, &res, 1, freq_hit_idx, freq_hit_freq);
+
+	printf("memory scan\n");
+	rig_set_vfo(rig, RIG_VFO_MEM);
+	for (i = 0; i < NCHANS; i++) {
+		rig_set_mem(rig, RIG_VFO_CURR, channels[i]);
+		rig_set_freq(rig, RIG_VFO_CURR, chan_freqs[i]);
+	}
+	rig_set_vfo(rig, RIG_VFO_A);
+	init_scan(&scan, &res);
+	scan.vfo = RIG_VFO_MEM;
+	scan.channels = channels;
+	scan.count = NCHANS;
+	ret = rig_sw_scan(rig, &scan);
+	check_hits("memory scan", ret, &res, 1, mem_hit_idx, mem_hit_freq);
+	if (rig->state.current_vfo != RIG_VFO_A) {
+		fprintf(stderr, "memory scan: VFO not restored\n");
+		errors++;
+	}
+
+	printf("no stop condition\n");
+	init_scan(&scan, &res);
+	scan.freqs = freqs;
+	scan.count = NFREQS;
+	scan.stop = RIG_SW_SCAN_STOP_NONE;
+	scan.level = RIG_LEVEL_NONE;
+	ret = rig_sw_scan(rig, &scan);
+	if (ret != NFREQS) {
+		fprintf(stderr, "no stop condition: %d hit(s)\n", ret);
+		errors++;
+	}
+
+	init_scan(&scan, &res);
+	if (rig_sw_scan(rig, &scan) != -RIG_EINVAL) {
+		fprintf(stderr, "empty scan accepted\n");
+		errors++;
+	}
+
+	init_scan(&scan, &res);
+	scan.freqs = freqs;
+	scan.count = NFREQS;
+	scan.passes = 0;
+	scan.hit_cb = NULL;
+	scan.stats_cb = NULL;
+	if (rig_sw_scan(rig, &scan) != -RIG_EINVAL) {
+		fprintf(stderr, "endless scan accepted\n");
+		errors++;
+	}
+
+	rig_close(rig);
+	rig_cleanup(rig);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
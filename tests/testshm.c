@@ -0,0 +1,203 @@
+
+/*
+ * Test program of the shared memory rig state: a reader attached before
+ * the first publication sees the empty state, then never sees a torn
+ * snapshot while two threads publish, nor loses an update published
+ * from the live state of a rig. A segment with a wrong magic is refused.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <hamlib/rig.h>
+#include <hamlib/rigshm.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+
+#define SEGMENT "testshm.seg"
+#define PUBLISHES 200000
+#define SET_FREQS 2000
+
+static rig_shm_t *shm;
+static RIG *rig;
+static volatile int stop;
+static int errors;
+
+/* the mode and passband derive from the frequency, to spot torn copies */
+static void make_snap(struct rig_shm_snapshot *snap, freq_t freq)
+{
+	memset(snap, 0, sizeof(*snap));
+	snap->vfo = RIG_VFO_A;
+	snap->freq = freq;
+	snap->mode = ((long)freq & 1) ? RIG_MODE_USB : RIG_MODE_LSB;
+	snap->width = (pbwidth_t)freq;
+}
+
+static void *publish_thread(void *arg)
+{
+	struct rig_shm_snapshot snap;
+	long base = (long)arg;
+	int i;
+
+	for (i = 0; i < PUBLISHES; i++) {
+		make_snap(&snap, base + i);
+		if (rig_shm_publish(shm, &snap) != RIG_OK)
+			break;
+	}
+	return NULL;
+}
+
+static void *publish_rig_thread(void *arg)
+{
+	long base = (long)arg;
+	int i;
+
+	for (i = 0; i < SET_FREQS; i++) {
+		rig_set_freq(rig, RIG_VFO_CURR, base + i*10);
+		if (rig_shm_publish_rig(shm, rig) != RIG_OK)
+			break;
+	}
+	return NULL;
+}
+
+static long reads;
+
+/* returns the number of inconsistent snapshots */
+static void *reader_thread(void *arg)
+{
+	rig_shm_t *reader = arg;
+	struct rig_shm_snapshot snap;
+	unsigned long last = 0;
+	long bad = 0, ret;
+
+	while (!stop) {
+		ret = rig_shm_read(reader, &snap);
+		/* the publishers never pause, so the reader may give up */
+		if (ret == -RIG_ETIMEOUT)
+			continue;
+		if (ret != RIG_OK) {
+			fprintf(stderr, "rig_shm_read: %s\n", rigerror(ret));
+			bad++;
+			break;
+		}
+		if (snap.serial == 0)
+			continue;
+		reads++;
+		if (snap.serial < last || snap.rig_model != RIG_MODEL_DUMMY ||
+				snap.width != (pbwidth_t)snap.freq ||
+				snap.mode != (((long)snap.freq & 1) ?
+					RIG_MODE_USB : RIG_MODE_LSB)) {
+			if (bad++ < 5)
+				fprintf(stderr, "torn snapshot: serial %lu after %lu, "
+						"%.0f Hz, mode %s, width %ld\n",
+						snap.serial, last, snap.freq,
+						rig_strrmode(snap.mode), snap.width);
+		}
+		last = snap.serial;
+	}
+	return (void *)bad;
+}
+
+int main(int argc, char *argv[])
+{
+	struct rig_shm_snapshot snap;
+	rig_shm_t *reader;
+	pthread_t threads[2], rthread;
+	char zeros[4096];
+	void *bad;
+	FILE *f;
+	int ret;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	printf("attach before publication\n");
+	shm = rig_shm_create(SEGMENT, RIG_MODEL_DUMMY);
+	reader = rig_shm_attach(SEGMENT);
+	if (!shm || !reader) {
+		printf("no shared memory available, skipping\n");
+		return 0;
+	}
+	ret = rig_shm_read(reader, &snap);
+	if (ret != RIG_OK || snap.serial != 0 ||
+			snap.rig_model != RIG_MODEL_DUMMY) {
+		fprintf(stderr, "empty segment: %s, serial %lu\n", rigerror(ret),
+				snap.serial);
+		errors++;
+	}
+
+	printf("two publishing threads\n");
+	pthread_create(&rthread, NULL, reader_thread, reader);
+	pthread_create(&threads[0], NULL, publish_thread, (void *)1000000L);
+	pthread_create(&threads[1], NULL, publish_thread, (void *)5000000L);
+	pthread_join(threads[0], NULL);
+	pthread_join(threads[1], NULL);
+	stop = 1;
+	pthread_join(rthread, &bad);
+	ret = rig_shm_read(reader, &snap);
+	printf("  last serial %lu, %ld read, %ld torn\n", snap.serial, reads,
+			(long)bad);
+	if (bad || ret != RIG_OK || snap.serial != 2*PUBLISHES) {
+		fprintf(stderr, "inconsistent publications\n");
+		errors++;
+	}
+
+	printf("live state published from two threads\n");
+	rig = rig_init(RIG_MODEL_DUMMY);
+	if (!rig || rig_open(rig) != RIG_OK) {
+		fprintf(stderr, "cannot open the dummy rig\n");
+		return 1;
+	}
+	pthread_create(&threads[0], NULL, publish_rig_thread, (void *)7000000L);
+	pthread_create(&threads[1], NULL, publish_rig_thread, (void *)14000000L);
+	pthread_join(threads[0], NULL);
+	pthread_join(threads[1], NULL);
+	ret = rig_shm_read(reader, &snap);
+	printf("  %.0f Hz published, %.0f Hz current\n", snap.freq,
+			rig->state.current_freq);
+	if (ret != RIG_OK || snap.freq != rig->state.current_freq) {
+		fprintf(stderr, "lost update\n");
+		errors++;
+	}
+	rig_close(rig);
+	rig_cleanup(rig);
+
+	rig_shm_close(reader);
+	rig_shm_close(shm);
+
+	printf("bad magic\n");
+	memset(zeros, 0, sizeof(zeros));
+	f = fopen(SEGMENT, "wb");
+	if (!f || fwrite(zeros, sizeof(zeros), 1, f) != 1) {
+		fprintf(stderr, "cannot write %s\n", SEGMENT);
+		return 1;
+	}
+	fclose(f);
+	reader = rig_shm_attach(SEGMENT);
+	ret = reader ? rig_shm_read(reader, &snap) : RIG_OK;
+	if (ret != -RIG_EPROTO) {
+		fprintf(stderr, "bad magic read: %s\n", rigerror(ret));
+		errors++;
+	}
+	if (reader)
+		rig_shm_close(reader);
+	unlink(SEGMENT);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
+
+#else	/* !HAVE_PTHREAD */
+
+int main(int argc, char *argv[])
+{
+	printf("no pthread support, nothing to test\n");
+	return 0;
+}
+
+#endif	/* !HAVE_PTHREAD */
@@ -0,0 +1,143 @@
+
+/*
+ * Test program of the Si570 register math of the kit backend:
+ * full divider search, smooth tune reusing the dividers, and
+ * the register encoding, checked against the full solution.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <hamlib/rig.h>
+#include "si570avrusb.h"
+
+#define OSC_FREQ SI570_NOMINAL_XTALL_FREQ
+#define TOLERANCE 1e-6	/* MHz, ie 1 Hz */
+
+static const double ppms[] = { -3499, -2000, -100, -1, 0, 1, 100, 2000, 3499 };
+#define NPPMS (sizeof(ppms)/sizeof(ppms[0]))
+
+static int errors;
+
+static double program(const struct solution *sol)
+{
+	unsigned char buffer[6];
+
+	si570_set_registers(sol, buffer);
+	return si570_calc_frequency(OSC_FREQ, buffer);
+}
+
+static int check_full(double f, struct solution *sol)
+{
+	double fout;
+
+	if (!si570_calc_dividers(OSC_FREQ, f, sol)) {
+		fprintf(stderr, "%.6f MHz: no solution\n", f);
+		errors++;
+		return 0;
+	}
+	if (sol->f0 < SI570_DCO_LOW || sol->f0 > SI570_DCO_HIGH) {
+		fprintf(stderr, "%.6f MHz: DCO at %.3f MHz\n", f, sol->f0);
+		errors++;
+	}
+	fout = program(sol);
+	if (fabs(fout - f) > TOLERANCE) {
+		fprintf(stderr, "%.6f MHz: programmed %.6f MHz\n", f, fout);
+		errors++;
+	}
+	return 1;
+}
+
+/* returns 1 when smooth tuned */
+static int check_smooth(double center, const struct solution *cached, double ppm)
+{
+	struct solution smooth, full;
+	unsigned char sbuf[6], fbuf[6];
+	double f = center * (1 + ppm / 1e6);
+	double f0, fout;
+
+	if (!si570_smooth_tune(OSC_FREQ, f, center, cached, &smooth)) {
+		/* only when the DCO would go out of range */
+		f0 = f * (cached->N1 + 1) * si570_hs_div_map[cached->HS_DIV];
+		if (f0 >= SI570_DCO_LOW && f0 <= SI570_DCO_HIGH) {
+			fprintf(stderr, "%.6f MHz %+g ppm: smooth tune refused\n",
+					center, ppm);
+			errors++;
+		}
+		return 0;
+	}
+
+	if (smooth.HS_DIV != cached->HS_DIV || smooth.N1 != cached->N1) {
+		fprintf(stderr, "%.6f MHz %+g ppm: dividers changed\n", center, ppm);
+		errors++;
+	}
+	fout = program(&smooth);
+	if (fabs(fout - f) > TOLERANCE) {
+		fprintf(stderr, "%.6f MHz %+g ppm: programmed %.6f MHz, expected %.6f\n",
+				center, ppm, fout, f);
+		errors++;
+	}
+
+	/* same registers as the full solution, when it has the same dividers */
+	si570_calc_dividers(OSC_FREQ, f, &full);
+	if (full.HS_DIV == smooth.HS_DIV && full.N1 == smooth.N1) {
+		si570_set_registers(&smooth, sbuf);
+		si570_set_registers(&full, fbuf);
+		if (memcmp(sbuf, fbuf, sizeof(sbuf))) {
+			fprintf(stderr, "%.6f MHz %+g ppm: registers differ from "
+					"the full solution\n", center, ppm);
+			errors++;
+		}
+	} else if (fabs(program(&full) - fout) > 2 * TOLERANCE) {
+		fprintf(stderr, "%.6f MHz %+g ppm: full solution at %.6f MHz\n",
+				center, ppm, program(&full));
+		errors++;
+	}
+
+	return 1;
+}
+
+int main(int argc, char *argv[])
+{
+	struct solution sol, dummy;
+	int i, tried = 0, smoothed = 0;
+	double f;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	for (f = 10.0; f <= 280.0; f += 0.737) {
+		if (!check_full(f, &sol))
+			continue;
+		for (i = 0; i < NPPMS; i++) {
+			tried++;
+			smoothed += check_smooth(f, &sol, ppms[i]);
+		}
+
+		/* out of the window */
+		if (si570_smooth_tune(OSC_FREQ, f * (1 + 3600 / 1e6), f, &sol, &dummy) ||
+				si570_smooth_tune(OSC_FREQ, f * (1 - 3600 / 1e6), f, &sol, &dummy)) {
+			fprintf(stderr, "%.6f MHz: smooth tune beyond %d ppm\n",
+					f, SI570_SMOOTH_TUNE_PPM);
+			errors++;
+		}
+	}
+
+	/* no cached solution yet */
+	if (si570_smooth_tune(OSC_FREQ, 56.0, 0, &sol, &dummy)) {
+		fprintf(stderr, "smooth tune without a cached solution\n");
+		errors++;
+	}
+
+	printf("%d/%d smooth tunes\n", smoothed, tried);
+	if (smoothed < tried * 9 / 10) {
+		fprintf(stderr, "too few smooth tunes\n");
+		errors++;
+	}
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
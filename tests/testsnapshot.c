@@ -0,0 +1,80 @@
+
+/*
+ * Test program of rig_get_snapshot() on the dummy rig, which has no
+ * get_snapshot of its own, the snapshot matching the individual calls.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <hamlib/rig.h>
+
+static int errors;
+
+int main(int argc, char *argv[])
+{
+	rig_snapshot_t snap;
+	RIG *rig;
+	int ret;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	rig = rig_init(RIG_MODEL_DUMMY);
+	if (!rig || rig_open(rig) != RIG_OK) {
+		fprintf(stderr, "cannot open the dummy rig\n");
+		return 1;
+	}
+
+	rig_set_vfo(rig, RIG_VFO_A);
+	rig_set_freq(rig, RIG_VFO_CURR, MHz(14.074));
+	rig_set_mode(rig, RIG_VFO_CURR, RIG_MODE_USB, RIG_PASSBAND_NORMAL);
+	rig_set_ptt(rig, RIG_VFO_CURR, RIG_PTT_ON);
+	rig_set_split_vfo(rig, RIG_VFO_CURR, RIG_SPLIT_ON, RIG_VFO_B);
+
+	ret = rig_get_snapshot(rig, RIG_VFO_CURR, &snap);
+	printf("fields 0x%x: %s %.0f Hz %s %ld Hz, PTT %d, split %d %s\n",
+			snap.fields, rig_strvfo(snap.vfo), snap.freq,
+			rig_strrmode(snap.mode), (long)snap.width, snap.ptt,
+			snap.split, rig_strvfo(snap.tx_vfo));
+	if (ret != RIG_OK || snap.fields != RIG_SNAPSHOT_ALL) {
+		fprintf(stderr, "snapshot: %s, fields 0x%x\n", rigerror(ret),
+				snap.fields);
+		errors++;
+	}
+	if (snap.vfo != RIG_VFO_A || snap.freq != MHz(14.074) ||
+			snap.mode != RIG_MODE_USB ||
+			snap.width != rig_passband_normal(rig, RIG_MODE_USB) ||
+			snap.ptt != RIG_PTT_ON || snap.split != RIG_SPLIT_ON ||
+			snap.tx_vfo != RIG_VFO_B) {
+		fprintf(stderr, "snapshot: unexpected state\n");
+		errors++;
+	}
+	if (snap.date.tv_sec == 0) {
+		fprintf(stderr, "snapshot: no date\n");
+		errors++;
+	}
+
+	/* another VFO than the current one */
+	rig_set_freq(rig, RIG_VFO_B, MHz(7.040));
+	ret = rig_get_snapshot(rig, RIG_VFO_B, &snap);
+	if (ret != RIG_OK || snap.vfo != RIG_VFO_A || snap.freq != MHz(7.040)) {
+		fprintf(stderr, "VFO B snapshot: %s, %s %.0f Hz\n", rigerror(ret),
+				rig_strvfo(snap.vfo), snap.freq);
+		errors++;
+	}
+
+	if (rig_get_snapshot(rig, RIG_VFO_CURR, NULL) != -RIG_EINVAL) {
+		fprintf(stderr, "NULL snapshot accepted\n");
+		errors++;
+	}
+
+	rig_close(rig);
+	rig_cleanup(rig);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,144 @@
+#! /usr/bin/perl
+
+# teststats.pl - (C) 2026 The Hamlib Group
+# A Perl test script for the statistics of the rigctld program.
+#
+#
+# It starts rigctld on the dummy rig, with a metrics listener, runs a
+# command, then checks the Prometheus lines printed by the \dump_stats
+# command and served to an HTTP scraper by the metrics listener.
+
+#############################################################################
+#    This program is free software; you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation; either version 2 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License along
+#    with this program; if not, write to the Free Software Foundation, Inc.,
+#    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#
+# See the file 'COPYING' in the main Hamlib distribution directory for the
+# complete text of the GNU Public License version 2.
+#
+#############################################################################
+
+
+# Perl modules this script uses
+use warnings;
+use strict;
+use IO::Socket;
+
+# Global variables
+my $host = '127.0.0.1';
+my $rigctld = $ARGV[0] || './rigctld';
+my $errors = 0;
+my $pid;
+
+# A port nobody listens to, as picked by the system
+sub free_port {
+    my $s = new IO::Socket::INET (LocalAddr => $host,
+                                  Proto     => 'tcp',
+                                  Listen    => 1)
+        or die "Could not create a socket: $!\n";
+    my $port = $s->sockport();
+    close($s);
+    return $port;
+}
+
+# Connect, waiting for rigctld to listen
+sub connect_to {
+    my $port = shift;
+    my $socket;
+
+    for (1 .. 50) {
+        $socket = new IO::Socket::INET (PeerAddr => $host,
+                                        PeerPort => $port,
+                                        Proto    => 'tcp',
+                                        Type     => SOCK_STREAM);
+        return $socket if $socket;
+        select(undef, undef, undef, 0.1);
+    }
+    return undef;
+}
+
+# Check that each of the patterns matches a line of the output
+sub check_lines {
+    my ($name, $out, @patterns) = @_;
+
+    foreach my $pat (@patterns) {
+        if ($out !~ /^$pat$/m) {
+            print STDERR "$name: no line matching '$pat'\n";
+            $errors++;
+        }
+    }
+}
+
+my $port = free_port();
+my $mport = free_port();
+
+$pid = fork();
+die "Could not fork: $!\n" unless defined $pid;
+if ($pid == 0) {
+    exec($rigctld, '-m', '1', '-T', $host, '-t', $port,
+         '-x', "$host:$mport") or die "Could not run $rigctld: $!\n";
+}
+
+my $socket = connect_to($port);
+if (!$socket) {
+    kill('TERM', $pid);
+    die "Could not connect to rigctld on port $port\n";
+}
+
+# One command to count
+print $socket "f\n";
+my $freq = <$socket>;
+print "get_freq: $freq";
+
+print "dump_stats\n";
+print $socket "+\\dump_stats\n";
+my $out = '';
+while (my $line = <$socket>) {
+    last if $line =~ /^RPRT/;
+    $out .= $line;
+}
+check_lines('dump_stats', $out,
+            '# TYPE rigctld_uptime_seconds gauge',
+            'rigctld_clients 1',
+            'rigctld_connections_total 1',
+            'rigctld_commands_total\{command="get_freq"\} 1',
+            'rigctld_errors_total 0',
+            'rigctld_client_commands_total\{client=".*"\} 1',
+            'rigctld_command_seconds_count 1',
+            '# TYPE rigctld_port_transactions_total counter',
+            'rigctld_port_transactions_total \d+',
+            'rigctld_port_ttfb_seconds_bucket\{le="\+Inf"\} \d+');
+
+print "metrics listener\n";
+my $scrape = connect_to($mport);
+if ($scrape) {
+    print $scrape "GET /metrics HTTP/1.0\r\n\r\n";
+    $out = join('', <$scrape>);
+    close($scrape);
+    $out =~ s/\r//g;
+    check_lines('metrics', $out,
+                'HTTP/1.0 200 OK',
+                'rigctld_commands_total\{command="get_freq"\} 1',
+                'rigctld_commands_total\{command="dump_stats"\} 1',
+                'rigctld_command_seconds_count 2');
+} else {
+    print STDERR "metrics: could not connect to port $mport\n";
+    $errors++;
+}
+
+close($socket);
+kill('TERM', $pid);
+waitpid($pid, 0);
+
+print "$errors error(s)\n";
+exit($errors ? 1 : 0);
@@ -0,0 +1,181 @@
+
+/*
+ * Very simple test program to check the rig_parse_* and rig_str*
+ * string tables of misc.c round trip, and reject unknown strings.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <hamlib/rig.h>
+
+#define MAXNAMES 80
+
+static unsigned long long p_mode(const char *s) { return rig_parse_mode(s); }
+static const char *s_mode(unsigned long long v) { return rig_strrmode(v); }
+static unsigned long long p_vfo(const char *s) { return (unsigned)rig_parse_vfo(s); }
+static const char *s_vfo(unsigned long long v) { return rig_strvfo(v); }
+static unsigned long long p_func(const char *s) { return rig_parse_func(s); }
+static const char *s_func(unsigned long long v) { return rig_strfunc(v); }
+static unsigned long long p_level(const char *s) { return rig_parse_level(s); }
+static const char *s_level(unsigned long long v) { return rig_strlevel(v); }
+static unsigned long long p_parm(const char *s) { return rig_parse_parm(s); }
+static const char *s_parm(unsigned long long v) { return rig_strparm(v); }
+static unsigned long long p_vfo_op(const char *s) { return rig_parse_vfo_op(s); }
+static const char *s_vfo_op(unsigned long long v) { return rig_strvfop(v); }
+static unsigned long long p_scan(const char *s) { return rig_parse_scan(s); }
+static const char *s_scan(unsigned long long v) { return rig_strscan(v); }
+static unsigned long long p_mtype(const char *s) { return rig_parse_mtype(s); }
+static const char *s_mtype(unsigned long long v) { return rig_strmtype(v); }
+
+static struct strtab {
+	const char *name;
+	unsigned long long (*parse)(const char *);
+	const char *(*str)(unsigned long long);
+	int bits;	/* values are single bits, else small integers */
+	int min;	/* minimum expected number of names */
+	const char *aliases[4];	/* names whose value prints differently */
+} tabs[] = {
+	{ "mode", p_mode, s_mode, 1, 20 },
+	{ "vfo", p_vfo, s_vfo, 1, 8, { "RX", "TX" } },
+	{ "func", p_func, s_func, 1, 30 },
+	{ "level", p_level, s_level, 1, 31 },
+	{ "parm", p_parm, s_parm, 1, 7 },
+	{ "vfo_op", p_vfo_op, s_vfo_op, 1, 13 },
+	{ "scan", p_scan, s_scan, 1, 7, { "STOP" } },
+	{ "mtype", p_mtype, s_mtype, 0, 7 },
+};
+
+static int errors;
+
+static int known(const char **names, int n, const char *s)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		if (!strcmp(names[i], s))
+			return 1;
+	return 0;
+}
+
+static void check_unknown(struct strtab *t, const char **names, int n, const char *s)
+{
+	if (!known(names, n, s) && t->parse(s) != 0) {
+		fprintf(stderr, "%s: '%s' parsed as %llx\n", t->name, s, t->parse(s));
+		errors++;
+	}
+}
+
+static void check_tab(struct strtab *t)
+{
+	const char *names[MAXNAMES];
+	char buf[64];
+	static const char alpha[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ_";
+	unsigned long long v, w;
+	const char *s;
+	int i, j, k, n = 0;
+
+	/* every value prints, and parses back */
+	for (i = 0; i < 64; i++) {
+		v = t->bits ? 1ULL << i : (unsigned long long)i;
+		s = t->str(v);
+		if (!s[0])
+			continue;
+		names[n++] = s;
+		if (t->parse(s) != v) {
+			fprintf(stderr, "%s: '%s' parsed as %llx, expected %llx\n",
+					t->name, s, t->parse(s), v);
+			errors++;
+		}
+	}
+	if (n < t->min) {
+		fprintf(stderr, "%s: only %d names\n", t->name, n);
+		errors++;
+	}
+
+	/* aliases print as the name their value first has */
+	for (i = 0; i < 4 && t->aliases[i]; i++) {
+		names[n++] = t->aliases[i];
+		v = t->parse(t->aliases[i]);
+		s = t->str(v);
+		if (v != 0 && t->parse(s) != v) {
+			fprintf(stderr, "%s: alias '%s' does not round trip\n",
+					t->name, t->aliases[i]);
+			errors++;
+		}
+	}
+
+	/* none, and values made of several bits */
+	if (t->str(0)[0] != '\0') {
+		fprintf(stderr, "%s: none prints as '%s'\n", t->name, t->str(0));
+		errors++;
+	}
+	if (t->bits) {
+		for (i = 0; i < 63; i++) {
+			v = 3ULL << i;
+			s = t->str(v);
+			/* RIG_VFO_TX is the only composite value */
+			if (s[0] && !(!strcmp(t->name, "vfo") && !strcmp(s, "TX"))) {
+				fprintf(stderr, "%s: %llx prints as '%s'\n", t->name, v, s);
+				errors++;
+			}
+		}
+	}
+
+	/* unknown strings parse as none */
+	check_unknown(t, names, n, "");
+	for (i = 0; i < n; i++) {
+		snprintf(buf, sizeof(buf), "%sX", names[i]);
+		check_unknown(t, names, n, buf);
+		snprintf(buf, sizeof(buf), "%s", names[i]);
+		buf[strlen(buf)-1] = '\0';
+		check_unknown(t, names, n, buf);
+		snprintf(buf, sizeof(buf), "%s", names[i]);
+		buf[0] = tolower(buf[0]);
+		check_unknown(t, names, n, buf);
+	}
+	for (i = 0; alpha[i]; i++)
+		for (j = 0; alpha[j]; j++)
+			for (k = 0; alpha[k]; k++) {
+				buf[0] = alpha[i];
+				buf[1] = alpha[j];
+				buf[2] = alpha[k];
+				buf[3] = '\0';
+				check_unknown(t, names, n, buf);
+				buf[2] = '\0';
+				check_unknown(t, names, n, buf);
+				buf[1] = '\0';
+				check_unknown(t, names, n, buf);
+			}
+
+	/* names are unique */
+	for (i = 0; i < n; i++)
+		for (j = i+1; j < n; j++)
+			if (!strcmp(names[i], names[j])) {
+				fprintf(stderr, "%s: duplicate '%s'\n", t->name, names[i]);
+				errors++;
+			}
+
+	w = 0;
+	for (i = 0; i < n; i++)
+		w |= t->parse(names[i]);
+	printf("%-8s %2d names, values %llx\n", t->name, n, w);
+}
+
+int main (int argc, char *argv[])
+{
+	int i;
+
+	for (i = 0; i < sizeof(tabs)/sizeof(tabs[0]); i++)
+		check_tab(&tabs[i]);
+
+	if (errors)
+		fprintf(stderr, "%d errors\n", errors);
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,213 @@
+
+/*
+ * Test program of the sweep engine rig_sweep() and rig_sweep_rot(),
+ * on the dummy rig, whose S-Meter is above -21 dB below 7 MHz, and
+ * below it from 50 MHz up, and the dummy rotator, turning 6° a second.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <hamlib/rig.h>
+#include <hamlib/rotator.h>
+
+#define MAX_POINTS 64
+
+struct result {
+	int count;
+	struct rig_sweep_point pts[MAX_POINTS];
+	int stop_after;		/* points before stopping, 0 for never */
+};
+
+static int errors;
+
+static int point_cb(RIG *rig, const struct rig_sweep_point *pt, rig_ptr_t arg)
+{
+	struct result *res = (struct result *)arg;
+
+	if (res->count < MAX_POINTS)
+		res->pts[res->count] = *pt;
+	res->count++;
+
+	return res->stop_after && res->count >= res->stop_after ? -RIG_EINVAL : RIG_OK;
+}
+
+static void init_sweep(struct rig_sweep *sweep, struct result *res)
+{
+	memset(sweep, 0, sizeof(*sweep));
+	memset(res, 0, sizeof(*res));
+	sweep->vfo = RIG_VFO_CURR;
+	sweep->level = RIG_LEVEL_STRENGTH;
+	/* the S-Meter of the dummy rig has a noise of 3 dB */
+	sweep->settle_max = 100;
+	sweep->settle_tol = 3;
+	sweep->samples = 2;
+	sweep->point_cb = point_cb;
+	sweep->arg = (rig_ptr_t)res;
+}
+
+int main(int argc, char *argv[])
+{
+	struct rig_sweep sweep;
+	struct rot_sweep rsweep;
+	struct result res;
+	RIG *rig;
+	ROT *rot;
+	freq_t freq;
+	int i, ret;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	rig = rig_init(RIG_MODEL_DUMMY);
+	rot = rot_init(ROT_MODEL_DUMMY);
+	if (!rig || rig_open(rig) != RIG_OK || !rot || rot_open(rot) != RIG_OK) {
+		fprintf(stderr, "cannot open the dummy rig or rotator\n");
+		return 1;
+	}
+
+	printf("frequency sweep\n");
+	init_sweep(&sweep, &res);
+	sweep.start = MHz(1);
+	sweep.stop = MHz(145);
+	sweep.step = MHz(16);
+	sweep.mode = RIG_MODE_USB;
+	ret = rig_sweep(rig, &sweep);
+	if (ret != 10 || res.count != 10) {
+		fprintf(stderr, "frequency sweep: returned %d, %d point(s)\n",
+				ret, res.count);
+		errors++;
+	}
+	for (i = 0; i < res.count && i < MAX_POINTS; i++) {
+		const struct rig_sweep_point *pt = &res.pts[i];
+
+		printf("  #%d %.0f Hz %d dB, settled in %d mS\n", pt->idx,
+				pt->freq, pt->val.i, pt->settle);
+		if (pt->idx != i || pt->freq != sweep.start + i * sweep.step ||
+				!pt->settled) {
+			fprintf(stderr, "frequency sweep: bad point #%d %.0f Hz\n",
+					pt->idx, pt->freq);
+			errors++;
+		}
+		if ((pt->freq < MHz(7) && pt->val.i < -21) ||
+				(pt->freq >= MHz(50) && pt->val.i > -21)) {
+			fprintf(stderr, "frequency sweep: %d dB at %.0f Hz\n",
+					pt->val.i, pt->freq);
+			errors++;
+		}
+	}
+	rig_get_freq(rig, RIG_VFO_CURR, &freq);
+	if (freq != sweep.stop) {
+		fprintf(stderr, "frequency sweep: left at %.0f Hz\n", freq);
+		errors++;
+	}
+
+	printf("meter stuck at its value before keying\n");
+	init_sweep(&sweep, &res);
+	sweep.level = RIG_LEVEL_SWR;
+	sweep.ptt = 1;
+	sweep.settle_tol = 0.05;
+	ret = rig_sweep(rig, &sweep);
+	if (ret != 1 || res.count != 1 || res.pts[0].settled ||
+			res.pts[0].settle < sweep.settle_max) {
+		fprintf(stderr, "SWR sweep: returned %d, settled %d in %d mS\n",
+				ret, res.pts[0].settled, res.pts[0].settle);
+		errors++;
+	}
+
+	printf("stop from the callback\n");
+	init_sweep(&sweep, &res);
+	sweep.start = MHz(1);
+	sweep.stop = MHz(2);
+	sweep.step = kHz(100);
+	res.stop_after = 3;
+	ret = rig_sweep(rig, &sweep);
+	if (ret != 3 || res.count != 3) {
+		fprintf(stderr, "stopped sweep: returned %d, %d point(s)\n",
+				ret, res.count);
+		errors++;
+	}
+
+	init_sweep(&sweep, &res);
+	sweep.level = RIG_LEVEL_NONE;
+	if (rig_sweep(rig, &sweep) != -RIG_EINVAL) {
+		fprintf(stderr, "sweep without level accepted\n");
+		errors++;
+	}
+	sweep.level = RIG_LEVEL_STRENGTH;
+	sweep.start = MHz(2);
+	sweep.stop = MHz(1);
+	sweep.step = kHz(100);
+	if (rig_sweep(rig, &sweep) != -RIG_EINVAL) {
+		fprintf(stderr, "reversed sweep accepted\n");
+		errors++;
+	}
+
+	printf("stepped rotator sweep\n");
+	init_sweep(&sweep, &res);
+	sweep.start = MHz(3.5);
+	sweep.stop = MHz(144);
+	sweep.step = MHz(140.5);
+	memset(&rsweep, 0, sizeof(rsweep));
+	rsweep.az_start = 0;
+	rsweep.az_stop = 2;
+	rsweep.az_step = 1;
+	rsweep.tolerance = 0.1;
+	ret = rig_sweep_rot(rig, rot, &sweep, &rsweep);
+	if (ret != 6 || res.count != 6) {
+		fprintf(stderr, "stepped rotator sweep: returned %d, %d point(s)\n",
+				ret, res.count);
+		errors++;
+	}
+	for (i = 0; i < res.count && i < MAX_POINTS; i++) {
+		const struct rig_sweep_point *pt = &res.pts[i];
+
+		printf("  #%d %.1f° %.0f Hz %d dB\n", pt->idx, pt->azimuth,
+				pt->freq, pt->val.i);
+		if (fabs(pt->azimuth - i/2) > 0.1 ||
+				pt->freq != (i % 2 ? MHz(144) : MHz(3.5))) {
+			fprintf(stderr, "stepped rotator sweep: bad point #%d\n", i);
+			errors++;
+		}
+	}
+
+	printf("continuous rotator sweep\n");
+	init_sweep(&sweep, &res);
+	sweep.settle_max = 0;
+	sweep.settle_min = 50;
+	sweep.samples = 1;
+	memset(&rsweep, 0, sizeof(rsweep));
+	rsweep.az_start = 2;
+	rsweep.az_stop = 4;
+	rsweep.tolerance = 0.1;
+	ret = rig_sweep_rot(rig, rot, &sweep, &rsweep);
+	if (ret >= 3 && ret == res.count) {
+		printf("  %d point(s), from %.1f° to %.1f°\n", res.count,
+				res.pts[0].azimuth, res.pts[res.count < MAX_POINTS ?
+					res.count-1 : MAX_POINTS-1].azimuth);
+	} else {
+		fprintf(stderr, "continuous rotator sweep: returned %d, %d point(s)\n",
+				ret, res.count);
+		errors++;
+	}
+	for (i = 1; i < res.count && i < MAX_POINTS; i++) {
+		if (res.pts[i].azimuth < res.pts[i-1].azimuth ||
+				res.pts[i].azimuth > 4.1) {
+			fprintf(stderr, "continuous rotator sweep: %.1f° after %.1f°\n",
+					res.pts[i].azimuth, res.pts[i-1].azimuth);
+			errors++;
+		}
+	}
+
+	rot_close(rot);
+	rot_cleanup(rot);
+	rig_close(rig);
+	rig_cleanup(rig);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,272 @@
+
+/*
+ * Test program of the I/O trace record/replay: a session with a fake
+ * rig on a pseudo terminal is recorded, then replayed without it,
+ * as fast as possible and at recorded speed. Replies never read by
+ * the backend are dropped rather than mistaken for the end of the
+ * trace.
+ */
+
+#define _GNU_SOURCE	/* posix_openpt, cfmakeraw */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <sys/time.h>
+#include <hamlib/rig.h>
+#include "iofunc.h"
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+
+#define TRACE_FILE "testtrace.trc"
+#define REPLY_DELAY_MS 30
+/* more than a pipe holds */
+#define UNREAD_LEN 200000
+
+static const char *cmds[] = { "FA;", "MD;", "FA;", NULL };
+static const char *replies[] = { "FA00014074000;", "MD2;", "FA00014074000;" };
+
+static int master, slave;
+static volatile int stop;
+static int errors;
+
+static void *fake_rig_thread(void *arg)
+{
+	char buf[64];
+	int len = 0, ret, i;
+
+	while (!stop) {
+		ret = read(master, buf + len, sizeof(buf) - 1 - len);
+		if (ret <= 0) {
+			usleep(1000);
+			continue;
+		}
+		len += ret;
+		buf[len] = '\0';
+		for (i = 0; cmds[i]; i++) {
+			if (!strcmp(buf, cmds[i])) {
+				usleep(REPLY_DELAY_MS*1000);
+				ret = write(master, replies[i], strlen(replies[i]));
+				len = 0;
+				break;
+			}
+		}
+		if (len >= sizeof(buf) - 1)
+			len = 0;
+	}
+	return NULL;
+}
+
+static void init_port(hamlib_port_t *p, const char *pathname, enum rig_trace_mode_e mode)
+{
+	memset(p, 0, sizeof(*p));
+	p->type.rig = RIG_PORT_SERIAL;
+	p->parm.serial.rate = 9600;
+	p->parm.serial.data_bits = 8;
+	p->parm.serial.stop_bits = 1;
+	p->timeout = 500;
+	strncpy(p->pathname, pathname, FILPATHLEN - 1);
+	strncpy(p->trace_file, TRACE_FILE, FILPATHLEN - 1);
+	p->trace_mode = mode;
+}
+
+static void put_varint(FILE *f, unsigned long v)
+{
+	do {
+		unsigned char c = v & 0x7f;
+
+		v >>= 7;
+		if (v)
+			c |= 0x80;
+		putc(c, f);
+	} while (v);
+}
+
+/* a long reply nobody reads, then FA; answered */
+static int write_unread_trace(void)
+{
+	FILE *f;
+	int i;
+
+	f = fopen(TRACE_FILE, "wb");
+	if (!f)
+		return -1;
+	fwrite("HLTRACE\001", 1, 8, f);
+	putc('R', f);
+	put_varint(f, 0);
+	put_varint(f, UNREAD_LEN);
+	for (i = 0; i < UNREAD_LEN; i++)
+		putc('x', f);
+	putc('W', f);
+	put_varint(f, 0);
+	put_varint(f, strlen(cmds[0]));
+	fputs(cmds[0], f);
+	putc('R', f);
+	put_varint(f, 0);
+	put_varint(f, strlen(replies[0]));
+	fputs(replies[0], f);
+	return fclose(f);
+}
+
+/* returns the elapsed time in mS */
+static long session(const char *name, hamlib_port_t *p)
+{
+	struct timeval t1, t2;
+	char buf[64];
+	int i, ret;
+
+	gettimeofday(&t1, NULL);
+
+	for (i = 0; cmds[i]; i++) {
+		ret = write_block(p, cmds[i], strlen(cmds[i]));
+		if (ret != RIG_OK) {
+			fprintf(stderr, "%s: write %s: %s\n", name, cmds[i], rigerror(ret));
+			errors++;
+			return -1;
+		}
+		ret = read_string(p, buf, sizeof(buf), ";", 1);
+		if (ret < 0 || strcmp(buf, replies[i])) {
+			fprintf(stderr, "%s: reply to %s: got '%s' (%d)\n", name,
+					cmds[i], ret < 0 ? "" : buf, ret);
+			errors++;
+			return -1;
+		}
+	}
+
+	gettimeofday(&t2, NULL);
+	return (t2.tv_sec - t1.tv_sec)*1000 + (t2.tv_usec - t1.tv_usec)/1000;
+}
+
+int main(int argc, char *argv[])
+{
+	hamlib_port_t port;
+	struct termios t;
+	pthread_t thread;
+	char buf[64];
+	long ms;
+	int ret;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) || unlockpt(master)) {
+		printf("no pseudo terminal available, skipping\n");
+		return 0;
+	}
+	slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+	if (slave < 0) {
+		printf("no pseudo terminal available, skipping\n");
+		return 0;
+	}
+	tcgetattr(slave, &t);
+	cfmakeraw(&t);
+	tcsetattr(slave, TCSANOW, &t);
+	fcntl(master, F_SETFL, O_NONBLOCK);
+
+	/* record */
+	init_port(&port, ptsname(master), RIG_TRACE_RECORD);
+	if (pthread_create(&thread, NULL, fake_rig_thread, NULL) != 0)
+		return 1;
+	ret = port_open(&port);
+	if (ret != RIG_OK) {
+		fprintf(stderr, "record: port_open: %s\n", rigerror(ret));
+		return 1;
+	}
+	ms = session("record", &port);
+	port_close(&port, port.type.rig);
+	stop = 1;
+	pthread_join(thread, NULL);
+	close(slave);
+	close(master);
+	printf("record: %ld ms\n", ms);
+
+	/* replay, the rig being gone */
+	init_port(&port, "/dev/nonexistent-hamlib-port", RIG_TRACE_REPLAY);
+	ret = port_open(&port);
+	if (ret != RIG_OK) {
+		fprintf(stderr, "replay: port_open: %s\n", rigerror(ret));
+		return 1;
+	}
+	ms = session("replay", &port);
+	printf("replay: %ld ms\n", ms);
+	if (ms >= REPLY_DELAY_MS) {
+		fprintf(stderr, "replay: too slow\n");
+		errors++;
+	}
+	/* end of trace, nobody answers */
+	port.timeout = 20;
+	if (read_string(&port, buf, sizeof(buf), ";", 1) != -RIG_ETIMEOUT) {
+		fprintf(stderr, "replay: read past the end of the trace\n");
+		errors++;
+	}
+	port_close(&port, port.type.rig);
+
+	/* replay at recorded speed */
+	init_port(&port, "/dev/nonexistent-hamlib-port", RIG_TRACE_REPLAY_REALTIME);
+	ret = port_open(&port);
+	if (ret != RIG_OK) {
+		fprintf(stderr, "realtime: port_open: %s\n", rigerror(ret));
+		return 1;
+	}
+	ms = session("realtime", &port);
+	printf("realtime: %ld ms\n", ms);
+	if (ms >= 0 && ms < 3 * REPLY_DELAY_MS * 8 / 10) {
+		fprintf(stderr, "realtime: too fast\n");
+		errors++;
+	}
+	port_close(&port, port.type.rig);
+
+	/* the backend diverging from the trace */
+	init_port(&port, "/dev/nonexistent-hamlib-port", RIG_TRACE_REPLAY);
+	port_open(&port);
+	if (write_block(&port, "ID;", 3) == RIG_OK) {
+		fprintf(stderr, "divergent write accepted\n");
+		errors++;
+	}
+	port_close(&port, port.type.rig);
+
+	/* replies filling the pipe, never read */
+	if (write_unread_trace() == 0) {
+		init_port(&port, "/dev/nonexistent-hamlib-port", RIG_TRACE_REPLAY);
+		port_open(&port);
+		ret = write_block(&port, cmds[0], strlen(cmds[0]));
+		printf("unread replies: %s\n", rigerror(ret));
+		if (ret != RIG_OK) {
+			fprintf(stderr, "unread replies: write %s: %s\n", cmds[0],
+					rigerror(ret));
+			errors++;
+		}
+		port_close(&port, port.type.rig);
+	}
+
+	/* not a trace */
+	strncpy(port.trace_file, "/dev/null", FILPATHLEN - 1);
+	if (port_open(&port) == RIG_OK) {
+		fprintf(stderr, "/dev/null accepted as a trace\n");
+		errors++;
+		port_close(&port, port.type.rig);
+	}
+
+	unlink(TRACE_FILE);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
+
+#else	/* !HAVE_PTHREAD */
+
+int main(int argc, char *argv[])
+{
+	printf("no pthread support, nothing to test\n");
+	return 0;
+}
+
+#endif	/* !HAVE_PTHREAD */
@@ -0,0 +1,204 @@
+
+/*
+ * Test program of the write pacing: a fake rig on a pseudo terminal
+ * timestamps the bytes it receives, which must be write_delay apart
+ * within a command, and write_delay+post_write_delay apart between
+ * commands, as rig_write_wait() announces.
+ */
+
+#define _GNU_SOURCE	/* posix_openpt, cfmakeraw */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <sys/time.h>
+#include <hamlib/rig.h>
+#include "iofunc.h"
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+
+#define WRITE_DELAY 20
+#define POST_WRITE_DELAY 50
+/* timestamps are taken every 0.2 mS */
+#define SLACK_MS 1
+
+static int master;
+static volatile int stop;
+static int errors;
+
+static volatile int received;
+static struct timeval dates[16];
+
+static double ms_between(const struct timeval *t1, const struct timeval *t2)
+{
+	return (t2->tv_sec - t1->tv_sec)*1000. +
+		(t2->tv_usec - t1->tv_usec)/1000.;
+}
+
+static void *fake_rig_thread(void *arg)
+{
+	char c;
+
+	while (!stop) {
+		if (read(master, &c, 1) != 1) {
+			usleep(200);
+			continue;
+		}
+		if (received < 16)
+			gettimeofday(&dates[received], NULL);
+		received++;
+	}
+	return NULL;
+}
+
+/* returns the elapsed time of write_block in mS */
+static double send_cmd(hamlib_port_t *p, const char *cmd)
+{
+	struct timeval t1, t2;
+
+	gettimeofday(&t1, NULL);
+	if (write_block(p, cmd, strlen(cmd)) != RIG_OK) {
+		fprintf(stderr, "write_block failed\n");
+		errors++;
+	}
+	gettimeofday(&t2, NULL);
+	return ms_between(&t1, &t2);
+}
+
+static void wait_received(int n)
+{
+	int i;
+
+	for (i = 0; received < n && i < 1000; i++)
+		usleep(1000);
+}
+
+int main(int argc, char *argv[])
+{
+	RIG *rig;
+	hamlib_port_t *port;
+	struct termios t;
+	pthread_t thread;
+	double ms, gap;
+	int slave, wait, rig_wait, i;
+
+	rig_set_debug(RIG_DEBUG_NONE);
+
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) || unlockpt(master)) {
+		printf("no pseudo terminal available, skipping\n");
+		return 0;
+	}
+	slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+	if (slave < 0) {
+		printf("no pseudo terminal available, skipping\n");
+		return 0;
+	}
+	tcgetattr(slave, &t);
+	cfmakeraw(&t);
+	tcsetattr(slave, TCSANOW, &t);
+	fcntl(master, F_SETFL, O_NONBLOCK);
+
+	if (pthread_create(&thread, NULL, fake_rig_thread, NULL) != 0)
+		return 1;
+
+	/* the dummy rig, talking to the pseudo terminal */
+	rig = rig_init(RIG_MODEL_DUMMY);
+	if (!rig || rig_open(rig) != RIG_OK) {
+		fprintf(stderr, "cannot open the dummy rig\n");
+		return 1;
+	}
+	port = &rig->state.rigport;
+	port->type.rig = RIG_PORT_SERIAL;
+	port->parm.serial.rate = 9600;
+	port->parm.serial.data_bits = 8;
+	port->parm.serial.stop_bits = 1;
+	port->write_delay = WRITE_DELAY;
+	port->post_write_delay = POST_WRITE_DELAY;
+	strncpy(port->pathname, ptsname(master), FILPATHLEN - 1);
+	if (port_open(port) != RIG_OK) {
+		fprintf(stderr, "port_open failed\n");
+		return 1;
+	}
+
+	printf("bytes of a command\n");
+	ms = send_cmd(port, "ABC");
+	wait = port_write_wait(port);
+	rig_wait = rig_write_wait(rig);
+	wait_received(3);
+	printf("  sent in %.1f mS, next write in %d mS\n", ms, wait);
+	for (i = 1; i < 3 && received >= 3; i++) {
+		gap = ms_between(&dates[i-1], &dates[i]);
+		printf("  byte %d after %.1f mS\n", i, gap);
+		if (gap < WRITE_DELAY - SLACK_MS) {
+			fprintf(stderr, "byte %d too early\n", i);
+			errors++;
+		}
+	}
+	/* two delays, none after the last byte */
+	if (received != 3 || ms < 2*WRITE_DELAY - SLACK_MS ||
+			ms >= 3*WRITE_DELAY) {
+		fprintf(stderr, "wrong pacing of the command\n");
+		errors++;
+	}
+	if (wait <= WRITE_DELAY || wait > WRITE_DELAY + POST_WRITE_DELAY ||
+			rig_wait > wait || rig_wait < wait - 1) {
+		fprintf(stderr, "wrong wait: port %d, rig %d\n", wait, rig_wait);
+		errors++;
+	}
+
+	printf("next command\n");
+	ms = send_cmd(port, "DE");
+	wait_received(5);
+	if (received == 5) {
+		gap = ms_between(&dates[2], &dates[3]);
+		printf("  first byte after %.1f mS\n", gap);
+		if (gap < WRITE_DELAY + POST_WRITE_DELAY - SLACK_MS ||
+				ms_between(&dates[3], &dates[4]) < WRITE_DELAY - SLACK_MS) {
+			fprintf(stderr, "command too early\n");
+			errors++;
+		}
+	} else {
+		fprintf(stderr, "%d bytes received\n", received);
+		errors++;
+	}
+
+	printf("command after the delay\n");
+	usleep((WRITE_DELAY + POST_WRITE_DELAY + 10)*1000);
+	wait = port_write_wait(port);
+	rig_wait = rig_write_wait(rig);
+	ms = send_cmd(port, "F");
+	printf("  waited %d mS, sent in %.1f mS\n", wait, ms);
+	if (wait != 0 || rig_wait != 0 || ms >= WRITE_DELAY) {
+		fprintf(stderr, "useless wait\n");
+		errors++;
+	}
+
+	rig_close(rig);
+	rig_cleanup(rig);
+	stop = 1;
+	pthread_join(thread, NULL);
+	close(slave);
+	close(master);
+
+	printf("%d error(s)\n", errors);
+	return errors ? 1 : 0;
+}
+
+#else	/* !HAVE_PTHREAD */
+
+int main(int argc, char *argv[])
+{
+	printf("no pthread support, nothing to test\n");
+	return 0;
+}
+
+#endif	/* !HAVE_PTHREAD */
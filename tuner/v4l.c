@@ -169,6 +169,10 @@ int v4l_open(RIG *rig)
 	struct rig_state *rs = &rig->state;
 	double fact;
 
+	ret = rig_copy_tables(rig);
+	if (ret != RIG_OK)
+		return ret;
+
 	for (i=0; i<8; i++) {
 		vt.tuner = i;
 		ret = ioctl(rig->state.rigport.fd, VIDIOCGTUNER, &vt);
@@ -169,6 +169,10 @@ int v4l2_open(RIG *rig)
 	struct rig_state *rs = &rig->state;
 	double fact;
 
+	ret = rig_copy_tables(rig);
+	if (ret != RIG_OK)
+		return ret;
+
 	for (i=0; i<8; i++) {
 		vt.index = i;
 		ret = ioctl(rig->state.rigport.fd, VIDIOC_G_TUNER, &vt);
@@ -32,6 +32,7 @@
 #include "hamlib/rig.h"
 #include "serial.h"
 #include "misc.h"
+#include "numcodec.h"
 #include "register.h"
 #include "idx_builtin.h"
 
@@ -239,7 +240,10 @@ int uniden_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
 	freq /= 100;
 
 	/* exactly 8 digits */
-	freq_len = sprintf(freqbuf, "RF%08u" EOM, (unsigned)freq);
+	freqbuf[0] = 'R';
+	freqbuf[1] = 'F';
+	strcpy(num_to_dec(freqbuf+2, (unsigned)freq, 8), EOM);
+	freq_len = strlen(freqbuf);
 
 	return uniden_transaction (rig, freqbuf, freq_len, NULL, NULL, NULL);
 }
@@ -252,6 +256,7 @@ int uniden_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
 {
 	char freqbuf[BUFSZ];
 	size_t freq_len=BUFSZ;
+	unsigned long long f;
 	int ret;
 
 	ret = uniden_transaction (rig, "RF" EOM, 3, NULL, freqbuf, &freq_len);
@@ -261,9 +266,10 @@ int uniden_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
 	if (freq_len < 10)
 		return -RIG_EPROTO;
 
-	sscanf(freqbuf+2, "%"SCNfreq, freq);
+	if (num_from_dec(freqbuf+2, 8, &f) != RIG_OK)
+		return -RIG_EPROTO;
 	/* returned freq in hundreds of Hz */
-	*freq *= 100;
+	*freq = f * 100;
 
 	return RIG_OK;
 }
@@ -492,7 +498,8 @@ int uniden_get_channel(RIG *rig, channel_t *chan)
 		return -RIG_EPROTO;
 
 	sscanf(membuf+1, "%d", &chan->channel_num);
-	sscanf(membuf+6, "%"SCNfreq, &chan->freq);
+	if (num_scan_freq(membuf+6, &chan->freq) < 0)
+		return -RIG_EPROTO;
 	/* returned freq in hundreds of Hz */
 	chan->freq *= 100;
 
@@ -650,6 +657,7 @@ DECLARE_PROBERIG_BACKEND(uniden)
 
 		if (retval != RIG_OK || id_len < 0)
 			continue;
+		break;
 	}
 
 	if (retval != RIG_OK || id_len < 0 || memcmp(idbuf, "SI ", 3))
@@ -174,8 +174,10 @@ const struct rig_caps ft450_caps = {
     .set_rit =            newcat_set_rit,
     .get_rit =            newcat_get_rit,
     .get_func =           newcat_get_func,
+    .get_funcs =          newcat_get_funcs,
     .set_func =           newcat_set_func,
     .get_level =          newcat_get_level,
+    .get_levels =         newcat_get_levels,
     .set_level =          newcat_set_level,
     .get_mem =            newcat_get_mem,
     .set_mem =            newcat_set_mem,
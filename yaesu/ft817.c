@@ -270,6 +270,7 @@ const struct rig_caps ft817_caps = {
 	.get_vfo = 		NULL,
 	.set_ptt = 		ft817_set_ptt,
 	.get_ptt = 		ft817_get_ptt,
+	.get_snapshot =		ft817_get_snapshot,
 	.get_dcd = 		ft817_get_dcd,
 	.set_rptr_shift = 	ft817_set_rptr_shift,
 	.get_rptr_shift = 	NULL,
@@ -557,6 +558,33 @@ int ft817_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 	return RIG_OK;
 }
 
+/*
+ * One read of each status, decoded right away from the cache,
+ * so that the snapshot holds together.
+ */
+int ft817_get_snapshot(RIG *rig, vfo_t vfo, rig_snapshot_t *snap)
+{
+	int n;
+
+	if (vfo != RIG_VFO_CURR)
+		return -RIG_ENTARGET;
+
+	if ((n = ft817_get_status(rig, FT817_NATIVE_CAT_GET_FREQ_MODE_STATUS)) < 0)
+		return n;
+
+	ft817_get_freq(rig, vfo, &snap->freq);
+	ft817_get_mode(rig, vfo, &snap->mode, &snap->width);
+	snap->fields |= RIG_SNAPSHOT_FREQ | RIG_SNAPSHOT_MODE;
+
+	if ((n = ft817_get_status(rig, FT817_NATIVE_CAT_GET_TX_STATUS)) < 0)
+		return n;
+
+	ft817_get_ptt(rig, vfo, &snap->ptt);
+	snap->fields |= RIG_SNAPSHOT_PTT;
+
+	return RIG_OK;
+}
+
 static int ft817_get_pometer_level(RIG *rig, value_t *val)
 {
 	struct ft817_priv_data *p = (struct ft817_priv_data *) rig->state.priv;
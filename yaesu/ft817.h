@@ -140,6 +140,7 @@ static int ft817_set_mode       (RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t wi
 static int ft817_get_mode       (RIG *rig, vfo_t vfo, rmode_t *mode, pbwidth_t *width);
 static int ft817_set_ptt        (RIG *rig, vfo_t vfo, ptt_t ptt);
 static int ft817_get_ptt        (RIG *rig, vfo_t vfo, ptt_t *ptt);
+static int ft817_get_snapshot   (RIG *rig, vfo_t vfo, rig_snapshot_t *snap);
 static int ft817_get_level      (RIG *rig, vfo_t vfo, setting_t level, value_t *val);
 static int ft817_set_func       (RIG *rig, vfo_t vfo, setting_t func, int status);
 static int ft817_set_dcs_code   (RIG *rig, vfo_t vfo, tone_t code);
@@ -267,6 +267,7 @@ const struct rig_caps ft857_caps = {
   .get_vfo = 		NULL,
   .set_ptt = 		ft857_set_ptt,
   .get_ptt = 		ft857_get_ptt,
+  .get_snapshot =	ft857_get_snapshot,
   .get_dcd = 		ft857_get_dcd,
   .set_rptr_shift = 	ft857_set_rptr_shift,
   .get_rptr_shift = 	NULL,
@@ -572,6 +573,35 @@ int ft857_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
   return RIG_OK;
 }
 
+/*
+ * One read of each status, decoded right away from the cache,
+ * so that the snapshot holds together.
+ */
+int ft857_get_snapshot(RIG *rig, vfo_t vfo, rig_snapshot_t *snap)
+{
+  int n;
+
+  if (vfo != RIG_VFO_CURR)
+    return -RIG_ENTARGET;
+
+  if ((n = ft857_get_status(rig, FT857_NATIVE_CAT_GET_FREQ_MODE_STATUS)) < 0)
+    return n;
+
+  ft857_get_freq(rig, vfo, &snap->freq);
+  ft857_get_mode(rig, vfo, &snap->mode, &snap->width);
+  snap->fields |= RIG_SNAPSHOT_FREQ | RIG_SNAPSHOT_MODE;
+
+  if ((n = ft857_get_status(rig, FT857_NATIVE_CAT_GET_TX_STATUS)) < 0)
+    return n;
+
+  ft857_get_ptt(rig, vfo, &snap->ptt);
+  snap->fields |= RIG_SNAPSHOT_PTT;
+  ft857_get_split_vfo(rig, vfo, &snap->split, &snap->tx_vfo);
+  snap->fields |= RIG_SNAPSHOT_SPLIT;
+
+  return RIG_OK;
+}
+
 static int ft857_get_pometer_level(RIG *rig, value_t *val)
 {
   struct ft857_priv_data *p = (struct ft857_priv_data *) rig->state.priv;
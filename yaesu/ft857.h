@@ -149,6 +149,7 @@ static int ft857_get_split_vfo(RIG *rig, vfo_t vfo, split_t *split, vfo_t *tx_vf
 // static int ft857_get_vfo(RIG *rig, vfo_t *vfo);
 static int ft857_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt);
 static int ft857_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt);
+static int ft857_get_snapshot(RIG *rig, vfo_t vfo, rig_snapshot_t *snap);
 // static int ft857_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val);
 static int ft857_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val);
 static int ft857_set_func(RIG *rig, vfo_t vfo, setting_t func, int status);
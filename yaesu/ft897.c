@@ -95,6 +95,7 @@ static int ft897_get_split_vfo(RIG *rig, vfo_t vfo, split_t *split, vfo_t *tx_vf
 static int ft897_vfo_op(RIG *rig, vfo_t vfo, vfo_op_t op);
 static int ft897_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt);
 static int ft897_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt);
+static int ft897_get_snapshot(RIG *rig, vfo_t vfo, rig_snapshot_t *snap);
 // static int ft897_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val);
 static int ft897_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val);
 static int ft897_set_func(RIG *rig, vfo_t vfo, setting_t func, int status);
@@ -294,6 +295,7 @@ const struct rig_caps ft897_caps = {
   .get_vfo = 		NULL,
   .set_ptt = 		ft897_set_ptt,
   .get_ptt = 		ft897_get_ptt,
+  .get_snapshot =	ft897_get_snapshot,
   .get_dcd = 		ft897_get_dcd,
   .set_rptr_shift = 	ft897_set_rptr_shift,
   .get_rptr_shift = 	NULL,
@@ -544,6 +546,35 @@ int ft897_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
   return RIG_OK;
 }
 
+/*
+ * One read of each status, decoded right away from the cache,
+ * so that the snapshot holds together.
+ */
+int ft897_get_snapshot(RIG *rig, vfo_t vfo, rig_snapshot_t *snap)
+{
+  int n;
+
+  if (vfo != RIG_VFO_CURR)
+    return -RIG_ENTARGET;
+
+  if ((n = ft897_get_status(rig, FT897_NATIVE_CAT_GET_FREQ_MODE_STATUS)) < 0)
+    return n;
+
+  ft897_get_freq(rig, vfo, &snap->freq);
+  ft897_get_mode(rig, vfo, &snap->mode, &snap->width);
+  snap->fields |= RIG_SNAPSHOT_FREQ | RIG_SNAPSHOT_MODE;
+
+  if ((n = ft897_get_status(rig, FT897_NATIVE_CAT_GET_TX_STATUS)) < 0)
+    return n;
+
+  ft897_get_ptt(rig, vfo, &snap->ptt);
+  snap->fields |= RIG_SNAPSHOT_PTT;
+  ft897_get_split_vfo(rig, vfo, &snap->split, &snap->tx_vfo);
+  snap->fields |= RIG_SNAPSHOT_SPLIT;
+
+  return RIG_OK;
+}
+
 static int ft897_get_pometer_level(RIG *rig, value_t *val)
 {
   struct ft897_priv_data *p = (struct ft897_priv_data *) rig->state.priv;
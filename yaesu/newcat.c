@@ -41,6 +41,7 @@
 
 #include "hamlib/rig.h"
 #include "iofunc.h"
+#include "numcodec.h"
 #include "newcat.h"
 
 /* global variables */
@@ -364,7 +365,7 @@ int newcat_set_freq(RIG *rig, vfo_t vfo, freq_t freq) {
     const struct rig_caps *caps;
     struct newcat_priv_data *priv;
     struct rig_state *state;
-    char c;
+    char c, *p;
     int err;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
@@ -387,6 +388,10 @@ int newcat_set_freq(RIG *rig, vfo_t vfo, freq_t freq) {
     rig_debug(RIG_DEBUG_TRACE, "%s: R2 minimum freq = %"PRIfreq" Hz\n", __func__, caps->rx_range_list2[0].start);
     rig_debug(RIG_DEBUG_TRACE, "%s: R2 maximum freq = %"PRIfreq" Hz\n", __func__, caps->rx_range_list2[0].end);
 
+    /* the field has no sign */
+    if (freq < 0)
+        return -RIG_EINVAL;
+
     if (freq < caps->rx_range_list1[0].start || freq > caps->rx_range_list1[0].end ||
             freq < caps->rx_range_list2[0].start || freq > caps->rx_range_list2[0].end)
         return -RIG_EINVAL;
@@ -412,12 +417,15 @@ int newcat_set_freq(RIG *rig, vfo_t vfo, freq_t freq) {
 
     // W1HKJ
     // creation of the priv structure guarantees that the string can be NEWCAT_DATA_LEN
-    // bytes in length.  the snprintf will only allow (NEWCAT_DATA_LEN - 1) chars
-    // followed by the NULL terminator.
+    // bytes in length, the frequency needing at most 10 digits.
     // CAT command string for setting frequency requires that 8 digits be sent
     // including leading fill zeros
 
-    snprintf(priv->cmd_str, sizeof(priv->cmd_str), "F%c%08d%c", c, (int)freq, cat_term);
+    priv->cmd_str[0] = 'F';
+    priv->cmd_str[1] = c;
+    p = num_to_dec(priv->cmd_str+2, (unsigned long long)freq, 8);
+    p[0] = cat_term;
+    p[1] = '\0';
 
     rig_debug(RIG_DEBUG_TRACE, "%s: cmd_str = %s\n", __func__, priv->cmd_str);
 
@@ -505,7 +513,11 @@ int newcat_get_freq(RIG *rig, vfo_t vfo, freq_t *freq) {
     }
 
     /* convert the read frequency string into freq_t and store in *freq */
-    sscanf(priv->ret_data+2, "%"SCNfreq, freq);
+    if (num_scan_freq(priv->ret_data+2, freq) < 0) {
+        rig_debug(RIG_DEBUG_ERR, "%s: Malformed frequency '%s'\n",
+                __func__, priv->ret_data);
+        return -RIG_EPROTO;
+    }
 
     rig_debug(RIG_DEBUG_TRACE,
             "%s: freq = %"PRIfreq" Hz for vfo 0x%02x\n", __func__, freq, vfo);
@@ -2359,23 +2371,16 @@ int newcat_set_level(RIG * rig, vfo_t vfo, setting_t level, value_t val)
 }
 
 
-int newcat_get_level(RIG * rig, vfo_t vfo, setting_t level, value_t * val)
+/*
+ * Command reading a level, into priv->cmd_str
+ */
+static int newcat_get_level_cmd(RIG * rig, vfo_t vfo, setting_t level)
 {
     struct newcat_priv_data *priv;
-    struct rig_state *state;
     int err;
-    int ret_data_len;
-    char *retlvl;
-    float scale;
     char main_sub_vfo = '0';
 
-    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
-
-    if (!rig)
-        return -RIG_EINVAL;
-
     priv = (struct newcat_priv_data *)rig->state.priv;
-    state = &rig->state;
 
     /* Set Main or SUB vfo */
     err = newcat_set_vfo_from_alias(rig, &vfo);
@@ -2524,11 +2529,23 @@ int newcat_get_level(RIG * rig, vfo_t vfo, setting_t level, value_t * val)
             return -RIG_EINVAL;
     }
 
-    err = write_block(&state->rigport, priv->cmd_str, strlen(priv->cmd_str));
-    if (err != RIG_OK)
-        return err;
+    return RIG_OK;
+}
 
-    err = read_string(&state->rigport, priv->ret_data, sizeof(priv->ret_data),
+
+/*
+ * Reads the answer to a command of cmd_len chars, terminator included,
+ * *ans pointing past the command in priv->ret_data, terminator chopped
+ */
+static int newcat_get_answer(RIG * rig, size_t cmd_len, char **ans)
+{
+    struct newcat_priv_data *priv;
+    int err;
+    int ret_data_len;
+
+    priv = (struct newcat_priv_data *)rig->state.priv;
+
+    err = read_string(&rig->state.rigport, priv->ret_data, sizeof(priv->ret_data),
             &cat_term, sizeof(cat_term));
     if (err < 0)
         return err;
@@ -2538,15 +2555,76 @@ int newcat_get_level(RIG * rig, vfo_t vfo, setting_t level, value_t * val)
 
     ret_data_len = strlen(priv->ret_data);
 
-    if (ret_data_len <= strlen(priv->cmd_str) ||
+    if (ret_data_len <= cmd_len ||
             priv->ret_data[ret_data_len-1] != cat_term)
         return -RIG_EPROTO;
 
     /* skip command */
-    retlvl = priv->ret_data + strlen(priv->cmd_str)-1;
+    *ans = priv->ret_data + cmd_len-1;
+    /* chop term */
+    priv->ret_data[ret_data_len-1] = '\0';
+
+    return RIG_OK;
+}
+
+
+/*
+ * Reads one answer to a batch of get commands, and matches it to the
+ * pending command it starts with. Returns the index of the setting
+ * answered, -RIG_EPROTO for an answer like "?;" telling no command,
+ * or -RIG_ENAVAIL for an answer to none of the pending commands.
+ */
+static int newcat_get_batch_answer(RIG * rig, const char *cmds,
+        const size_t *cmd_off, const size_t *cmd_len, setting_t pending,
+        char **ans)
+{
+    struct newcat_priv_data *priv;
+    int err, i;
+    size_t ret_data_len;
+
+    priv = (struct newcat_priv_data *)rig->state.priv;
+
+    err = read_string(&rig->state.rigport, priv->ret_data, sizeof(priv->ret_data),
+            &cat_term, sizeof(cat_term));
+    if (err < 0)
+        return err;
+
+    rig_debug(RIG_DEBUG_TRACE, "%s: read count = %d, ret_data = %s\n",
+            __func__, err, priv->ret_data);
+
+    ret_data_len = strlen(priv->ret_data);
+    if (ret_data_len == 0 || priv->ret_data[ret_data_len-1] != cat_term)
+        return -RIG_EPROTO;
+
+    for (i = 0; i < RIG_SETTING_MAX; i++) {
+        if (!(pending & rig_idx2setting(i)) || ret_data_len <= cmd_len[i])
+            continue;
+        /* the command without its terminator */
+        if (!strncmp(priv->ret_data, cmds + cmd_off[i], cmd_len[i]-1))
+            break;
+    }
+    if (i == RIG_SETTING_MAX) {
+        if (ret_data_len <= 2)
+            return -RIG_EPROTO;
+        rig_debug(RIG_DEBUG_VERBOSE, "%s: unsolicited answer %s\n",
+                __func__, priv->ret_data);
+        return -RIG_ENAVAIL;
+    }
+
+    /* skip command */
+    *ans = priv->ret_data + cmd_len[i]-1;
     /* chop term */
     priv->ret_data[ret_data_len-1] = '\0';
 
+    return i;
+}
+
+
+static int newcat_parse_level(RIG * rig, setting_t level, const char *retlvl, value_t * val)
+{
+    struct rig_state *state = &rig->state;
+    float scale;
+
     switch (level) {
         case RIG_LEVEL_RFPOWER:
         case RIG_LEVEL_VOXGAIN:
@@ -2635,6 +2713,104 @@ int newcat_get_level(RIG * rig, vfo_t vfo, setting_t level, value_t * val)
 }
 
 
+int newcat_get_level(RIG * rig, vfo_t vfo, setting_t level, value_t * val)
+{
+    struct newcat_priv_data *priv;
+    int err;
+    char *retlvl;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!rig)
+        return -RIG_EINVAL;
+
+    priv = (struct newcat_priv_data *)rig->state.priv;
+
+    err = newcat_get_level_cmd(rig, vfo, level);
+    if (err != RIG_OK)
+        return err;
+
+    err = write_block(&rig->state.rigport, priv->cmd_str, strlen(priv->cmd_str));
+    if (err != RIG_OK)
+        return err;
+
+    err = newcat_get_answer(rig, strlen(priv->cmd_str), &retlvl);
+    if (err != RIG_OK)
+        return err;
+
+    return newcat_parse_level(rig, level, retlvl, val);
+}
+
+
+/*
+ * Levels read in one exchange, their commands sent at once and the
+ * answers matched to them by their prefix. Those not answered as
+ * expected, or not answered before the timeout, are left to
+ * newcat_get_level().
+ */
+int newcat_get_levels(RIG * rig, vfo_t vfo, setting_t * levels, value_t * vals)
+{
+    struct newcat_priv_data *priv;
+    char cmds[NEWCAT_DATA_LEN * 2];
+    size_t cmd_off[RIG_SETTING_MAX];
+    size_t cmd_len[RIG_SETTING_MAX];
+    size_t len = 0;
+    setting_t level, batch = 0;
+    char *retlvl;
+    int i, err, npending = 0;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!rig || !levels || !vals)
+        return -RIG_EINVAL;
+
+    priv = (struct newcat_priv_data *)rig->state.priv;
+
+    for (i = 0; i < RIG_SETTING_MAX; i++) {
+        level = rig_idx2setting(i);
+        if (!(*levels & level) || newcat_get_level_cmd(rig, vfo, level) != RIG_OK)
+            continue;
+        cmd_len[i] = strlen(priv->cmd_str);
+        if (len + cmd_len[i] > sizeof(cmds))
+            break;
+        memcpy(cmds + len, priv->cmd_str, cmd_len[i]);
+        cmd_off[i] = len;
+        len += cmd_len[i];
+        batch |= level;
+        npending++;
+    }
+    if (!batch)
+        return RIG_OK;
+
+    err = write_block(&rig->state.rigport, cmds, len);
+    if (err != RIG_OK)
+        return err;
+
+    while (npending > 0) {
+        i = newcat_get_batch_answer(rig, cmds, cmd_off, cmd_len, batch, &retlvl);
+        /* the answers read are kept, the others left to the single reads */
+        if (i == -RIG_ETIMEOUT)
+            break;
+        /* e.g. "?;", left to the single read */
+        if (i == -RIG_EPROTO) {
+            npending--;
+            continue;
+        }
+        if (i == -RIG_ENAVAIL)
+            continue;
+        if (i < 0)
+            return i;
+        level = rig_idx2setting(i);
+        batch &= ~level;
+        npending--;
+        if (newcat_parse_level(rig, level, retlvl, &vals[i]) == RIG_OK)
+            *levels &= ~level;
+    }
+
+    return RIG_OK;
+}
+
+
 int newcat_set_func(RIG * rig, vfo_t vfo, setting_t func, int status)
 {
     struct newcat_priv_data *priv;
@@ -2734,22 +2910,15 @@ int newcat_set_func(RIG * rig, vfo_t vfo, setting_t func, int status)
 }
 
 
-int newcat_get_func(RIG * rig, vfo_t vfo, setting_t func, int *status)
+/*
+ * Command reading a function, into priv->cmd_str
+ */
+static int newcat_get_func_cmd(RIG * rig, vfo_t vfo, setting_t func)
 {
     struct newcat_priv_data *priv;
-    struct rig_state *state;
-    int err;
-    int ret_data_len;
-    char *retfunc;
     char main_sub_vfo = '0';
 
-    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
-
-    if (!rig)
-        return -RIG_EINVAL;
-
     priv = (struct newcat_priv_data *)rig->state.priv;
-    state = &rig->state;
 
     switch (func) {
         case RIG_FUNC_ANF:
@@ -2819,28 +2988,12 @@ int newcat_get_func(RIG * rig, vfo_t vfo, setting_t func, int *status)
             return -RIG_EINVAL;
     }
 
-    err = write_block(&state->rigport, priv->cmd_str, strlen(priv->cmd_str));
-    if (err != RIG_OK)
-        return err;
-
-    err = read_string(&state->rigport, priv->ret_data, sizeof(priv->ret_data),
-            &cat_term, sizeof(cat_term));
-    if (err < 0)
-        return err;
-
-    rig_debug(RIG_DEBUG_TRACE, "%s: read count = %d, ret_data = %s\n",
-            __func__, err, priv->ret_data);
-
-    ret_data_len = strlen(priv->ret_data);
-    if (ret_data_len <= strlen(priv->cmd_str) ||
-            priv->ret_data[ret_data_len-1] != cat_term)
-        return -RIG_EPROTO;
+    return RIG_OK;
+}
 
-    /* skip command */
-    retfunc = priv->ret_data + strlen(priv->cmd_str)-1;
-    /* chop term */
-    priv->ret_data[ret_data_len-1] = '\0';
 
+static int newcat_parse_func(RIG * rig, setting_t func, const char *retfunc, int *status)
+{
     switch (func) {
         case RIG_FUNC_MN:
             *status = (retfunc[2] == '0') ? 0 : 1;
@@ -2870,6 +3023,104 @@ int newcat_get_func(RIG * rig, vfo_t vfo, setting_t func, int *status)
 }
 
 
+int newcat_get_func(RIG * rig, vfo_t vfo, setting_t func, int *status)
+{
+    struct newcat_priv_data *priv;
+    int err;
+    char *retfunc;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!rig)
+        return -RIG_EINVAL;
+
+    priv = (struct newcat_priv_data *)rig->state.priv;
+
+    err = newcat_get_func_cmd(rig, vfo, func);
+    if (err != RIG_OK)
+        return err;
+
+    err = write_block(&rig->state.rigport, priv->cmd_str, strlen(priv->cmd_str));
+    if (err != RIG_OK)
+        return err;
+
+    err = newcat_get_answer(rig, strlen(priv->cmd_str), &retfunc);
+    if (err != RIG_OK)
+        return err;
+
+    return newcat_parse_func(rig, func, retfunc, status);
+}
+
+
+/*
+ * Functions read in one exchange, as newcat_get_levels()
+ */
+int newcat_get_funcs(RIG * rig, vfo_t vfo, setting_t * funcs, setting_t * status)
+{
+    struct newcat_priv_data *priv;
+    char cmds[NEWCAT_DATA_LEN * 2];
+    size_t cmd_off[RIG_SETTING_MAX];
+    size_t cmd_len[RIG_SETTING_MAX];
+    size_t len = 0;
+    setting_t func, batch = 0;
+    char *retfunc;
+    int i, err, fstatus, npending = 0;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!rig || !funcs || !status)
+        return -RIG_EINVAL;
+
+    priv = (struct newcat_priv_data *)rig->state.priv;
+
+    for (i = 0; i < RIG_SETTING_MAX; i++) {
+        func = rig_idx2setting(i);
+        if (!(*funcs & func) || newcat_get_func_cmd(rig, vfo, func) != RIG_OK)
+            continue;
+        cmd_len[i] = strlen(priv->cmd_str);
+        if (len + cmd_len[i] > sizeof(cmds))
+            break;
+        memcpy(cmds + len, priv->cmd_str, cmd_len[i]);
+        cmd_off[i] = len;
+        len += cmd_len[i];
+        batch |= func;
+        npending++;
+    }
+    if (!batch)
+        return RIG_OK;
+
+    err = write_block(&rig->state.rigport, cmds, len);
+    if (err != RIG_OK)
+        return err;
+
+    while (npending > 0) {
+        i = newcat_get_batch_answer(rig, cmds, cmd_off, cmd_len, batch, &retfunc);
+        /* the answers read are kept, the others left to the single reads */
+        if (i == -RIG_ETIMEOUT)
+            break;
+        /* e.g. "?;", left to the single read */
+        if (i == -RIG_EPROTO) {
+            npending--;
+            continue;
+        }
+        if (i == -RIG_ENAVAIL)
+            continue;
+        if (i < 0)
+            return i;
+        func = rig_idx2setting(i);
+        batch &= ~func;
+        npending--;
+        if (newcat_parse_func(rig, func, retfunc, &fstatus) != RIG_OK)
+            continue;
+        if (fstatus)
+            *status |= func;
+        *funcs &= ~func;
+    }
+
+    return RIG_OK;
+}
+
+
 int newcat_set_parm(RIG * rig, setting_t parm, value_t val)
 {
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
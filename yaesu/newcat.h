@@ -121,8 +121,10 @@ int newcat_set_ant(RIG * rig, vfo_t vfo, ant_t ant);
 int newcat_get_ant(RIG * rig, vfo_t vfo, ant_t * ant);
 int newcat_set_level(RIG * rig, vfo_t vfo, setting_t level, value_t val);
 int newcat_get_level(RIG * rig, vfo_t vfo, setting_t level, value_t * val);
+int newcat_get_levels(RIG * rig, vfo_t vfo, setting_t * levels, value_t * vals);
 int newcat_set_func(RIG * rig, vfo_t vfo, setting_t func, int status);
 int newcat_get_func(RIG * rig, vfo_t vfo, setting_t func, int *status);
+int newcat_get_funcs(RIG * rig, vfo_t vfo, setting_t * funcs, setting_t * status);
 int newcat_set_mem(RIG * rig, vfo_t vfo, int ch);
 int newcat_get_mem(RIG * rig, vfo_t vfo, int *ch);
 int newcat_vfo_op(RIG * rig, vfo_t vfo, vfo_op_t op);
@@ -121,7 +121,7 @@ DECLARE_PROBERIG_BACKEND(yaesu)
 	static const unsigned char cmd[YAESU_CMD_LENGTH] = { 0x00, 0x00, 0x00, 0x00, 0xfa};
 	int id_len=-1, i, id1, id2;
 	int retval=-1;
-	int rates[] = { 4800, 57600, 9600, 38400, 0 };	/* possible baud rates */
+	int rates[] = { 4800, 9600, 38400, 57600, 0 };	/* possible baud rates, most likely first */
 	int rates_idx;
 
 	if (!port)
@@ -153,6 +153,7 @@ DECLARE_PROBERIG_BACKEND(yaesu)
 
 		if (retval != RIG_OK || id_len < 0)
 			continue;
+		break;
 	}
 
 	if (retval != RIG_OK || id_len < 0)
@@ -161,7 +162,7 @@ DECLARE_PROBERIG_BACKEND(yaesu)
 	/*
 	 * reply should be [Flag1,Flag2,Flag3,ID1,ID2]
 	 */
-	if (id_len != 5 || id_len != 6) {
+	if (id_len != 5 && id_len != 6) {
 		idbuf[YAESU_CMD_LENGTH] = '\0';
 		rig_debug(RIG_DEBUG_WARN,"probe_yaesu: protocol error,"
 			" expected %d, received %d: %s\n", 6, id_len, idbuf);